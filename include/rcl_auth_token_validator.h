@@ -16,6 +16,14 @@ class RAuthTokenValidator : public QObject
         //! Validate.
         virtual bool validate(const QString &resourceName, const QString &token) = 0;
 
+        //! Validate and return validity date of the token in seconds since epoch (0 if not known).
+        //! Validators which know the validity date should override this so that caches can respect it.
+        virtual bool validateWithValidityDate(const QString &resourceName, const QString &token, qint64 &validityDate)
+        {
+            validityDate = 0;
+            return this->validate(resourceName,token);
+        }
+
 };
 
 #endif // RCL_AUTH_TOKEN_VALIDATOR_H
@@ -0,0 +1,110 @@
+#ifndef RCL_AUTH_TOKEN_VALIDATOR_CACHE_H
+#define RCL_AUTH_TOKEN_VALIDATOR_CACHE_H
+
+#include <QCache>
+#include <QJsonObject>
+#include <QMutex>
+
+#include <atomic>
+
+#include "rcl_auth_token_validator.h"
+
+//! Caching decorator of authentication token validator.
+//! Positive results are kept in a bounded LRU cache until their TTL or the token validity date
+//! expires, negative results are kept for a short TTL only.
+class RAuthTokenValidatorCache : public RAuthTokenValidator
+{
+
+    Q_OBJECT
+
+    public:
+
+        static constexpr qsizetype defaultMaxEntries = 10000;
+        static constexpr qint64 defaultTtlMs = 300000;
+        static constexpr qint64 defaultNegativeTtlMs = 5000;
+
+    protected:
+
+        struct Entry
+        {
+            //! Expiry time in milliseconds since epoch.
+            qint64 expiryTime;
+        };
+
+        //! Validator whose results are cached.
+        RAuthTokenValidator *pValidator;
+        //! Time to live of positive results.
+        qint64 ttlMs;
+        //! Time to live of negative results.
+        qint64 negativeTtlMs;
+        //! Cache mutex.
+        mutable QMutex mutex;
+        //! Positive results.
+        QCache<QString,Entry> validCache;
+        //! Negative results.
+        QCache<QString,Entry> invalidCache;
+        //! Generation, incremented by each invalidation (guarded by the mutex).
+        quint64 generation;
+        //! Number of cache hits.
+        std::atomic<quint64> nHits;
+        //! Number of cache misses.
+        std::atomic<quint64> nMisses;
+
+    public:
+
+        //! Constructor.
+        explicit RAuthTokenValidatorCache(RAuthTokenValidator *pValidator,
+                                          qsizetype maxEntries = defaultMaxEntries,
+                                          qint64 ttlMs = defaultTtlMs,
+                                          qint64 negativeTtlMs = defaultNegativeTtlMs,
+                                          QObject *parent = nullptr);
+
+        //! Return validator whose results are cached.
+        RAuthTokenValidator *getValidator() const;
+
+        //! Set validator whose results are cached (clears the cache).
+        void setValidator(RAuthTokenValidator *pValidator);
+
+        //! Validate.
+        bool validate(const QString &resourceName, const QString &token) override final;
+
+        //! Validate and return validity date of the token.
+        bool validateWithValidityDate(const QString &resourceName, const QString &token, qint64 &validityDate) override final;
+
+        //! Invalidate cached result of given token.
+        void invalidate(const QString &resourceName, const QString &token);
+
+        //! Invalidate cached results of all tokens of given resource.
+        void invalidateResource(const QString &resourceName);
+
+        //! Invalidate all cached results.
+        void clear();
+
+        //! Return number of cached results.
+        qsizetype size() const;
+
+        //! Return number of cache hits.
+        quint64 getHitCount() const;
+
+        //! Return number of cache misses.
+        quint64 getMissCount() const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+    protected:
+
+        //! Return current time in milliseconds since epoch.
+        virtual qint64 currentTime() const;
+
+    private:
+
+        //! Build cache key.
+        static QString buildKey(const QString &resourceName, const QString &token);
+
+};
+
+#endif // RCL_AUTH_TOKEN_VALIDATOR_CACHE_H
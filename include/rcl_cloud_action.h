@@ -1,6 +1,9 @@
 #ifndef RCL_CLOUD_ACTION_H
 #define RCL_CLOUD_ACTION_H
 
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
 #include <QMap>
 #include <QString>
 #include <QUuid>
@@ -46,6 +49,33 @@ class RCloudAction
                 static const QString key;
                 static const QString description;
             };
+
+            struct Range
+            {
+                static const QString key;
+                static const QString description;
+            };
+
+            struct IfRange
+            {
+                static const QString key;
+                static const QString description;
+            };
+
+            struct IfNoneMatch
+            {
+                static const QString key;
+                static const QString description;
+            };
+        };
+
+        struct Server
+        {
+            struct Metrics
+            {
+                static const QString key;
+                static const QString description;
+            };
         };
 
         struct Action
@@ -231,6 +261,16 @@ class RCloudAction
                 static const QString key;
                 static const QString description;
             };
+            struct Batch
+            {
+                static const QString key;
+                static const QString description;
+            };
+            struct FileChanges
+            {
+                static const QString key;
+                static const QString description;
+            };
         };
 
     protected:
@@ -296,9 +336,71 @@ class RCloudAction
         //! Set error type.
         void setErrorType(RError::Type errorType);
 
+        //! Create action object from Json.
+        //! Executor and authentication token are not exchanged, they belong to the enclosing request.
+        static RCloudAction fromJson(const QJsonObject &json);
+
+        //! Create Json from action object.
+        QJsonObject toJson() const;
+
+        //! Build body of batch request or response.
+        static QByteArray batchToJson(const QList<RCloudAction> &actions);
+
+        //! Parse body of batch request or response.
+        static QList<RCloudAction> batchFromJson(const QByteArray &data, bool *ok = nullptr);
+
         //! Return list of actions.
         static QMap<QString,QString> getActionMap();
 
+        //! Return true if action changes state of the server.
+        static bool isMutatingAction(const QString &actionKey);
+
+        //! Return true if action changes files.
+        static bool isFileChangingAction(const QString &actionKey);
+
+        //! Return true if response carries entity tag so that request may be conditional.
+        static bool isConditionalAction(const QString &actionKey);
+
+        //! Return true if response may be cached between requests.
+        static bool isCacheableAction(const QString &actionKey);
+
+        //! Return true if action may be part of batch.
+        static bool isBatchableAction(const QString &actionKey);
+
+        //! Return true if action transfers large body.
+        static bool isBulkAction(const QString &actionKey);
+
+        //! Return true if action administers the server.
+        static bool isAdminAction(const QString &actionKey);
+
+        //! Return cacheable actions whose responses may be changed by given mutating action.
+        static QList<QString> findAffectedActions(const QString &mutatingActionKey);
+
+    private:
+
+        //! Action properties.
+        enum Property
+        {
+            Mutating     = 1 << 0,
+            FileChanging = 1 << 1,
+            Conditional  = 1 << 2,
+            Cacheable    = 1 << 3,
+            Batchable    = 1 << 4,
+            Bulk         = 1 << 5,
+            Admin        = 1 << 6,
+            //! Action reads or changes users.
+            UserData     = 1 << 7,
+            //! Action reads or changes groups.
+            GroupData    = 1 << 8,
+            //! Action reads or changes access rights of actions.
+            ActionData   = 1 << 9,
+            //! Action reads or changes access rights of processes.
+            ProcessData  = 1 << 10
+        };
+
+        //! Return properties of all actions.
+        static const QHash<QString,int> &getActionProperties();
+
 };
 
 #endif // RCL_CLOUD_ACTION_H
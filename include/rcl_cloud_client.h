@@ -22,6 +22,8 @@ class RCloudClient : public QObject
         RHttpClientSettings httpClientSettings;
         //! Blocking task.
         bool blocking;
+        //! Listings remembered for conditional requests, shared by all requests.
+        std::shared_ptr<RHttpClientValidatorCache> pValidatorCache;
 
         //! Logger prefix.
         static const QString logPrefix;
@@ -136,8 +138,19 @@ class RCloudClient : public QObject
         //! Submit query request.
         RToolTask *requestQuery(const QString &query, const QString &authUser = QString(), const QString &authToken = QString());
 
+        //! Submit batch of several small actions in one request.
+        //! Failure of the whole batch is reported by batchFailed() only.
+        RToolTask *requestBatch(const QList<RCloudAction> &actions, const QString &authUser = QString(), const QString &authToken = QString());
+
+        //! Submit wait for changes of files after given cursor.
+        //! Result is reported by fileChangesAvailable() or fileChangesFailed() only.
+        RToolTask *requestFileChanges(quint64 cursor, const QString &authUser = QString(), const QString &authToken = QString());
+
     private:
 
+        //! Create HTTP client for a single request.
+        RHttpClient *createHttpClient();
+
         //! Submit task.
         RToolTask *submitAction(const QSharedPointer<RCloudToolAction> &toolAction);
 
@@ -293,6 +306,18 @@ class RCloudClient : public QObject
         //! Query result is available.
         void queryResultAvailable(QString response);
 
+        //! Batch has finished (each result carries its own error type).
+        void batchFinished(QList<RCloudAction> results);
+
+        //! Whole batch has failed (actions are those which were submitted).
+        void batchFailed(RError::Type errorType, QString errorMessage, QString message, QList<RCloudAction> actions);
+
+        //! Changes of files are available.
+        void fileChangesAvailable(RFileChangeSet fileChangeSet);
+
+        //! Wait for changes of files has failed.
+        void fileChangesFailed(RError::Type errorType, QString errorMessage);
+
         //! File was downloaded.
         void statisticsAvailable(QString statistics);
 
@@ -10,6 +10,7 @@
 #include "rcl_access_owner.h"
 #include "rcl_auth_token.h"
 #include "rcl_cloud_action_info.h"
+#include "rcl_file_change_set.h"
 #include "rcl_file_info.h"
 #include "rcl_http_client.h"
 #include "rcl_cloud_process_info.h"
@@ -62,6 +63,8 @@ class RCloudToolAction : public RToolAction
             ProcessUpdateAccessMode,
             SubmitReport,
             Query,
+            Batch,
+            FileChanges,
             NTypes
         };
 
@@ -311,6 +314,19 @@ class RCloudToolAction : public RToolAction
         //! Process query response.
         static QString processQueryResponse(const QByteArray &data);
 
+        //! Set action batch of several actions.
+        //! Authentication of the batch applies to all its actions.
+        static QSharedPointer<RCloudToolAction> requestBatch(RHttpClient *httpClient, const QList<RCloudAction> &actions, const QString &authUser = QString(), const QString &authToken = QString());
+
+        //! Process batch response (results carry action ID, error type and response data).
+        static QList<RCloudAction> processBatchResponse(const QByteArray &data);
+
+        //! Set action wait for changes of files after given cursor (0 to get current cursor).
+        static QSharedPointer<RCloudToolAction> requestFileChanges(RHttpClient *httpClient, quint64 cursor, const QString &authUser = QString(), const QString &authToken = QString());
+
+        //! Process file changes response.
+        static RFileChangeSet processFileChangesResponse(const QByteArray &data);
+
 };
 
 #endif // RCL_CLOUD_TOOL_ACTION_H
@@ -0,0 +1,83 @@
+#ifndef RCL_FILE_CHANGE_H
+#define RCL_FILE_CHANGE_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QUuid>
+
+class RFileChange
+{
+
+    public:
+
+        enum Operation
+        {
+            //! File was uploaded.
+            Created = 0,
+            //! File content or metadata was updated.
+            Updated,
+            //! File was removed.
+            Removed
+        };
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const RFileChange *pFileChange = nullptr);
+
+    protected:
+
+        //! File ID.
+        QUuid id;
+        //! File name (including path).
+        QString path;
+        //! Checksum.
+        QByteArray md5Checksum;
+        //! Operation.
+        Operation operation;
+
+    public:
+
+        //! Constructor.
+        RFileChange();
+
+        //! Constructor.
+        RFileChange(const QUuid &id, const QString &path, const QByteArray &md5Checksum, Operation operation);
+
+        //! Copy constructor.
+        RFileChange(const RFileChange &fileChange);
+
+        //! Destructor.
+        ~RFileChange();
+
+        //! Assignment operator.
+        RFileChange &operator =(const RFileChange &fileChange);
+
+        //! Return const reference to file ID.
+        const QUuid &getId() const;
+
+        //! Return const reference to file name.
+        const QString &getPath() const;
+
+        //! Return const reference to checksum.
+        const QByteArray &getMd5Checksum() const;
+
+        //! Return operation.
+        Operation getOperation() const;
+
+        //! Create file change object from Json.
+        static RFileChange fromJson(const QJsonObject &json);
+
+        //! Create Json from file change object.
+        QJsonObject toJson() const;
+
+        //! Return name of given operation.
+        static QString operationToString(Operation operation);
+
+        //! Return operation of given name.
+        static Operation operationFromString(const QString &operationName);
+
+};
+
+#endif // RCL_FILE_CHANGE_H
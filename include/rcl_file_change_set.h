@@ -0,0 +1,60 @@
+#ifndef RCL_FILE_CHANGE_SET_H
+#define RCL_FILE_CHANGE_SET_H
+
+#include <QJsonObject>
+#include <QList>
+
+#include "rcl_file_change.h"
+
+class RFileChangeSet
+{
+
+    protected:
+
+        //! Internal initialization function.
+        void _init(const RFileChangeSet *pFileChangeSet = nullptr);
+
+    protected:
+
+        //! Cursor to wait for next changes from.
+        quint64 cursor;
+        //! True if changes since the requested cursor are not known and files have to be listed.
+        bool reset;
+        //! Changes in order they happened.
+        QList<RFileChange> changes;
+
+    public:
+
+        //! Constructor.
+        RFileChangeSet();
+
+        //! Constructor.
+        RFileChangeSet(quint64 cursor, bool reset, const QList<RFileChange> &changes);
+
+        //! Copy constructor.
+        RFileChangeSet(const RFileChangeSet &fileChangeSet);
+
+        //! Destructor.
+        ~RFileChangeSet();
+
+        //! Assignment operator.
+        RFileChangeSet &operator =(const RFileChangeSet &fileChangeSet);
+
+        //! Return cursor to wait for next changes from.
+        quint64 getCursor() const;
+
+        //! Return true if files have to be listed.
+        bool getReset() const;
+
+        //! Return const reference to list of changes.
+        const QList<RFileChange> &getChanges() const;
+
+        //! Create file change set object from Json.
+        static RFileChangeSet fromJson(const QJsonObject &json);
+
+        //! Create Json from file change set object.
+        QJsonObject toJson() const;
+
+};
+
+#endif // RCL_FILE_CHANGE_SET_H
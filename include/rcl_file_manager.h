@@ -29,6 +29,8 @@ class RFileManager : public QObject
         QFileSystemWatcher *localFileSystemWatcher;
         //! Remote refresh timer.
         QTimer *remoteRefreshTimer;
+        //! Remote refresh timeout in milliseconds.
+        uint remoteRefreshTimeout;
         //! List of remote files.
         QList<RFileInfo> remoteFiles;
         //! List of local files.
@@ -40,6 +42,15 @@ class RFileManager : public QObject
         //! File manager is running.
         bool isRunning;
 
+        //! Cursor of the last received file changes.
+        quint64 changeCursor;
+        //! Wait for file changes is running.
+        bool isWaitingForChanges;
+        //! Remote files have changed while previous sync was still running.
+        bool isRemoteRefreshPending;
+        //! Server accepts batch requests.
+        bool isBatchSupported;
+
         struct
         {
             QMutex mutex;
@@ -61,6 +72,10 @@ class RFileManager : public QObject
 
     public:
 
+        //! While the change feed works, remote files are still listed this many times less often.
+        //! Listing catches changes the feed does not report (e.g. made directly in the backend).
+        static constexpr uint changeFeedRefreshFactor = 10;
+
         //! Constructor.
         explicit RFileManager(const RFileManagerSettings &fileManagerSettings, RCloudClient *cloudClient, QObject *parent = nullptr);
 
@@ -93,6 +108,15 @@ class RFileManager : public QObject
         //! Compare files in local and remote file lists.
         void compareFileLists();
 
+        //! Request initial version and tags of uploaded file.
+        void requestNewFileMetadata(const QUuid &fileId);
+
+        //! Request initial version and tags of uploaded file without batch.
+        void requestNewFileMetadataSeparately(const QUuid &fileId);
+
+        //! Wait for next changes of remote files.
+        void requestFileChanges();
+
         //! Return incrementeded version.
         static RVersion incrementVersion(const RVersion &in);
 
@@ -125,6 +149,18 @@ class RFileManager : public QObject
         //! File tags has been updated.
         void onFileTagsUpdated(RFileInfo fileInfo);
 
+        //! Batch of cloud actions has finished.
+        void onBatchFinished(QList<RCloudAction> results);
+
+        //! Batch of cloud actions has failed as a whole.
+        void onBatchFailed(RError::Type errorType, const QString &errorMessage, const QString &message, QList<RCloudAction> actions);
+
+        //! Changes of remote files are available.
+        void onFileChangesAvailable(RFileChangeSet fileChangeSet);
+
+        //! Wait for changes of remote files has failed.
+        void onFileChangesFailed(RError::Type errorType, const QString &errorMessage);
+
         //! Cloud action has finished.
         void onCloudActionFinished();
 
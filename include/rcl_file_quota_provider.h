@@ -0,0 +1,34 @@
+#ifndef RCL_FILE_QUOTA_PROVIDER_H
+#define RCL_FILE_QUOTA_PROVIDER_H
+
+#include <QObject>
+#include <QUuid>
+
+#include "rcl_file_quota.h"
+
+class RFileQuotaProvider : public QObject
+{
+
+    Q_OBJECT
+
+    public:
+
+        //! Constructor.
+        explicit RFileQuotaProvider(QObject *parent = nullptr) : QObject{parent} { }
+
+        //! Find file quota and current usage of given user, return false if user is not known.
+        //! Called from server threads before request body is received, so it should not block.
+        virtual bool findFileQuota(const QString &user, RFileQuota &fileQuota, RFileQuota &fileUsage) = 0;
+
+        //! Find size of given file in bytes, return -1 if it is not known.
+        //! Replaced file is counted out of the store usage, otherwise only the file size limit is checked.
+        //! Called from server threads before request body is received, so it should not block.
+        virtual qint64 findFileSize(const QUuid &fileId)
+        {
+            Q_UNUSED(fileId);
+            return -1;
+        }
+
+};
+
+#endif // RCL_FILE_QUOTA_PROVIDER_H
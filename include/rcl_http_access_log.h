@@ -0,0 +1,184 @@
+#ifndef RCL_HTTP_ACCESS_LOG_H
+#define RCL_HTTP_ACCESS_LOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QStringView>
+#include <QThread>
+#include <QUuid>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+#include <rbl_error.h>
+
+//! Asynchronous access log of the HTTP server.
+//! Server threads append fixed size records into a bounded lock-free ring buffer,
+//! records are formatted and written by a background writer thread.
+class RHttpAccessLog
+{
+
+    public:
+
+        enum Format
+        {
+            //! Human readable line of the former request log, completed with response details.
+            Text = 0,
+            //! Compact key=value line.
+            Compact
+        };
+
+        //! Fixed size access log record (no heap allocations).
+        struct Record
+        {
+            //! Time the request was finished (milliseconds since epoch).
+            qint64 timestamp = 0;
+            //! Time from receiving request to sending response in microseconds.
+            qint64 duration = 0;
+            //! Request body size.
+            qint64 bytesIn = 0;
+            //! Response body size.
+            qint64 bytesOut = 0;
+            //! Remote address (IPv4 addresses are IPv4-mapped).
+            Q_IPV6ADDR remoteAddress = {};
+            //! Remote port.
+            quint16 remotePort = 0;
+            //! Error type of the response.
+            RError::Type errorType = RError::None;
+            //! Resource id.
+            QUuid resourceId;
+            //! Service name.
+            char service[24] = {};
+            //! Action.
+            char action[32] = {};
+            //! User name.
+            char user[64] = {};
+            //! Resource name.
+            char resourceName[128] = {};
+        };
+
+    protected:
+
+        //! Ring buffer cell.
+        struct Cell
+        {
+            //! Sequence number telling whether the cell is free or holds a record.
+            std::atomic<quint64> sequence;
+            //! Record.
+            Record record;
+        };
+
+        //! Output format.
+        Format format;
+        //! Only every n-th successful request is logged (failed requests are always logged).
+        quint32 sampleRate;
+        //! Output file name (empty = logger).
+        QString fileName;
+        //! Output file.
+        QFile file;
+        //! Ring buffer cells.
+        std::unique_ptr<Cell[]> cells;
+        //! Ring buffer index mask (capacity - 1).
+        quint64 mask;
+        //! Position of the next appended record.
+        alignas(64) std::atomic<quint64> enqueuePosition;
+        //! Position of the next written record (writer side only).
+        alignas(64) quint64 dequeuePosition;
+        //! Serializes writers (background thread and flush()).
+        QMutex writeMutex;
+        //! Sampling counter.
+        std::atomic<quint64> sampleCounter;
+        //! Number of appended records.
+        std::atomic<quint64> nAppended;
+        //! Number of written records.
+        std::atomic<quint64> nWritten;
+        //! Number of records dropped because the ring buffer was full.
+        std::atomic<quint64> nDropped;
+        //! Number of records skipped by sampling.
+        std::atomic<quint64> nSampledOut;
+        //! Writer thread (nullptr if not running).
+        QThread *pWriterThread;
+        //! Writer thread should stop.
+        std::atomic<bool> stopRequested;
+        //! Interval at which writer thread drains the ring buffer.
+        quint32 flushIntervalMs;
+        //! Mutex for writer thread wake up.
+        QMutex waitMutex;
+        //! Wakes up writer thread.
+        QWaitCondition waitCondition;
+
+    public:
+
+        //! Constructor (capacity is rounded up to power of two).
+        RHttpAccessLog(qsizetype capacity, quint32 sampleRate, Format format, const QString &fileName, quint32 flushIntervalMs = 100);
+
+        //! Destructor (writes remaining records).
+        ~RHttpAccessLog();
+
+        RHttpAccessLog(const RHttpAccessLog &) = delete;
+        RHttpAccessLog &operator=(const RHttpAccessLog &) = delete;
+
+        //! Start background writer thread.
+        void start();
+
+        //! Stop background writer thread and write remaining records.
+        void stop();
+
+        //! Append record, return false if it was sampled out or dropped. Lock-free, callable from any thread.
+        bool append(const Record &record);
+
+        //! Format and write all queued records, return number of written records.
+        qsizetype flush();
+
+        //! Return ring buffer capacity.
+        qsizetype getCapacity() const;
+
+        //! Return number of appended records.
+        quint64 getAppendedCount() const;
+
+        //! Return number of written records.
+        quint64 getWrittenCount() const;
+
+        //! Return number of records dropped because the ring buffer was full.
+        quint64 getDroppedCount() const;
+
+        //! Return number of records skipped by sampling.
+        quint64 getSampledOutCount() const;
+
+        //! Export metrics in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Export metrics as JSON.
+        QJsonObject toJson() const;
+
+        //! Format record as one line (including new line).
+        static QByteArray formatRecord(const Record &record, Format format);
+
+        //! Copy text into fixed size record field as UTF-8 (truncated on character boundary).
+        static void setText(char *target, qsizetype size, QStringView source);
+
+        //! Set remote address of the record.
+        static void setRemoteAddress(Record &record, const QHostAddress &address, quint16 port);
+
+        //! Return format for given name.
+        static Format formatFromString(const QString &formatName, bool *pOk = nullptr);
+
+        //! Return name of given format.
+        static QString formatToString(Format format);
+
+    protected:
+
+        //! Take next record from the ring buffer (writer side only).
+        bool take(Record &record);
+
+        //! Write formatted lines.
+        void write(const QByteArray &lines);
+
+};
+
+#endif // RCL_HTTP_ACCESS_LOG_H
@@ -0,0 +1,25 @@
+#ifndef RCL_HTTP_ACTION_HANDLER_H
+#define RCL_HTTP_ACTION_HANDLER_H
+
+#include <QObject>
+
+#include "rcl_http_message.h"
+
+class RHttpActionHandler : public QObject
+{
+
+    Q_OBJECT
+
+    public:
+
+        //! Constructor.
+        explicit RHttpActionHandler(QObject *parent = nullptr) : QObject{parent} { }
+
+        //! Process request and return reply message.
+        //! Called from worker threads, requests with the same shard key are processed in order of arrival.
+        //! Throws RError on failure.
+        virtual RHttpMessage processRequest(const RHttpMessage &requestMessage) = 0;
+
+};
+
+#endif // RCL_HTTP_ACTION_HANDLER_H
@@ -0,0 +1,133 @@
+#ifndef RCL_HTTP_ADMISSION_GATE_H
+#define RCL_HTTP_ADMISSION_GATE_H
+
+#include <QByteArray>
+#include <QHttpHeaders>
+#include <QHttpServerResponse>
+#include <QObject>
+#include <QSslSocket>
+#include <QTcpServer>
+#include <QUrl>
+
+#include <functional>
+
+//! Early admission of requests on a server connection.
+//! Request heads are inspected as soon as they arrive, before the HTTP server reads the body.
+//! Rejected request is answered with final status and the connection is closed, so that its
+//! body is neither received (clients sending "Expect: 100-continue" wait for the answer)
+//! nor buffered. Anything the gate cannot follow (chunked bodies, malformed heads) is passed
+//! through to the HTTP server unchecked.
+class RHttpAdmissionGate : public QObject
+{
+
+    Q_OBJECT
+
+    public:
+
+        enum State
+        {
+            //! Waiting for request head.
+            ReadingHead = 0,
+            //! Skipping body of admitted request.
+            SkippingBody,
+            //! Connection is no longer inspected.
+            PassThrough,
+            //! Request was rejected and connection is being closed.
+            Rejected
+        };
+
+        //! Request line and headers.
+        struct RequestHead
+        {
+            //! Request method.
+            QByteArray method;
+            //! Request target (path and query).
+            QUrl url;
+            //! Request headers.
+            QHttpHeaders headers;
+            //! Content-Length (-1 if not set).
+            qint64 contentLength = -1;
+            //! Body is chunked.
+            bool chunked = false;
+            //! Client waits for "100 Continue" before sending body.
+            bool expectContinue = false;
+        };
+
+        //! Decision on request head.
+        struct Verdict
+        {
+            //! Request is admitted.
+            bool admitted = true;
+            //! Status code of rejected request.
+            QHttpServerResponse::StatusCode statusCode = QHttpServerResponse::StatusCode::Ok;
+            //! Headers of rejected request response.
+            QHttpHeaders headers;
+
+            //! Return verdict rejecting request with given status code.
+            static Verdict reject(QHttpServerResponse::StatusCode statusCode, const QHttpHeaders &headers = QHttpHeaders());
+        };
+
+        //! Function deciding on request head.
+        typedef std::function<Verdict(const RequestHead &requestHead)> Evaluator;
+
+        //! Maximum size of request head which is inspected.
+        static const qsizetype maxHeadSize;
+
+    protected:
+
+        //! Evaluator.
+        Evaluator evaluator;
+        //! Value of Server response header.
+        QByteArray serverName;
+        //! State.
+        State state;
+        //! Incomplete request head.
+        QByteArray headBuffer;
+        //! Remaining body bytes of admitted request.
+        qint64 nBodyBytes;
+        //! Inspected socket.
+        QSslSocket *pSocket;
+        //! Connection waiting for the HTTP server to take the socket.
+        QMetaObject::Connection pendingConnection;
+        //! HTTP server reads after the gate.
+        bool armed;
+        //! Number of unread socket bytes which were already inspected.
+        qint64 nInspectedBytes;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpAdmissionGate(const Evaluator &evaluator, const QByteArray &serverName, QObject *parent = nullptr);
+
+        //! Inspect requests on given socket (gate becomes child of the socket).
+        //! Must be called before the socket is handed over to the HTTP server, for example
+        //! when its encryption handshake starts.
+        void attach(QSslSocket *pSocket, QTcpServer *pServer);
+
+        //! Inspect next bytes of the request stream.
+        //! Return false if a request was rejected (verdict is set).
+        bool inspect(const QByteArray &data, Verdict &verdict);
+
+        //! Return state.
+        State getState() const;
+
+        //! Parse request head (request line and headers terminated by an empty line).
+        static bool parseHead(const QByteArray &data, RequestHead &requestHead);
+
+        //! Build raw response of rejected request.
+        static QByteArray buildResponse(const Verdict &verdict, const QByteArray &serverName);
+
+    private slots:
+
+        //! Socket has data, HTTP server has not read it yet.
+        void onReadyRead();
+
+        //! HTTP server has read its part of the data.
+        void onReadFinished();
+
+        //! HTTP server has taken pending connections.
+        void onPendingConnectionAvailable();
+
+};
+
+#endif // RCL_HTTP_ADMISSION_GATE_H
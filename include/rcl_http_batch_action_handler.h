@@ -0,0 +1,39 @@
+#ifndef RCL_HTTP_BATCH_ACTION_HANDLER_H
+#define RCL_HTTP_BATCH_ACTION_HANDLER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "rcl_http_action_handler.h"
+#include "rcl_http_request_dispatcher.h"
+
+//! Handler of batch requests whose items all have in-process action handlers.
+//! Items are processed one after another on the worker of the batch request, each with
+//! the handler registered for its action, and every item gets its own reply and error type.
+class RHttpBatchActionHandler : public RHttpActionHandler
+{
+
+    Q_OBJECT
+
+    protected:
+
+        //! Dispatcher holding item handlers.
+        const RHttpRequestDispatcher *pDispatcher;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpBatchActionHandler(const RHttpRequestDispatcher *pDispatcher, QObject *parent = nullptr);
+
+        //! Process batch request and return batch reply message.
+        RHttpMessage processRequest(const RHttpMessage &requestMessage) override;
+
+        //! Validate batch request body, on failure errorMessage describes the problem.
+        static bool validate(const QByteArray &body, qsizetype maxItems, QString &errorMessage);
+
+        //! Return true if every item of given batch has an in-process handler.
+        static bool isHandledInProcess(const RHttpRequestDispatcher &dispatcher, const QByteArray &body);
+
+};
+
+#endif // RCL_HTTP_BATCH_ACTION_HANDLER_H
@@ -0,0 +1,48 @@
+#ifndef RCL_HTTP_BODY_DEVICE_H
+#define RCL_HTTP_BODY_DEVICE_H
+
+#include <QIODevice>
+#include <QSharedPointer>
+
+//! Read-only view of a shared body device (or its byte range).
+//! Keeps the source device alive and seeks it before every read, so several
+//! views may read the same source (from one thread) independently.
+class RHttpBodyDevice : public QIODevice
+{
+
+    Q_OBJECT
+
+    protected:
+
+        //! Source device.
+        QSharedPointer<QIODevice> sourceDevice;
+        //! Offset of the view in the source device.
+        qint64 offset;
+        //! Length of the view (-1 means up to the end of the source device).
+        qint64 length;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpBodyDevice(const QSharedPointer<QIODevice> &sourceDevice, QObject *parent = nullptr);
+
+        //! Constructor (byte range of a random-access source device).
+        explicit RHttpBodyDevice(const QSharedPointer<QIODevice> &sourceDevice, qint64 offset, qint64 length, QObject *parent = nullptr);
+
+        //! Return true if source device is sequential.
+        bool isSequential() const override;
+
+        //! Return size of the body.
+        qint64 size() const override;
+
+    protected:
+
+        //! Read data from source device.
+        qint64 readData(char *data, qint64 maxSize) override;
+
+        //! Writing is not supported.
+        qint64 writeData(const char *data, qint64 maxSize) override;
+
+};
+
+#endif // RCL_HTTP_BODY_DEVICE_H
@@ -0,0 +1,130 @@
+#ifndef RCL_HTTP_CHANGE_FEED_H
+#define RCL_HTTP_CHANGE_FEED_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+#include "rcl_file_change_set.h"
+
+//! Per-user feed of file changes for long-polling sync clients.
+//! Each change gets a sequence number, client waits for changes after the cursor of its last
+//! response instead of listing all files periodically. Only the most recent changes of each
+//! user are kept, client whose cursor is older than that (or comes from a previous server run)
+//! is told to list files again.
+class RHttpChangeFeed
+{
+
+    public:
+
+        static constexpr qsizetype defaultMaxChangesPerUser = 1000;
+
+    protected:
+
+        struct Change
+        {
+            //! Sequence number.
+            quint64 sequence;
+            //! Change.
+            RFileChange change;
+        };
+
+        struct Waiter
+        {
+            //! Waiter ID.
+            quint64 id;
+            //! Promise fulfilled by the next change.
+            std::shared_ptr<QPromise<RFileChangeSet>> pPromise;
+        };
+
+        struct UserFeed
+        {
+            //! Recent changes.
+            QQueue<Change> changes;
+            //! Sequence number of the last forgotten change.
+            quint64 forgottenSequence = 0;
+            //! Waiting clients.
+            QList<Waiter> waiters;
+        };
+
+        //! Maximum number of changes kept per user.
+        qsizetype maxChangesPerUser;
+        //! Mutex.
+        mutable QMutex mutex;
+        //! First sequence number of this run.
+        quint64 firstSequence;
+        //! Last sequence number.
+        quint64 sequence;
+        //! Sequence number of the last reset, clients with an older cursor have to list files.
+        quint64 resetSequence;
+        //! Last waiter ID.
+        quint64 waiterId;
+        //! Feeds of users.
+        QHash<QString,UserFeed> feeds;
+        //! Number of published changes.
+        std::atomic<quint64> nPublished;
+        //! Number of waits answered with changes.
+        std::atomic<quint64> nDelivered;
+        //! Number of waits answered without changes.
+        std::atomic<quint64> nIdle;
+        //! Number of waits answered with reset.
+        std::atomic<quint64> nResets;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpChangeFeed(qsizetype maxChangesPerUser = defaultMaxChangesPerUser);
+
+        //! Destructor.
+        ~RHttpChangeFeed();
+
+        RHttpChangeFeed(const RHttpChangeFeed &) = delete;
+        RHttpChangeFeed &operator=(const RHttpChangeFeed &) = delete;
+
+        //! Publish change to given user and wake up its waiting clients.
+        void publish(const QString &user, const RFileChange &change);
+
+        //! Tell all clients to list files again and wake up all waiting clients.
+        void publishReset();
+
+        //! Publish changes described by successful response to file action of given user.
+        //! Change is published to the user and to the owner of the file. Readers of files shared
+        //! with groups or others are not known here, such changes are published as a reset.
+        void publishResponse(const QString &actionKey, const QString &user, const QByteArray &responseBody);
+
+        //! Return changes after given cursor, or wait for them if there are none yet.
+        //! Returns ID of the waiter to be passed to stopWaiting(), or 0 if the future is already finished.
+        quint64 wait(const QString &user, quint64 cursor, QFuture<RFileChangeSet> &future);
+
+        //! Stop waiting and answer waiter with no changes (e.g. once the wait time is over).
+        void stopWaiting(const QString &user, quint64 waiterId);
+
+        //! Return cursor of the last change.
+        quint64 getCursor() const;
+
+        //! Return number of waiting clients.
+        qsizetype getWaitingCount() const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Return changes described by successful response to given action.
+        //! Pairs are file owner and change. If isShared is given, it is set to true when a changed
+        //! file may be seen by users other than its owner (or when the access rights have changed).
+        static QList<std::pair<QString,RFileChange>> findChanges(const QString &actionKey, const QByteArray &responseBody, bool *isShared = nullptr);
+
+};
+
+#endif // RCL_HTTP_CHANGE_FEED_H
@@ -2,13 +2,17 @@
 #define RCL_HTTP_CLIENT_H
 
 #include <QAuthenticator>
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QMutex>
 #include <QObject>
 #include <QSslCertificate>
 
+#include <memory>
+
 #include "rcl_http_client_settings.h"
+#include "rcl_http_client_validator_cache.h"
 #include "rcl_http_message.h"
 
 class RHttpClient : public QObject
@@ -51,6 +55,11 @@ class RHttpClient : public QObject
 
         QByteArray responseBytes;
 
+        //! Recent listings shared with other clients (null if requests are not conditional).
+        std::shared_ptr<RHttpClientValidatorCache> pValidatorCache;
+        //! Url of pending conditional request (empty if request is not conditional).
+        QString conditionalUrl;
+
         //! Mutex locking pending request.
         QMutex requestMutex;
 
@@ -59,6 +68,9 @@ class RHttpClient : public QObject
         //! Constructor
         explicit RHttpClient(RHttpClient::Type type, const RHttpClientSettings &httpClientSettings, QObject *parent = nullptr);
 
+        //! Set cache of listings used for conditional requests.
+        void setValidatorCache(const std::shared_ptr<RHttpClientValidatorCache> &pValidatorCache);
+
         //! Send message.
         void sendRequest(const RHttpMessage &httpMessageRequest, RHttpMessage &httpMessageReply);
 
@@ -0,0 +1,59 @@
+#ifndef RCL_HTTP_CLIENT_VALIDATOR_CACHE_H
+#define RCL_HTTP_CLIENT_VALIDATOR_CACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+//! Listings remembered by the client for conditional requests.
+//! Cache is shared by all HTTP clients of a cloud client, each of which serves a single request.
+class RHttpClientValidatorCache
+{
+
+    public:
+
+        //! Maximum number of remembered listings.
+        static constexpr qsizetype defaultMaxEntries = 64;
+
+    protected:
+
+        //! Listing remembered for conditional requests.
+        struct Entry
+        {
+            //! Entity tag.
+            QByteArray entityTag;
+            //! Response body.
+            QByteArray body;
+        };
+
+        //! Maximum number of remembered listings.
+        qsizetype maxEntries;
+        //! Cache mutex.
+        mutable QMutex mutex;
+        //! Recent listings by request url.
+        QHash<QString,Entry> entries;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpClientValidatorCache(qsizetype maxEntries = defaultMaxEntries);
+
+        //! Return entity tag of listing remembered for given url (empty if none).
+        QByteArray findEntityTag(const QString &url) const;
+
+        //! Find body of listing remembered for given url.
+        bool findBody(const QString &url, QByteArray &body) const;
+
+        //! Remember listing for given url.
+        void insert(const QString &url, const QByteArray &entityTag, const QByteArray &body);
+
+        //! Forget listing for given url.
+        void remove(const QString &url);
+
+        //! Return number of remembered listings.
+        qsizetype size() const;
+
+};
+
+#endif // RCL_HTTP_CLIENT_VALIDATOR_CACHE_H
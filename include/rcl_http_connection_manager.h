@@ -0,0 +1,195 @@
+#ifndef RCL_HTTP_CONNECTION_MANAGER_H
+#define RCL_HTTP_CONNECTION_MANAGER_H
+
+#include <QAbstractSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <QUuid>
+
+#include "rcl_http_connection_metrics.h"
+#include "rcl_http_timing_wheel.h"
+
+//! Deadlines and limits of client connections of one HTTP server instance.
+//! Each connection is in one phase at a time and the phase decides its deadline: new connection
+//! must send a request within the idle timeout, kept-alive connection within the keep-alive timeout,
+//! request head must arrive within the header read timeout and request body must keep arriving,
+//! each chunk extends the body read deadline. Connections whose request is processed have no deadline,
+//! handler timeouts apply to them. Deadlines are kept in a timing wheel and moved lazily, so that
+//! traffic on a connection does not reschedule anything.
+//! When the connection limit is reached, least recently used idle connection is closed to make
+//! room; if no connection is idle, accepting is paused until one is gone.
+//! The manager lives in the server thread and is not thread safe.
+class RHttpConnectionManager : public QObject
+{
+
+    Q_OBJECT
+
+    public:
+
+        enum Phase
+        {
+            //! Waiting for request.
+            Idle = 0,
+            //! Receiving request head.
+            ReadingHead,
+            //! Receiving request body.
+            ReadingBody,
+            //! Request is being processed or its response sent.
+            Processing
+        };
+
+        //! Resolution of deadlines in milliseconds.
+        static constexpr qint64 resolutionMs = 250;
+
+    protected:
+
+        struct Connection
+        {
+            //! Socket.
+            QAbstractSocket *pSocket;
+            //! Phase.
+            Phase phase;
+            //! Deadline in milliseconds (0 = none).
+            qint64 deadline;
+            //! Earliest deadline waiting in the timing wheel (0 = none).
+            qint64 scheduledDeadline;
+            //! Number of requests served.
+            quint64 nRequests;
+            //! Response body is being streamed.
+            bool streaming;
+            //! Position in idle queue (0 = not idle).
+            quint64 idleSequence;
+            //! Last bytes of incomplete request head.
+            QByteArray headTail;
+            //! Peer key.
+            QString peerKey;
+        };
+
+        //! Idle timeout in milliseconds (0 = none).
+        qint64 idleTimeoutMs;
+        //! Keep-alive timeout in milliseconds (0 = none).
+        qint64 keepAliveTimeoutMs;
+        //! Header read timeout in milliseconds (0 = none).
+        qint64 headerReadTimeoutMs;
+        //! Body read timeout in milliseconds (0 = none).
+        qint64 bodyReadTimeoutMs;
+        //! Maximum number of connections (0 = unlimited).
+        qsizetype maxConnections;
+        //! Value of Server response header.
+        QByteArray serverName;
+        //! Shared metrics (may be null).
+        RHttpConnectionMetrics *pMetrics;
+        //! Connections.
+        QHash<QUuid,Connection> connections;
+        //! Connection IDs by socket.
+        QHash<QAbstractSocket*,QUuid> socketIds;
+        //! Connection IDs by peer address and port.
+        QHash<QString,QUuid> peerIds;
+        //! Idle connections, least recently used first.
+        QMap<quint64,QUuid> idleQueue;
+        //! Last idle queue position.
+        quint64 idleSequence;
+        //! Connection deadlines.
+        RHttpTimingWheel timingWheel;
+        //! Expiry timer.
+        QTimer *pExpiryTimer;
+        //! Accepting is paused.
+        bool paused;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpConnectionManager(qint64 idleTimeoutMs,
+                                        qint64 keepAliveTimeoutMs,
+                                        qint64 headerReadTimeoutMs,
+                                        qint64 bodyReadTimeoutMs,
+                                        qsizetype maxConnections,
+                                        const QByteArray &serverName,
+                                        RHttpConnectionMetrics *pMetrics,
+                                        QObject *parent = nullptr);
+
+        //! Track new connection.
+        //! Must be called before the socket is handed over to the HTTP server, for example
+        //! when its encryption handshake starts, so that socket data is seen first.
+        void addConnection(QAbstractSocket *pSocket, qint64 now);
+
+        //! Forget connection.
+        void removeConnection(QAbstractSocket *pSocket);
+
+        //! Socket received data which the HTTP server has not read yet.
+        void receiveData(QAbstractSocket *pSocket, const QByteArray &unreadData, qint64 now);
+
+        //! HTTP server started processing request from given peer.
+        void startRequest(const QHostAddress &address, quint16 port);
+
+        //! Response to the request of given peer is streamed from given device.
+        //! Connection stays busy, even while its write buffer is drained, until the responder
+        //! closes or deletes the device.
+        void streamResponse(const QHostAddress &address, quint16 port, QIODevice *pBodyDevice);
+
+        //! Socket has written data.
+        void sendData(QAbstractSocket *pSocket, qint64 now);
+
+        //! Close connections whose deadline has passed and return their sockets.
+        QList<QAbstractSocket*> expire(qint64 now);
+
+        //! Return phase of given connection.
+        Phase getPhase(QAbstractSocket *pSocket) const;
+
+        //! Return deadline of given connection (0 = none).
+        qint64 getDeadline(QAbstractSocket *pSocket) const;
+
+        //! Return true if given connection is tracked.
+        bool contains(QAbstractSocket *pSocket) const;
+
+        //! Return number of connections.
+        qsizetype size() const;
+
+        //! Return number of idle connections.
+        qsizetype getIdleCount() const;
+
+        //! Return true if accepting is paused.
+        bool isPaused() const;
+
+        //! Build peer key.
+        static QString buildPeerKey(const QHostAddress &address, quint16 port);
+
+    protected:
+
+        //! Set connection deadline, timing wheel is updated only if the deadline moves earlier.
+        void setDeadline(const QUuid &id, Connection &connection, qint64 deadline);
+
+        //! Mark connection as idle.
+        void enterIdle(const QUuid &id, Connection &connection, qint64 now);
+
+        //! Mark connection as no longer idle.
+        void leaveIdle(Connection &connection);
+
+        //! Mark connection as idle if its response has been sent completely.
+        void finishResponse(const QUuid &id, Connection &connection, qint64 now);
+
+        //! Close connection for given reason.
+        void closeConnection(const QUuid &id, RHttpConnectionMetrics::CloseReason reason);
+
+        //! Forget connection with given ID.
+        void forgetConnection(const QUuid &id);
+
+        //! Pause or resume accepting depending on number of connections.
+        void updatePaused();
+
+    signals:
+
+        //! Connection limit was reached and no connection is idle, stop accepting.
+        void acceptPaused();
+
+        //! Connection limit is no longer reached, accept again.
+        void acceptResumed();
+
+};
+
+#endif // RCL_HTTP_CONNECTION_MANAGER_H
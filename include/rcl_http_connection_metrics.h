@@ -0,0 +1,85 @@
+#ifndef RCL_HTTP_CONNECTION_METRICS_H
+#define RCL_HTTP_CONNECTION_METRICS_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <atomic>
+
+//! Connection metrics of the HTTP server.
+class RHttpConnectionMetrics
+{
+
+    public:
+
+        enum CloseReason
+        {
+            //! No request arrived on new connection in time.
+            IdleTimeout = 0,
+            //! No further request arrived on kept-alive connection in time.
+            KeepAliveTimeout,
+            //! Request head was not received in time.
+            HeaderTimeout,
+            //! Request body stopped arriving.
+            BodyTimeout,
+            //! Idle connection was closed to make room for new one.
+            Evicted,
+            nCloseReasons
+        };
+
+    protected:
+
+        //! Number of open connections.
+        std::atomic<qint64> nOpen;
+        //! Number of accepted connections.
+        std::atomic<quint64> nAccepted;
+        //! Number of connections closed by the server by reason.
+        std::atomic<quint64> nClosed[nCloseReasons];
+        //! Number of times accepting was paused because the connection limit was reached.
+        std::atomic<quint64> nAcceptPauses;
+
+    public:
+
+        //! Constructor.
+        RHttpConnectionMetrics();
+
+        RHttpConnectionMetrics(const RHttpConnectionMetrics &) = delete;
+        RHttpConnectionMetrics &operator=(const RHttpConnectionMetrics &) = delete;
+
+        //! Record accepted connection.
+        void recordOpened();
+
+        //! Record connection which is gone, regardless of who closed it.
+        void recordRemoved();
+
+        //! Record connection closed by the server for given reason.
+        void recordClosed(CloseReason reason);
+
+        //! Record pause of accepting new connections.
+        void recordAcceptPause();
+
+        //! Return number of open connections.
+        qint64 getOpenCount() const;
+
+        //! Return number of accepted connections.
+        quint64 getAcceptedCount() const;
+
+        //! Return number of connections closed by the server for given reason.
+        quint64 getClosedCount(CloseReason reason) const;
+
+        //! Return number of times accepting was paused.
+        quint64 getAcceptPauseCount() const;
+
+        //! Export metrics in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Export metrics as JSON.
+        QJsonObject toJson() const;
+
+        //! Return name of given close reason.
+        static QString closeReasonToString(CloseReason reason);
+
+};
+
+#endif // RCL_HTTP_CONNECTION_METRICS_H
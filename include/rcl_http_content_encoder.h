@@ -0,0 +1,52 @@
+#ifndef RCL_HTTP_CONTENT_ENCODER_H
+#define RCL_HTTP_CONTENT_ENCODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include "rcl_http_message.h"
+
+class RHttpContentEncoder
+{
+
+    public:
+
+        enum Encoding
+        {
+            Identity = 0,
+            Gzip,
+            Zstd
+        };
+
+        //! Default gzip compression level.
+        static constexpr int defaultGzipLevel = 6;
+        //! Default zstd compression level.
+        static constexpr int defaultZstdLevel = 3;
+
+    public:
+
+        //! Return true if given encoding is available in this build.
+        static bool isAvailable(Encoding encoding);
+
+        //! Return Content-Encoding token for given encoding.
+        static QByteArray toName(Encoding encoding);
+
+        //! Select best available encoding accepted by the client (Accept-Encoding header value).
+        static Encoding negotiate(QByteArrayView acceptEncoding);
+
+        //! Compress data with given encoding.
+        //! Returns empty array on failure.
+        static QByteArray encode(const QByteArray &data, Encoding encoding);
+
+        //! Decompress data with given encoding.
+        //! Returns empty array on failure.
+        static QByteArray decode(const QByteArray &data, Encoding encoding);
+
+        //! Compress in-memory body of the response message if it is worth it.
+        //! Bodies smaller than minSize, device bodies and already encoded bodies are left untouched.
+        //! Return true if message was encoded.
+        static bool encodeMessage(RHttpMessage &httpMessage, Encoding encoding, qint64 minSize);
+
+};
+
+#endif // RCL_HTTP_CONTENT_ENCODER_H
@@ -0,0 +1,106 @@
+#ifndef RCL_HTTP_DISPATCH_LANE_H
+#define RCL_HTTP_DISPATCH_LANE_H
+
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+
+#include <memory>
+
+//! Dispatch lane of the HTTP server.
+//! Lane bounds the number of requests being processed and the number of requests waiting for a slot,
+//! and has its own thread pool for blocking work (compression), so that bulk transfers
+//! cannot delay cheap metadata requests.
+class RHttpDispatchLane
+{
+
+    public:
+
+        enum Type
+        {
+            //! Interactive metadata requests.
+            Interactive = 0,
+            //! Bulk transfers.
+            Bulk,
+            //! Administration and processes.
+            Admin,
+            nTypes
+        };
+
+        enum Admission
+        {
+            //! Slot was granted.
+            Granted = 0,
+            //! Request waits in queue, slot future is fulfilled once a slot is granted.
+            Queued,
+            //! Queue is full.
+            Rejected
+        };
+
+    protected:
+
+        //! Lane type.
+        Type type;
+        //! Maximum number of requests being processed.
+        qsizetype maxConcurrency;
+        //! Maximum number of waiting requests.
+        qsizetype maxQueueSize;
+        //! Mutex.
+        mutable QMutex mutex;
+        //! Number of requests being processed.
+        qsizetype nActive;
+        //! Waiting requests.
+        QQueue<std::shared_ptr<QPromise<void>>> waitQueue;
+        //! Thread pool for blocking work.
+        QThreadPool threadPool;
+
+    public:
+
+        //! Constructor.
+        RHttpDispatchLane(Type type, qsizetype maxConcurrency, qsizetype maxQueueSize);
+
+        //! Destructor.
+        ~RHttpDispatchLane();
+
+        RHttpDispatchLane(const RHttpDispatchLane &) = delete;
+        RHttpDispatchLane &operator=(const RHttpDispatchLane &) = delete;
+
+        //! Return lane type.
+        Type getType() const;
+
+        //! Acquire slot.
+        //! If request is queued, slot future is fulfilled once the slot is granted.
+        //! Every granted slot must be released with release().
+        Admission acquire(QFuture<void> &slotFuture);
+
+        //! Release slot and grant it to the first waiting request.
+        void release();
+
+        //! Return maximum number of requests being processed.
+        qsizetype getMaxConcurrency() const;
+
+        //! Return number of requests being processed.
+        qsizetype getActiveCount() const;
+
+        //! Return number of waiting requests.
+        qsizetype getQueuedCount() const;
+
+        //! Return thread pool for blocking work of the lane.
+        QThreadPool *getThreadPool();
+
+        //! Return lane for given action.
+        static Type findTypeForAction(const QString &actionKey);
+
+        //! Return name of given lane type.
+        static QString typeToString(Type type);
+
+        //! Export gauges of given lanes in Prometheus text exposition format.
+        static QByteArray toPrometheusText(const QList<RHttpDispatchLane*> &lanes);
+
+};
+
+#endif // RCL_HTTP_DISPATCH_LANE_H
@@ -0,0 +1,101 @@
+#ifndef RCL_HTTP_ENTITY_TAG_CACHE_H
+#define RCL_HTTP_ENTITY_TAG_CACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QUuid>
+
+#include <atomic>
+
+//! Entity tags of recent list and download responses.
+//! Conditional request (If-None-Match) whose validator matches a cached entity tag is answered
+//! with "304 Not Modified" without asking the backend. Cached tags live for a short TTL and all
+//! of them are forgotten whenever a mutating request succeeds, changes made elsewhere are
+//! therefore noticed within the TTL at the latest.
+class RHttpEntityTagCache
+{
+
+    public:
+
+        static constexpr qsizetype defaultMaxEntries = 10000;
+        static constexpr qint64 defaultTtlMs = 30000;
+
+    protected:
+
+        struct Entry
+        {
+            //! Entity tag.
+            QByteArray entityTag;
+            //! Expiry time in milliseconds.
+            qint64 expiryTime;
+        };
+
+        //! Time to live.
+        qint64 ttlMs;
+        //! Cache mutex.
+        mutable QMutex mutex;
+        //! Cached entity tags.
+        QCache<QString,Entry> cache;
+        //! Generation, incremented by each invalidation.
+        std::atomic<quint64> generation;
+        //! Number of requests answered without the backend.
+        std::atomic<quint64> nHits;
+        //! Number of backend responses replaced by "304 Not Modified".
+        std::atomic<quint64> nRevalidated;
+        //! Number of invalidations.
+        std::atomic<quint64> nInvalidations;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpEntityTagCache(qsizetype maxEntries = defaultMaxEntries, qint64 ttlMs = defaultTtlMs);
+
+        RHttpEntityTagCache(const RHttpEntityTagCache &) = delete;
+        RHttpEntityTagCache &operator=(const RHttpEntityTagCache &) = delete;
+
+        //! Return cached entity tag (empty if not cached or expired).
+        QByteArray find(const QString &key, qint64 currentTime);
+
+        //! Cache entity tag of response to request which started in given generation.
+        //! Tag is dropped if the cache was invalidated in the meantime.
+        void insert(const QString &key, const QByteArray &entityTag, quint64 generation, qint64 currentTime);
+
+        //! Forget all entity tags.
+        void invalidate();
+
+        //! Return current generation.
+        quint64 getGeneration() const;
+
+        //! Record request answered without the backend.
+        void recordHit();
+
+        //! Record backend response replaced by "304 Not Modified".
+        void recordRevalidation();
+
+        //! Return number of cached entity tags.
+        qsizetype size() const;
+
+        //! Return number of requests answered without the backend.
+        quint64 getHitCount() const;
+
+        //! Return number of backend responses replaced by "304 Not Modified".
+        quint64 getRevalidatedCount() const;
+
+        //! Return number of invalidations.
+        quint64 getInvalidationCount() const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Build cache key, responses differ per user because of access rights.
+        static QString buildKey(const QString &user, const QString &actionKey, const QString &resourceName, const QUuid &resourceId);
+
+};
+
+#endif // RCL_HTTP_ENTITY_TAG_CACHE_H
@@ -0,0 +1,141 @@
+#ifndef RCL_HTTP_IDEMPOTENCY_STORE_H
+#define RCL_HTTP_IDEMPOTENCY_STORE_H
+
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+#include "rcl_http_message.h"
+
+//! Responses of mutating requests remembered by their idempotency key.
+//! Retried request (same user and key) is answered with the response of the original
+//! request, or waits for it if the original is still being processed, instead of being
+//! executed again. Only successful responses are remembered, failed request may be retried.
+//! Number of keys is bounded, keys are forgotten after their TTL (counted from the first request).
+class RHttpIdempotencyStore
+{
+
+    public:
+
+        static constexpr qsizetype defaultMaxEntries = 10000;
+        static constexpr qint64 defaultTtlMs = 600000;
+        //! Maximum length of accepted idempotency key.
+        static constexpr qsizetype maxKeyLength = 128;
+
+        enum Result
+        {
+            //! Request is new and must be processed (and finished).
+            Started = 0,
+            //! Original request is in progress, future yields its response.
+            Attached,
+            //! Original request has finished, future yields its response.
+            Replayed,
+            //! Key was used for a different request.
+            Conflict
+        };
+
+    protected:
+
+        struct Entry
+        {
+            //! Fingerprint of the original request.
+            QString fingerprint;
+            //! Expiry time in milliseconds.
+            qint64 expiryTime;
+            //! Original request has finished.
+            bool finished;
+            //! Response of the original request.
+            RHttpMessage response;
+            //! Promises of retried requests waiting for the original one.
+            QList<std::shared_ptr<QPromise<RHttpMessage>>> waiting;
+        };
+
+        struct ExpiryItem
+        {
+            //! Entry key.
+            QString key;
+            //! Expiry time of the entry.
+            qint64 expiryTime;
+        };
+
+        //! Maximum number of entries.
+        qsizetype maxEntries;
+        //! Time to live.
+        qint64 ttlMs;
+        //! Store mutex.
+        mutable QMutex mutex;
+        //! Entries.
+        QHash<QString,Entry> entries;
+        //! Entry keys in order of expiry (may contain keys of removed entries).
+        QQueue<ExpiryItem> expiryQueue;
+        //! Number of started requests.
+        std::atomic<quint64> nStarted;
+        //! Number of retries attached to requests in progress.
+        std::atomic<quint64> nAttached;
+        //! Number of retries answered with remembered response.
+        std::atomic<quint64> nReplayed;
+        //! Number of keys reused for a different request.
+        std::atomic<quint64> nConflicts;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpIdempotencyStore(qsizetype maxEntries = defaultMaxEntries, qint64 ttlMs = defaultTtlMs);
+
+        RHttpIdempotencyStore(const RHttpIdempotencyStore &) = delete;
+        RHttpIdempotencyStore &operator=(const RHttpIdempotencyStore &) = delete;
+
+        //! Look up request with given key.
+        //! Unless result is Started or Conflict the future yields the response to send.
+        //! Started request must be followed by finish() or abandon().
+        Result begin(const QString &user, const QString &key, const QString &fingerprint, qint64 currentTime, QFuture<RHttpMessage> &future);
+
+        //! Finish started request, response is passed to waiting retries and remembered if successful.
+        void finish(const QString &user, const QString &key, const RHttpMessage &response);
+
+        //! Forget started request which was not processed (waiting retries are canceled).
+        void abandon(const QString &user, const QString &key);
+
+        //! Return number of entries.
+        qsizetype size() const;
+
+        //! Return number of started requests.
+        quint64 getStartedCount() const;
+
+        //! Return number of retries attached to requests in progress.
+        quint64 getAttachedCount() const;
+
+        //! Return number of retries answered with remembered response.
+        quint64 getReplayedCount() const;
+
+        //! Return number of keys reused for a different request.
+        quint64 getConflictCount() const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Return true if given idempotency key is acceptable.
+        static bool isValidKey(const QString &key);
+
+    private:
+
+        //! Remove expired entries, mutex must be locked.
+        void removeExpired(qint64 currentTime);
+
+        //! Build entry key.
+        static QString buildKey(const QString &user, const QString &key);
+
+};
+
+#endif // RCL_HTTP_IDEMPOTENCY_STORE_H
@@ -0,0 +1,68 @@
+#ifndef RCL_HTTP_LATENCY_HISTOGRAM_H
+#define RCL_HTTP_LATENCY_HISTOGRAM_H
+
+#include <QtGlobal>
+
+#include <atomic>
+
+//! Lock-free log-linear (HDR style) histogram of latencies in microseconds.
+//! Every power of two is split into 16 linear sub-buckets, which bounds the
+//! relative error of reported percentiles to 1/16.
+class RHttpLatencyHistogram
+{
+
+    public:
+
+        //! Number of bits of linear sub-buckets in each power of two.
+        static constexpr int subBucketBits = 4;
+        //! Number of linear sub-buckets in each power of two.
+        static constexpr int subBucketCount = 1 << subBucketBits;
+        //! Largest recorded value (larger values are clamped), about 19 hours.
+        static constexpr qint64 maxValue = (qint64(1) << 36) - 1;
+        //! Number of buckets.
+        static constexpr int nBuckets = subBucketCount + (36 - subBucketBits) * subBucketCount;
+
+    protected:
+
+        //! Bucket counters.
+        std::atomic<quint64> buckets[nBuckets];
+        //! Number of recorded values.
+        std::atomic<quint64> count;
+        //! Sum of recorded values.
+        std::atomic<quint64> sum;
+        //! Largest recorded value.
+        std::atomic<qint64> max;
+
+    public:
+
+        //! Constructor.
+        RHttpLatencyHistogram();
+
+        RHttpLatencyHistogram(const RHttpLatencyHistogram &) = delete;
+        RHttpLatencyHistogram &operator=(const RHttpLatencyHistogram &) = delete;
+
+        //! Record value (negative values are recorded as 0).
+        void record(qint64 valueUs);
+
+        //! Return number of recorded values.
+        quint64 getCount() const;
+
+        //! Return sum of recorded values.
+        quint64 getSum() const;
+
+        //! Return largest recorded value.
+        qint64 getMax() const;
+
+        //! Return value at given quantile (0.0 - 1.0).
+        //! Result is the highest value equivalent to the bucket containing the quantile.
+        qint64 findQuantile(double quantile) const;
+
+        //! Return bucket index of given value.
+        static int findBucket(qint64 valueUs);
+
+        //! Return highest value of given bucket.
+        static qint64 findBucketUpperBound(int bucket);
+
+};
+
+#endif // RCL_HTTP_LATENCY_HISTOGRAM_H
@@ -0,0 +1,100 @@
+#ifndef RCL_HTTP_LOAD_SHEDDER_H
+#define RCL_HTTP_LOAD_SHEDDER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+
+#include "rcl_http_dispatch_lane.h"
+
+//! Load shedder of the HTTP server.
+//! Keeps exponentially weighted moving average of backend service time of each action and lane,
+//! and predicts whether a request which has to wait for a slot can still be answered within its
+//! timeout. Request which cannot is rejected at once instead of holding a handler until it times out.
+//! Requests which get a slot immediately are never shed, so estimates keep being refreshed.
+class RHttpLoadShedder
+{
+
+    public:
+
+        enum Stage
+        {
+            //! Request would have to wait in a lane queue.
+            Admission = 0,
+            //! Request got its slot too late.
+            Dispatch,
+            nStages
+        };
+
+        //! Weight of a new sample in the moving average.
+        static constexpr double smoothingFactor = 0.125;
+
+    protected:
+
+        struct Estimate
+        {
+            //! Average service time in microseconds (0 if there is no sample yet).
+            std::atomic<qint64> serviceTime{0};
+        };
+
+        //! Estimates of each action.
+        QHash<QString,Estimate*> actionEstimates;
+        //! Estimates of each lane (indexed by RHttpDispatchLane::Type).
+        Estimate laneEstimates[RHttpDispatchLane::nTypes];
+        //! Number of shed requests per stage.
+        std::atomic<quint64> nShed[nStages];
+
+    public:
+
+        //! Constructor.
+        explicit RHttpLoadShedder(const QList<QString> &actionKeys);
+
+        //! Destructor.
+        ~RHttpLoadShedder();
+
+        RHttpLoadShedder(const RHttpLoadShedder &) = delete;
+        RHttpLoadShedder &operator=(const RHttpLoadShedder &) = delete;
+
+        //! Record backend service time of finished request in microseconds.
+        void recordServiceTime(const QString &action, RHttpDispatchLane::Type laneType, qint64 serviceTime);
+
+        //! Return average service time of given action in microseconds (0 if unknown).
+        qint64 getServiceTime(const QString &action) const;
+
+        //! Return average service time of given lane in microseconds (0 if unknown).
+        qint64 getLaneServiceTime(RHttpDispatchLane::Type laneType) const;
+
+        //! Decide whether request may join the queue of a saturated lane.
+        //! Time left and retry-after are in microseconds and milliseconds respectively.
+        bool admitQueued(const QString &action, RHttpDispatchLane::Type laneType, qsizetype nQueued, qsizetype concurrency, qint64 timeLeft, qint64 &retryAfterMs);
+
+        //! Decide whether request which has just got a slot after waiting may be dispatched.
+        bool admitDispatch(const QString &action, RHttpDispatchLane::Type laneType, qint64 timeLeft, qint64 &retryAfterMs);
+
+        //! Return number of requests shed at given stage.
+        quint64 getShedCount(Stage stage) const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Return name of given stage.
+        static QString stageToString(Stage stage);
+
+    protected:
+
+        //! Add sample to moving average.
+        static void addSample(Estimate &estimate, qint64 sample);
+
+        //! Convert expected wait in microseconds to retry-after in milliseconds (at least one second).
+        static qint64 toRetryAfter(qint64 waitTime);
+
+};
+
+#endif // RCL_HTTP_LOAD_SHEDDER_H
@@ -1,6 +1,8 @@
 #ifndef RCL_HTTP_MESSAGE_H
 #define RCL_HTTP_MESSAGE_H
 
+#include <QIODevice>
+#include <QSharedPointer>
 #include <QUrlQuery>
 #include <QHttpServerRequest>
 #include <QHttpServerResponse>
@@ -12,6 +14,11 @@ class RHttpMessage : public RNetworkMessage
 
     public:
 
+        //! Request header carrying per-request response timeout in milliseconds.
+        static const QByteArray requestTimeoutHeader;
+        //! Request header carrying key of mutating request which may be safely retried.
+        static const QByteArray idempotencyKeyHeader;
+
     protected:
 
         //! Internal initialization function.
@@ -27,6 +34,8 @@ class RHttpMessage : public RNetworkMessage
         QHttpHeaders requestHeaders;
         //! Response header.
         QHttpHeaders responseHeaders;
+        //! Body device (used instead of body for streamed content).
+        QSharedPointer<QIODevice> bodyDevice;
 
     public:
 
@@ -72,9 +81,28 @@ class RHttpMessage : public RNetworkMessage
         //! Set response headers.
         void setResponseHeaders(const QHttpHeaders &responseHeaders);
 
+        //! Return entity tag of response (ETag header value, empty if not set).
+        QByteArray getEntityTag() const;
+
+        //! Set entity tag of response (e.g. buildEntityTag() of listing version or file checksum).
+        void setEntityTag(const QByteArray &entityTag);
+
+        //! Return body device (null if body is held in memory).
+        const QSharedPointer<QIODevice> &getBodyDevice() const;
+
+        //! Set body device.
+        void setBodyDevice(const QSharedPointer<QIODevice> &bodyDevice);
+
         //! Print message to standard output.
         void print(bool printBody = false) const override;
 
+        //! Build strong entity tag (ETag header value) from checksum (e.g. RFileInfo::getMd5Checksum()).
+        static QByteArray buildEntityTag(const QString &checksum);
+
+        //! Return true if If-None-Match header value (list of entity tags or "*") matches given entity tag.
+        //! Weak comparison is used as for If-None-Match, so "W/" prefix is ignored.
+        static bool entityTagMatches(const QByteArray &ifNoneMatch, const QByteArray &entityTag);
+
         //! Find what HTTP method to use for given action.
         static QHttpServerRequest::Method findMethodForAction(const QString &actionKey);
 
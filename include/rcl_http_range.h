@@ -0,0 +1,72 @@
+#ifndef RCL_HTTP_RANGE_H
+#define RCL_HTTP_RANGE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+//! Single byte range as defined by the HTTP Range header ("bytes=first-last",
+//! "bytes=first-" or "bytes=-suffixLength").
+class RHttpRange
+{
+
+    protected:
+
+        //! First byte position (-1 for suffix range).
+        qint64 first;
+        //! Last byte position (-1 if open or suffix range).
+        qint64 last;
+        //! Suffix length (-1 if not a suffix range).
+        qint64 suffixLength;
+
+    private:
+
+        //! Internal initialization function.
+        void _init(const RHttpRange *pHttpRange = nullptr);
+
+    public:
+
+        //! Constructor.
+        RHttpRange();
+
+        //! Copy constructor.
+        RHttpRange(const RHttpRange &httpRange);
+
+        //! Destructor.
+        ~RHttpRange();
+
+        //! Assignment operator.
+        RHttpRange &operator =(const RHttpRange &httpRange);
+
+        //! Return true if no range is set.
+        bool isNull() const;
+
+        //! Return first byte position (-1 for suffix range).
+        qint64 getFirst() const;
+
+        //! Return last byte position (-1 if open or suffix range).
+        qint64 getLast() const;
+
+        //! Return suffix length (-1 if not a suffix range).
+        qint64 getSuffixLength() const;
+
+        //! Resolve range against resource of given size.
+        //! Return false if range is not satisfiable.
+        bool resolve(qint64 size, qint64 &offset, qint64 &length) const;
+
+        //! Convert range to Range header value.
+        QString toString() const;
+
+        //! Parse Range header value.
+        //! Returns null range if value is not a single byte range.
+        static RHttpRange fromString(QByteArrayView value);
+
+        //! Build Content-Range header value for resolved range.
+        static QByteArray buildContentRange(qint64 offset, qint64 length, qint64 size);
+
+        //! Build Content-Range header value for unsatisfiable range.
+        static QByteArray buildUnsatisfiedContentRange(qint64 size);
+
+};
+
+#endif // RCL_HTTP_RANGE_H
@@ -0,0 +1,87 @@
+#ifndef RCL_HTTP_RATE_LIMITER_H
+#define RCL_HTTP_RATE_LIMITER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+//! Per-principal rate limiter.
+//! Each principal (user, certificate CN or remote address) has a token bucket for requests,
+//! a token bucket for request body bytes and a cap on the number of requests in flight.
+//! Limits equal to 0 are disabled.
+class RHttpRateLimiter
+{
+
+    protected:
+
+        struct Bucket
+        {
+            //! Available tokens (may be negative after a request larger than the burst).
+            double tokens = 0.0;
+            //! Time of last refill in milliseconds.
+            qint64 refillTime = 0;
+        };
+
+        struct Principal
+        {
+            Bucket requestBucket;
+            Bucket byteBucket;
+            qint64 nInFlight = 0;
+        };
+
+        //! Requests per second.
+        double requestRate;
+        //! Request burst.
+        double requestBurst;
+        //! Bytes per second.
+        double byteRate;
+        //! Byte burst.
+        double byteBurst;
+        //! Maximum number of requests in flight.
+        qint64 maxInFlight;
+
+        //! Mutex.
+        mutable QMutex mutex;
+        //! Principals.
+        QHash<QString,Principal> principals;
+
+    public:
+
+        //! Constructor.
+        RHttpRateLimiter(double requestRate, double requestBurst, double byteRate, double byteBurst, qint64 maxInFlight);
+
+        //! Return true if any limit is enabled.
+        bool isEnabled() const;
+
+        //! Try to admit request of given principal.
+        //! On success the in-flight count is increased and must be released with release().
+        //! On failure retryAfterMs is set to the time after which the request may succeed.
+        bool tryAcquire(const QString &principal, qint64 nBytes, qint64 currentTime, qint64 &retryAfterMs);
+
+        //! Check whether request of given principal would be admitted now, without acquiring anything.
+        //! Used to reject requests before their body is received.
+        bool check(const QString &principal, qint64 nBytes, qint64 currentTime, qint64 &retryAfterMs);
+
+        //! Release request of given principal.
+        void release(const QString &principal);
+
+        //! Remove idle principals (full buckets and nothing in flight).
+        void prune(qint64 currentTime);
+
+        //! Return number of tracked principals.
+        qsizetype size() const;
+
+    private:
+
+        //! Refill buckets of given principal and return time in milliseconds until its request can be admitted (0 = now).
+        qint64 findRetryAfter(Principal &state, double byteCost, qint64 currentTime) const;
+
+        //! Refill bucket.
+        static void refill(Bucket &bucket, double rate, double burst, qint64 currentTime);
+
+        //! Return time in milliseconds until bucket contains given number of tokens.
+        static qint64 findWaitTime(const Bucket &bucket, double rate, double nTokens);
+
+};
+
+#endif // RCL_HTTP_RATE_LIMITER_H
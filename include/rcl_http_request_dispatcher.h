@@ -0,0 +1,78 @@
+#ifndef RCL_HTTP_REQUEST_DISPATCHER_H
+#define RCL_HTTP_REQUEST_DISPATCHER_H
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+
+#include "rcl_http_action_handler.h"
+#include "rcl_http_message.h"
+
+//! Dispatcher of requests to action handlers running on a worker pool.
+//! Requests are sharded by resource ID (or owner if request has no resource),
+//! shards are processed in parallel while requests of one shard keep their order.
+class RHttpRequestDispatcher
+{
+
+    protected:
+
+        struct Shard
+        {
+            QMutex mutex;
+            QQueue<std::function<void()>> tasks;
+            bool running = false;
+        };
+
+        //! Worker pool.
+        QThreadPool threadPool;
+        //! Shards.
+        QList<Shard*> shards;
+        //! Mutex guarding handlers.
+        mutable QMutex handlersMutex;
+        //! Action handlers.
+        QHash<QString,RHttpActionHandler*> handlers;
+
+    public:
+
+        //! Constructor.
+        //! Zero number of threads means ideal thread count.
+        explicit RHttpRequestDispatcher(int nThreads = 0);
+
+        //! Destructor.
+        ~RHttpRequestDispatcher();
+
+        RHttpRequestDispatcher(const RHttpRequestDispatcher &) = delete;
+        RHttpRequestDispatcher &operator=(const RHttpRequestDispatcher &) = delete;
+
+        //! Return number of worker threads.
+        int getThreadCount() const;
+
+        //! Set handler of given action (nullptr removes handler).
+        //! Dispatcher does not take ownership of the handler.
+        void setHandler(const QString &actionKey, RHttpActionHandler *pHandler);
+
+        //! Find handler of given action (nullptr if there is none).
+        RHttpActionHandler *findHandler(const QString &actionKey) const;
+
+        //! Dispatch request to given handler.
+        //! Returned future is fulfilled with the reply which carries handler ID of the request.
+        //! Errors thrown by the handler are returned as error replies.
+        QFuture<RHttpMessage> dispatch(RHttpActionHandler *pHandler, const RHttpMessage &requestMessage);
+
+        //! Return key used to shard given request.
+        static QString findShardKey(const RHttpMessage &requestMessage);
+
+    protected:
+
+        //! Run queued tasks of given shard.
+        void drainShard(Shard *pShard);
+
+};
+
+#endif // RCL_HTTP_REQUEST_DISPATCHER_H
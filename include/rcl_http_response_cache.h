@@ -0,0 +1,105 @@
+#ifndef RCL_HTTP_RESPONSE_CACHE_H
+#define RCL_HTTP_RESPONSE_CACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QUuid>
+
+#include <atomic>
+
+#include "rcl_http_message.h"
+
+//! Cache of responses to read-mostly administration listings (users, groups, actions, processes).
+//! Responses are cached per action, principal, query and content encoding, the cache is bounded
+//! by the total size of cached bodies. Successful mutating request forgets responses of the
+//! actions it may change, entries expire after TTL so that changes made elsewhere are noticed.
+class RHttpResponseCache
+{
+
+    public:
+
+        static constexpr qint64 defaultMaxBytes = 16 * 1024 * 1024;
+        static constexpr qint64 defaultTtlMs = 60000;
+
+    protected:
+
+        struct Entry
+        {
+            //! Response.
+            RHttpMessage response;
+            //! Expiry time in milliseconds.
+            qint64 expiryTime;
+        };
+
+        //! Time to live.
+        qint64 ttlMs;
+        //! Cache mutex.
+        mutable QMutex mutex;
+        //! Cached responses (cost is size in bytes).
+        QCache<QString,Entry> cache;
+        //! Generation, incremented by each invalidation.
+        std::atomic<quint64> generation;
+        //! Number of requests answered from the cache.
+        std::atomic<quint64> nHits;
+        //! Number of cacheable requests passed to the backend.
+        std::atomic<quint64> nMisses;
+        //! Number of invalidations.
+        std::atomic<quint64> nInvalidations;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpResponseCache(qint64 maxBytes = defaultMaxBytes, qint64 ttlMs = defaultTtlMs);
+
+        RHttpResponseCache(const RHttpResponseCache &) = delete;
+        RHttpResponseCache &operator=(const RHttpResponseCache &) = delete;
+
+        //! Find cached response, return false if not cached or expired.
+        bool find(const QString &key, qint64 currentTime, RHttpMessage &response);
+
+        //! Cache successful response to request which started in given generation.
+        //! Response is dropped if the cache was invalidated in the meantime or if it is streamed.
+        void insert(const QString &key, const RHttpMessage &response, quint64 generation, qint64 currentTime);
+
+        //! Forget responses of actions which may be changed by given mutating action.
+        void invalidate(const QString &mutatingActionKey);
+
+        //! Return current generation.
+        quint64 getGeneration() const;
+
+        //! Return number of cached responses.
+        qsizetype size() const;
+
+        //! Return total size of cached responses in bytes.
+        qint64 getTotalBytes() const;
+
+        //! Return number of requests answered from the cache.
+        quint64 getHitCount() const;
+
+        //! Return number of cacheable requests passed to the backend.
+        quint64 getMissCount() const;
+
+        //! Return number of invalidations.
+        quint64 getInvalidationCount() const;
+
+        //! Export counters as JSON.
+        QJsonObject toJson() const;
+
+        //! Export counters in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Build cache key, responses differ per user because of access rights.
+        static QString buildKey(const QString &actionKey, const QString &user, const QString &resourceName, const QUuid &resourceId, const QByteArray &contentEncoding);
+
+    protected:
+
+        //! Return approximate memory cost of given response.
+        static qint64 findCost(const QString &key, const RHttpMessage &response);
+
+};
+
+#endif // RCL_HTTP_RESPONSE_CACHE_H
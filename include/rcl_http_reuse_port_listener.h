@@ -0,0 +1,26 @@
+#ifndef RCL_HTTP_REUSE_PORT_LISTENER_H
+#define RCL_HTTP_REUSE_PORT_LISTENER_H
+
+#include <QtGlobal>
+
+//! Listening sockets which share one port (SO_REUSEPORT).
+//! Kernel balances incoming connections across all sockets bound to the port,
+//! each socket is handed to a QTcpServer with setSocketDescriptor().
+class RHttpReusePortListener
+{
+
+    public:
+
+        //! Return true if port sharing is supported on this platform.
+        static bool isSupported();
+
+        //! Open non-blocking socket listening on all addresses on given port with SO_REUSEPORT set.
+        //! Throws RError on failure.
+        static qintptr open(quint16 port, int backlog = 1024);
+
+        //! Close socket returned by open() which was not handed over to a server.
+        static void close(qintptr socketDescriptor);
+
+};
+
+#endif // RCL_HTTP_REUSE_PORT_LISTENER_H
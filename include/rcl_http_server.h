@@ -2,22 +2,34 @@
 #define RCL_HTTP_SERVER_H
 
 #include <QObject>
+#include <QFileSystemWatcher>
+#include <QFuture>
+#include <QHttpServerResponder>
 #include <QHttpServerResponse>
+#include <QJsonObject>
 #include <QString>
 #include <QMap>
-#include <QMutex>
 #include <QUuid>
 #include <QSslSocket>
 #include <QSslServer>
 #include <QTimer>
-#include <QDateTime>
+
+#include <memory>
 
 #include "rcl_auth_token_validator.h"
+#include "rcl_file_quota_provider.h"
+#include "rcl_http_admission_gate.h"
+#include "rcl_http_action_handler.h"
+#include "rcl_http_connection_manager.h"
 #include "rcl_http_message.h"
+#include "rcl_http_range.h"
+#include "rcl_http_server_context.h"
+#include "rcl_http_server_handler_registry.h"
+#include "rcl_http_server_metrics.h"
 #include "rcl_http_server_settings.h"
+#include "rcl_http_timing_wheel.h"
 
 class QHttpServer;
-class RHttpServerHandler;
 
 class RHttpServer : public QObject
 {
@@ -32,10 +44,24 @@ class RHttpServer : public QObject
             Private = 1
         };
 
+        //! Value of Server response header.
+        static const QByteArray serverName;
+        //! Path of metrics route (Prometheus text format, private server only).
+        static const QString metricsRoute;
+        //! Content type of metrics response.
+        static const QByteArray metricsContentType;
+
     private:
 
-        //! Mutex.
-        QMutex syncMutex;
+        //! State of one API request shared by its continuations, which run one after another.
+        //! Allocated once per request.
+        struct RequestState
+        {
+            //! Time points.
+            RHttpServerMetrics::Timing timing;
+            //! Access log record, completed and queued once the response is sent (filled only if access log is enabled).
+            RHttpAccessLog::Record accessRecord;
+        };
 
         //! Server type.
         Type type;
@@ -45,23 +71,73 @@ class RHttpServer : public QObject
         QSslServer *pSslServer;
         //! Pointer to HTTP server.
         QHttpServer *pHttpServer;
-        //! Map of server handlers.
-        QMap<QUuid,RHttpServerHandler*> serverHandlers;
-        //! Map of handler creation times.
-        QMap<QUuid,QDateTime> handlerCreationTimes;
-        //! Timer for handler cleanup.
+        //! Registry of pending server handlers.
+        RHttpServerHandlerRegistry handlerRegistry;
+        //! Deadlines of pending server handlers.
+        RHttpTimingWheel handlerTimingWheel;
+        //! Timer driving handler expiry.
+        QTimer *pExpiryTimer;
+        //! Deadlines and limit of client connections.
+        RHttpConnectionManager *pConnectionManager;
+        //! Timer for pending handler checks.
         QTimer *pCleanupTimer;
+        //! Watcher of TLS certificate and key files (nullptr if disabled).
+        QFileSystemWatcher *pTlsFileWatcher;
+        //! Timer collecting TLS file changes into one reload.
+        QTimer *pTlsReloadTimer;
+        //! Generation of the latest TLS configuration reload.
+        quint64 tlsReloadGeneration;
+        //! SSL configuration being built by the latest reload.
+        QFuture<QSslConfiguration> tlsBuildFuture;
         //! Authentication token validator.
         RAuthTokenValidator *pAuthTokenValidator;
+        //! File quota provider for early admission of uploads (nullptr if not set).
+        RFileQuotaProvider *pFileQuotaProvider;
+        //! Shared state (metrics, rate limiter, lanes, dispatcher, token cache).
+        std::shared_ptr<RHttpServerContext> pContext;
 
     public:
 
         //! Constructor.
         explicit RHttpServer(RHttpServer::Type type, const RHttpServerSettings &httpServerSettings, QObject *parent = nullptr);
 
+        //! Constructor of server instance sharing given context with other instances.
+        explicit RHttpServer(RHttpServer::Type type,
+                             const RHttpServerSettings &httpServerSettings,
+                             const std::shared_ptr<RHttpServerContext> &pContext,
+                             QObject *parent = nullptr);
+
+        //! Destructor.
+        ~RHttpServer();
+
         //! Set authentication token validator.
+        //! Results are cached unless authTokenCacheSize setting is 0.
         void setAuthTokenValidator(RAuthTokenValidator *pAuthTokenValidator);
 
+        //! Set file quota provider.
+        //! Uploads exceeding user's quota are rejected before their body is received.
+        void setFileQuotaProvider(RFileQuotaProvider *pFileQuotaProvider);
+
+        //! Invalidate cached validation result of given token (call when token is removed).
+        void invalidateAuthToken(const QString &resourceName, const QString &token);
+
+        //! Invalidate cached validation results of all tokens of given resource.
+        void invalidateAuthTokens(const QString &resourceName);
+
+        //! Invalidate cached entity tags (call when listings or files change outside of this server).
+        void invalidateEntityTags();
+
+        //! Reload TLS certificates and keys.
+        //! Configuration is built on a worker thread and then used for new connections,
+        //! existing connections keep their configuration. Returned future is fulfilled with true
+        //! once new configuration is in use, or with false if it failed or was superseded by a newer reload.
+        QFuture<bool> reloadTlsConfiguration();
+
+        //! Set handler of given action (nullptr removes handler).
+        //! Handler is called from worker threads and its reply is sent as if passed to sendMessageReply().
+        //! Requests of actions without handler are emitted through requestAvailable().
+        void setActionHandler(const QString &actionKey, RHttpActionHandler *pActionHandler);
+
         //! Start service.
         void start();
 
@@ -69,11 +145,18 @@ class RHttpServer : public QObject
         void stop();
 
         //! Send message.
+        //! Can be called from any thread.
         void sendMessageReply(const RHttpMessage &httpMessage);
 
+        //! Return request metrics as JSON.
+        QJsonObject getMetrics() const;
+
         //! Check if server contains given handler ID.
         bool containsServerHandlerId(const QUuid &serverHandlerId);
 
+        //! Return number of requests waiting for the backend.
+        qint64 getPendingHandlerCount() const;
+
     private:
 
         //! Build SSL configuration.
@@ -85,6 +168,9 @@ class RHttpServer : public QObject
         //! Check certificate expiry dates.
         void checkCertificateExpiry(const QList<QSslCertificate> &certificates, const QString &certificateFile) const;
 
+        //! Return TLS certificate and key files.
+        QStringList findTlsFiles() const;
+
         //! Returns name of given algorithm.
         static QString getKeyAlgorithmName(QSsl::KeyAlgorithm algorithm);
 
@@ -93,30 +179,89 @@ class RHttpServer : public QObject
 
         void buildApiRoute(const QString &actionKey);
 
+        //! Release rate limiter and lane slots, record metrics and access log record of finished request.
+        void finishRequest(const QString &action, const QString &principal, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const RHttpServerMetrics::Timing &timing, RHttpAccessLog::Record *pAccessRecord);
+
+        //! Record metrics and access log record of finished request.
+        void recordRequest(const QString &action, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const RHttpServerMetrics::Timing &timing, RHttpAccessLog::Record *pAccessRecord);
+
+        //! Decide on request head before its body is received.
+        RHttpAdmissionGate::Verdict admitRequestHead(const RHttpAdmissionGate::RequestHead &requestHead, QSslSocket *socket);
+
         //! Authenticate user and token.
         bool authenticateToken(const QString &user, const QString &token) const;
 
         //! Process request.
-        QHttpServerResponse processRequest(const QString &action,
-                                           const QString &owner,
-                                           const QString &fromAddress,
-                                           const QString &resourceName,
-                                           const QUuid &id,
-                                           const QByteArray &data);
+        //! Returned future is fulfilled once the backend replies through sendMessageReply()
+        //! or when the request times out after given number of milliseconds.
+        QFuture<RHttpMessage> processRequest(const QString &action,
+                                             const QString &owner,
+                                             const QString &fromAddress,
+                                             const QString &resourceName,
+                                             const QUuid &id,
+                                             const QMap<QString,QString> &requestProperties,
+                                             const QByteArray &data,
+                                             quint32 timeoutMs);
+
+        //! Find response timeout requested by the client (limited by server settings).
+        quint32 findRequestTimeout(const QHttpServerRequest &request) const;
+
+        //! Send response message to given peer and return size of the response body.
+        //! Body device (if any) is streamed with flow control instead of being loaded into memory.
+        qint64 sendResponse(QHttpServerResponder &responder,
+                            const RHttpMessage &responseMessage,
+                            const QHostAddress &remoteAddress,
+                            quint16 remotePort) const;
+
+        //! Send response message restricted to requested byte range to given peer.
+        //! Full content is sent if range is not set or if-range validator does not match.
+        //! Body device is read in chunks and encrypted by QSslSocket. Kernel TLS with sendfile()
+        //! is not possible: QSslSocket drives OpenSSL through memory BIOs and QHttpServer gives
+        //! no access to the raw socket after the handshake.
+        //! Return size of the response body.
+        qint64 sendRangeResponse(QHttpServerResponder &responder,
+                                 const RHttpMessage &responseMessage,
+                                 const RHttpRange &range,
+                                 const QByteArray &ifRange,
+                                 const QHostAddress &remoteAddress,
+                                 quint16 remotePort) const;
+
+        //! Send "304 Not Modified" with given entity tag.
+        //! Return size of the response body (always 0).
+        qint64 sendNotModified(QHttpServerResponder &responder, const QByteArray &entityTag) const;
+
+        //! Write response (takes ownership of body device) and return size of the response body.
+        //! Connection of given peer is kept busy until the body device is sent.
+        qint64 writeResponse(QHttpServerResponder &responder,
+                             QHttpServerResponse::StatusCode statusCode,
+                             const QHttpHeaders &responseHeaders,
+                             const QByteArray &body,
+                             QIODevice *pBodyDevice,
+                             const QHostAddress &remoteAddress = QHostAddress(),
+                             quint16 remotePort = 0) const;
+
+        //! Check if-range validator against entity tag of the response.
+        static bool ifRangeMatches(const QByteArray &ifRange, const QHttpHeaders &responseHeaders);
+
+        //! Build reply to request which was not processed because of overload (sent as 503 with Retry-After).
+        static RHttpMessage buildOverloadMessage(qint64 retryAfterMs);
 
         //! Return service name.
         QString getServiceName() const;
 
     private slots:
 
-        void serverHandlerAdd(RHttpServerHandler *serverHandler);
+        void expireHandlers();
 
-        void serverHandlerRemove(const QUuid &serverHandlerId);
+        void checkPendingHandlers();
 
-        void cleanupStaleHandlers();
+        void onTlsFileChanged(const QString &path);
 
+        //! Observe handshake of given socket without blocking.
         void onStartedEncryptionHandshake(QSslSocket *socket);
 
+        void onHandshakeErrorOccurred(QSslSocket *socket, QAbstractSocket::SocketError socketError);
+
     signals:
 
         //! Service is ready.
@@ -131,6 +276,7 @@ class RHttpServer : public QObject
         //! Service has failed.
         void failed();
 
+        //! Request of action without action handler is available.
         void requestAvailable(const RHttpMessage &httpMessage);
 
 };
@@ -0,0 +1,115 @@
+#ifndef RCL_HTTP_SERVER_CLUSTER_H
+#define RCL_HTTP_SERVER_CLUSTER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QThread>
+
+#include <functional>
+#include <memory>
+
+#include "rcl_http_server.h"
+#include "rcl_http_server_context.h"
+
+//! Several HTTP server instances listening on one port.
+//! Each instance runs in its own thread with its own event loop, so TLS and HTTP
+//! processing scale across cores. Kernel balances connections across instances
+//! (SO_REUSEPORT). Instances share one context (metrics, rate limiter, lanes,
+//! dispatcher and token cache). Number of instances is given by listenerInstanceCount setting.
+class RHttpServerCluster : public QObject
+{
+
+    Q_OBJECT
+
+    private:
+
+        //! Shared state of all instances.
+        std::shared_ptr<RHttpServerContext> pContext;
+        //! Threads of server instances.
+        QList<QThread*> threads;
+        //! Server instances.
+        QList<RHttpServer*> servers;
+        //! Number of started instances.
+        int nStarted;
+        //! Number of finished instances.
+        int nFinished;
+        //! True once failure was reported.
+        bool hasFailed;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpServerCluster(RHttpServer::Type type, const RHttpServerSettings &httpServerSettings, QObject *parent = nullptr);
+
+        //! Destructor.
+        ~RHttpServerCluster();
+
+        //! Return number of server instances.
+        int getInstanceCount() const;
+
+        //! Set authentication token validator of all instances.
+        //! Validator is called from threads of server instances.
+        void setAuthTokenValidator(RAuthTokenValidator *pAuthTokenValidator);
+
+        //! Set file quota provider of all instances.
+        //! Provider is called from threads of server instances.
+        void setFileQuotaProvider(RFileQuotaProvider *pFileQuotaProvider);
+
+        //! Invalidate cached validation result of given token (call when token is removed).
+        void invalidateAuthToken(const QString &resourceName, const QString &token);
+
+        //! Invalidate cached validation results of all tokens of given resource.
+        void invalidateAuthTokens(const QString &resourceName);
+
+        //! Set handler of given action (nullptr removes handler).
+        void setActionHandler(const QString &actionKey, RHttpActionHandler *pActionHandler);
+
+        //! Reload TLS certificates and keys of all instances.
+        void reloadTlsConfiguration();
+
+        //! Start all instances.
+        void start();
+
+        //! Stop all instances.
+        void stop();
+
+        //! Send message through the instance which received the request.
+        void sendMessageReply(const RHttpMessage &httpMessage);
+
+        //! Return request metrics of all instances as JSON.
+        QJsonObject getMetrics() const;
+
+    private:
+
+        //! Run given function in thread of each instance and wait for it to finish.
+        void runOnInstances(const std::function<void(RHttpServer *)> &function);
+
+    private slots:
+
+        void onInstanceStarted();
+
+        void onInstanceFinished();
+
+        void onInstanceFailed();
+
+    signals:
+
+        //! All instances are ready.
+        void ready();
+
+        //! All instances have started.
+        void started();
+
+        //! All instances have finished.
+        void finished();
+
+        //! Some instance has failed.
+        void failed();
+
+        //! Request of action without action handler is available.
+        void requestAvailable(const RHttpMessage &httpMessage);
+
+};
+
+#endif // RCL_HTTP_SERVER_CLUSTER_H
@@ -0,0 +1,129 @@
+#ifndef RCL_HTTP_SERVER_CONTEXT_H
+#define RCL_HTTP_SERVER_CONTEXT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include "rcl_auth_token_validator_cache.h"
+#include "rcl_http_access_log.h"
+#include "rcl_http_batch_action_handler.h"
+#include "rcl_http_change_feed.h"
+#include "rcl_http_connection_metrics.h"
+#include "rcl_http_dispatch_lane.h"
+#include "rcl_http_entity_tag_cache.h"
+#include "rcl_http_idempotency_store.h"
+#include "rcl_http_load_shedder.h"
+#include "rcl_http_rate_limiter.h"
+#include "rcl_http_request_dispatcher.h"
+#include "rcl_http_response_cache.h"
+#include "rcl_http_server_metrics.h"
+#include "rcl_http_server_settings.h"
+#include "rcl_http_tls_metrics.h"
+#include "rcl_http_tls_ticket_key_store.h"
+
+//! State of the HTTP server which is independent of its event loop.
+//! All members are thread-safe, so one context can be shared by several server
+//! instances running in their own threads (see RHttpServerCluster).
+class RHttpServerContext
+{
+
+    protected:
+
+        //! Request metrics.
+        RHttpServerMetrics metrics;
+        //! TLS handshake metrics.
+        RHttpTlsMetrics tlsMetrics;
+        //! Client connection metrics.
+        RHttpConnectionMetrics connectionMetrics;
+        //! Per-principal rate limiter.
+        RHttpRateLimiter rateLimiter;
+        //! Dispatch lanes (indexed by RHttpDispatchLane::Type).
+        QList<RHttpDispatchLane*> lanes;
+        //! Dispatcher of requests to action handlers.
+        RHttpRequestDispatcher dispatcher;
+        //! Handler of batches whose items all have in-process handlers.
+        RHttpBatchActionHandler batchHandler;
+        //! Authentication token validator cache (nullptr if disabled).
+        RAuthTokenValidatorCache *pAuthTokenCache;
+        //! Asynchronous access log (nullptr if disabled).
+        RHttpAccessLog *pAccessLog;
+        //! Responses of mutating requests by idempotency key (nullptr if disabled).
+        RHttpIdempotencyStore *pIdempotencyStore;
+        //! Entity tags of recent responses (nullptr if disabled).
+        RHttpEntityTagCache *pEntityTagCache;
+        //! Load shedder (nullptr if disabled).
+        RHttpLoadShedder *pLoadShedder;
+        //! Responses of read-mostly listings (nullptr if disabled).
+        RHttpResponseCache *pResponseCache;
+        //! Feed of file changes for waiting sync clients (nullptr if disabled).
+        RHttpChangeFeed *pChangeFeed;
+        //! Keys of TLS session tickets (nullptr if session resumption is disabled).
+        RHttpTlsTicketKeyStore *pTicketKeyStore;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpServerContext(const RHttpServerSettings &httpServerSettings);
+
+        //! Destructor.
+        ~RHttpServerContext();
+
+        RHttpServerContext(const RHttpServerContext &) = delete;
+        RHttpServerContext &operator=(const RHttpServerContext &) = delete;
+
+        //! Return request metrics.
+        RHttpServerMetrics &getMetrics();
+
+        //! Return TLS handshake metrics.
+        RHttpTlsMetrics &getTlsMetrics();
+
+        //! Return client connection metrics.
+        RHttpConnectionMetrics &getConnectionMetrics();
+
+        //! Return per-principal rate limiter.
+        RHttpRateLimiter &getRateLimiter();
+
+        //! Return dispatch lane of given action.
+        RHttpDispatchLane *findLane(const QString &actionKey) const;
+
+        //! Return dispatcher of requests to action handlers.
+        RHttpRequestDispatcher &getDispatcher();
+
+        //! Return handler of batches whose items all have in-process handlers.
+        RHttpBatchActionHandler &getBatchHandler();
+
+        //! Return authentication token validator cache (nullptr if disabled).
+        RAuthTokenValidatorCache *getAuthTokenCache() const;
+
+        //! Return asynchronous access log (nullptr if disabled).
+        RHttpAccessLog *getAccessLog() const;
+
+        //! Return store of responses by idempotency key (nullptr if disabled).
+        RHttpIdempotencyStore *getIdempotencyStore() const;
+
+        //! Return entity tags of recent responses (nullptr if disabled).
+        RHttpEntityTagCache *getEntityTagCache() const;
+
+        //! Return load shedder (nullptr if disabled).
+        RHttpLoadShedder *getLoadShedder() const;
+
+        //! Return cache of read-mostly listings (nullptr if disabled).
+        RHttpResponseCache *getResponseCache() const;
+
+        //! Return feed of file changes (nullptr if disabled).
+        RHttpChangeFeed *getChangeFeed() const;
+
+        //! Return keys of TLS session tickets (nullptr if session resumption is disabled).
+        RHttpTlsTicketKeyStore *getTicketKeyStore() const;
+
+        //! Export metrics in Prometheus text exposition format.
+        QByteArray toPrometheusText(qint64 nInFlightHandlers) const;
+
+        //! Export metrics as JSON.
+        QJsonObject toJson(qint64 nInFlightHandlers) const;
+
+};
+
+#endif // RCL_HTTP_SERVER_CONTEXT_H
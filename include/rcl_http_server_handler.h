@@ -0,0 +1,56 @@
+#ifndef RCL_HTTP_SERVER_HANDLER_H
+#define RCL_HTTP_SERVER_HANDLER_H
+
+#include <QFuture>
+#include <QPromise>
+#include <QUuid>
+
+#include "rcl_http_message.h"
+
+class RHttpServerHandlerRegistry;
+
+class RHttpServerHandler
+{
+
+    friend class RHttpServerHandlerRegistry;
+
+    private:
+
+        //! Handler ID.
+        QUuid id;
+        //! Registry handle.
+        quint64 handle;
+        //! Creation time (monotonic clock in milliseconds).
+        qint64 creationTime;
+        //! Response promise.
+        QPromise<RHttpMessage> responsePromise;
+
+    public:
+
+        //! Constructor.
+        RHttpServerHandler();
+
+        //! Return handler ID.
+        const QUuid &getId() const;
+
+        //! Return registry handle.
+        quint64 getHandle() const;
+
+        //! Return creation time (monotonic clock in milliseconds).
+        qint64 getCreationTime() const;
+
+        //! Return future which is fulfilled once the reply is sent.
+        QFuture<RHttpMessage> getFuture();
+
+        //! Fulfil response promise.
+        //! Must be called exactly once by whoever took the handler out of the registry.
+        void sendReply(const RHttpMessage &httpMessage);
+
+    private:
+
+        //! Prepare handler for (re)use.
+        void reset(const QUuid &id, quint64 handle, qint64 creationTime);
+
+};
+
+#endif // RCL_HTTP_SERVER_HANDLER_H
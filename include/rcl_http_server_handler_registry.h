@@ -0,0 +1,109 @@
+#ifndef RCL_HTTP_SERVER_HANDLER_REGISTRY_H
+#define RCL_HTTP_SERVER_HANDLER_REGISTRY_H
+
+#include <QAtomicInteger>
+#include <QList>
+#include <QMutex>
+#include <QUuid>
+#include <QVector>
+
+#include "rcl_http_server_handler.h"
+
+//! Registry of pending server handlers.
+//!
+//! Handlers are stored in a slot map split into independently locked stripes.
+//! Each handler is addressed by a generation-counted handle (stripe, slot index,
+//! generation) which is packed into the handler QUuid, so a stale or foreign
+//! ID never resolves to a recycled slot. Released handler objects are kept in
+//! a per-stripe pool and reused by subsequent requests.
+class RHttpServerHandlerRegistry
+{
+
+    public:
+
+        //! Number of stripes.
+        static constexpr uint nStripes = 16;
+        //! Maximum number of pooled handler objects per stripe.
+        static constexpr int maxPoolSize = 256;
+        //! Size of a cache line.
+        static constexpr size_t cacheLineSize = 64;
+
+    private:
+
+        struct Slot
+        {
+            //! Registered handler (nullptr if slot is free).
+            RHttpServerHandler *pHandler;
+            //! Slot generation.
+            quint32 generation;
+        };
+
+        //! Stripes are kept on separate cache lines, so that their mutexes do not share one.
+        struct alignas(cacheLineSize) Stripe
+        {
+            //! Stripe mutex.
+            QMutex mutex;
+            //! Slots.
+            QVector<Slot> slots;
+            //! Indexes of free slots.
+            QVector<quint32> freeSlots;
+            //! Pool of recycled handlers.
+            QVector<RHttpServerHandler*> pool;
+        };
+
+        //! Stripes.
+        Stripe stripes[nStripes];
+        //! Stripe used by next acquire.
+        QAtomicInteger<quint32> nextStripe;
+        //! Number of registered handlers.
+        QAtomicInteger<qint32> nHandlers;
+        //! Registry tag (first part of every handler ID).
+        quint32 tag1;
+        //! Registry tag (second part of every handler ID).
+        quint32 tag2;
+
+    public:
+
+        //! Constructor.
+        RHttpServerHandlerRegistry();
+
+        //! Destructor.
+        ~RHttpServerHandlerRegistry();
+
+        //! Register new handler and return it.
+        //! Registry keeps the ownership until the handler is taken out.
+        RHttpServerHandler *acquire();
+
+        //! Remove handler with given ID from the registry and pass its ownership to the caller.
+        //! Return nullptr if no such handler is registered.
+        RHttpServerHandler *take(const QUuid &id);
+
+        //! Remove all handlers and pass their ownership to the caller.
+        QList<RHttpServerHandler*> takeAll();
+
+        //! Return handler (which was taken out of the registry) to the pool.
+        void release(RHttpServerHandler *pHandler);
+
+        //! Check if handler with given ID is registered.
+        bool contains(const QUuid &id);
+
+        //! Return number of registered handlers.
+        int size() const;
+
+        //! Return current time of monotonic clock in milliseconds.
+        static qint64 currentTime();
+
+    private:
+
+        //! Build handler ID from handle.
+        QUuid encodeId(quint64 handle) const;
+
+        //! Extract handle from handler ID.
+        bool decodeId(const QUuid &id, quint64 &handle) const;
+
+        //! Take handler out of given slot. Stripe must be locked.
+        RHttpServerHandler *takeSlot(Stripe &stripe, quint32 slotIndex);
+
+};
+
+#endif // RCL_HTTP_SERVER_HANDLER_REGISTRY_H
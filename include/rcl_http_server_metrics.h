@@ -0,0 +1,106 @@
+#ifndef RCL_HTTP_SERVER_METRICS_H
+#define RCL_HTTP_SERVER_METRICS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+
+#include <rbl_error.h>
+
+#include "rcl_http_latency_histogram.h"
+
+//! Request metrics of the HTTP server.
+//! Set of actions is fixed at construction, all counters are atomic so
+//! recording never takes a lock.
+class RHttpServerMetrics
+{
+
+    public:
+
+        enum Phase
+        {
+            //! From request arrival to dispatch to the backend.
+            Queue = 0,
+            //! From dispatch to backend reply.
+            Backend,
+            //! From backend reply to response being handed to the socket.
+            Send,
+            nPhases
+        };
+
+        //! Time points of a request in microseconds (see currentTime()).
+        struct Timing
+        {
+            qint64 receivedTime = 0;
+            qint64 dispatchedTime = 0;
+            qint64 repliedTime = 0;
+        };
+
+    protected:
+
+        struct ActionMetrics
+        {
+            std::atomic<quint64> nRequests{0};
+            std::atomic<quint64> nRejected{0};
+            std::atomic<quint64> bytesIn{0};
+            std::atomic<quint64> bytesOut{0};
+            std::atomic<quint64> nErrors[32];
+            RHttpLatencyHistogram latency[nPhases];
+        };
+
+        //! Metrics of each action.
+        QHash<QString,ActionMetrics*> actionMetrics;
+        //! Action keys in order of export.
+        QList<QString> actionKeys;
+
+    public:
+
+        //! Constructor.
+        explicit RHttpServerMetrics(const QList<QString> &actionKeys);
+
+        //! Destructor.
+        ~RHttpServerMetrics();
+
+        RHttpServerMetrics(const RHttpServerMetrics &) = delete;
+        RHttpServerMetrics &operator=(const RHttpServerMetrics &) = delete;
+
+        //! Record finished request (unknown actions are ignored).
+        void recordRequest(const QString &action, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const Timing &timing);
+
+        //! Record request rejected before it was dispatched (e.g. rate limited).
+        void recordRejection(const QString &action);
+
+        //! Return number of rejected requests of given action.
+        quint64 getRejectionCount(const QString &action) const;
+
+        //! Return number of requests of given action.
+        quint64 getRequestCount(const QString &action) const;
+
+        //! Return number of requests of given action which failed with given error type.
+        quint64 getErrorCount(const QString &action, RError::Type errorType) const;
+
+        //! Return latency histogram of given action and phase.
+        const RHttpLatencyHistogram *findLatency(const QString &action, Phase phase) const;
+
+        //! Export metrics in Prometheus text exposition format.
+        QByteArray toPrometheusText(qint64 nInFlightHandlers) const;
+
+        //! Export metrics as JSON.
+        QJsonObject toJson(qint64 nInFlightHandlers) const;
+
+        //! Return current monotonic time in microseconds.
+        static qint64 currentTime();
+
+        //! Return name of given phase.
+        static QString phaseToString(Phase phase);
+
+        //! Return name of given error type.
+        static QString errorTypeToString(RError::Type errorType);
+
+};
+
+#endif // RCL_HTTP_SERVER_METRICS_H
@@ -14,7 +14,49 @@ class RHttpServerSettings : public RHttpSettings
     static quint32 constexpr defaultResponseTimeoutMs = 10000;
     static quint32 constexpr defaultHandlerCleanupIntervalMs = 60000;
     static quint32 constexpr defaultMaxStaleHandlerAgeMs = 120000;
+    static quint32 constexpr defaultHandlerExpiryResolutionMs = 50;
     static qint64 constexpr defaultMaxBodySize = 104857600;
+    static bool constexpr defaultCompressionEnabled = true;
+    static qint64 constexpr defaultCompressionMinSize = 1024;
+    static qint64 constexpr defaultAuthTokenCacheSize = 0;
+    static qint64 constexpr defaultAuthTokenCacheTtlMs = 300000;
+    static qint64 constexpr defaultAuthTokenNegativeCacheTtlMs = 5000;
+    static quint32 constexpr defaultPrincipalRequestRate = 0;
+    static quint32 constexpr defaultPrincipalRequestBurst = 200;
+    static qint64 constexpr defaultPrincipalByteRate = 0;
+    static qint64 constexpr defaultPrincipalByteBurst = 0;
+    static quint32 constexpr defaultPrincipalMaxInFlight = 0;
+    static quint32 constexpr defaultInteractiveLaneConcurrency = 64;
+    static quint32 constexpr defaultInteractiveLaneQueueSize = 256;
+    static quint32 constexpr defaultBulkLaneConcurrency = 8;
+    static quint32 constexpr defaultBulkLaneQueueSize = 64;
+    static quint32 constexpr defaultAdminLaneConcurrency = 4;
+    static quint32 constexpr defaultAdminLaneQueueSize = 32;
+    static quint32 constexpr defaultDispatcherThreadCount = 0;
+    static bool constexpr defaultTlsSessionResumptionEnabled = true;
+    static quint32 constexpr defaultTlsSessionTicketKeyRotationMs = 12 * 60 * 60 * 1000;
+    static bool constexpr defaultTlsFileWatchEnabled = false;
+    static quint32 constexpr defaultListenerInstanceCount = 1;
+    static bool constexpr defaultAccessLogEnabled = true;
+    static quint32 constexpr defaultAccessLogCapacity = 8192;
+    static quint32 constexpr defaultAccessLogSampleRate = 1;
+    static bool constexpr defaultAccessLogCompactFormat = false;
+    static bool constexpr defaultEarlyAdmissionEnabled = false;
+    static qint64 constexpr defaultIdempotencyCacheSize = 10000;
+    static qint64 constexpr defaultIdempotencyTtlMs = 600000;
+    static qint64 constexpr defaultEntityTagCacheSize = 0;
+    static qint64 constexpr defaultEntityTagCacheTtlMs = 30000;
+    static quint32 constexpr defaultMaxBatchSize = 100;
+    static bool constexpr defaultLoadSheddingEnabled = true;
+    static qint64 constexpr defaultResponseCacheMaxBytes = 0;
+    static qint64 constexpr defaultResponseCacheTtlMs = 60000;
+    static bool constexpr defaultChangeFeedEnabled = true;
+    static qint64 constexpr defaultChangeFeedMaxWaitMs = 30000;
+    static qint64 constexpr defaultConnectionIdleTimeoutMs = 30000;
+    static qint64 constexpr defaultKeepAliveTimeoutMs = 120000;
+    static qint64 constexpr defaultHeaderReadTimeoutMs = 10000;
+    static qint64 constexpr defaultBodyReadTimeoutMs = 30000;
+    static uint constexpr defaultMaxConnections = 20000;
 
     protected:
 
@@ -22,7 +64,51 @@ class RHttpServerSettings : public RHttpSettings
         quint32 responseTimeoutMs;
         quint32 handlerCleanupIntervalMs;
         quint32 maxStaleHandlerAgeMs;
+        quint32 handlerExpiryResolutionMs;
         qint64 maxBodySize;
+        bool compressionEnabled;
+        qint64 compressionMinSize;
+        qint64 authTokenCacheSize;
+        qint64 authTokenCacheTtlMs;
+        qint64 authTokenNegativeCacheTtlMs;
+        quint32 principalRequestRate;
+        quint32 principalRequestBurst;
+        qint64 principalByteRate;
+        qint64 principalByteBurst;
+        quint32 principalMaxInFlight;
+        quint32 interactiveLaneConcurrency;
+        quint32 interactiveLaneQueueSize;
+        quint32 bulkLaneConcurrency;
+        quint32 bulkLaneQueueSize;
+        quint32 adminLaneConcurrency;
+        quint32 adminLaneQueueSize;
+        quint32 dispatcherThreadCount;
+        bool tlsSessionResumptionEnabled;
+        quint32 tlsSessionTicketKeyRotationMs;
+        bool tlsFileWatchEnabled;
+        quint32 listenerInstanceCount;
+        bool accessLogEnabled;
+        quint32 accessLogCapacity;
+        quint32 accessLogSampleRate;
+        bool accessLogCompactFormat;
+        //! Access log file (empty = logger).
+        QString accessLogFile;
+        bool earlyAdmissionEnabled;
+        qint64 idempotencyCacheSize;
+        qint64 idempotencyTtlMs;
+        qint64 entityTagCacheSize;
+        qint64 entityTagCacheTtlMs;
+        quint32 maxBatchSize;
+        bool loadSheddingEnabled;
+        qint64 responseCacheMaxBytes;
+        qint64 responseCacheTtlMs;
+        bool changeFeedEnabled;
+        qint64 changeFeedMaxWaitMs;
+        qint64 connectionIdleTimeoutMs;
+        qint64 keepAliveTimeoutMs;
+        qint64 headerReadTimeoutMs;
+        qint64 bodyReadTimeoutMs;
+        uint maxConnections;
 
     protected:
 
@@ -67,6 +153,11 @@ class RHttpServerSettings : public RHttpSettings
         //! Set maximum stale handler age in milliseconds.
         void setMaxStaleHandlerAgeMs(quint32 ageMs);
 
+        //! Return resolution of handler expiry in milliseconds.
+        quint32 getHandlerExpiryResolutionMs() const;
+
+        //! Set resolution of handler expiry in milliseconds.
+        void setHandlerExpiryResolutionMs(quint32 resolutionMs);
 
         //! Return maximum body size in bytes.
         qint64 getMaxBodySize() const;
@@ -74,6 +165,268 @@ class RHttpServerSettings : public RHttpSettings
         //! Set maximum body size in bytes.
         void setMaxBodySize(qint64 maxBodySize);
 
+        //! Return true if response bodies are compressed when client accepts it.
+        bool getCompressionEnabled() const;
+
+        //! Set whether response bodies are compressed when client accepts it.
+        void setCompressionEnabled(bool compressionEnabled);
+
+        //! Return minimum size of response body in bytes to be compressed.
+        qint64 getCompressionMinSize() const;
+
+        //! Set minimum size of response body in bytes to be compressed.
+        void setCompressionMinSize(qint64 compressionMinSize);
+
+        //! Return maximum number of cached token validation results (0 disables the cache).
+        //! Removed tokens keep being accepted until their TTL expires unless the backend calls
+        //! RHttpServer::invalidateAuthToken() or RHttpServer::invalidateAuthTokens() when it removes them.
+        qint64 getAuthTokenCacheSize() const;
+
+        //! Set maximum number of cached token validation results (0 disables the cache).
+        //! Removed tokens keep being accepted until their TTL expires unless the backend calls
+        //! RHttpServer::invalidateAuthToken() or RHttpServer::invalidateAuthTokens() when it removes them.
+        void setAuthTokenCacheSize(qint64 authTokenCacheSize);
+
+        //! Return time to live of cached valid tokens in milliseconds.
+        qint64 getAuthTokenCacheTtlMs() const;
+
+        //! Set time to live of cached valid tokens in milliseconds.
+        void setAuthTokenCacheTtlMs(qint64 authTokenCacheTtlMs);
+
+        //! Return time to live of cached invalid tokens in milliseconds.
+        qint64 getAuthTokenNegativeCacheTtlMs() const;
+
+        //! Set time to live of cached invalid tokens in milliseconds.
+        void setAuthTokenNegativeCacheTtlMs(qint64 authTokenNegativeCacheTtlMs);
+
+        //! Return allowed number of requests per second of each principal (0 means unlimited).
+        quint32 getPrincipalRequestRate() const;
+
+        //! Set allowed number of requests per second of each principal (0 means unlimited).
+        void setPrincipalRequestRate(quint32 principalRequestRate);
+
+        //! Return request burst of each principal.
+        quint32 getPrincipalRequestBurst() const;
+
+        //! Set request burst of each principal.
+        void setPrincipalRequestBurst(quint32 principalRequestBurst);
+
+        //! Return allowed number of request body bytes per second of each principal (0 means unlimited).
+        qint64 getPrincipalByteRate() const;
+
+        //! Set allowed number of request body bytes per second of each principal (0 means unlimited).
+        void setPrincipalByteRate(qint64 principalByteRate);
+
+        //! Return request body byte burst of each principal.
+        qint64 getPrincipalByteBurst() const;
+
+        //! Set request body byte burst of each principal.
+        void setPrincipalByteBurst(qint64 principalByteBurst);
+
+        //! Return maximum number of requests in flight of each principal (0 means unlimited).
+        quint32 getPrincipalMaxInFlight() const;
+
+        //! Set maximum number of requests in flight of each principal (0 means unlimited).
+        void setPrincipalMaxInFlight(quint32 principalMaxInFlight);
+
+        //! Return maximum number of interactive (metadata) requests being processed.
+        quint32 getInteractiveLaneConcurrency() const;
+
+        //! Set maximum number of interactive (metadata) requests being processed.
+        void setInteractiveLaneConcurrency(quint32 interactiveLaneConcurrency);
+
+        //! Return maximum number of interactive (metadata) requests waiting for a slot.
+        quint32 getInteractiveLaneQueueSize() const;
+
+        //! Set maximum number of interactive (metadata) requests waiting for a slot.
+        void setInteractiveLaneQueueSize(quint32 interactiveLaneQueueSize);
+
+        //! Return maximum number of bulk transfer requests being processed.
+        quint32 getBulkLaneConcurrency() const;
+
+        //! Set maximum number of bulk transfer requests being processed.
+        void setBulkLaneConcurrency(quint32 bulkLaneConcurrency);
+
+        //! Return maximum number of bulk transfer requests waiting for a slot.
+        quint32 getBulkLaneQueueSize() const;
+
+        //! Set maximum number of bulk transfer requests waiting for a slot.
+        void setBulkLaneQueueSize(quint32 bulkLaneQueueSize);
+
+        //! Return maximum number of administration and process requests being processed.
+        quint32 getAdminLaneConcurrency() const;
+
+        //! Set maximum number of administration and process requests being processed.
+        void setAdminLaneConcurrency(quint32 adminLaneConcurrency);
+
+        //! Return maximum number of administration and process requests waiting for a slot.
+        quint32 getAdminLaneQueueSize() const;
+
+        //! Set maximum number of administration and process requests waiting for a slot.
+        void setAdminLaneQueueSize(quint32 adminLaneQueueSize);
+
+        //! Return number of worker threads running action handlers (0 = ideal thread count).
+        quint32 getDispatcherThreadCount() const;
+
+        //! Set number of worker threads running action handlers (0 = ideal thread count).
+        void setDispatcherThreadCount(quint32 dispatcherThreadCount);
+
+        //! Return true if TLS session resumption (session tickets) is enabled.
+        bool getTlsSessionResumptionEnabled() const;
+
+        //! Set whether TLS session resumption (session tickets) is enabled.
+        void setTlsSessionResumptionEnabled(bool tlsSessionResumptionEnabled);
+
+        //! Return interval of TLS session ticket key rotation in milliseconds (0 = never).
+        quint32 getTlsSessionTicketKeyRotationMs() const;
+
+        //! Set interval of TLS session ticket key rotation in milliseconds (0 = never).
+        void setTlsSessionTicketKeyRotationMs(quint32 tlsSessionTicketKeyRotationMs);
+
+        //! Return true if TLS certificate and key files are watched and reloaded on change.
+        bool getTlsFileWatchEnabled() const;
+
+        //! Set whether TLS certificate and key files are watched and reloaded on change.
+        void setTlsFileWatchEnabled(bool tlsFileWatchEnabled);
+
+        //! Return number of server instances sharing the port (see RHttpServerCluster, more than 1 requires SO_REUSEPORT).
+        quint32 getListenerInstanceCount() const;
+
+        //! Set number of server instances sharing the port (see RHttpServerCluster, more than 1 requires SO_REUSEPORT).
+        void setListenerInstanceCount(quint32 listenerInstanceCount);
+
+        //! Get whether requests are written to asynchronous access log.
+        bool getAccessLogEnabled() const;
+
+        //! Set whether requests are written to asynchronous access log.
+        void setAccessLogEnabled(bool accessLogEnabled);
+
+        //! Get number of access log records buffered for background writer.
+        quint32 getAccessLogCapacity() const;
+
+        //! Set number of access log records buffered for background writer.
+        void setAccessLogCapacity(quint32 accessLogCapacity);
+
+        //! Get access log sample rate (every n-th successful request is logged).
+        quint32 getAccessLogSampleRate() const;
+
+        //! Set access log sample rate (every n-th successful request is logged).
+        void setAccessLogSampleRate(quint32 accessLogSampleRate);
+
+        //! Get whether access log uses compact key=value format.
+        bool getAccessLogCompactFormat() const;
+
+        //! Set whether access log uses compact key=value format.
+        void setAccessLogCompactFormat(bool accessLogCompactFormat);
+
+        //! Get access log file (empty = logger).
+        const QString &getAccessLogFile() const;
+
+        //! Set access log file (empty = logger).
+        void setAccessLogFile(const QString &accessLogFile);
+
+        //! Get whether uploads are admitted on request headers before their body is received.
+        //! Rejections are written to the socket past the HTTP server and the connection is closed,
+        //! so enable only where clients do not pipeline requests on a kept-alive connection.
+        bool getEarlyAdmissionEnabled() const;
+
+        //! Set whether uploads are admitted on request headers before their body is received.
+        //! Rejections are written to the socket past the HTTP server and the connection is closed,
+        //! so enable only where clients do not pipeline requests on a kept-alive connection.
+        void setEarlyAdmissionEnabled(bool earlyAdmissionEnabled);
+
+        //! Return maximum number of remembered idempotency keys (0 disables the idempotency cache).
+        qint64 getIdempotencyCacheSize() const;
+
+        //! Set maximum number of remembered idempotency keys.
+        void setIdempotencyCacheSize(qint64 idempotencyCacheSize);
+
+        //! Return how long idempotency key is remembered in milliseconds.
+        qint64 getIdempotencyTtlMs() const;
+
+        //! Set how long idempotency key is remembered in milliseconds.
+        void setIdempotencyTtlMs(qint64 idempotencyTtlMs);
+
+        //! Return maximum number of cached entity tags (0 disables answering conditional requests without the backend).
+        //! Enable only if every change of listings or files goes through this server,
+        //! or if the backend calls RHttpServer::invalidateEntityTags() when data changes elsewhere.
+        qint64 getEntityTagCacheSize() const;
+
+        //! Set maximum number of cached entity tags.
+        void setEntityTagCacheSize(qint64 entityTagCacheSize);
+
+        //! Return how long entity tag is cached in milliseconds.
+        qint64 getEntityTagCacheTtlMs() const;
+
+        //! Set how long entity tag is cached in milliseconds.
+        void setEntityTagCacheTtlMs(qint64 entityTagCacheTtlMs);
+
+        //! Return maximum number of actions in one batch request.
+        quint32 getMaxBatchSize() const;
+
+        //! Set maximum number of actions in one batch request.
+        void setMaxBatchSize(quint32 maxBatchSize);
+
+        //! Return true if requests which cannot be answered in time are rejected early.
+        bool getLoadSheddingEnabled() const;
+
+        //! Set whether requests which cannot be answered in time are rejected early.
+        void setLoadSheddingEnabled(bool loadSheddingEnabled);
+
+        //! Return maximum size of cached responses in bytes (0 disables the cache).
+        qint64 getResponseCacheMaxBytes() const;
+
+        //! Set maximum size of cached responses in bytes (0 disables the cache).
+        void setResponseCacheMaxBytes(qint64 responseCacheMaxBytes);
+
+        //! Return how long response is cached in milliseconds.
+        qint64 getResponseCacheTtlMs() const;
+
+        //! Set how long response is cached in milliseconds.
+        void setResponseCacheTtlMs(qint64 responseCacheTtlMs);
+
+        //! Return true if change feed is enabled.
+        bool getChangeFeedEnabled() const;
+
+        //! Set whether change feed is enabled.
+        void setChangeFeedEnabled(bool changeFeedEnabled);
+
+        //! Return maximum time a change feed request waits for changes.
+        qint64 getChangeFeedMaxWaitMs() const;
+
+        //! Set maximum time a change feed request waits for changes.
+        void setChangeFeedMaxWaitMs(qint64 changeFeedMaxWaitMs);
+
+        //! Return time in milliseconds within which new connection must send a request (0 = no limit).
+        qint64 getConnectionIdleTimeoutMs() const;
+
+        //! Set time in milliseconds within which new connection must send a request.
+        void setConnectionIdleTimeoutMs(qint64 connectionIdleTimeoutMs);
+
+        //! Return time in milliseconds for which kept-alive connection may wait for next request (0 = no limit).
+        qint64 getKeepAliveTimeoutMs() const;
+
+        //! Set time in milliseconds for which kept-alive connection may wait for next request.
+        void setKeepAliveTimeoutMs(qint64 keepAliveTimeoutMs);
+
+        //! Return time in milliseconds within which request head must be received (0 = no limit).
+        qint64 getHeaderReadTimeoutMs() const;
+
+        //! Set time in milliseconds within which request head must be received.
+        void setHeaderReadTimeoutMs(qint64 headerReadTimeoutMs);
+
+        //! Return time in milliseconds for which request body may stop arriving (0 = no limit).
+        qint64 getBodyReadTimeoutMs() const;
+
+        //! Set time in milliseconds for which request body may stop arriving.
+        void setBodyReadTimeoutMs(qint64 bodyReadTimeoutMs);
+
+        //! Return maximum number of connections per server instance (0 = unlimited).
+        uint getMaxConnections() const;
+
+        //! Set maximum number of connections per server instance.
+        void setMaxConnections(uint maxConnections);
+
         //! Validate settings and return true if valid.
         bool validate(QString *errorMessage = nullptr) const;
 
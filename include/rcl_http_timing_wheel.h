@@ -0,0 +1,84 @@
+#ifndef RCL_HTTP_TIMING_WHEEL_H
+#define RCL_HTTP_TIMING_WHEEL_H
+
+#include <QList>
+#include <QUuid>
+#include <QVector>
+
+//! Hierarchical timing wheel for handler deadlines.
+//!
+//! Deadlines are expressed on a monotonic clock in milliseconds and rounded
+//! up to the wheel resolution. Scheduling is O(1) and advancing the wheel
+//! only touches due slots, so the cost does not depend on the number of
+//! pending entries. Entries are never cancelled; whoever consumes expired
+//! IDs must ignore those which were already completed.
+//! The wheel is not thread safe.
+class RHttpTimingWheel
+{
+
+    public:
+
+        //! Number of bits per wheel level.
+        static constexpr uint levelBits = 6;
+        //! Number of slots per wheel level.
+        static constexpr uint levelSize = 1u << levelBits;
+        //! Number of wheel levels.
+        static constexpr uint nLevels = 4;
+
+    private:
+
+        struct Entry
+        {
+            //! Entry ID.
+            QUuid id;
+            //! Expiry tick.
+            qint64 expiryTick;
+        };
+
+        //! Resolution (duration of a tick) in milliseconds.
+        qint64 resolutionMs;
+        //! Time of tick zero.
+        qint64 startTime;
+        //! Current tick.
+        qint64 currentTick;
+        //! Number of scheduled entries.
+        int nEntries;
+        //! Wheel slots (level-major).
+        QVector<QList<Entry>> slots;
+        //! Entries which were due on scheduling.
+        QList<QUuid> dueIds;
+
+    public:
+
+        //! Constructor.
+        RHttpTimingWheel(qint64 resolutionMs, qint64 startTime);
+
+        //! Return resolution in milliseconds.
+        qint64 getResolutionMs() const;
+
+        //! Schedule ID to expire at given time.
+        void schedule(const QUuid &id, qint64 deadline);
+
+        //! Advance wheel to given time and return expired IDs.
+        QList<QUuid> advance(qint64 now);
+
+        //! Return number of scheduled entries.
+        int size() const;
+
+        //! Return true if there are no scheduled entries.
+        bool isEmpty() const;
+
+    private:
+
+        //! Insert entry into appropriate slot.
+        void insert(const Entry &entry);
+
+        //! Move entries from given slot to lower levels.
+        void cascade(uint level);
+
+        //! Return slot for given level and tick.
+        QList<Entry> &slot(uint level, qint64 tick);
+
+};
+
+#endif // RCL_HTTP_TIMING_WHEEL_H
@@ -0,0 +1,77 @@
+#ifndef RCL_HTTP_TLS_METRICS_H
+#define RCL_HTTP_TLS_METRICS_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <atomic>
+
+#include "rcl_http_latency_histogram.h"
+
+//! TLS handshake metrics of the HTTP server.
+class RHttpTlsMetrics
+{
+
+    public:
+
+        enum Result
+        {
+            //! Full handshake.
+            Full = 0,
+            //! Abbreviated handshake resuming earlier session.
+            Resumed,
+            //! Completed handshake, TLS backend cannot tell whether session was resumed.
+            Unknown,
+            //! Handshake failed.
+            Failed,
+            nResults
+        };
+
+    protected:
+
+        //! Number of handshakes by result.
+        std::atomic<quint64> nHandshakes[nResults];
+        //! Duration of completed handshakes in microseconds.
+        RHttpLatencyHistogram latency;
+        //! Number of session ticket key rotations.
+        std::atomic<quint64> nKeyRotations;
+
+    public:
+
+        //! Constructor.
+        RHttpTlsMetrics();
+
+        RHttpTlsMetrics(const RHttpTlsMetrics &) = delete;
+        RHttpTlsMetrics &operator=(const RHttpTlsMetrics &) = delete;
+
+        //! Record handshake with given result and duration in microseconds (ignored for failed handshakes).
+        void recordHandshake(Result result, qint64 duration);
+
+        //! Record rotation of session ticket keys.
+        void recordKeyRotation();
+
+        //! Return number of handshakes with given result.
+        quint64 getHandshakeCount(Result result) const;
+
+        //! Return number of session ticket key rotations.
+        quint64 getKeyRotationCount() const;
+
+        //! Return fraction of completed handshakes known to resume a session.
+        double getResumptionRatio() const;
+
+        //! Return handshake duration histogram.
+        const RHttpLatencyHistogram &getLatency() const;
+
+        //! Export metrics in Prometheus text exposition format.
+        QByteArray toPrometheusText() const;
+
+        //! Export metrics as JSON.
+        QJsonObject toJson() const;
+
+        //! Return name of given result.
+        static QString resultToString(Result result);
+
+};
+
+#endif // RCL_HTTP_TLS_METRICS_H
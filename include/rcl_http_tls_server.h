@@ -0,0 +1,53 @@
+#ifndef RCL_HTTP_TLS_SERVER_H
+#define RCL_HTTP_TLS_SERVER_H
+
+#include <QSslServer>
+#include <QSslSocket>
+
+#include "rcl_http_tls_metrics.h"
+#include "rcl_http_tls_ticket_key_store.h"
+
+//! TLS server whose connections share session ticket keys.
+//! Qt builds new TLS context for every accepted socket, so tickets issued on one connection
+//! could not resume session on another one. Handshake is therefore started as soon as the
+//! connection is accepted (before the client hello is read) and the ticket keys of the
+//! store are installed into the context of the socket (OpenSSL 3 TLS backend only).
+//! Signals are those of QSslServer, startedEncryptionHandshake() is emitted once the
+//! handshake has been started.
+class RHttpTlsServer : public QSslServer
+{
+
+    Q_OBJECT
+
+    protected:
+
+        //! Session ticket key store (nullptr if session tickets are disabled).
+        RHttpTlsTicketKeyStore *pTicketKeyStore;
+        //! TLS metrics receiving key rotations.
+        RHttpTlsMetrics *pTlsMetrics;
+
+    public:
+
+        //! Session ID context of sessions issued by the server.
+        static const QByteArray sessionIdContext;
+
+        //! Constructor.
+        explicit RHttpTlsServer(RHttpTlsTicketKeyStore *pTicketKeyStore, RHttpTlsMetrics *pTlsMetrics, QObject *parent = nullptr);
+
+        //! Return session ticket key store (nullptr if session tickets are disabled).
+        RHttpTlsTicketKeyStore *getTicketKeyStore() const;
+
+        //! Return TLS metrics.
+        RHttpTlsMetrics *getTlsMetrics() const;
+
+    protected:
+
+        //! Accept connection and start its handshake.
+        void incomingConnection(qintptr socketDescriptor) override;
+
+        //! Install session ticket keys into TLS context of given socket.
+        void installTicketKeys(QSslSocket *pSocket);
+
+};
+
+#endif // RCL_HTTP_TLS_SERVER_H
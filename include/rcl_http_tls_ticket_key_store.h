@@ -0,0 +1,71 @@
+#ifndef RCL_HTTP_TLS_TICKET_KEY_STORE_H
+#define RCL_HTTP_TLS_TICKET_KEY_STORE_H
+
+#include <QByteArray>
+#include <QMutex>
+
+//! Keys protecting TLS session tickets, shared by all connections of the server.
+//! Ticket issued on one connection (or by another server instance sharing the context)
+//! resumes the session on any other one. Keys are rotated after given period, tickets
+//! protected by the previous key are accepted for one more period and renewed.
+class RHttpTlsTicketKeyStore
+{
+
+    public:
+
+        //! Size of key name in bytes.
+        static constexpr qsizetype nameSize = 16;
+        //! Size of encryption and HMAC secrets in bytes.
+        static constexpr qsizetype secretSize = 32;
+
+        struct Key
+        {
+            //! Name sent in clear within the ticket.
+            QByteArray name;
+            //! AES-256 encryption secret.
+            QByteArray encryptionSecret;
+            //! HMAC-SHA256 secret.
+            QByteArray macSecret;
+            //! Creation time in milliseconds.
+            qint64 createTime;
+        };
+
+    protected:
+
+        //! Rotation period in milliseconds (0 = never).
+        qint64 rotationMs;
+        //! Key protecting new tickets.
+        Key currentKey;
+        //! Key replaced by the last rotation (empty name if none).
+        Key previousKey;
+        //! Mutex.
+        mutable QMutex mutex;
+
+        //! Generate new random key.
+        static Key generateKey(qint64 currentTime);
+
+    public:
+
+        //! Constructor.
+        explicit RHttpTlsTicketKeyStore(qint64 rotationMs, qint64 currentTime);
+
+        RHttpTlsTicketKeyStore(const RHttpTlsTicketKeyStore &) = delete;
+        RHttpTlsTicketKeyStore &operator=(const RHttpTlsTicketKeyStore &) = delete;
+
+        //! Rotate keys if the current key is older than rotation period.
+        //! Return true if keys were rotated.
+        bool rotateIfDue(qint64 currentTime);
+
+        //! Rotate keys.
+        void rotate(qint64 currentTime);
+
+        //! Return key protecting new tickets.
+        Key getCurrentKey() const;
+
+        //! Find key with given name.
+        //! Return false if no such key is held, ticket must then be ignored.
+        bool findKey(const QByteArray &name, Key &key, bool *isCurrent = nullptr) const;
+
+};
+
+#endif // RCL_HTTP_TLS_TICKET_KEY_STORE_H
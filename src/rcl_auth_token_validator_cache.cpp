@@ -0,0 +1,215 @@
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_auth_token_validator_cache.h"
+
+RAuthTokenValidatorCache::RAuthTokenValidatorCache(RAuthTokenValidator *pValidator,
+                                                   qsizetype maxEntries,
+                                                   qint64 ttlMs,
+                                                   qint64 negativeTtlMs,
+                                                   QObject *parent)
+    : RAuthTokenValidator{parent}
+    , pValidator{pValidator}
+    , ttlMs{ttlMs}
+    , negativeTtlMs{negativeTtlMs}
+    , validCache{maxEntries}
+    , invalidCache{maxEntries}
+    , generation{0}
+    , nHits{0}
+    , nMisses{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RAuthTokenValidator *RAuthTokenValidatorCache::getValidator() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->pValidator;
+}
+
+void RAuthTokenValidatorCache::setValidator(RAuthTokenValidator *pValidator)
+{
+    R_LOG_TRACE_IN;
+    QMutexLocker locker(&this->mutex);
+    this->pValidator = pValidator;
+    this->generation++;
+    this->validCache.clear();
+    this->invalidCache.clear();
+    R_LOG_TRACE_OUT;
+}
+
+bool RAuthTokenValidatorCache::validate(const QString &resourceName, const QString &token)
+{
+    qint64 validityDate = 0;
+    return this->validateWithValidityDate(resourceName,token,validityDate);
+}
+
+bool RAuthTokenValidatorCache::validateWithValidityDate(const QString &resourceName, const QString &token, qint64 &validityDate)
+{
+    R_LOG_TRACE_IN;
+    validityDate = 0;
+    const QString key = RAuthTokenValidatorCache::buildKey(resourceName,token);
+    const qint64 now = this->currentTime();
+
+    RAuthTokenValidator *pValidator = nullptr;
+    quint64 generation = 0;
+    {
+        QMutexLocker locker(&this->mutex);
+        if (Entry *pEntry = this->validCache.object(key))
+        {
+            if (pEntry->expiryTime > now)
+            {
+                this->nHits.fetch_add(1,std::memory_order_relaxed);
+                R_LOG_TRACE_RETURN(true);
+            }
+            this->validCache.remove(key);
+        }
+        if (Entry *pEntry = this->invalidCache.object(key))
+        {
+            if (pEntry->expiryTime > now)
+            {
+                this->nHits.fetch_add(1,std::memory_order_relaxed);
+                R_LOG_TRACE_RETURN(false);
+            }
+            this->invalidCache.remove(key);
+        }
+        pValidator = this->pValidator;
+        generation = this->generation;
+    }
+
+    this->nMisses.fetch_add(1,std::memory_order_relaxed);
+    if (!pValidator)
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    // Validator is called without holding the lock, concurrent misses of the same key
+    // may both reach the validator which is harmless.
+    const bool isValid = pValidator->validateWithValidityDate(resourceName,token,validityDate);
+
+    QMutexLocker locker(&this->mutex);
+    if (generation != this->generation)
+    {
+        // Token may have been revoked or validator replaced in the meantime, do not cache the result.
+        R_LOG_TRACE_RETURN(isValid);
+    }
+    if (isValid)
+    {
+        qint64 expiryTime = now + this->ttlMs;
+        if (validityDate > 0)
+        {
+            expiryTime = qMin(expiryTime,validityDate * 1000);
+        }
+        if (expiryTime > now)
+        {
+            this->invalidCache.remove(key);
+            this->validCache.insert(key,new Entry{expiryTime});
+        }
+    }
+    else if (this->negativeTtlMs > 0)
+    {
+        this->validCache.remove(key);
+        this->invalidCache.insert(key,new Entry{now + this->negativeTtlMs});
+    }
+    R_LOG_TRACE_RETURN(isValid);
+}
+
+void RAuthTokenValidatorCache::invalidate(const QString &resourceName, const QString &token)
+{
+    R_LOG_TRACE_IN;
+    const QString key = RAuthTokenValidatorCache::buildKey(resourceName,token);
+    QMutexLocker locker(&this->mutex);
+    this->generation++;
+    this->validCache.remove(key);
+    this->invalidCache.remove(key);
+    R_LOG_TRACE_OUT;
+}
+
+void RAuthTokenValidatorCache::invalidateResource(const QString &resourceName)
+{
+    R_LOG_TRACE_IN;
+    const QString prefix = RAuthTokenValidatorCache::buildKey(resourceName,QString());
+    QMutexLocker locker(&this->mutex);
+    this->generation++;
+    const QList<QString> validKeys = this->validCache.keys();
+    for (const QString &key : validKeys)
+    {
+        if (key.startsWith(prefix))
+        {
+            this->validCache.remove(key);
+        }
+    }
+    const QList<QString> invalidKeys = this->invalidCache.keys();
+    for (const QString &key : invalidKeys)
+    {
+        if (key.startsWith(prefix))
+        {
+            this->invalidCache.remove(key);
+        }
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RAuthTokenValidatorCache::clear()
+{
+    R_LOG_TRACE_IN;
+    QMutexLocker locker(&this->mutex);
+    this->generation++;
+    this->validCache.clear();
+    this->invalidCache.clear();
+    R_LOG_TRACE_OUT;
+}
+
+qsizetype RAuthTokenValidatorCache::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->validCache.size() + this->invalidCache.size();
+}
+
+quint64 RAuthTokenValidatorCache::getHitCount() const
+{
+    return this->nHits.load(std::memory_order_relaxed);
+}
+
+quint64 RAuthTokenValidatorCache::getMissCount() const
+{
+    return this->nMisses.load(std::memory_order_relaxed);
+}
+
+QJsonObject RAuthTokenValidatorCache::toJson() const
+{
+    QJsonObject json;
+    json["hits"] = qint64(this->getHitCount());
+    json["misses"] = qint64(this->getMissCount());
+    json["size"] = qint64(this->size());
+    return json;
+}
+
+QByteArray RAuthTokenValidatorCache::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_auth_cache_hits_total Number of token validations answered from cache.\n";
+    text += "# TYPE range_cloud_auth_cache_hits_total counter\n";
+    text += "range_cloud_auth_cache_hits_total " + QByteArray::number(this->getHitCount()) + "\n";
+    text += "# HELP range_cloud_auth_cache_misses_total Number of token validations passed to the validator.\n";
+    text += "# TYPE range_cloud_auth_cache_misses_total counter\n";
+    text += "range_cloud_auth_cache_misses_total " + QByteArray::number(this->getMissCount()) + "\n";
+    text += "# HELP range_cloud_auth_cache_entries Number of cached token validation results.\n";
+    text += "# TYPE range_cloud_auth_cache_entries gauge\n";
+    text += "range_cloud_auth_cache_entries " + QByteArray::number(this->size()) + "\n";
+    return text;
+}
+
+qint64 RAuthTokenValidatorCache::currentTime() const
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+QString RAuthTokenValidatorCache::buildKey(const QString &resourceName, const QString &token)
+{
+    // Resource names cannot contain new line.
+    return resourceName + QChar('\n') + token;
+}
@@ -1,3 +1,6 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+
 #include "rcl_cloud_action.h"
 
 const QString RCloudAction::Auth::User::key = "auth-user";
@@ -15,6 +18,18 @@ const QString RCloudAction::Resource::Name::description = "Resource name";
 const QString RCloudAction::Resource::Path::key = "resource-path";
 const QString RCloudAction::Resource::Path::description = "Resource path";
 
+const QString RCloudAction::Resource::Range::key = "resource-range";
+const QString RCloudAction::Resource::Range::description = "Requested byte range of the resource";
+
+const QString RCloudAction::Resource::IfRange::key = "resource-if-range";
+const QString RCloudAction::Resource::IfRange::description = "Validator which must match for the byte range to apply";
+
+const QString RCloudAction::Resource::IfNoneMatch::key = "resource-if-none-match";
+const QString RCloudAction::Resource::IfNoneMatch::description = "Validators of representations held by the client (body may be omitted if one matches)";
+
+const QString RCloudAction::Server::Metrics::key = "server-metrics";
+const QString RCloudAction::Server::Metrics::description = "Request metrics of the HTTP server (JSON)";
+
 const QString RCloudAction::Action::key = "action";
 
 const QString RCloudAction::Action::Test::key = "test-request";
@@ -125,6 +140,12 @@ const QString RCloudAction::Action::SubmitReport::description = "Submit report t
 const QString RCloudAction::Action::Query::key = "query";
 const QString RCloudAction::Action::Query::description = "Send a query to the cloud server";
 
+const QString RCloudAction::Action::Batch::key = "batch";
+const QString RCloudAction::Action::Batch::description = "Perform several actions in one request";
+
+const QString RCloudAction::Action::FileChanges::key = "file-changes";
+const QString RCloudAction::Action::FileChanges::description = "Wait for changes of files on the cloud server";
+
 void RCloudAction::_init(const RCloudAction *pCAction)
 {
     if (pCAction)
@@ -142,6 +163,7 @@ void RCloudAction::_init(const RCloudAction *pCAction)
 
 RCloudAction::RCloudAction()
     : id(QUuid::createUuid())
+    , errorType{RError::None}
 {
 
 }
@@ -230,6 +252,103 @@ void RCloudAction::setErrorType(RError::Type errorType)
     this->errorType = errorType;
 }
 
+RCloudAction RCloudAction::fromJson(const QJsonObject &json)
+{
+    RCloudAction action;
+
+    if (const QJsonValue &v = json["id"]; v.isString())
+    {
+        action.id = QUuid(v.toString());
+    }
+    if (const QJsonValue &v = json[RCloudAction::Action::key]; v.isString())
+    {
+        action.action = v.toString();
+    }
+    if (const QJsonValue &v = json[RCloudAction::Resource::Name::key]; v.isString())
+    {
+        action.resourceName = v.toString();
+    }
+    if (const QJsonValue &v = json[RCloudAction::Resource::Id::key]; v.isString())
+    {
+        action.resourceId = QUuid(v.toString());
+    }
+    if (const QJsonValue &v = json["data"]; v.isString())
+    {
+        action.data = QByteArray::fromBase64(v.toString().toLatin1());
+    }
+    if (const QJsonValue &v = json["error-type"]; v.isDouble())
+    {
+        action.errorType = RError::Type(v.toInt());
+    }
+
+    return action;
+}
+
+QJsonObject RCloudAction::toJson() const
+{
+    QJsonObject json;
+
+    json["id"] = this->id.toString(QUuid::WithoutBraces);
+    json[RCloudAction::Action::key] = this->action;
+    if (!this->resourceName.isEmpty())
+    {
+        json[RCloudAction::Resource::Name::key] = this->resourceName;
+    }
+    if (!this->resourceId.isNull())
+    {
+        json[RCloudAction::Resource::Id::key] = this->resourceId.toString(QUuid::WithoutBraces);
+    }
+    if (!this->data.isEmpty())
+    {
+        json["data"] = QString::fromLatin1(this->data.toBase64());
+    }
+    json["error-type"] = int(this->errorType);
+
+    return json;
+}
+
+QByteArray RCloudAction::batchToJson(const QList<RCloudAction> &actions)
+{
+    QJsonArray jsonArray;
+    for (const RCloudAction &action : actions)
+    {
+        jsonArray.append(action.toJson());
+    }
+    return QJsonDocument(jsonArray).toJson(QJsonDocument::Compact);
+}
+
+QList<RCloudAction> RCloudAction::batchFromJson(const QByteArray &data, bool *ok)
+{
+    QList<RCloudAction> actions;
+
+    QJsonParseError parseError;
+    const QJsonDocument jsonDocument = QJsonDocument::fromJson(data,&parseError);
+    bool isValid = (parseError.error == QJsonParseError::NoError && jsonDocument.isArray());
+    if (isValid)
+    {
+        const QJsonArray jsonArray = jsonDocument.array();
+        for (const QJsonValue &value : jsonArray)
+        {
+            if (!value.isObject())
+            {
+                isValid = false;
+                break;
+            }
+            actions.append(RCloudAction::fromJson(value.toObject()));
+        }
+    }
+    if (ok)
+    {
+        *ok = isValid;
+    }
+    if (!isValid)
+    {
+        actions.clear();
+    }
+
+    return actions;
+}
+
 QMap<QString, QString> RCloudAction::getActionMap()
 {
     QMap<QString,QString> actionMap;
@@ -270,6 +389,111 @@ QMap<QString, QString> RCloudAction::getActionMap()
     actionMap.insert(Action::ProcessUpdateAccessMode::key,Action::ProcessUpdateAccessMode::description);
     actionMap.insert(Action::SubmitReport::key,Action::SubmitReport::description);
     actionMap.insert(Action::Query::key,Action::Query::description);
+    actionMap.insert(Action::Batch::key,Action::Batch::description);
+    actionMap.insert(Action::FileChanges::key,Action::FileChanges::description);
 
     return actionMap;
 }
+
+bool RCloudAction::isMutatingAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Mutating;
+}
+
+bool RCloudAction::isFileChangingAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & FileChanging;
+}
+
+bool RCloudAction::isConditionalAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Conditional;
+}
+
+bool RCloudAction::isCacheableAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Cacheable;
+}
+
+bool RCloudAction::isBatchableAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Batchable;
+}
+
+bool RCloudAction::isBulkAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Bulk;
+}
+
+bool RCloudAction::isAdminAction(const QString &actionKey)
+{
+    return RCloudAction::getActionProperties().value(actionKey,0) & Admin;
+}
+
+QList<QString> RCloudAction::findAffectedActions(const QString &mutatingActionKey)
+{
+    const QHash<QString,int> &actionProperties = RCloudAction::getActionProperties();
+    const int changedData = actionProperties.value(mutatingActionKey,0) & (UserData | GroupData | ActionData | ProcessData);
+
+    QList<QString> affectedActions;
+    if (!(actionProperties.value(mutatingActionKey,0) & Mutating) || changedData == 0)
+    {
+        return affectedActions;
+    }
+    for (QHash<QString,int>::const_iterator iter = actionProperties.cbegin(); iter != actionProperties.cend(); ++iter)
+    {
+        if ((iter.value() & Cacheable) && (iter.value() & changedData))
+        {
+            affectedActions.append(iter.key());
+        }
+    }
+    return affectedActions;
+}
+
+const QHash<QString,int> &RCloudAction::getActionProperties()
+{
+    // Built on first use, so that it is available to static objects of other translation units.
+    static const QHash<QString,int> actionProperties = {
+        {Action::Test::key,                     Batchable},
+        {Action::ListFiles::key,                Conditional | Batchable},
+        {Action::FileInfo::key,                 Batchable},
+        {Action::FileUpload::key,               Mutating | FileChanging | Bulk},
+        {Action::FileReplace::key,              Mutating | FileChanging | Bulk},
+        {Action::FileUpdate::key,               Mutating | FileChanging},
+        {Action::FileUpdateAccessOwner::key,    Mutating | FileChanging | Batchable},
+        {Action::FileUpdateAccessMode::key,     Mutating | FileChanging | Batchable},
+        {Action::FileUpdateVersion::key,        Mutating | FileChanging | Batchable},
+        {Action::FileUpdateTags::key,           Mutating | FileChanging | Batchable},
+        {Action::FileDownload::key,             Conditional | Bulk},
+        {Action::FileRemove::key,               Mutating | FileChanging | Batchable},
+        {Action::Stop::key,                     Admin},
+        {Action::Statistics::key,               Admin},
+        {Action::Process::key,                  Mutating | Admin | Batchable},
+        // Users are members of groups.
+        {Action::ListUsers::key,                Conditional | Cacheable | Batchable | UserData | GroupData},
+        {Action::UserInfo::key,                 Cacheable | Batchable | UserData | GroupData},
+        {Action::UserAdd::key,                  Mutating | Admin | Batchable | UserData},
+        {Action::UserUpdate::key,               Mutating | Admin | Batchable | UserData},
+        {Action::UserRemove::key,               Mutating | Admin | Batchable | UserData},
+        {Action::UserRegister::key,             Mutating | Admin | Batchable | UserData},
+        {Action::ListUserTokens::key,           Conditional | Batchable},
+        {Action::UserTokenGenerate::key,        Mutating | Admin | Batchable},
+        {Action::UserTokenRemove::key,          Mutating | Admin | Batchable},
+        {Action::ListGroups::key,               Conditional | Cacheable | Batchable | GroupData | UserData},
+        {Action::GroupInfo::key,                Cacheable | Batchable | GroupData | UserData},
+        {Action::GroupAdd::key,                 Mutating | Admin | Batchable | GroupData},
+        {Action::GroupRemove::key,              Mutating | Admin | Batchable | GroupData},
+        {Action::ListActions::key,              Conditional | Cacheable | Batchable | ActionData},
+        {Action::ActionUpdateAccessOwner::key,  Mutating | Admin | Batchable | ActionData},
+        {Action::ActionUpdateAccessMode::key,   Mutating | Admin | Batchable | ActionData},
+        {Action::ListProcesses::key,            Conditional | Cacheable | Batchable | ProcessData},
+        {Action::ProcessUpdateAccessOwner::key, Mutating | Admin | Batchable | ProcessData},
+        {Action::ProcessUpdateAccessMode::key,  Mutating | Admin | Batchable | ProcessData},
+        {Action::SubmitReport::key,             Mutating | Bulk | Batchable},
+        {Action::Query::key,                    Batchable},
+        // Batch may contain any of the above except transfers of large bodies.
+        {Action::Batch::key,                    Mutating | FileChanging | UserData | GroupData | ActionData | ProcessData},
+        {Action::FileChanges::key,              0}
+    };
+    return actionProperties;
+}
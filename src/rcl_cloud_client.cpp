@@ -18,6 +18,7 @@ RCloudClient::RCloudClient(RHttpClient::Type type, const RHttpClientSettings &ht
     , type{type}
     , httpClientSettings{httpClientSettings}
     , blocking{true}
+    , pValidatorCache{std::make_shared<RHttpClientValidatorCache>()}
 {
     R_LOG_TRACE_IN;
     R_LOG_TRACE_OUT;
@@ -33,7 +34,7 @@ void RCloudClient::setBlocking(bool blocking)
 RToolTask *RCloudClient::requestTest(const QString &responseMessage, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestTest(new RHttpClient(this->type,this->httpClientSettings,this),responseMessage,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestTest(this->createHttpClient(),responseMessage,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestCsrProcess(const QByteArray &csrBase64, const QString &authUser, const QString &authToken)
@@ -65,187 +66,207 @@ RToolTask *RCloudClient::requestReportProcess(const QByteArray &reportBase64, co
 RToolTask *RCloudClient::requestProcess(const RCloudProcessRequest &processRequest, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcess(new RHttpClient(this->type,this->httpClientSettings,this),processRequest,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcess(this->createHttpClient(),processRequest,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListFiles(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListFiles(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListFiles(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpload(const QString &filePath, const QString &name, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpload(new RHttpClient(this->type,this->httpClientSettings,this),filePath,name,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpload(this->createHttpClient(),filePath,name,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileReplace(const QString &filePath, const QString &name, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileReplace(new RHttpClient(this->type,this->httpClientSettings,this),filePath,name,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileReplace(this->createHttpClient(),filePath,name,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpdate(const QString &filePath, const QString &name, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdate(new RHttpClient(this->type,this->httpClientSettings,this),filePath,name,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdate(this->createHttpClient(),filePath,name,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpdateAccessOwner(const RAccessOwner &accessOwner, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateAccessOwner(new RHttpClient(this->type,this->httpClientSettings,this),accessOwner,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateAccessOwner(this->createHttpClient(),accessOwner,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpdateAccessMode(const RAccessMode &accessMode, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateAccessMode(new RHttpClient(this->type,this->httpClientSettings,this),accessMode,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateAccessMode(this->createHttpClient(),accessMode,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpdateVersion(const RVersion &version, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateVersion(new RHttpClient(this->type,this->httpClientSettings,this),version,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateVersion(this->createHttpClient(),version,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileUpdateTags(const QStringList &tags, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateTags(new RHttpClient(this->type,this->httpClientSettings,this),tags,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileUpdateTags(this->createHttpClient(),tags,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileDownload(const QString &filePath, const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileDownload(new RHttpClient(this->type,this->httpClientSettings,this),filePath,id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileDownload(this->createHttpClient(),filePath,id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestFileRemove(const QUuid &fileId, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileRemove(new RHttpClient(this->type,this->httpClientSettings,this),fileId,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileRemove(this->createHttpClient(),fileId,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListUsers(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListUsers(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListUsers(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserAdd(const QString &userName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserAdd(new RHttpClient(this->type,this->httpClientSettings,this),userName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserAdd(this->createHttpClient(),userName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserUpdate(const QString &userName, const RUserInfo &userInfo, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserUpdate(new RHttpClient(this->type,this->httpClientSettings,this),userName,userInfo,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserUpdate(this->createHttpClient(),userName,userInfo,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserRemove(const QString &userName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserRemove(new RHttpClient(this->type,this->httpClientSettings,this),userName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserRemove(this->createHttpClient(),userName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserRegister(const QString &userName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserRegister(new RHttpClient(this->type,this->httpClientSettings,this),userName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserRegister(this->createHttpClient(),userName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListUserTokens(const QString &userName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListUserTokens(new RHttpClient(this->type,this->httpClientSettings,this),userName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListUserTokens(this->createHttpClient(),userName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserTokenGenerate(const QString &userName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserTokenGenerate(new RHttpClient(this->type,this->httpClientSettings,this),userName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserTokenGenerate(this->createHttpClient(),userName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestUserTokenRemove(const QUuid &id, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserTokenRemove(new RHttpClient(this->type,this->httpClientSettings,this),id,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestUserTokenRemove(this->createHttpClient(),id,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListGroups(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListGroups(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListGroups(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestGroupAdd(const QString &groupName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestGroupAdd(new RHttpClient(this->type,this->httpClientSettings,this),groupName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestGroupAdd(this->createHttpClient(),groupName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestGroupRemove(const QString &groupName, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestGroupRemove(new RHttpClient(this->type,this->httpClientSettings,this),groupName,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestGroupRemove(this->createHttpClient(),groupName,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListActions(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListActions(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListActions(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestActionUpdateAccessOwner(const QString &actionName, const RAccessOwner &accessOwner, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestActionUpdateAccessOwner(new RHttpClient(this->type,this->httpClientSettings,this),actionName,accessOwner,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestActionUpdateAccessOwner(this->createHttpClient(),actionName,accessOwner,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestActionUpdateAccessMode(const QString &actionName, const RAccessMode &accessMode, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestActionUpdateAccessMode(new RHttpClient(this->type,this->httpClientSettings,this),actionName,accessMode,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestActionUpdateAccessMode(this->createHttpClient(),actionName,accessMode,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestStatistics(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestStatistics(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestStatistics(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestListProcesses(const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListProcesses(new RHttpClient(this->type,this->httpClientSettings,this),authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestListProcesses(this->createHttpClient(),authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestProcessUpdateAccessOwner(const QString &processName, const RAccessOwner &accessOwner, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcessUpdateAccessOwner(new RHttpClient(this->type,this->httpClientSettings,this),processName,accessOwner,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcessUpdateAccessOwner(this->createHttpClient(),processName,accessOwner,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestProcessUpdateAccessMode(const QString &processName, const RAccessMode &accessMode, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcessUpdateAccessMode(new RHttpClient(this->type,this->httpClientSettings,this),processName,accessMode,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestProcessUpdateAccessMode(this->createHttpClient(),processName,accessMode,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestSubmitReport(const RReportRecord &reportRecord, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestSubmitReport(new RHttpClient(this->type,this->httpClientSettings,this),reportRecord,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestSubmitReport(this->createHttpClient(),reportRecord,authUser,authToken)));
 }
 
 RToolTask *RCloudClient::requestQuery(const QString &query, const QString &authUser, const QString &authToken)
 {
     R_LOG_TRACE_IN;
-    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestQuery(new RHttpClient(this->type,this->httpClientSettings,this),query,authUser,authToken)));
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestQuery(this->createHttpClient(),query,authUser,authToken)));
+}
+
+RToolTask *RCloudClient::requestBatch(const QList<RCloudAction> &actions, const QString &authUser, const QString &authToken)
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestBatch(this->createHttpClient(),actions,authUser,authToken)));
+}
+
+RToolTask *RCloudClient::requestFileChanges(quint64 cursor, const QString &authUser, const QString &authToken)
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_RETURN(this->submitAction(RCloudToolAction::requestFileChanges(this->createHttpClient(),cursor,authUser,authToken)));
+}
+
+RHttpClient *RCloudClient::createHttpClient()
+{
+    R_LOG_TRACE_IN;
+    RHttpClient *pHttpClient = new RHttpClient(this->type,this->httpClientSettings,this);
+    pHttpClient->setValidatorCache(this->pValidatorCache);
+    R_LOG_TRACE_RETURN(pHttpClient);
 }
 
 RToolTask *RCloudClient::submitAction(const QSharedPointer<RCloudToolAction> &toolAction)
@@ -297,6 +318,14 @@ void RCloudClient::onActionFinished(const QSharedPointer<RToolAction> &action)
 
     RCloudToolAction::Type actionType = action.staticCast<RCloudToolAction>().data()->getType();
 
+    if (actionType == RCloudToolAction::FileChanges)
+    {
+        // Long-lasting wait is not one of the actions users of actionFinished() are counting.
+        emit this->fileChangesAvailable(RCloudToolAction::processFileChangesResponse(responseMessage.getBody()));
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
     switch (actionType)
     {
         case RCloudToolAction::Test:
@@ -475,6 +504,11 @@ void RCloudClient::onActionFinished(const QSharedPointer<RToolAction> &action)
             emit this->queryResultAvailable(RCloudToolAction::processQueryResponse(responseMessage.getBody()));
             break;
         }
+        case RCloudToolAction::Batch:
+        {
+            emit this->batchFinished(RCloudToolAction::processBatchResponse(responseMessage.getBody()));
+            break;
+        }
         case RCloudToolAction::Statistics:
         {
             emit this->statisticsAvailable(RCloudToolAction::processStatisticsResponse(responseMessage.getBody()));
@@ -501,7 +535,21 @@ void RCloudClient::onActionFailed(const QSharedPointer<RToolAction> &action)
 {
     R_LOG_TRACE_IN;
     RLogger::error("[%s] Requested cloud action has failed.\n", RCloudClient::logPrefix.toUtf8().constData());
+    if (action.staticCast<RCloudToolAction>().data()->getType() == RCloudToolAction::FileChanges)
+    {
+        emit this->fileChangesFailed(action->getErrorType(), action->getErrorMessage());
+        R_LOG_TRACE_OUT;
+        return;
+    }
     RHttpMessage responseMessage = action.staticCast<RCloudToolAction>().data()->getResponseMessage();
+    if (action.staticCast<RCloudToolAction>().data()->getType() == RCloudToolAction::Batch)
+    {
+        // Caller may fall back to sending the actions one by one.
+        emit this->batchFailed(action->getErrorType(), action->getErrorMessage(), responseMessage.getBody(),
+                               RCloudAction::batchFromJson(action.staticCast<RCloudToolAction>().data()->getRequestMessage().getBody()));
+        R_LOG_TRACE_OUT;
+        return;
+    }
     emit this->actionFailed(action->getErrorType(), action->getErrorMessage(), responseMessage.getBody());
     R_LOG_TRACE_OUT;
 }
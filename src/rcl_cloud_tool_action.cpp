@@ -129,6 +129,8 @@ void RCloudToolAction::perform()
         case ProcessUpdateAccessMode:
         case SubmitReport:
         case Query:
+        case Batch:
+        case FileChanges:
         {
             if (this->httpClient)
             {
@@ -750,3 +752,27 @@ QString RCloudToolAction::processQueryResponse(const QByteArray &data)
 {
     return data;
 }
+
+QSharedPointer<RCloudToolAction> RCloudToolAction::requestBatch(RHttpClient *httpClient, const QList<RCloudAction> &actions, const QString &authUser, const QString &authToken)
+{
+    RCloudToolAction *toolAction = new RCloudToolAction(Batch,httpClient);
+    toolAction->input.setValue<RCloudAction>(RCloudAction(QUuid::createUuid(),authUser,authToken,RCloudAction::Action::Batch::key,QString(),QUuid(),RCloudAction::batchToJson(actions)));
+    return QSharedPointer<RCloudToolAction>(toolAction);
+}
+
+QList<RCloudAction> RCloudToolAction::processBatchResponse(const QByteArray &data)
+{
+    return RCloudAction::batchFromJson(data);
+}
+
+QSharedPointer<RCloudToolAction> RCloudToolAction::requestFileChanges(RHttpClient *httpClient, quint64 cursor, const QString &authUser, const QString &authToken)
+{
+    RCloudToolAction *toolAction = new RCloudToolAction(FileChanges,httpClient);
+    toolAction->input.setValue<RCloudAction>(RCloudAction(QUuid::createUuid(),authUser,authToken,RCloudAction::Action::FileChanges::key,QString(),QUuid(),QByteArray::number(cursor)));
+    return QSharedPointer<RCloudToolAction>(toolAction);
+}
+
+RFileChangeSet RCloudToolAction::processFileChangesResponse(const QByteArray &data)
+{
+    return RFileChangeSet::fromJson(QJsonDocument::fromJson(data).object());
+}
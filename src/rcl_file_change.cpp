@@ -0,0 +1,123 @@
+#include "rcl_file_change.h"
+
+void RFileChange::_init(const RFileChange *pFileChange)
+{
+    if (pFileChange)
+    {
+        this->id = pFileChange->id;
+        this->path = pFileChange->path;
+        this->md5Checksum = pFileChange->md5Checksum;
+        this->operation = pFileChange->operation;
+    }
+}
+
+RFileChange::RFileChange()
+    : operation{RFileChange::Updated}
+{
+    this->_init();
+}
+
+RFileChange::RFileChange(const QUuid &id, const QString &path, const QByteArray &md5Checksum, Operation operation)
+    : id{id}
+    , path{path}
+    , md5Checksum{md5Checksum}
+    , operation{operation}
+{
+    this->_init();
+}
+
+RFileChange::RFileChange(const RFileChange &fileChange)
+{
+    this->_init(&fileChange);
+}
+
+RFileChange::~RFileChange()
+{
+
+}
+
+RFileChange &RFileChange::operator =(const RFileChange &fileChange)
+{
+    this->_init(&fileChange);
+    return (*this);
+}
+
+const QUuid &RFileChange::getId() const
+{
+    return this->id;
+}
+
+const QString &RFileChange::getPath() const
+{
+    return this->path;
+}
+
+const QByteArray &RFileChange::getMd5Checksum() const
+{
+    return this->md5Checksum;
+}
+
+RFileChange::Operation RFileChange::getOperation() const
+{
+    return this->operation;
+}
+
+RFileChange RFileChange::fromJson(const QJsonObject &json)
+{
+    RFileChange fileChange;
+
+    if (const QJsonValue &v = json["id"]; v.isString())
+    {
+        fileChange.id = QUuid(v.toString());
+    }
+    if (const QJsonValue &v = json["path"]; v.isString())
+    {
+        fileChange.path = v.toString();
+    }
+    if (const QJsonValue &v = json["md5Checksum"]; v.isString())
+    {
+        fileChange.md5Checksum = v.toString().toUtf8();
+    }
+    if (const QJsonValue &v = json["operation"]; v.isString())
+    {
+        fileChange.operation = RFileChange::operationFromString(v.toString());
+    }
+
+    return fileChange;
+}
+
+QJsonObject RFileChange::toJson() const
+{
+    QJsonObject json;
+
+    json["id"] = this->id.toString(QUuid::WithoutBraces);
+    json["path"] = this->path;
+    json["md5Checksum"] = QString(this->md5Checksum);
+    json["operation"] = RFileChange::operationToString(this->operation);
+
+    return json;
+}
+
+QString RFileChange::operationToString(Operation operation)
+{
+    switch (operation)
+    {
+        case RFileChange::Created: return "created";
+        case RFileChange::Removed: return "removed";
+        case RFileChange::Updated:
+        default:                   return "updated";
+    }
+}
+
+RFileChange::Operation RFileChange::operationFromString(const QString &operationName)
+{
+    if (operationName == "created")
+    {
+        return RFileChange::Created;
+    }
+    if (operationName == "removed")
+    {
+        return RFileChange::Removed;
+    }
+    return RFileChange::Updated;
+}
@@ -0,0 +1,100 @@
+#include <QJsonArray>
+
+#include "rcl_file_change_set.h"
+
+void RFileChangeSet::_init(const RFileChangeSet *pFileChangeSet)
+{
+    if (pFileChangeSet)
+    {
+        this->cursor = pFileChangeSet->cursor;
+        this->reset = pFileChangeSet->reset;
+        this->changes = pFileChangeSet->changes;
+    }
+}
+
+RFileChangeSet::RFileChangeSet()
+    : cursor{0}
+    , reset{false}
+{
+    this->_init();
+}
+
+RFileChangeSet::RFileChangeSet(quint64 cursor, bool reset, const QList<RFileChange> &changes)
+    : cursor{cursor}
+    , reset{reset}
+    , changes{changes}
+{
+    this->_init();
+}
+
+RFileChangeSet::RFileChangeSet(const RFileChangeSet &fileChangeSet)
+{
+    this->_init(&fileChangeSet);
+}
+
+RFileChangeSet::~RFileChangeSet()
+{
+
+}
+
+RFileChangeSet &RFileChangeSet::operator =(const RFileChangeSet &fileChangeSet)
+{
+    this->_init(&fileChangeSet);
+    return (*this);
+}
+
+quint64 RFileChangeSet::getCursor() const
+{
+    return this->cursor;
+}
+
+bool RFileChangeSet::getReset() const
+{
+    return this->reset;
+}
+
+const QList<RFileChange> &RFileChangeSet::getChanges() const
+{
+    return this->changes;
+}
+
+RFileChangeSet RFileChangeSet::fromJson(const QJsonObject &json)
+{
+    RFileChangeSet fileChangeSet;
+
+    // Cursor is sent as string, JSON numbers cannot hold all 64-bit values.
+    if (const QJsonValue &v = json["cursor"]; v.isString())
+    {
+        fileChangeSet.cursor = v.toString().toULongLong();
+    }
+    if (const QJsonValue &v = json["reset"]; v.isBool())
+    {
+        fileChangeSet.reset = v.toBool();
+    }
+    if (const QJsonValue &v = json["changes"]; v.isArray())
+    {
+        const QJsonArray jsonArray = v.toArray();
+        for (const QJsonValue &value : jsonArray)
+        {
+            fileChangeSet.changes.append(RFileChange::fromJson(value.toObject()));
+        }
+    }
+
+    return fileChangeSet;
+}
+
+QJsonObject RFileChangeSet::toJson() const
+{
+    QJsonObject json;
+
+    json["cursor"] = QString::number(this->cursor);
+    json["reset"] = this->reset;
+    QJsonArray jsonArray;
+    for (const RFileChange &fileChange : this->changes)
+    {
+        jsonArray.append(fileChange.toJson());
+    }
+    json["changes"] = jsonArray;
+
+    return json;
+}
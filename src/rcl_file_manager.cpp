@@ -4,6 +4,8 @@
 
 #include <QDir>
 
+#include <limits>
+
 #include "rcl_file_manager.h"
 
 const QString RFileManager::logPrefix = "LocalFileManager";
@@ -12,8 +14,13 @@ RFileManager::RFileManager(const RFileManagerSettings &fileManagerSettings, RClo
     : QObject{parent}
     , fileManagerSettings{fileManagerSettings}
     , cloudClient{cloudClient}
+    , remoteRefreshTimeout{0}
     , nRunningActions{0}
     , isRunning{false}
+    , changeCursor{0}
+    , isWaitingForChanges{false}
+    , isRemoteRefreshPending{false}
+    , isBatchSupported{true}
 {
     R_LOG_TRACE_IN;
     this->localFiles = RFileTools::listFiles(this->fileManagerSettings.getLocalDirectory());
@@ -42,6 +49,10 @@ RFileManager::RFileManager(const RFileManagerSettings &fileManagerSettings, RClo
     QObject::connect(this->cloudClient,&RCloudClient::fileReplaced,this,&RFileManager::onFileReplaced);
     QObject::connect(this->cloudClient,&RCloudClient::fileVersionUpdated,this,&RFileManager::onFileVersionUpdated);
     QObject::connect(this->cloudClient,&RCloudClient::fileTagsUpdated,this,&RFileManager::onFileTagsUpdated);
+    QObject::connect(this->cloudClient,&RCloudClient::batchFinished,this,&RFileManager::onBatchFinished);
+    QObject::connect(this->cloudClient,&RCloudClient::batchFailed,this,&RFileManager::onBatchFailed);
+    QObject::connect(this->cloudClient,&RCloudClient::fileChangesAvailable,this,&RFileManager::onFileChangesAvailable);
+    QObject::connect(this->cloudClient,&RCloudClient::fileChangesFailed,this,&RFileManager::onFileChangesFailed);
     QObject::connect(this->cloudClient,&RCloudClient::actionFinished,this,&RFileManager::onCloudActionFinished);
     QObject::connect(this->cloudClient,&RCloudClient::actionFailed,this,&RFileManager::onCloudActionFailed);
 
@@ -84,9 +95,13 @@ void RFileManager::start(uint remoteRefreshTimeout)
     RLogger::info("[%s] Start remote refresh timer with timeout %lu [ms]\n",
                   RFileManager::logPrefix.toUtf8().constData(),
                   remoteRefreshTimeout);
+    this->remoteRefreshTimeout = remoteRefreshTimeout;
     this->remoteRefreshTimer->start(remoteRefreshTimeout);
 
     this->isRunning = true;
+
+    // Once the server answers, remote files are listed only when they change.
+    this->requestFileChanges();
 }
 
 void RFileManager::stop()
@@ -445,12 +460,7 @@ void RFileManager::onFileUploaded(RFileInfo fileInfo)
     this->filesToSync.mutex.lock();
     this->filesToSync.pendingUploadPaths.remove(fileInfo.getPath());
     this->filesToSync.mutex.unlock();
-    // Request update version.
-    this->cloudClient->requestFileUpdateVersion(RFileManager::incrementVersion(RVersion()),fileInfo.getId());
-    this->nRunningActions++;
-    // Request update tags.
-    this->cloudClient->requestFileUpdateTags(this->fileManagerSettings.getFileTags(),fileInfo.getId());
-    this->nRunningActions++;
+    this->requestNewFileMetadata(fileInfo.getId());
     emit this->fileUploaded(fileInfo);
     R_LOG_TRACE_OUT;
 }
@@ -465,12 +475,7 @@ void RFileManager::onFileReplaced(std::tuple<RFileInfo, QList<RFileInfo> > fileI
     this->filesToSync.mutex.lock();
     this->filesToSync.pendingUploadPaths.remove(std::get<0>(fileInfoList).getPath());
     this->filesToSync.mutex.unlock();
-    // Request update version.
-    this->cloudClient->requestFileUpdateVersion(RFileManager::incrementVersion(RVersion()),std::get<0>(fileInfoList).getId());
-    this->nRunningActions++;
-    // Request update tags.
-    this->cloudClient->requestFileUpdateTags(this->fileManagerSettings.getFileTags(),std::get<0>(fileInfoList).getId());
-    this->nRunningActions++;
+    this->requestNewFileMetadata(std::get<0>(fileInfoList).getId());
     emit this->fileUploaded(std::get<0>(fileInfoList));
     R_LOG_TRACE_OUT;
 }
@@ -497,6 +502,171 @@ void RFileManager::onFileTagsUpdated(RFileInfo fileInfo)
     R_LOG_TRACE_OUT;
 }
 
+void RFileManager::onBatchFinished(QList<RCloudAction> results)
+{
+    R_LOG_TRACE_IN;
+    for (const RCloudAction &result : std::as_const(results))
+    {
+        if (result.getErrorType() != RError::None)
+        {
+            RLogger::warning("[%s] Batched action \"%s\" on file \"%s\" has failed. %s\n",
+                             RFileManager::logPrefix.toUtf8().constData(),
+                             result.getAction().toUtf8().constData(),
+                             result.getResourceId().toString(QUuid::WithoutBraces).toUtf8().constData(),
+                             result.getData().constData());
+            emit this->cloudError(result.getErrorType(),RError::getTypeMessage(result.getErrorType()),QString::fromUtf8(result.getData()));
+        }
+        else if (result.getAction() == RCloudAction::Action::FileUpdateVersion::key)
+        {
+            this->onFileVersionUpdated(RCloudToolAction::processFileUpdateVersionResponse(result.getData()));
+        }
+        else if (result.getAction() == RCloudAction::Action::FileUpdateTags::key)
+        {
+            this->onFileTagsUpdated(RCloudToolAction::processFileUpdateTagsResponse(result.getData()));
+        }
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::onBatchFailed(RError::Type errorType, const QString &errorMessage, const QString &message, QList<RCloudAction> actions)
+{
+    R_LOG_TRACE_IN;
+    if (errorType != RError::NotFound && errorType != RError::InvalidInput)
+    {
+        this->onCloudActionFailed(errorType,errorMessage,message);
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    // Server does not know the batch action, actions are sent one by one from now on.
+    RLogger::warning("[%s] Batch request was rejected (%s), sending actions separately.\n",
+                     RFileManager::logPrefix.toUtf8().constData(),
+                     RError::getTypeMessage(errorType).toUtf8().constData());
+    this->isBatchSupported = false;
+    for (const RCloudAction &action : std::as_const(actions))
+    {
+        if (action.getAction() == RCloudAction::Action::FileUpdateVersion::key)
+        {
+            this->requestNewFileMetadataSeparately(action.getResourceId());
+        }
+    }
+    // Batch request itself is done.
+    this->onCloudActionFinished();
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::requestNewFileMetadata(const QUuid &fileId)
+{
+    R_LOG_TRACE_IN;
+    if (!this->isBatchSupported)
+    {
+        this->requestNewFileMetadataSeparately(fileId);
+        R_LOG_TRACE_OUT;
+        return;
+    }
+    // Version and tags of a new file are set in one round trip.
+    QList<RCloudAction> actions;
+    actions.append(RCloudAction(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateVersion::key,QString(),fileId,RFileManager::incrementVersion(RVersion()).toString().toUtf8()));
+    actions.append(RCloudAction(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateTags::key,QString(),fileId,this->fileManagerSettings.getFileTags().join(',').toUtf8()));
+    this->cloudClient->requestBatch(actions);
+    this->nRunningActions++;
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::requestNewFileMetadataSeparately(const QUuid &fileId)
+{
+    R_LOG_TRACE_IN;
+    // Request update version.
+    this->cloudClient->requestFileUpdateVersion(RFileManager::incrementVersion(RVersion()),fileId);
+    this->nRunningActions++;
+    // Request update tags.
+    this->cloudClient->requestFileUpdateTags(this->fileManagerSettings.getFileTags(),fileId);
+    this->nRunningActions++;
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::requestFileChanges()
+{
+    R_LOG_TRACE_IN;
+    if (this->isWaitingForChanges)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+    try
+    {
+        this->cloudClient->requestFileChanges(this->changeCursor);
+        this->isWaitingForChanges = true;
+    }
+    catch (const RError &rError)
+    {
+        RLogger::error("[%s] Failed to request changes of cloud files. %s\n",
+                       RFileManager::logPrefix.toUtf8().constData(),
+                       rError.getMessage().toUtf8().constData());
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::onFileChangesAvailable(RFileChangeSet fileChangeSet)
+{
+    R_LOG_TRACE_IN;
+    this->isWaitingForChanges = false;
+    if (!this->isRunning)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+    const int backstopTimeout = int(qMin(quint64(this->remoteRefreshTimeout) * RFileManager::changeFeedRefreshFactor,quint64(std::numeric_limits<int>::max())));
+    if (this->remoteRefreshTimer->interval() != backstopTimeout)
+    {
+        RLogger::info("[%s] Server reports file changes, slow down remote refresh timer to %d [ms]\n",
+                      RFileManager::logPrefix.toUtf8().constData(),
+                      backstopTimeout);
+        this->remoteRefreshTimer->start(backstopTimeout);
+    }
+
+    this->changeCursor = fileChangeSet.getCursor();
+    if (fileChangeSet.getReset() || !fileChangeSet.getChanges().isEmpty())
+    {
+        RLogger::info("[%s] Remote files have changed (%lld changes%s).\n",
+                      RFileManager::logPrefix.toUtf8().constData(),
+                      qint64(fileChangeSet.getChanges().size()),
+                      fileChangeSet.getReset() ? ", full listing required" : "");
+        if (this->nRunningActions > 0)
+        {
+            // Files are listed once the running sync completes.
+            this->isRemoteRefreshPending = true;
+        }
+        else
+        {
+            // Listing is compared against the cache, the same way periodic refresh does.
+            this->onRemoteRefreshTimeout();
+        }
+    }
+
+    this->requestFileChanges();
+    R_LOG_TRACE_OUT;
+}
+
+void RFileManager::onFileChangesFailed(RError::Type errorType, const QString &errorMessage)
+{
+    R_LOG_TRACE_IN;
+    this->isWaitingForChanges = false;
+    RLogger::warning("[%s] Failed to wait for changes of cloud files (%s). %s\n",
+                     RFileManager::logPrefix.toUtf8().constData(),
+                     RError::getTypeMessage(errorType).toUtf8().constData(),
+                     errorMessage.toUtf8().constData());
+    if (this->isRunning && int(this->remoteRefreshTimeout) != this->remoteRefreshTimer->interval())
+    {
+        // Fall back to periodic refresh, which also retries the wait.
+        RLogger::info("[%s] Restart remote refresh timer with timeout %u [ms]\n",
+                      RFileManager::logPrefix.toUtf8().constData(),
+                      this->remoteRefreshTimeout);
+        this->remoteRefreshTimer->start(this->remoteRefreshTimeout);
+    }
+    R_LOG_TRACE_OUT;
+}
+
 void RFileManager::onCloudActionFinished()
 {
     R_LOG_TRACE_IN;
@@ -510,6 +680,11 @@ void RFileManager::onCloudActionFinished()
         this->filesToSync.pendingUploadPaths.clear();
         this->filesToSync.mutex.unlock();
         emit this->syncFilesCompleted();
+        if (this->isRemoteRefreshPending && this->isRunning)
+        {
+            this->isRemoteRefreshPending = false;
+            this->onRemoteRefreshTimeout();
+        }
     }
     R_LOG_TRACE_OUT;
 }
@@ -528,6 +703,11 @@ void RFileManager::onCloudActionFailed(RError::Type errorType, const QString &er
         this->filesToSync.pendingUploadPaths.clear();
         this->filesToSync.mutex.unlock();
         emit this->syncFilesCompleted();
+        if (this->isRemoteRefreshPending && this->isRunning)
+        {
+            this->isRemoteRefreshPending = false;
+            this->onRemoteRefreshTimeout();
+        }
     }
     R_LOG_TRACE_OUT;
 }
@@ -569,5 +749,9 @@ void RFileManager::onRemoteRefreshTimeout()
                            rError.getMessage().toUtf8().constData());
         }
     }
+    if (this->isRunning)
+    {
+        this->requestFileChanges();
+    }
     R_LOG_TRACE_OUT;
 }
@@ -0,0 +1,381 @@
+#include <QDateTime>
+#include <QTimeZone>
+
+#include <cstring>
+
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_access_log.h"
+#include "rcl_http_message.h"
+
+RHttpAccessLog::RHttpAccessLog(qsizetype capacity, quint32 sampleRate, Format format, const QString &fileName, quint32 flushIntervalMs)
+    : format{format}
+    , sampleRate{qMax(sampleRate,quint32(1))}
+    , fileName{fileName}
+    , mask{0}
+    , enqueuePosition{0}
+    , dequeuePosition{0}
+    , sampleCounter{0}
+    , nAppended{0}
+    , nWritten{0}
+    , nDropped{0}
+    , nSampledOut{0}
+    , pWriterThread{nullptr}
+    , stopRequested{false}
+    , flushIntervalMs{qMax(flushIntervalMs,quint32(1))}
+{
+    R_LOG_TRACE_IN;
+    quint64 nCells = 2;
+    while (nCells < quint64(capacity))
+    {
+        nCells <<= 1;
+    }
+    this->mask = nCells - 1;
+    this->cells.reset(new Cell[nCells]);
+    for (quint64 i = 0; i < nCells; i++)
+    {
+        this->cells[i].sequence.store(i,std::memory_order_relaxed);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpAccessLog::~RHttpAccessLog()
+{
+    this->stop();
+}
+
+void RHttpAccessLog::start()
+{
+    R_LOG_TRACE_IN;
+    if (this->pWriterThread)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+    this->stopRequested.store(false);
+    this->pWriterThread = QThread::create([this]()
+    {
+        while (!this->stopRequested.load())
+        {
+            {
+                QMutexLocker locker(&this->waitMutex);
+                if (!this->stopRequested.load())
+                {
+                    // Server threads never signal, writer polls so that appending stays lock-free.
+                    this->waitCondition.wait(&this->waitMutex,this->flushIntervalMs);
+                }
+            }
+            this->flush();
+        }
+    });
+    this->pWriterThread->setObjectName("AccessLogWriter");
+    this->pWriterThread->start(QThread::LowPriority);
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpAccessLog::stop()
+{
+    R_LOG_TRACE_IN;
+    if (this->pWriterThread)
+    {
+        {
+            QMutexLocker locker(&this->waitMutex);
+            this->stopRequested.store(true);
+            this->waitCondition.wakeAll();
+        }
+        this->pWriterThread->wait();
+        delete this->pWriterThread;
+        this->pWriterThread = nullptr;
+    }
+    this->flush();
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpAccessLog::append(const Record &record)
+{
+    if (this->sampleRate > 1 && record.errorType == RError::None)
+    {
+        if (this->sampleCounter.fetch_add(1,std::memory_order_relaxed) % this->sampleRate != 0)
+        {
+            this->nSampledOut.fetch_add(1,std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    // Bounded multi-producer queue: each cell carries a sequence number telling
+    // producers whether it is free for the current lap of the ring.
+    quint64 position = this->enqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell &cell = this->cells[position & this->mask];
+        const quint64 sequence = cell.sequence.load(std::memory_order_acquire);
+        const qint64 difference = qint64(sequence) - qint64(position);
+        if (difference == 0)
+        {
+            if (this->enqueuePosition.compare_exchange_weak(position,position + 1,std::memory_order_relaxed))
+            {
+                cell.record = record;
+                cell.sequence.store(position + 1,std::memory_order_release);
+                this->nAppended.fetch_add(1,std::memory_order_relaxed);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Ring buffer is full, writer does not keep up.
+            this->nDropped.fetch_add(1,std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = this->enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+qsizetype RHttpAccessLog::flush()
+{
+    QMutexLocker locker(&this->writeMutex);
+
+    qsizetype nRecords = 0;
+    QByteArray lines;
+    Record record;
+    while (this->take(record))
+    {
+        lines += RHttpAccessLog::formatRecord(record,this->format);
+        nRecords++;
+        if (lines.size() >= 64 * 1024)
+        {
+            this->write(lines);
+            lines.clear();
+        }
+    }
+    if (!lines.isEmpty())
+    {
+        this->write(lines);
+    }
+    this->nWritten.fetch_add(quint64(nRecords),std::memory_order_relaxed);
+    return nRecords;
+}
+
+qsizetype RHttpAccessLog::getCapacity() const
+{
+    return qsizetype(this->mask + 1);
+}
+
+quint64 RHttpAccessLog::getAppendedCount() const
+{
+    return this->nAppended.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpAccessLog::getWrittenCount() const
+{
+    return this->nWritten.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpAccessLog::getDroppedCount() const
+{
+    return this->nDropped.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpAccessLog::getSampledOutCount() const
+{
+    return this->nSampledOut.load(std::memory_order_relaxed);
+}
+
+QByteArray RHttpAccessLog::toPrometheusText() const
+{
+    R_LOG_TRACE_IN;
+    QByteArray text;
+    text += "# HELP range_cloud_access_log_records_total Number of access log records by outcome.\n";
+    text += "# TYPE range_cloud_access_log_records_total counter\n";
+    text += "range_cloud_access_log_records_total{outcome=\"written\"} " + QByteArray::number(this->getWrittenCount()) + "\n";
+    text += "range_cloud_access_log_records_total{outcome=\"dropped\"} " + QByteArray::number(this->getDroppedCount()) + "\n";
+    text += "range_cloud_access_log_records_total{outcome=\"sampled_out\"} " + QByteArray::number(this->getSampledOutCount()) + "\n";
+    text += "# HELP range_cloud_access_log_queued Number of access log records waiting to be written.\n";
+    text += "# TYPE range_cloud_access_log_queued gauge\n";
+    text += "range_cloud_access_log_queued " + QByteArray::number(this->getAppendedCount() - qMin(this->getAppendedCount(),this->getWrittenCount())) + "\n";
+    R_LOG_TRACE_RETURN(text);
+}
+
+QJsonObject RHttpAccessLog::toJson() const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject json;
+    json["written"] = qint64(this->getWrittenCount());
+    json["dropped"] = qint64(this->getDroppedCount());
+    json["sampled-out"] = qint64(this->getSampledOutCount());
+    json["capacity"] = this->getCapacity();
+    R_LOG_TRACE_RETURN(json);
+}
+
+QByteArray RHttpAccessLog::formatRecord(const Record &record, Format format)
+{
+    QHostAddress address(record.remoteAddress);
+    bool isIPv4 = false;
+    const quint32 ipv4Address = address.toIPv4Address(&isIPv4);
+    if (isIPv4)
+    {
+        address.setAddress(ipv4Address);
+    }
+    const QByteArray fromAddress = address.toString().toUtf8() + ":" + QByteArray::number(record.remotePort);
+
+    QByteArray line;
+    if (format == RHttpAccessLog::Compact)
+    {
+        line += "time=" + QDateTime::fromMSecsSinceEpoch(record.timestamp,QTimeZone::UTC).toString(Qt::ISODateWithMs).toUtf8();
+        line += " service=" + QByteArray(record.service);
+        line += " action=" + QByteArray(record.action);
+        line += " user=\"" + QByteArray(record.user) + "\"";
+        line += " from=" + fromAddress;
+        line += " resource=\"" + QByteArray(record.resourceName) + "\"";
+        if (!record.resourceId.isNull())
+        {
+            line += " id=" + record.resourceId.toByteArray(QUuid::WithoutBraces);
+        }
+        line += " status=" + QByteArray::number(int(RHttpMessage::errorTypeToStatusCode(record.errorType)));
+        line += " in=" + QByteArray::number(record.bytesIn);
+        line += " out=" + QByteArray::number(record.bytesOut);
+        line += " us=" + QByteArray::number(record.duration);
+        line += "\n";
+        return line;
+    }
+
+    // Url is rebuilt from recorded fields, authentication token is never logged.
+    QByteArray url = "/" + QByteArray(record.action) + "/";
+    QByteArray query;
+    if (record.resourceName[0] != '\0')
+    {
+        query += RCloudAction::Resource::Name::key.toUtf8() + "=" + QByteArray(record.resourceName);
+    }
+    if (!record.resourceId.isNull())
+    {
+        query += QByteArray(query.isEmpty() ? "" : "&") + RCloudAction::Resource::Id::key.toUtf8() + "=" + record.resourceId.toByteArray(QUuid::WithBraces);
+    }
+    if (!query.isEmpty())
+    {
+        url += "?" + query;
+    }
+
+    line += "[" + QByteArray(record.service) + "] Request: user = \"" + QByteArray(record.user) + "\" (" + fromAddress + "), url = \"" + url + "\"";
+    line += ", status = " + QByteArray::number(int(RHttpMessage::errorTypeToStatusCode(record.errorType)));
+    line += ", bytes in/out = " + QByteArray::number(record.bytesIn) + "/" + QByteArray::number(record.bytesOut);
+    line += ", duration = " + QByteArray::number(record.duration) + " us\n";
+    return line;
+}
+
+void RHttpAccessLog::setText(char *target, qsizetype size, QStringView source)
+{
+    qsizetype length = 0;
+    for (const QChar &character : source)
+    {
+        if (length + 1 >= size)
+        {
+            break;
+        }
+        if (character.unicode() >= 0x80)
+        {
+            // Non-ASCII text is rare, convert it as a whole.
+            const QByteArray utf8 = source.toUtf8();
+            length = qMin(size - 1,utf8.size());
+            while (length > 0 && length < utf8.size() && (uchar(utf8.at(length)) & 0xC0) == 0x80)
+            {
+                length--;
+            }
+            std::memcpy(target,utf8.constData(),size_t(length));
+            break;
+        }
+        target[length++] = char(character.unicode());
+    }
+    target[length] = '\0';
+}
+
+void RHttpAccessLog::setRemoteAddress(Record &record, const QHostAddress &address, quint16 port)
+{
+    record.remoteAddress = address.toIPv6Address();
+    record.remotePort = port;
+}
+
+RHttpAccessLog::Format RHttpAccessLog::formatFromString(const QString &formatName, bool *pOk)
+{
+    if (pOk)
+    {
+        *pOk = true;
+    }
+    if (formatName == RHttpAccessLog::formatToString(RHttpAccessLog::Compact))
+    {
+        return RHttpAccessLog::Compact;
+    }
+    if (formatName != RHttpAccessLog::formatToString(RHttpAccessLog::Text) && pOk)
+    {
+        *pOk = false;
+    }
+    return RHttpAccessLog::Text;
+}
+
+QString RHttpAccessLog::formatToString(Format format)
+{
+    switch (format)
+    {
+        case RHttpAccessLog::Compact:
+        {
+            return QString("compact");
+        }
+        default:
+        {
+            return QString("text");
+        }
+    }
+}
+
+bool RHttpAccessLog::take(Record &record)
+{
+    Cell &cell = this->cells[this->dequeuePosition & this->mask];
+    const quint64 sequence = cell.sequence.load(std::memory_order_acquire);
+    if (qint64(sequence) - qint64(this->dequeuePosition + 1) < 0)
+    {
+        return false;
+    }
+    record = cell.record;
+    // Cell is free again for the next lap of the ring.
+    cell.sequence.store(this->dequeuePosition + this->mask + 1,std::memory_order_release);
+    this->dequeuePosition++;
+    return true;
+}
+
+void RHttpAccessLog::write(const QByteArray &lines)
+{
+    if (!this->fileName.isEmpty())
+    {
+        if (!this->file.isOpen())
+        {
+            this->file.setFileName(this->fileName);
+            if (!this->file.open(QIODevice::WriteOnly | QIODevice::Append))
+            {
+                RLogger::error("[AccessLog] Failed to open access log file \"%s\". %s\n",
+                               this->fileName.toUtf8().constData(),
+                               this->file.errorString().toUtf8().constData());
+                this->fileName.clear();
+            }
+        }
+        if (this->file.isOpen())
+        {
+            this->file.write(lines);
+            this->file.flush();
+            return;
+        }
+    }
+
+    qsizetype lineStart = 0;
+    while (lineStart < lines.size())
+    {
+        qsizetype lineEnd = lines.indexOf('\n',lineStart);
+        if (lineEnd < 0)
+        {
+            lineEnd = lines.size();
+        }
+        RLogger::info("%s\n",lines.mid(lineStart,lineEnd - lineStart).constData());
+        lineStart = lineEnd + 1;
+    }
+}
@@ -0,0 +1,272 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_admission_gate.h"
+
+const qsizetype RHttpAdmissionGate::maxHeadSize = 64 * 1024;
+
+RHttpAdmissionGate::Verdict RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode statusCode, const QHttpHeaders &headers)
+{
+    Verdict verdict;
+    verdict.admitted = false;
+    verdict.statusCode = statusCode;
+    verdict.headers = headers;
+    return verdict;
+}
+
+RHttpAdmissionGate::RHttpAdmissionGate(const Evaluator &evaluator, const QByteArray &serverName, QObject *parent)
+    : QObject{parent}
+    , evaluator{evaluator}
+    , serverName{serverName}
+    , state{RHttpAdmissionGate::ReadingHead}
+    , nBodyBytes{0}
+    , pSocket{nullptr}
+    , armed{false}
+    , nInspectedBytes{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpAdmissionGate::attach(QSslSocket *pSocket, QTcpServer *pServer)
+{
+    R_LOG_TRACE_IN;
+    this->pSocket = pSocket;
+    this->setParent(pSocket);
+    // Connected before the HTTP server gets the socket, so the gate sees new data first.
+    QObject::connect(pSocket, &QIODevice::readyRead, this, &RHttpAdmissionGate::onReadyRead);
+    this->pendingConnection = QObject::connect(pServer, &QTcpServer::pendingConnectionAvailable, this, &RHttpAdmissionGate::onPendingConnectionAvailable);
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpAdmissionGate::inspect(const QByteArray &data, Verdict &verdict)
+{
+    qsizetype position = 0;
+    while (position < data.size())
+    {
+        switch (this->state)
+        {
+            case RHttpAdmissionGate::SkippingBody:
+            {
+                const qint64 nBytes = qMin(this->nBodyBytes,qint64(data.size() - position));
+                this->nBodyBytes -= nBytes;
+                position += nBytes;
+                if (this->nBodyBytes == 0)
+                {
+                    this->state = RHttpAdmissionGate::ReadingHead;
+                }
+                break;
+            }
+            case RHttpAdmissionGate::ReadingHead:
+            {
+                const qsizetype nBufferedBytes = this->headBuffer.size();
+                this->headBuffer += data.mid(position);
+                const qsizetype headEnd = this->headBuffer.indexOf("\r\n\r\n",qMax(qsizetype(0),nBufferedBytes - 3));
+                if (headEnd < 0)
+                {
+                    position = data.size();
+                    if (this->headBuffer.size() > RHttpAdmissionGate::maxHeadSize)
+                    {
+                        // HTTP server refuses such head by itself.
+                        this->headBuffer.clear();
+                        this->state = RHttpAdmissionGate::PassThrough;
+                    }
+                    break;
+                }
+
+                const qsizetype headSize = headEnd + 4;
+                position += headSize - nBufferedBytes;
+                RequestHead requestHead;
+                const bool parsed = RHttpAdmissionGate::parseHead(this->headBuffer.left(headSize),requestHead);
+                this->headBuffer.clear();
+                if (!parsed)
+                {
+                    this->state = RHttpAdmissionGate::PassThrough;
+                    break;
+                }
+
+                verdict = this->evaluator(requestHead);
+                if (!verdict.admitted)
+                {
+                    this->state = RHttpAdmissionGate::Rejected;
+                    return false;
+                }
+                if (requestHead.chunked)
+                {
+                    // End of chunked body is not tracked.
+                    this->state = RHttpAdmissionGate::PassThrough;
+                    break;
+                }
+                this->nBodyBytes = qMax(qint64(0),requestHead.contentLength);
+                this->state = (this->nBodyBytes > 0) ? RHttpAdmissionGate::SkippingBody : RHttpAdmissionGate::ReadingHead;
+                break;
+            }
+            case RHttpAdmissionGate::Rejected:
+            {
+                return false;
+            }
+            default:
+            {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+RHttpAdmissionGate::State RHttpAdmissionGate::getState() const
+{
+    return this->state;
+}
+
+bool RHttpAdmissionGate::parseHead(const QByteArray &data, RequestHead &requestHead)
+{
+    QList<QByteArray> lines = data.split('\n');
+    // Empty lines may precede request line.
+    while (!lines.isEmpty() && lines.first().trimmed().isEmpty())
+    {
+        lines.removeFirst();
+    }
+    if (lines.isEmpty())
+    {
+        return false;
+    }
+
+    const QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.") || !requestLine.at(1).startsWith('/'))
+    {
+        return false;
+    }
+    requestHead.method = requestLine.at(0);
+    requestHead.url = QUrl::fromEncoded(requestLine.at(1));
+    if (!requestHead.url.isValid())
+    {
+        return false;
+    }
+
+    for (const QByteArray &line : std::as_const(lines))
+    {
+        const QByteArray headerLine = line.trimmed();
+        if (headerLine.isEmpty())
+        {
+            continue;
+        }
+        const qsizetype separator = headerLine.indexOf(':');
+        if (separator <= 0 || !requestHead.headers.append(headerLine.left(separator).trimmed(),headerLine.mid(separator + 1).trimmed()))
+        {
+            return false;
+        }
+    }
+
+    if (requestHead.headers.contains(QHttpHeaders::WellKnownHeader::ContentLength))
+    {
+        bool ok = false;
+        requestHead.contentLength = requestHead.headers.value(QHttpHeaders::WellKnownHeader::ContentLength).toLongLong(&ok);
+        if (!ok || requestHead.contentLength < 0)
+        {
+            return false;
+        }
+    }
+    requestHead.chunked = requestHead.headers.combinedValue(QHttpHeaders::WellKnownHeader::TransferEncoding).toLower().contains("chunked");
+    requestHead.expectContinue = (requestHead.headers.value(QHttpHeaders::WellKnownHeader::Expect).trimmed().compare("100-continue",Qt::CaseInsensitive) == 0);
+    return true;
+}
+
+QByteArray RHttpAdmissionGate::buildResponse(const Verdict &verdict, const QByteArray &serverName)
+{
+    QByteArray reasonPhrase;
+    switch (verdict.statusCode)
+    {
+        case QHttpServerResponse::StatusCode::Unauthorized:
+        {
+            reasonPhrase = "Unauthorized";
+            break;
+        }
+        case QHttpServerResponse::StatusCode::RequestTimeout:
+        {
+            reasonPhrase = "Request Timeout";
+            break;
+        }
+        case QHttpServerResponse::StatusCode::PayloadTooLarge:
+        {
+            reasonPhrase = "Payload Too Large";
+            break;
+        }
+        case QHttpServerResponse::StatusCode::TooManyRequests:
+        {
+            reasonPhrase = "Too Many Requests";
+            break;
+        }
+        case QHttpServerResponse::StatusCode::ServiceUnavailable:
+        {
+            reasonPhrase = "Service Unavailable";
+            break;
+        }
+        default:
+        {
+            reasonPhrase = "Rejected";
+            break;
+        }
+    }
+
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(int(verdict.statusCode)) + " " + reasonPhrase + "\r\n";
+    for (qsizetype i = 0; i < verdict.headers.size(); i++)
+    {
+        response += verdict.headers.nameAt(i).toString().toLatin1() + ": " + verdict.headers.valueAt(i).toByteArray() + "\r\n";
+    }
+    if (!serverName.isEmpty())
+    {
+        response += "Server: " + serverName + "\r\n";
+    }
+    response += "Content-Length: 0\r\nConnection: close\r\n\r\n";
+    return response;
+}
+
+void RHttpAdmissionGate::onReadyRead()
+{
+    if (this->state == RHttpAdmissionGate::Rejected)
+    {
+        // Nothing is left for the HTTP server to parse.
+        this->pSocket->skip(this->pSocket->bytesAvailable());
+        return;
+    }
+    if (!this->armed)
+    {
+        this->state = RHttpAdmissionGate::PassThrough;
+    }
+    if (this->state == RHttpAdmissionGate::PassThrough)
+    {
+        QObject::disconnect(this->pSocket, nullptr, this, nullptr);
+        return;
+    }
+
+    // HTTP server may leave part of earlier data unread (incomplete lines), only the rest is new.
+    const QByteArray unreadData = this->pSocket->peek(this->pSocket->bytesAvailable());
+    const QByteArray data = unreadData.mid(this->nInspectedBytes);
+    this->nInspectedBytes = unreadData.size();
+
+    Verdict verdict;
+    if (!this->inspect(data,verdict))
+    {
+        this->pSocket->write(RHttpAdmissionGate::buildResponse(verdict,this->serverName));
+        this->pSocket->skip(this->pSocket->bytesAvailable());
+        this->pSocket->disconnectFromHost();
+    }
+}
+
+void RHttpAdmissionGate::onReadFinished()
+{
+    this->nInspectedBytes = this->pSocket->bytesAvailable();
+}
+
+void RHttpAdmissionGate::onPendingConnectionAvailable()
+{
+    // HTTP server takes all pending connections before this slot runs, encrypted socket is among them.
+    if (this->armed || !this->pSocket->isEncrypted())
+    {
+        return;
+    }
+    QObject::disconnect(this->pendingConnection);
+    // Connected after the HTTP server, tells how much data it left unread.
+    QObject::connect(this->pSocket, &QIODevice::readyRead, this, &RHttpAdmissionGate::onReadFinished);
+    this->armed = true;
+}
@@ -0,0 +1,118 @@
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_batch_action_handler.h"
+
+RHttpBatchActionHandler::RHttpBatchActionHandler(const RHttpRequestDispatcher *pDispatcher, QObject *parent)
+    : RHttpActionHandler{parent}
+    , pDispatcher{pDispatcher}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RHttpMessage RHttpBatchActionHandler::processRequest(const RHttpMessage &requestMessage)
+{
+    R_LOG_TRACE_IN;
+    bool isValid = false;
+    const QList<RCloudAction> items = RCloudAction::batchFromJson(requestMessage.getBody(),&isValid);
+    if (!isValid)
+    {
+        throw RError(RError::InvalidInput,R_ERROR_REF,"Invalid batch request");
+    }
+
+    QList<RCloudAction> results;
+    results.reserve(items.size());
+    for (const RCloudAction &item : items)
+    {
+        // Item request inherits owner and origin of the batch, so access rights are checked as usual.
+        RHttpMessage itemMessage(requestMessage);
+        QMap<QString,QString> properties;
+        properties.insert(RCloudAction::Action::key,item.getAction());
+        properties.insert(RCloudAction::Resource::Name::key,item.getResourceName());
+        properties.insert(RCloudAction::Resource::Id::key,item.getResourceId().toString(QUuid::WithBraces));
+        itemMessage.setProperties(properties);
+        itemMessage.setBody(item.getData());
+
+        RHttpMessage itemReply;
+        RHttpActionHandler *pHandler = this->pDispatcher->findHandler(item.getAction());
+        if (!pHandler || !RCloudAction::isBatchableAction(item.getAction()))
+        {
+            itemReply.setErrorType(RError::InvalidInput);
+            itemReply.setBody(QString("Action \"%1\" cannot be part of a batch").arg(item.getAction()).toUtf8());
+        }
+        else
+        {
+            try
+            {
+                itemReply = pHandler->processRequest(itemMessage);
+            }
+            catch (const RError &rError)
+            {
+                itemReply.setErrorType(rError.getType());
+                itemReply.setBody(rError.getMessage().toUtf8());
+            }
+            catch (const std::exception &exception)
+            {
+                itemReply.setErrorType(RError::Application);
+                itemReply.setBody(QByteArray(exception.what()));
+            }
+        }
+
+        RCloudAction result(item.getId(),QString(),QString(),item.getAction(),item.getResourceName(),item.getResourceId(),itemReply.getBody());
+        result.setErrorType(itemReply.getErrorType());
+        results.append(result);
+    }
+
+    RHttpMessage replyMessage;
+    replyMessage.setBody(RCloudAction::batchToJson(results));
+    R_LOG_TRACE_RETURN(replyMessage);
+}
+
+bool RHttpBatchActionHandler::validate(const QByteArray &body, qsizetype maxItems, QString &errorMessage)
+{
+    bool isValid = false;
+    const QList<RCloudAction> items = RCloudAction::batchFromJson(body,&isValid);
+    if (!isValid)
+    {
+        errorMessage = "Batch request body is not a JSON array of actions";
+        return false;
+    }
+    if (items.isEmpty())
+    {
+        errorMessage = "Batch request is empty";
+        return false;
+    }
+    if (items.size() > maxItems)
+    {
+        errorMessage = QString("Batch request has %1 items, at most %2 are allowed").arg(items.size()).arg(maxItems);
+        return false;
+    }
+    for (const RCloudAction &item : items)
+    {
+        if (!RCloudAction::isBatchableAction(item.getAction()))
+        {
+            errorMessage = QString("Action \"%1\" cannot be part of a batch").arg(item.getAction());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RHttpBatchActionHandler::isHandledInProcess(const RHttpRequestDispatcher &dispatcher, const QByteArray &body)
+{
+    const QList<RCloudAction> items = RCloudAction::batchFromJson(body);
+    if (items.isEmpty())
+    {
+        return false;
+    }
+    for (const RCloudAction &item : items)
+    {
+        if (!dispatcher.findHandler(item.getAction()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_body_device.h"
+
+RHttpBodyDevice::RHttpBodyDevice(const QSharedPointer<QIODevice> &sourceDevice, QObject *parent)
+    : RHttpBodyDevice{sourceDevice,0,-1,parent}
+{
+}
+
+RHttpBodyDevice::RHttpBodyDevice(const QSharedPointer<QIODevice> &sourceDevice, qint64 offset, qint64 length, QObject *parent)
+    : QIODevice{parent}
+    , sourceDevice{sourceDevice}
+    , offset{offset}
+    , length{length}
+{
+    R_LOG_TRACE_IN;
+    if (this->sourceDevice && this->sourceDevice->isReadable())
+    {
+        this->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpBodyDevice::isSequential() const
+{
+    return this->sourceDevice && this->sourceDevice->isSequential();
+}
+
+qint64 RHttpBodyDevice::size() const
+{
+    if (!this->sourceDevice)
+    {
+        return 0;
+    }
+    if (this->isSequential())
+    {
+        return this->sourceDevice->bytesAvailable();
+    }
+    const qint64 available = qMax(qint64(0),this->sourceDevice->size() - this->offset);
+    return (this->length < 0) ? available : qMin(this->length,available);
+}
+
+qint64 RHttpBodyDevice::readData(char *data, qint64 maxSize)
+{
+    if (!this->sourceDevice)
+    {
+        return -1;
+    }
+    if (this->isSequential())
+    {
+        return this->sourceDevice->read(data,maxSize);
+    }
+    const qint64 nBytes = qMin(maxSize,this->size() - this->pos());
+    if (nBytes <= 0)
+    {
+        return 0;
+    }
+    if (!this->sourceDevice->seek(this->offset + this->pos()))
+    {
+        this->setErrorString(this->sourceDevice->errorString());
+        return -1;
+    }
+    return this->sourceDevice->read(data,nBytes);
+}
+
+qint64 RHttpBodyDevice::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
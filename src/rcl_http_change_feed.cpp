@@ -0,0 +1,295 @@
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_file_info.h"
+#include "rcl_http_change_feed.h"
+
+RHttpChangeFeed::RHttpChangeFeed(qsizetype maxChangesPerUser)
+    : maxChangesPerUser{qMax(qsizetype(1),maxChangesPerUser)}
+    // Cursors of a previous run are always older than the first sequence of this one.
+    , firstSequence{quint64(QDateTime::currentMSecsSinceEpoch()) * 1000}
+    , sequence{firstSequence}
+    , resetSequence{firstSequence}
+    , waiterId{0}
+    , nPublished{0}
+    , nDelivered{0}
+    , nIdle{0}
+    , nResets{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RHttpChangeFeed::~RHttpChangeFeed()
+{
+    // Waiting requests are cancelled together with their promises.
+    for (const UserFeed &feed : std::as_const(this->feeds))
+    {
+        for (const Waiter &waiter : feed.waiters)
+        {
+            waiter.pPromise->future().cancel();
+            waiter.pPromise->finish();
+        }
+    }
+}
+
+void RHttpChangeFeed::publish(const QString &user, const RFileChange &change)
+{
+    QList<Waiter> waiters;
+    quint64 changeSequence = 0;
+    {
+        QMutexLocker locker(&this->mutex);
+        changeSequence = ++this->sequence;
+        UserFeed &feed = this->feeds[user];
+        feed.changes.enqueue(Change{changeSequence,change});
+        while (feed.changes.size() > this->maxChangesPerUser)
+        {
+            feed.forgottenSequence = feed.changes.dequeue().sequence;
+        }
+        waiters.swap(feed.waiters);
+    }
+    this->nPublished.fetch_add(1,std::memory_order_relaxed);
+    this->nDelivered.fetch_add(quint64(waiters.size()),std::memory_order_relaxed);
+
+    const RFileChangeSet changeSet(changeSequence,false,{change});
+    for (const Waiter &waiter : std::as_const(waiters))
+    {
+        waiter.pPromise->addResult(changeSet);
+        waiter.pPromise->finish();
+    }
+}
+
+void RHttpChangeFeed::publishReset()
+{
+    QList<Waiter> waiters;
+    quint64 cursor = 0;
+    {
+        QMutexLocker locker(&this->mutex);
+        cursor = ++this->sequence;
+        this->resetSequence = cursor;
+        for (UserFeed &feed : this->feeds)
+        {
+            // Changes before the reset are never delivered.
+            feed.changes.clear();
+            waiters.append(feed.waiters);
+            feed.waiters.clear();
+        }
+    }
+    this->nPublished.fetch_add(1,std::memory_order_relaxed);
+    this->nResets.fetch_add(quint64(waiters.size()),std::memory_order_relaxed);
+
+    const RFileChangeSet changeSet(cursor,true,{});
+    for (const Waiter &waiter : std::as_const(waiters))
+    {
+        waiter.pPromise->addResult(changeSet);
+        waiter.pPromise->finish();
+    }
+}
+
+void RHttpChangeFeed::publishResponse(const QString &actionKey, const QString &user, const QByteArray &responseBody)
+{
+    bool isShared = false;
+    const QList<std::pair<QString,RFileChange>> changes = RHttpChangeFeed::findChanges(actionKey,responseBody,&isShared);
+    if (isShared)
+    {
+        this->publishReset();
+        return;
+    }
+    for (const std::pair<QString,RFileChange> &change : changes)
+    {
+        this->publish(user,change.second);
+        if (!change.first.isEmpty() && change.first != user)
+        {
+            this->publish(change.first,change.second);
+        }
+    }
+}
+
+quint64 RHttpChangeFeed::wait(const QString &user, quint64 cursor, QFuture<RFileChangeSet> &future)
+{
+    QMutexLocker locker(&this->mutex);
+    UserFeed &feed = this->feeds[user];
+
+    if (cursor < this->resetSequence || cursor > this->sequence || cursor < feed.forgottenSequence)
+    {
+        // Some changes after the cursor are not known, client has to list files.
+        this->nResets.fetch_add(1,std::memory_order_relaxed);
+        future = QtFuture::makeReadyValueFuture(RFileChangeSet(this->sequence,true,{}));
+        return 0;
+    }
+
+    QList<RFileChange> changes;
+    for (const Change &change : std::as_const(feed.changes))
+    {
+        if (change.sequence > cursor)
+        {
+            changes.append(change.change);
+        }
+    }
+    if (!changes.isEmpty())
+    {
+        this->nDelivered.fetch_add(1,std::memory_order_relaxed);
+        future = QtFuture::makeReadyValueFuture(RFileChangeSet(this->sequence,false,changes));
+        return 0;
+    }
+
+    std::shared_ptr<QPromise<RFileChangeSet>> pPromise = std::make_shared<QPromise<RFileChangeSet>>();
+    pPromise->start();
+    future = pPromise->future();
+    feed.waiters.append(Waiter{++this->waiterId,pPromise});
+    return this->waiterId;
+}
+
+void RHttpChangeFeed::stopWaiting(const QString &user, quint64 waiterId)
+{
+    std::shared_ptr<QPromise<RFileChangeSet>> pPromise;
+    quint64 cursor = 0;
+    {
+        QMutexLocker locker(&this->mutex);
+        QHash<QString,UserFeed>::iterator iter = this->feeds.find(user);
+        if (iter == this->feeds.end())
+        {
+            return;
+        }
+        for (qsizetype i = 0; i < iter->waiters.size(); i++)
+        {
+            if (iter->waiters.at(i).id == waiterId)
+            {
+                pPromise = iter->waiters.takeAt(i).pPromise;
+                break;
+            }
+        }
+        // No change of the user has a sequence number below the current one.
+        cursor = this->sequence;
+    }
+    if (!pPromise)
+    {
+        // Already answered by a change.
+        return;
+    }
+    this->nIdle.fetch_add(1,std::memory_order_relaxed);
+    pPromise->addResult(RFileChangeSet(cursor,false,{}));
+    pPromise->finish();
+}
+
+quint64 RHttpChangeFeed::getCursor() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->sequence;
+}
+
+qsizetype RHttpChangeFeed::getWaitingCount() const
+{
+    QMutexLocker locker(&this->mutex);
+    qsizetype nWaiting = 0;
+    for (const UserFeed &feed : this->feeds)
+    {
+        nWaiting += feed.waiters.size();
+    }
+    return nWaiting;
+}
+
+QJsonObject RHttpChangeFeed::toJson() const
+{
+    QJsonObject json;
+    json["published"] = qint64(this->nPublished.load(std::memory_order_relaxed));
+    json["delivered"] = qint64(this->nDelivered.load(std::memory_order_relaxed));
+    json["idle"] = qint64(this->nIdle.load(std::memory_order_relaxed));
+    json["resets"] = qint64(this->nResets.load(std::memory_order_relaxed));
+    json["waiting"] = qint64(this->getWaitingCount());
+    return json;
+}
+
+QByteArray RHttpChangeFeed::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_change_feed_published_total Number of published file changes.\n";
+    text += "# TYPE range_cloud_change_feed_published_total counter\n";
+    text += "range_cloud_change_feed_published_total " + QByteArray::number(this->nPublished.load(std::memory_order_relaxed)) + "\n";
+    text += "# HELP range_cloud_change_feed_waits_total Number of answered change feed waits by outcome.\n";
+    text += "# TYPE range_cloud_change_feed_waits_total counter\n";
+    text += "range_cloud_change_feed_waits_total{result=\"changes\"} " + QByteArray::number(this->nDelivered.load(std::memory_order_relaxed)) + "\n";
+    text += "range_cloud_change_feed_waits_total{result=\"idle\"} " + QByteArray::number(this->nIdle.load(std::memory_order_relaxed)) + "\n";
+    text += "range_cloud_change_feed_waits_total{result=\"reset\"} " + QByteArray::number(this->nResets.load(std::memory_order_relaxed)) + "\n";
+    text += "# HELP range_cloud_change_feed_waiting Number of clients waiting for file changes.\n";
+    text += "# TYPE range_cloud_change_feed_waiting gauge\n";
+    text += "range_cloud_change_feed_waiting " + QByteArray::number(this->getWaitingCount()) + "\n";
+    return text;
+}
+
+QList<std::pair<QString,RFileChange>> RHttpChangeFeed::findChanges(const QString &actionKey, const QByteArray &responseBody, bool *isShared)
+{
+    QList<std::pair<QString,RFileChange>> changes;
+    if (!RCloudAction::isFileChangingAction(actionKey))
+    {
+        return changes;
+    }
+
+    // Users who could see the file before its access rights have changed are not known.
+    const bool isAccessChange = (actionKey == RCloudAction::Action::FileUpdateAccessOwner::key
+                              || actionKey == RCloudAction::Action::FileUpdateAccessMode::key);
+
+    auto appendChange = [&changes,isShared,isAccessChange](const QJsonObject &json, RFileChange::Operation operation)
+    {
+        const RFileInfo fileInfo = RFileInfo::fromJson(json);
+        if (!fileInfo.getId().isNull())
+        {
+            const RAccessMode &accessMode = fileInfo.getAccessRights().getMode();
+            if (isShared && (isAccessChange || ((accessMode.getGroupModeMask() | accessMode.getOtherModeMask()) & RAccessMode::Read)))
+            {
+                *isShared = true;
+            }
+            changes.append({fileInfo.getAccessRights().getOwner().getUser(),
+                            RFileChange(fileInfo.getId(),fileInfo.getPath(),fileInfo.getMd5Checksum(),operation)});
+        }
+    };
+
+    if (actionKey == RCloudAction::Action::Batch::key)
+    {
+        const QList<RCloudAction> results = RCloudAction::batchFromJson(responseBody);
+        for (const RCloudAction &result : results)
+        {
+            if (result.getErrorType() == RError::None && result.getAction() != RCloudAction::Action::Batch::key)
+            {
+                changes.append(RHttpChangeFeed::findChanges(result.getAction(),result.getData(),isShared));
+            }
+        }
+        return changes;
+    }
+
+    const QJsonObject json = QJsonDocument::fromJson(responseBody).object();
+    if (actionKey == RCloudAction::Action::FileReplace::key)
+    {
+        // Replacement is a new file, replaced files are removed.
+        if (const QJsonValue &v = json["upload"]; v.isObject())
+        {
+            appendChange(v.toObject(),RFileChange::Created);
+        }
+        if (const QJsonValue &v = json["remove"]; v.isArray())
+        {
+            const QJsonArray jsonArray = v.toArray();
+            for (const QJsonValue &value : jsonArray)
+            {
+                appendChange(value.toObject(),RFileChange::Removed);
+            }
+        }
+    }
+    else if (actionKey == RCloudAction::Action::FileUpload::key)
+    {
+        appendChange(json,RFileChange::Created);
+    }
+    else if (actionKey == RCloudAction::Action::FileRemove::key)
+    {
+        appendChange(json,RFileChange::Removed);
+    }
+    else
+    {
+        appendChange(json,RFileChange::Updated);
+    }
+    return changes;
+}
@@ -11,6 +11,7 @@
 #include <rbl_logger.h>
 #include <rbl_utils.h>
 
+#include "rcl_cloud_action.h"
 #include "rcl_http_client.h"
 
 RHttpClient::RHttpClient(Type type, const RHttpClientSettings &httpClientSettings, QObject *parent)
@@ -32,6 +33,13 @@ RHttpClient::RHttpClient(Type type, const RHttpClientSettings &httpClientSetting
     R_LOG_TRACE_OUT;
 }
 
+void RHttpClient::setValidatorCache(const std::shared_ptr<RHttpClientValidatorCache> &pValidatorCache)
+{
+    R_LOG_TRACE_IN;
+    this->pValidatorCache = pValidatorCache;
+    R_LOG_TRACE_OUT;
+}
+
 void RHttpClient::sendRequest(const RHttpMessage &httpMessageRequest, RHttpMessage &httpMessageReply)
 {
     R_LOG_TRACE_IN;
@@ -364,6 +372,23 @@ void RHttpClient::onFinished()
     this->httpErrorCode = QHttpServerResponder::StatusCode(this->networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toUInt());
     this->httpErrorString = this->networkReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray();
 
+    if (!this->conditionalUrl.isEmpty() && this->pValidatorCache)
+    {
+        if (this->httpErrorCode == QHttpServerResponder::StatusCode::NotModified && this->pValidatorCache->findBody(this->conditionalUrl,this->responseBytes))
+        {
+            RLogger::debug("Listing was not modified\n");
+            this->httpErrorCode = QHttpServerResponder::StatusCode::Ok;
+        }
+        else if (this->httpErrorCode == QHttpServerResponder::StatusCode::Ok && this->networkReply->hasRawHeader("ETag"))
+        {
+            this->pValidatorCache->insert(this->conditionalUrl,this->networkReply->rawHeader("ETag"),this->responseBytes);
+        }
+        else
+        {
+            this->pValidatorCache->remove(this->conditionalUrl);
+        }
+    }
+
     this->replyMessage.setBody(this->responseBytes);
     this->replyMessage.setErrorType(RHttpMessage::statusCodeToErrorType(this->httpErrorCode));
 
@@ -433,6 +458,29 @@ void RHttpClient::onRequestAvailable(const RHttpMessage &httpMessageRequest)
     {
         networkRequest.setRawHeader(QByteArray(reqHeaders.nameAt(i)), QByteArray(reqHeaders.valueAt(i)));
     }
+    if (!httpMessageRequest.getCorrelationId().isNull())
+    {
+        // Server answers retried mutating request with the original response instead of processing it again.
+        networkRequest.setRawHeader(RHttpMessage::idempotencyKeyHeader, httpMessageRequest.getCorrelationId().toString(QUuid::WithoutBraces).toLatin1());
+    }
+
+    // Listing which was not modified since the last poll is not transferred again.
+    this->conditionalUrl.clear();
+    const QString actionKey = httpMessageRequest.getTo().section('/',0,0);
+    if (actionKey == RCloudAction::Action::FileChanges::key)
+    {
+        // Server stops waiting for changes before the transfer times out.
+        networkRequest.setRawHeader(RHttpMessage::requestTimeoutHeader, QByteArray::number(this->httpClientSettings.getTimeout()));
+    }
+    if (this->pValidatorCache && actionKey != RCloudAction::Action::FileDownload::key && RCloudAction::isConditionalAction(actionKey))
+    {
+        this->conditionalUrl = url.toString();
+        const QByteArray entityTag = this->pValidatorCache->findEntityTag(this->conditionalUrl);
+        if (!entityTag.isEmpty())
+        {
+            networkRequest.setRawHeader("If-None-Match", entityTag);
+        }
+    }
 
     try
     {
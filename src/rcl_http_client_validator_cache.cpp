@@ -0,0 +1,57 @@
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_client_validator_cache.h"
+
+RHttpClientValidatorCache::RHttpClientValidatorCache(qsizetype maxEntries)
+    : maxEntries{maxEntries}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+QByteArray RHttpClientValidatorCache::findEntityTag(const QString &url) const
+{
+    QMutexLocker locker(&this->mutex);
+    QHash<QString,Entry>::const_iterator iter = this->entries.constFind(url);
+    return (iter != this->entries.cend()) ? iter->entityTag : QByteArray();
+}
+
+bool RHttpClientValidatorCache::findBody(const QString &url, QByteArray &body) const
+{
+    QMutexLocker locker(&this->mutex);
+    QHash<QString,Entry>::const_iterator iter = this->entries.constFind(url);
+    if (iter == this->entries.cend())
+    {
+        return false;
+    }
+    body = iter->body;
+    return true;
+}
+
+void RHttpClientValidatorCache::insert(const QString &url, const QByteArray &entityTag, const QByteArray &body)
+{
+    R_LOG_TRACE_IN;
+    QMutexLocker locker(&this->mutex);
+    if (!this->entries.contains(url) && this->entries.size() >= this->maxEntries)
+    {
+        this->entries.clear();
+    }
+    this->entries.insert(url,Entry{entityTag,body});
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpClientValidatorCache::remove(const QString &url)
+{
+    R_LOG_TRACE_IN;
+    QMutexLocker locker(&this->mutex);
+    this->entries.remove(url);
+    R_LOG_TRACE_OUT;
+}
+
+qsizetype RHttpClientValidatorCache::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->entries.size();
+}
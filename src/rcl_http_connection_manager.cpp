@@ -0,0 +1,410 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_admission_gate.h"
+#include "rcl_http_connection_manager.h"
+#include "rcl_http_server_handler_registry.h"
+
+RHttpConnectionManager::RHttpConnectionManager(qint64 idleTimeoutMs,
+                                               qint64 keepAliveTimeoutMs,
+                                               qint64 headerReadTimeoutMs,
+                                               qint64 bodyReadTimeoutMs,
+                                               qsizetype maxConnections,
+                                               const QByteArray &serverName,
+                                               RHttpConnectionMetrics *pMetrics,
+                                               QObject *parent)
+    : QObject{parent}
+    , idleTimeoutMs{idleTimeoutMs}
+    , keepAliveTimeoutMs{keepAliveTimeoutMs}
+    , headerReadTimeoutMs{headerReadTimeoutMs}
+    , bodyReadTimeoutMs{bodyReadTimeoutMs}
+    , maxConnections{maxConnections}
+    , serverName{serverName}
+    , pMetrics{pMetrics}
+    , idleSequence{0}
+    , timingWheel{RHttpConnectionManager::resolutionMs,RHttpServerHandlerRegistry::currentTime()}
+    , pExpiryTimer{nullptr}
+    , paused{false}
+{
+    R_LOG_TRACE_IN;
+    // Runs only while there are connections.
+    this->pExpiryTimer = new QTimer(this);
+    this->pExpiryTimer->setTimerType(Qt::CoarseTimer);
+    this->pExpiryTimer->setInterval(RHttpConnectionManager::resolutionMs);
+    QObject::connect(this->pExpiryTimer, &QTimer::timeout, this, [this]()
+    {
+        this->expire(RHttpServerHandlerRegistry::currentTime());
+    });
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpConnectionManager::addConnection(QAbstractSocket *pSocket, qint64 now)
+{
+    R_LOG_TRACE_IN;
+    if (this->maxConnections > 0 && this->connections.size() >= this->maxConnections && !this->idleQueue.isEmpty())
+    {
+        this->closeConnection(this->idleQueue.first(),RHttpConnectionMetrics::Evicted);
+    }
+
+    const QUuid id = QUuid::createUuid();
+    Connection &connection = this->connections[id];
+    connection.pSocket = pSocket;
+    connection.phase = RHttpConnectionManager::Idle;
+    connection.deadline = 0;
+    connection.scheduledDeadline = 0;
+    connection.nRequests = 0;
+    connection.streaming = false;
+    connection.idleSequence = 0;
+    connection.peerKey = RHttpConnectionManager::buildPeerKey(pSocket->peerAddress(),pSocket->peerPort());
+    this->socketIds.insert(pSocket,id);
+    this->peerIds.insert(connection.peerKey,id);
+    if (this->pMetrics)
+    {
+        this->pMetrics->recordOpened();
+    }
+    this->enterIdle(id,connection,now);
+
+    QObject::connect(pSocket, &QAbstractSocket::readyRead, this, [this, pSocket]()
+    {
+        // Only request head is searched, body is just counted as progress.
+        QByteArray unreadData;
+        const Phase phase = this->getPhase(pSocket);
+        if (phase == RHttpConnectionManager::Idle || phase == RHttpConnectionManager::ReadingHead)
+        {
+            unreadData = pSocket->peek(qMin(pSocket->bytesAvailable(),qint64(RHttpAdmissionGate::maxHeadSize)));
+        }
+        this->receiveData(pSocket,unreadData,RHttpServerHandlerRegistry::currentTime());
+    });
+    QObject::connect(pSocket, &QAbstractSocket::bytesWritten, this, [this, pSocket]()
+    {
+        this->sendData(pSocket,RHttpServerHandlerRegistry::currentTime());
+    });
+    QObject::connect(pSocket, &QAbstractSocket::disconnected, this, [this, pSocket]()
+    {
+        this->removeConnection(pSocket);
+    });
+    QObject::connect(pSocket, &QObject::destroyed, this, [this, pSocket]()
+    {
+        this->removeConnection(pSocket);
+    });
+
+    if (!this->pExpiryTimer->isActive())
+    {
+        this->pExpiryTimer->start();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpConnectionManager::removeConnection(QAbstractSocket *pSocket)
+{
+    R_LOG_TRACE_IN;
+    const QUuid id = this->socketIds.value(pSocket);
+    if (!id.isNull())
+    {
+        this->forgetConnection(id);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpConnectionManager::receiveData(QAbstractSocket *pSocket, const QByteArray &unreadData, qint64 now)
+{
+    const QUuid id = this->socketIds.value(pSocket);
+    if (id.isNull())
+    {
+        return;
+    }
+    Connection &connection = this->connections[id];
+
+    if (connection.phase == RHttpConnectionManager::Idle)
+    {
+        this->leaveIdle(connection);
+        connection.phase = RHttpConnectionManager::ReadingHead;
+        connection.headTail.clear();
+        this->setDeadline(id,connection,this->headerReadTimeoutMs > 0 ? now + this->headerReadTimeoutMs : 0);
+    }
+
+    switch (connection.phase)
+    {
+        case RHttpConnectionManager::ReadingHead:
+        {
+            // Head ends with an empty line, which may be split between reads.
+            const QByteArray scannedData = connection.headTail + unreadData;
+            if (scannedData.contains("\r\n\r\n"))
+            {
+                connection.headTail.clear();
+                connection.phase = RHttpConnectionManager::ReadingBody;
+                this->setDeadline(id,connection,this->bodyReadTimeoutMs > 0 ? now + this->bodyReadTimeoutMs : 0);
+            }
+            else
+            {
+                connection.headTail = scannedData.right(3);
+            }
+            break;
+        }
+        case RHttpConnectionManager::ReadingBody:
+        {
+            this->setDeadline(id,connection,this->bodyReadTimeoutMs > 0 ? now + this->bodyReadTimeoutMs : 0);
+            break;
+        }
+        default:
+        {
+            // Pipelined request waits until the current one is answered.
+            break;
+        }
+    }
+}
+
+void RHttpConnectionManager::startRequest(const QHostAddress &address, quint16 port)
+{
+    const QUuid id = this->peerIds.value(RHttpConnectionManager::buildPeerKey(address,port));
+    if (id.isNull())
+    {
+        return;
+    }
+    Connection &connection = this->connections[id];
+    this->leaveIdle(connection);
+    connection.phase = RHttpConnectionManager::Processing;
+    connection.streaming = false;
+    connection.headTail.clear();
+    this->setDeadline(id,connection,0);
+}
+
+void RHttpConnectionManager::streamResponse(const QHostAddress &address, quint16 port, QIODevice *pBodyDevice)
+{
+    const QUuid id = this->peerIds.value(RHttpConnectionManager::buildPeerKey(address,port));
+    if (id.isNull() || !pBodyDevice)
+    {
+        return;
+    }
+    Connection &connection = this->connections[id];
+    if (connection.phase != RHttpConnectionManager::Processing)
+    {
+        return;
+    }
+    connection.streaming = true;
+
+    auto onBodySent = [this, id]()
+    {
+        QHash<QUuid,Connection>::iterator iter = this->connections.find(id);
+        if (iter == this->connections.end() || !iter->streaming)
+        {
+            return;
+        }
+        iter->streaming = false;
+        this->finishResponse(id,*iter,RHttpServerHandlerRegistry::currentTime());
+    };
+    QObject::connect(pBodyDevice, &QIODevice::aboutToClose, this, onBodySent);
+    QObject::connect(pBodyDevice, &QObject::destroyed, this, onBodySent);
+}
+
+void RHttpConnectionManager::sendData(QAbstractSocket *pSocket, qint64 now)
+{
+    const QUuid id = this->socketIds.value(pSocket);
+    if (id.isNull())
+    {
+        return;
+    }
+    Connection &connection = this->connections[id];
+    if (!connection.streaming)
+    {
+        // Streamed response may drain the buffer between chunks, it is finished when its body is.
+        this->finishResponse(id,connection,now);
+    }
+}
+
+QList<QAbstractSocket*> RHttpConnectionManager::expire(qint64 now)
+{
+    QList<QAbstractSocket*> closedSockets;
+    const QList<QUuid> expiredIds = this->timingWheel.advance(now);
+    for (const QUuid &id : expiredIds)
+    {
+        QHash<QUuid,Connection>::iterator iter = this->connections.find(id);
+        if (iter == this->connections.end())
+        {
+            continue;
+        }
+        if (iter->scheduledDeadline <= now)
+        {
+            iter->scheduledDeadline = 0;
+        }
+        if (iter->deadline == 0)
+        {
+            continue;
+        }
+        if (iter->deadline > now)
+        {
+            // Deadline moved later since the entry was scheduled.
+            if (iter->scheduledDeadline == 0)
+            {
+                this->timingWheel.schedule(id,iter->deadline);
+                iter->scheduledDeadline = iter->deadline;
+            }
+            continue;
+        }
+
+        RHttpConnectionMetrics::CloseReason reason = RHttpConnectionMetrics::IdleTimeout;
+        switch (iter->phase)
+        {
+            case RHttpConnectionManager::ReadingHead:
+            {
+                reason = RHttpConnectionMetrics::HeaderTimeout;
+                break;
+            }
+            case RHttpConnectionManager::ReadingBody:
+            {
+                reason = RHttpConnectionMetrics::BodyTimeout;
+                break;
+            }
+            default:
+            {
+                reason = iter->nRequests > 0 ? RHttpConnectionMetrics::KeepAliveTimeout : RHttpConnectionMetrics::IdleTimeout;
+                break;
+            }
+        }
+        closedSockets.append(iter->pSocket);
+        this->closeConnection(id,reason);
+    }
+    if (this->connections.isEmpty())
+    {
+        this->pExpiryTimer->stop();
+    }
+    return closedSockets;
+}
+
+RHttpConnectionManager::Phase RHttpConnectionManager::getPhase(QAbstractSocket *pSocket) const
+{
+    const QUuid id = this->socketIds.value(pSocket);
+    return id.isNull() ? RHttpConnectionManager::Idle : this->connections.value(id).phase;
+}
+
+qint64 RHttpConnectionManager::getDeadline(QAbstractSocket *pSocket) const
+{
+    const QUuid id = this->socketIds.value(pSocket);
+    return id.isNull() ? 0 : this->connections.value(id).deadline;
+}
+
+bool RHttpConnectionManager::contains(QAbstractSocket *pSocket) const
+{
+    return this->socketIds.contains(pSocket);
+}
+
+qsizetype RHttpConnectionManager::size() const
+{
+    return this->connections.size();
+}
+
+qsizetype RHttpConnectionManager::getIdleCount() const
+{
+    return this->idleQueue.size();
+}
+
+bool RHttpConnectionManager::isPaused() const
+{
+    return this->paused;
+}
+
+QString RHttpConnectionManager::buildPeerKey(const QHostAddress &address, quint16 port)
+{
+    return address.toString() + QChar(':') + QString::number(port);
+}
+
+void RHttpConnectionManager::setDeadline(const QUuid &id, Connection &connection, qint64 deadline)
+{
+    connection.deadline = deadline;
+    // Later deadline is noticed when the earlier entry expires.
+    if (deadline > 0 && (connection.scheduledDeadline == 0 || deadline < connection.scheduledDeadline))
+    {
+        this->timingWheel.schedule(id,deadline);
+        connection.scheduledDeadline = deadline;
+    }
+}
+
+void RHttpConnectionManager::enterIdle(const QUuid &id, Connection &connection, qint64 now)
+{
+    this->leaveIdle(connection);
+    connection.phase = RHttpConnectionManager::Idle;
+    connection.idleSequence = ++this->idleSequence;
+    this->idleQueue.insert(connection.idleSequence,id);
+    const qint64 timeoutMs = connection.nRequests > 0 ? this->keepAliveTimeoutMs : this->idleTimeoutMs;
+    this->setDeadline(id,connection,timeoutMs > 0 ? now + timeoutMs : 0);
+    this->updatePaused();
+}
+
+void RHttpConnectionManager::leaveIdle(Connection &connection)
+{
+    if (connection.idleSequence == 0)
+    {
+        return;
+    }
+    this->idleQueue.remove(connection.idleSequence);
+    connection.idleSequence = 0;
+    this->updatePaused();
+}
+
+void RHttpConnectionManager::finishResponse(const QUuid &id, Connection &connection, qint64 now)
+{
+    if (connection.phase == RHttpConnectionManager::Processing && connection.pSocket->bytesToWrite() == 0)
+    {
+        connection.nRequests++;
+        this->enterIdle(id,connection,now);
+    }
+}
+
+void RHttpConnectionManager::closeConnection(const QUuid &id, RHttpConnectionMetrics::CloseReason reason)
+{
+    QAbstractSocket *pSocket = this->connections.value(id).pSocket;
+    this->forgetConnection(id);
+    if (this->pMetrics)
+    {
+        this->pMetrics->recordClosed(reason);
+    }
+
+    if ((reason == RHttpConnectionMetrics::HeaderTimeout || reason == RHttpConnectionMetrics::BodyTimeout)
+        && pSocket->state() == QAbstractSocket::ConnectedState)
+    {
+        pSocket->write(RHttpAdmissionGate::buildResponse(RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::RequestTimeout),this->serverName));
+        // Partial request must not reach the HTTP server.
+        pSocket->skip(pSocket->bytesAvailable());
+    }
+    pSocket->disconnectFromHost();
+}
+
+void RHttpConnectionManager::forgetConnection(const QUuid &id)
+{
+    const Connection connection = this->connections.take(id);
+    this->socketIds.remove(connection.pSocket);
+    if (this->peerIds.value(connection.peerKey) == id)
+    {
+        this->peerIds.remove(connection.peerKey);
+    }
+    if (connection.idleSequence > 0)
+    {
+        this->idleQueue.remove(connection.idleSequence);
+    }
+    QObject::disconnect(connection.pSocket, nullptr, this, nullptr);
+    if (this->pMetrics)
+    {
+        this->pMetrics->recordRemoved();
+    }
+    this->updatePaused();
+}
+
+void RHttpConnectionManager::updatePaused()
+{
+    const bool full = this->maxConnections > 0
+                   && this->connections.size() >= this->maxConnections
+                   && this->idleQueue.isEmpty();
+    if (full && !this->paused)
+    {
+        this->paused = true;
+        if (this->pMetrics)
+        {
+            this->pMetrics->recordAcceptPause();
+        }
+        emit this->acceptPaused();
+    }
+    else if (!full && this->paused)
+    {
+        this->paused = false;
+        emit this->acceptResumed();
+    }
+}
@@ -0,0 +1,128 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_connection_metrics.h"
+
+RHttpConnectionMetrics::RHttpConnectionMetrics()
+    : nOpen{0}
+    , nAccepted{0}
+    , nAcceptPauses{0}
+{
+    R_LOG_TRACE_IN;
+    for (std::atomic<quint64> &nReasonClosed : this->nClosed)
+    {
+        nReasonClosed.store(0,std::memory_order_relaxed);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpConnectionMetrics::recordOpened()
+{
+    this->nOpen.fetch_add(1,std::memory_order_relaxed);
+    this->nAccepted.fetch_add(1,std::memory_order_relaxed);
+}
+
+void RHttpConnectionMetrics::recordRemoved()
+{
+    this->nOpen.fetch_sub(1,std::memory_order_relaxed);
+}
+
+void RHttpConnectionMetrics::recordClosed(CloseReason reason)
+{
+    this->nClosed[reason].fetch_add(1,std::memory_order_relaxed);
+}
+
+void RHttpConnectionMetrics::recordAcceptPause()
+{
+    this->nAcceptPauses.fetch_add(1,std::memory_order_relaxed);
+}
+
+qint64 RHttpConnectionMetrics::getOpenCount() const
+{
+    return this->nOpen.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpConnectionMetrics::getAcceptedCount() const
+{
+    return this->nAccepted.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpConnectionMetrics::getClosedCount(CloseReason reason) const
+{
+    return this->nClosed[reason].load(std::memory_order_relaxed);
+}
+
+quint64 RHttpConnectionMetrics::getAcceptPauseCount() const
+{
+    return this->nAcceptPauses.load(std::memory_order_relaxed);
+}
+
+QByteArray RHttpConnectionMetrics::toPrometheusText() const
+{
+    R_LOG_TRACE_IN;
+    QByteArray text;
+    text += "# HELP range_cloud_connections_open Number of open client connections.\n";
+    text += "# TYPE range_cloud_connections_open gauge\n";
+    text += "range_cloud_connections_open " + QByteArray::number(this->getOpenCount()) + "\n";
+    text += "# HELP range_cloud_connections_accepted_total Number of accepted client connections.\n";
+    text += "# TYPE range_cloud_connections_accepted_total counter\n";
+    text += "range_cloud_connections_accepted_total " + QByteArray::number(this->getAcceptedCount()) + "\n";
+    text += "# HELP range_cloud_connections_closed_total Number of client connections closed by the server by reason.\n";
+    text += "# TYPE range_cloud_connections_closed_total counter\n";
+    for (int reason = 0; reason < RHttpConnectionMetrics::nCloseReasons; reason++)
+    {
+        text += "range_cloud_connections_closed_total{reason=\"" + RHttpConnectionMetrics::closeReasonToString(CloseReason(reason)).toUtf8() + "\"} "
+              + QByteArray::number(this->getClosedCount(CloseReason(reason))) + "\n";
+    }
+    text += "# HELP range_cloud_connections_accept_pauses_total Number of times accepting stopped at the connection limit.\n";
+    text += "# TYPE range_cloud_connections_accept_pauses_total counter\n";
+    text += "range_cloud_connections_accept_pauses_total " + QByteArray::number(this->getAcceptPauseCount()) + "\n";
+    R_LOG_TRACE_RETURN(text);
+}
+
+QJsonObject RHttpConnectionMetrics::toJson() const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject closedObject;
+    for (int reason = 0; reason < RHttpConnectionMetrics::nCloseReasons; reason++)
+    {
+        closedObject[RHttpConnectionMetrics::closeReasonToString(CloseReason(reason))] = qint64(this->getClosedCount(CloseReason(reason)));
+    }
+
+    QJsonObject json;
+    json["open"] = this->getOpenCount();
+    json["accepted"] = qint64(this->getAcceptedCount());
+    json["closed"] = closedObject;
+    json["accept-pauses"] = qint64(this->getAcceptPauseCount());
+    R_LOG_TRACE_RETURN(json);
+}
+
+QString RHttpConnectionMetrics::closeReasonToString(CloseReason reason)
+{
+    switch (reason)
+    {
+        case RHttpConnectionMetrics::IdleTimeout:
+        {
+            return "idle-timeout";
+        }
+        case RHttpConnectionMetrics::KeepAliveTimeout:
+        {
+            return "keep-alive-timeout";
+        }
+        case RHttpConnectionMetrics::HeaderTimeout:
+        {
+            return "header-timeout";
+        }
+        case RHttpConnectionMetrics::BodyTimeout:
+        {
+            return "body-timeout";
+        }
+        case RHttpConnectionMetrics::Evicted:
+        {
+            return "evicted";
+        }
+        default:
+        {
+            return QString();
+        }
+    }
+}
@@ -0,0 +1,296 @@
+#include <QHash>
+#include <QList>
+
+#include <rbl_logger.h>
+
+#include <zlib.h>
+#ifdef RCL_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "rcl_http_content_encoder.h"
+
+//! Window bits selecting gzip wrapper in zlib.
+static constexpr int gzipWindowBits = 15 + 16;
+
+static QByteArray gzipEncode(const QByteArray &data, int level)
+{
+    z_stream stream{};
+    if (deflateInit2(&stream,level,Z_DEFLATED,gzipWindowBits,8,Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return QByteArray();
+    }
+
+    QByteArray output;
+    output.resize(qsizetype(deflateBound(&stream,uLong(data.size()))));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    stream.avail_in = uInt(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = uInt(output.size());
+
+    const int result = deflate(&stream,Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
+    {
+        return QByteArray();
+    }
+    output.resize(qsizetype(stream.total_out));
+    return output;
+}
+
+static QByteArray gzipDecode(const QByteArray &data)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream,gzipWindowBits) != Z_OK)
+    {
+        return QByteArray();
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    stream.avail_in = uInt(data.size());
+
+    QByteArray output;
+    int result = Z_OK;
+    char buffer[16384];
+    while (result == Z_OK)
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = uInt(sizeof(buffer));
+        result = inflate(&stream,Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END)
+        {
+            break;
+        }
+        output.append(buffer,qsizetype(sizeof(buffer) - stream.avail_out));
+    }
+    inflateEnd(&stream);
+    return (result == Z_STREAM_END) ? output : QByteArray();
+}
+
+#ifdef RCL_HAVE_ZSTD
+static QByteArray zstdEncode(const QByteArray &data, int level)
+{
+    QByteArray output;
+    output.resize(qsizetype(ZSTD_compressBound(size_t(data.size()))));
+    const size_t nBytes = ZSTD_compress(output.data(),size_t(output.size()),data.constData(),size_t(data.size()),level);
+    if (ZSTD_isError(nBytes))
+    {
+        return QByteArray();
+    }
+    output.resize(qsizetype(nBytes));
+    return output;
+}
+
+static QByteArray zstdDecode(const QByteArray &data)
+{
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if (!stream)
+    {
+        return QByteArray();
+    }
+    ZSTD_initDStream(stream);
+
+    ZSTD_inBuffer input{data.constData(),size_t(data.size()),0};
+    QByteArray output;
+    char buffer[16384];
+    size_t result = 1;
+    while (input.pos < input.size)
+    {
+        ZSTD_outBuffer outBuffer{buffer,sizeof(buffer),0};
+        result = ZSTD_decompressStream(stream,&outBuffer,&input);
+        if (ZSTD_isError(result))
+        {
+            break;
+        }
+        output.append(buffer,qsizetype(outBuffer.pos));
+    }
+    ZSTD_freeDStream(stream);
+    return (result == 0) ? output : QByteArray();
+}
+#endif
+
+bool RHttpContentEncoder::isAvailable(Encoding encoding)
+{
+    switch (encoding)
+    {
+        case RHttpContentEncoder::Identity:
+        case RHttpContentEncoder::Gzip:
+        {
+            return true;
+        }
+        case RHttpContentEncoder::Zstd:
+        {
+#ifdef RCL_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+QByteArray RHttpContentEncoder::toName(Encoding encoding)
+{
+    switch (encoding)
+    {
+        case RHttpContentEncoder::Gzip:
+        {
+            return QByteArray("gzip");
+        }
+        case RHttpContentEncoder::Zstd:
+        {
+            return QByteArray("zstd");
+        }
+        case RHttpContentEncoder::Identity:
+        default:
+        {
+            return QByteArray("identity");
+        }
+    }
+}
+
+RHttpContentEncoder::Encoding RHttpContentEncoder::negotiate(QByteArrayView acceptEncoding)
+{
+    // Prefer zstd over gzip when both are accepted with the same quality.
+    const QList<Encoding> candidates = {RHttpContentEncoder::Zstd, RHttpContentEncoder::Gzip};
+
+    Encoding bestEncoding = RHttpContentEncoder::Identity;
+    double bestQuality = 0.0;
+    double wildcardQuality = -1.0;
+
+    QHash<QByteArray,double> qualities;
+    for (QByteArrayView token : QByteArrayView(acceptEncoding).tokenize(','))
+    {
+        token = token.trimmed();
+        if (token.isEmpty())
+        {
+            continue;
+        }
+        double quality = 1.0;
+        const qsizetype separator = token.indexOf(';');
+        QByteArrayView coding = token;
+        if (separator >= 0)
+        {
+            coding = token.first(separator).trimmed();
+            QByteArrayView parameter = token.sliced(separator + 1).trimmed();
+            if (parameter.startsWith("q=") || parameter.startsWith("Q="))
+            {
+                bool isOk = false;
+                quality = parameter.sliced(2).trimmed().toDouble(&isOk);
+                if (!isOk)
+                {
+                    quality = 0.0;
+                }
+            }
+        }
+        const QByteArray codingName = coding.toByteArray().toLower();
+        if (codingName == "*")
+        {
+            wildcardQuality = quality;
+        }
+        else
+        {
+            qualities.insert(codingName,quality);
+        }
+    }
+
+    for (Encoding encoding : candidates)
+    {
+        if (!RHttpContentEncoder::isAvailable(encoding))
+        {
+            continue;
+        }
+        const double quality = qualities.value(RHttpContentEncoder::toName(encoding),wildcardQuality);
+        if (quality > bestQuality)
+        {
+            bestQuality = quality;
+            bestEncoding = encoding;
+        }
+    }
+
+    return bestEncoding;
+}
+
+QByteArray RHttpContentEncoder::encode(const QByteArray &data, Encoding encoding)
+{
+    switch (encoding)
+    {
+        case RHttpContentEncoder::Gzip:
+        {
+            return gzipEncode(data,RHttpContentEncoder::defaultGzipLevel);
+        }
+        case RHttpContentEncoder::Zstd:
+        {
+#ifdef RCL_HAVE_ZSTD
+            return zstdEncode(data,RHttpContentEncoder::defaultZstdLevel);
+#else
+            return QByteArray();
+#endif
+        }
+        case RHttpContentEncoder::Identity:
+        default:
+        {
+            return data;
+        }
+    }
+}
+
+QByteArray RHttpContentEncoder::decode(const QByteArray &data, Encoding encoding)
+{
+    switch (encoding)
+    {
+        case RHttpContentEncoder::Gzip:
+        {
+            return gzipDecode(data);
+        }
+        case RHttpContentEncoder::Zstd:
+        {
+#ifdef RCL_HAVE_ZSTD
+            return zstdDecode(data);
+#else
+            return QByteArray();
+#endif
+        }
+        case RHttpContentEncoder::Identity:
+        default:
+        {
+            return data;
+        }
+    }
+}
+
+bool RHttpContentEncoder::encodeMessage(RHttpMessage &httpMessage, Encoding encoding, qint64 minSize)
+{
+    R_LOG_TRACE_IN;
+    if (encoding == RHttpContentEncoder::Identity ||
+        httpMessage.getBodyDevice() ||
+        httpMessage.getBody().size() < minSize ||
+        httpMessage.getResponseHeaders().contains(QHttpHeaders::WellKnownHeader::ContentEncoding))
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    QByteArray encodedBody = RHttpContentEncoder::encode(httpMessage.getBody(),encoding);
+    if (encodedBody.isEmpty() || encodedBody.size() >= httpMessage.getBody().size())
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    QHttpHeaders responseHeaders(httpMessage.getResponseHeaders());
+    responseHeaders.append(QHttpHeaders::WellKnownHeader::ContentEncoding,RHttpContentEncoder::toName(encoding));
+    responseHeaders.append(QHttpHeaders::WellKnownHeader::Vary,"Accept-Encoding");
+    // Encoded bytes differ from the identity representation, strong entity tag is weakened.
+    const QByteArray entityTag = responseHeaders.value(QHttpHeaders::WellKnownHeader::ETag).trimmed().toByteArray();
+    if (!entityTag.isEmpty() && !entityTag.startsWith("W/"))
+    {
+        responseHeaders.replaceOrAppend(QHttpHeaders::WellKnownHeader::ETag,"W/" + entityTag);
+    }
+    httpMessage.setResponseHeaders(responseHeaders);
+    httpMessage.setBody(encodedBody);
+    R_LOG_TRACE_RETURN(true);
+}
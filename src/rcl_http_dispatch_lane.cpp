@@ -0,0 +1,146 @@
+#include <QMutexLocker>
+#include <QThread>
+
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_dispatch_lane.h"
+
+RHttpDispatchLane::RHttpDispatchLane(Type type, qsizetype maxConcurrency, qsizetype maxQueueSize)
+    : type{type}
+    , maxConcurrency{qMax(qsizetype(1),maxConcurrency)}
+    , maxQueueSize{qMax(qsizetype(0),maxQueueSize)}
+    , nActive{0}
+{
+    R_LOG_TRACE_IN;
+    this->threadPool.setMaxThreadCount(int(qMin(this->maxConcurrency,qsizetype(QThread::idealThreadCount()))));
+    this->threadPool.setObjectName("RHttpDispatchLane::" + RHttpDispatchLane::typeToString(type));
+    R_LOG_TRACE_OUT;
+}
+
+RHttpDispatchLane::~RHttpDispatchLane()
+{
+    // Waiting requests are cancelled together with their promises.
+    this->waitQueue.clear();
+    this->threadPool.waitForDone();
+}
+
+RHttpDispatchLane::Type RHttpDispatchLane::getType() const
+{
+    return this->type;
+}
+
+RHttpDispatchLane::Admission RHttpDispatchLane::acquire(QFuture<void> &slotFuture)
+{
+    QMutexLocker locker(&this->mutex);
+    if (this->nActive < this->maxConcurrency)
+    {
+        this->nActive++;
+        return RHttpDispatchLane::Granted;
+    }
+    if (this->waitQueue.size() >= this->maxQueueSize)
+    {
+        return RHttpDispatchLane::Rejected;
+    }
+    std::shared_ptr<QPromise<void>> pPromise = std::make_shared<QPromise<void>>();
+    pPromise->start();
+    slotFuture = pPromise->future();
+    this->waitQueue.enqueue(pPromise);
+    return RHttpDispatchLane::Queued;
+}
+
+void RHttpDispatchLane::release()
+{
+    std::shared_ptr<QPromise<void>> pPromise;
+    {
+        QMutexLocker locker(&this->mutex);
+        if (this->waitQueue.isEmpty())
+        {
+            this->nActive = qMax(qsizetype(0),this->nActive - 1);
+            return;
+        }
+        // Slot is handed over to the first waiting request.
+        pPromise = this->waitQueue.dequeue();
+    }
+    pPromise->finish();
+}
+
+qsizetype RHttpDispatchLane::getMaxConcurrency() const
+{
+    return this->maxConcurrency;
+}
+
+qsizetype RHttpDispatchLane::getActiveCount() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->nActive;
+}
+
+qsizetype RHttpDispatchLane::getQueuedCount() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->waitQueue.size();
+}
+
+QThreadPool *RHttpDispatchLane::getThreadPool()
+{
+    return &this->threadPool;
+}
+
+RHttpDispatchLane::Type RHttpDispatchLane::findTypeForAction(const QString &actionKey)
+{
+    if (RCloudAction::isBulkAction(actionKey))
+    {
+        return RHttpDispatchLane::Bulk;
+    }
+    if (RCloudAction::isAdminAction(actionKey))
+    {
+        return RHttpDispatchLane::Admin;
+    }
+    // Everything else (listings, info, metadata updates, test request) is interactive.
+    return RHttpDispatchLane::Interactive;
+}
+
+QString RHttpDispatchLane::typeToString(Type type)
+{
+    switch (type)
+    {
+        case RHttpDispatchLane::Interactive:
+        {
+            return "interactive";
+        }
+        case RHttpDispatchLane::Bulk:
+        {
+            return "bulk";
+        }
+        case RHttpDispatchLane::Admin:
+        {
+            return "admin";
+        }
+        default:
+        {
+            return QString();
+        }
+    }
+}
+
+QByteArray RHttpDispatchLane::toPrometheusText(const QList<RHttpDispatchLane*> &lanes)
+{
+    QByteArray activeText;
+    QByteArray queuedText;
+    for (const RHttpDispatchLane *pLane : lanes)
+    {
+        const QByteArray laneLabel = "{lane=\"" + RHttpDispatchLane::typeToString(pLane->getType()).toUtf8() + "\"} ";
+        activeText += "range_cloud_http_lane_active" + laneLabel + QByteArray::number(pLane->getActiveCount()) + "\n";
+        queuedText += "range_cloud_http_lane_queued" + laneLabel + QByteArray::number(pLane->getQueuedCount()) + "\n";
+    }
+
+    QByteArray text;
+    text += "# HELP range_cloud_http_lane_active Number of requests being processed in dispatch lane.\n";
+    text += "# TYPE range_cloud_http_lane_active gauge\n";
+    text += activeText;
+    text += "# HELP range_cloud_http_lane_queued Number of requests waiting in dispatch lane.\n";
+    text += "# TYPE range_cloud_http_lane_queued gauge\n";
+    text += queuedText;
+    return text;
+}
@@ -0,0 +1,120 @@
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_entity_tag_cache.h"
+
+RHttpEntityTagCache::RHttpEntityTagCache(qsizetype maxEntries, qint64 ttlMs)
+    : ttlMs{ttlMs}
+    , cache{maxEntries}
+    , generation{0}
+    , nHits{0}
+    , nRevalidated{0}
+    , nInvalidations{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+QByteArray RHttpEntityTagCache::find(const QString &key, qint64 currentTime)
+{
+    QMutexLocker locker(&this->mutex);
+    Entry *pEntry = this->cache.object(key);
+    if (!pEntry)
+    {
+        return QByteArray();
+    }
+    if (pEntry->expiryTime <= currentTime)
+    {
+        this->cache.remove(key);
+        return QByteArray();
+    }
+    return pEntry->entityTag;
+}
+
+void RHttpEntityTagCache::insert(const QString &key, const QByteArray &entityTag, quint64 generation, qint64 currentTime)
+{
+    QMutexLocker locker(&this->mutex);
+    // Checked under the lock, invalidate() clears the cache under the same lock.
+    if (generation != this->generation.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    this->cache.insert(key,new Entry{entityTag,currentTime + this->ttlMs});
+}
+
+void RHttpEntityTagCache::invalidate()
+{
+    QMutexLocker locker(&this->mutex);
+    this->generation.fetch_add(1,std::memory_order_relaxed);
+    this->nInvalidations.fetch_add(1,std::memory_order_relaxed);
+    this->cache.clear();
+}
+
+quint64 RHttpEntityTagCache::getGeneration() const
+{
+    return this->generation.load(std::memory_order_relaxed);
+}
+
+void RHttpEntityTagCache::recordHit()
+{
+    this->nHits.fetch_add(1,std::memory_order_relaxed);
+}
+
+void RHttpEntityTagCache::recordRevalidation()
+{
+    this->nRevalidated.fetch_add(1,std::memory_order_relaxed);
+}
+
+qsizetype RHttpEntityTagCache::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->cache.size();
+}
+
+quint64 RHttpEntityTagCache::getHitCount() const
+{
+    return this->nHits.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpEntityTagCache::getRevalidatedCount() const
+{
+    return this->nRevalidated.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpEntityTagCache::getInvalidationCount() const
+{
+    return this->nInvalidations.load(std::memory_order_relaxed);
+}
+
+QJsonObject RHttpEntityTagCache::toJson() const
+{
+    QJsonObject json;
+    json["hits"] = qint64(this->getHitCount());
+    json["revalidated"] = qint64(this->getRevalidatedCount());
+    json["invalidations"] = qint64(this->getInvalidationCount());
+    json["size"] = qint64(this->size());
+    return json;
+}
+
+QByteArray RHttpEntityTagCache::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_not_modified_total Number of \"304 Not Modified\" responses by source.\n";
+    text += "# TYPE range_cloud_not_modified_total counter\n";
+    text += "range_cloud_not_modified_total{source=\"cache\"} " + QByteArray::number(this->getHitCount()) + "\n";
+    text += "range_cloud_not_modified_total{source=\"backend\"} " + QByteArray::number(this->getRevalidatedCount()) + "\n";
+    text += "# HELP range_cloud_entity_tag_invalidations_total Number of entity tag cache invalidations.\n";
+    text += "# TYPE range_cloud_entity_tag_invalidations_total counter\n";
+    text += "range_cloud_entity_tag_invalidations_total " + QByteArray::number(this->getInvalidationCount()) + "\n";
+    text += "# HELP range_cloud_entity_tag_entries Number of cached entity tags.\n";
+    text += "# TYPE range_cloud_entity_tag_entries gauge\n";
+    text += "range_cloud_entity_tag_entries " + QByteArray::number(this->size()) + "\n";
+    return text;
+}
+
+QString RHttpEntityTagCache::buildKey(const QString &user, const QString &actionKey, const QString &resourceName, const QUuid &resourceId)
+{
+    // User names and action keys cannot contain new line.
+    return user + QChar('\n') + actionKey + QChar('\n') + resourceId.toString(QUuid::WithoutBraces) + QChar('\n') + resourceName;
+}
@@ -0,0 +1,221 @@
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_idempotency_store.h"
+
+RHttpIdempotencyStore::RHttpIdempotencyStore(qsizetype maxEntries, qint64 ttlMs)
+    : maxEntries{maxEntries}
+    , ttlMs{ttlMs}
+    , nStarted{0}
+    , nAttached{0}
+    , nReplayed{0}
+    , nConflicts{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RHttpIdempotencyStore::Result RHttpIdempotencyStore::begin(const QString &user, const QString &key, const QString &fingerprint, qint64 currentTime, QFuture<RHttpMessage> &future)
+{
+    R_LOG_TRACE_IN;
+    const QString entryKey = RHttpIdempotencyStore::buildKey(user,key);
+
+    QMutexLocker locker(&this->mutex);
+    this->removeExpired(currentTime);
+
+    QHash<QString,Entry>::iterator iter = this->entries.find(entryKey);
+    if (iter != this->entries.end())
+    {
+        if (iter->fingerprint != fingerprint)
+        {
+            this->nConflicts.fetch_add(1,std::memory_order_relaxed);
+            R_LOG_TRACE_RETURN(RHttpIdempotencyStore::Conflict);
+        }
+        std::shared_ptr<QPromise<RHttpMessage>> pPromise = std::make_shared<QPromise<RHttpMessage>>();
+        pPromise->start();
+        future = pPromise->future();
+        if (iter->finished)
+        {
+            pPromise->addResult(iter->response);
+            pPromise->finish();
+            this->nReplayed.fetch_add(1,std::memory_order_relaxed);
+            R_LOG_TRACE_RETURN(RHttpIdempotencyStore::Replayed);
+        }
+        iter->waiting.append(pPromise);
+        this->nAttached.fetch_add(1,std::memory_order_relaxed);
+        R_LOG_TRACE_RETURN(RHttpIdempotencyStore::Attached);
+    }
+
+    this->nStarted.fetch_add(1,std::memory_order_relaxed);
+    // When full of keys which have not expired yet, the request is processed without being remembered.
+    if (this->entries.size() < this->maxEntries)
+    {
+        const qint64 expiryTime = currentTime + this->ttlMs;
+        this->entries.insert(entryKey,Entry{fingerprint,expiryTime,false,RHttpMessage(),{}});
+        this->expiryQueue.enqueue(ExpiryItem{entryKey,expiryTime});
+    }
+    R_LOG_TRACE_RETURN(RHttpIdempotencyStore::Started);
+}
+
+void RHttpIdempotencyStore::finish(const QString &user, const QString &key, const RHttpMessage &response)
+{
+    R_LOG_TRACE_IN;
+    const QString entryKey = RHttpIdempotencyStore::buildKey(user,key);
+
+    // Body device can be sent only once, retries get the rest of the response.
+    RHttpMessage recordedResponse(response);
+    recordedResponse.setBodyDevice(QSharedPointer<QIODevice>());
+
+    QList<std::shared_ptr<QPromise<RHttpMessage>>> waiting;
+    {
+        QMutexLocker locker(&this->mutex);
+        QHash<QString,Entry>::iterator iter = this->entries.find(entryKey);
+        if (iter == this->entries.end() || iter->finished)
+        {
+            R_LOG_TRACE_OUT;
+            return;
+        }
+        waiting.swap(iter->waiting);
+        if (response.getErrorType() == RError::None)
+        {
+            iter->finished = true;
+            iter->response = recordedResponse;
+        }
+        else
+        {
+            // Failure may be transient, next retry is processed again.
+            this->entries.erase(iter);
+        }
+    }
+
+    for (const std::shared_ptr<QPromise<RHttpMessage>> &pPromise : std::as_const(waiting))
+    {
+        pPromise->addResult(recordedResponse);
+        pPromise->finish();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpIdempotencyStore::abandon(const QString &user, const QString &key)
+{
+    R_LOG_TRACE_IN;
+    const QString entryKey = RHttpIdempotencyStore::buildKey(user,key);
+
+    QList<std::shared_ptr<QPromise<RHttpMessage>>> waiting;
+    {
+        QMutexLocker locker(&this->mutex);
+        QHash<QString,Entry>::iterator iter = this->entries.find(entryKey);
+        if (iter == this->entries.end() || iter->finished)
+        {
+            R_LOG_TRACE_OUT;
+            return;
+        }
+        waiting.swap(iter->waiting);
+        this->entries.erase(iter);
+    }
+
+    for (const std::shared_ptr<QPromise<RHttpMessage>> &pPromise : std::as_const(waiting))
+    {
+        pPromise->future().cancel();
+        pPromise->finish();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+qsizetype RHttpIdempotencyStore::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->entries.size();
+}
+
+quint64 RHttpIdempotencyStore::getStartedCount() const
+{
+    return this->nStarted.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpIdempotencyStore::getAttachedCount() const
+{
+    return this->nAttached.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpIdempotencyStore::getReplayedCount() const
+{
+    return this->nReplayed.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpIdempotencyStore::getConflictCount() const
+{
+    return this->nConflicts.load(std::memory_order_relaxed);
+}
+
+QJsonObject RHttpIdempotencyStore::toJson() const
+{
+    QJsonObject json;
+    json["started"] = qint64(this->getStartedCount());
+    json["attached"] = qint64(this->getAttachedCount());
+    json["replayed"] = qint64(this->getReplayedCount());
+    json["conflicts"] = qint64(this->getConflictCount());
+    json["size"] = qint64(this->size());
+    return json;
+}
+
+QByteArray RHttpIdempotencyStore::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_idempotency_requests_total Number of requests carrying idempotency key by outcome.\n";
+    text += "# TYPE range_cloud_idempotency_requests_total counter\n";
+    text += "range_cloud_idempotency_requests_total{result=\"started\"} " + QByteArray::number(this->getStartedCount()) + "\n";
+    text += "range_cloud_idempotency_requests_total{result=\"attached\"} " + QByteArray::number(this->getAttachedCount()) + "\n";
+    text += "range_cloud_idempotency_requests_total{result=\"replayed\"} " + QByteArray::number(this->getReplayedCount()) + "\n";
+    text += "range_cloud_idempotency_requests_total{result=\"conflict\"} " + QByteArray::number(this->getConflictCount()) + "\n";
+    text += "# HELP range_cloud_idempotency_entries Number of remembered idempotency keys.\n";
+    text += "# TYPE range_cloud_idempotency_entries gauge\n";
+    text += "range_cloud_idempotency_entries " + QByteArray::number(this->size()) + "\n";
+    return text;
+}
+
+bool RHttpIdempotencyStore::isValidKey(const QString &key)
+{
+    if (key.isEmpty() || key.size() > RHttpIdempotencyStore::maxKeyLength)
+    {
+        return false;
+    }
+    for (const QChar &c : key)
+    {
+        if (c.unicode() <= 0x20 || c.unicode() >= 0x7f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RHttpIdempotencyStore::removeExpired(qint64 currentTime)
+{
+    // TTL is the same for all entries, so the queue is ordered by expiry time.
+    QList<std::shared_ptr<QPromise<RHttpMessage>>> waiting;
+    while (!this->expiryQueue.isEmpty() && this->expiryQueue.head().expiryTime <= currentTime)
+    {
+        const ExpiryItem item = this->expiryQueue.dequeue();
+        QHash<QString,Entry>::iterator iter = this->entries.find(item.key);
+        // Entry may have been removed, or removed and started again.
+        if (iter != this->entries.end() && iter->expiryTime == item.expiryTime)
+        {
+            // Original request which has not finished within TTL is not waited for any more.
+            waiting.append(iter->waiting);
+            this->entries.erase(iter);
+        }
+    }
+    for (const std::shared_ptr<QPromise<RHttpMessage>> &pPromise : std::as_const(waiting))
+    {
+        pPromise->future().cancel();
+        pPromise->finish();
+    }
+}
+
+QString RHttpIdempotencyStore::buildKey(const QString &user, const QString &key)
+{
+    // Keys cannot contain new line.
+    return user + QChar('\n') + key;
+}
@@ -0,0 +1,97 @@
+#include <QtAlgorithms>
+
+#include <cmath>
+
+#include "rcl_http_latency_histogram.h"
+
+RHttpLatencyHistogram::RHttpLatencyHistogram()
+    : count{0}
+    , sum{0}
+    , max{0}
+{
+    for (std::atomic<quint64> &bucket : this->buckets)
+    {
+        bucket.store(0,std::memory_order_relaxed);
+    }
+}
+
+void RHttpLatencyHistogram::record(qint64 valueUs)
+{
+    valueUs = qBound(qint64(0),valueUs,RHttpLatencyHistogram::maxValue);
+
+    this->buckets[RHttpLatencyHistogram::findBucket(valueUs)].fetch_add(1,std::memory_order_relaxed);
+    this->count.fetch_add(1,std::memory_order_relaxed);
+    this->sum.fetch_add(quint64(valueUs),std::memory_order_relaxed);
+
+    qint64 currentMax = this->max.load(std::memory_order_relaxed);
+    while (valueUs > currentMax && !this->max.compare_exchange_weak(currentMax,valueUs,std::memory_order_relaxed))
+    {
+    }
+}
+
+quint64 RHttpLatencyHistogram::getCount() const
+{
+    return this->count.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpLatencyHistogram::getSum() const
+{
+    return this->sum.load(std::memory_order_relaxed);
+}
+
+qint64 RHttpLatencyHistogram::getMax() const
+{
+    return this->max.load(std::memory_order_relaxed);
+}
+
+qint64 RHttpLatencyHistogram::findQuantile(double quantile) const
+{
+    // Counters are read one by one, total is taken from the buckets so that
+    // a concurrent record() cannot push the rank past the last bucket.
+    quint64 bucketCounts[RHttpLatencyHistogram::nBuckets];
+    quint64 totalCount = 0;
+    for (int i = 0; i < RHttpLatencyHistogram::nBuckets; i++)
+    {
+        bucketCounts[i] = this->buckets[i].load(std::memory_order_relaxed);
+        totalCount += bucketCounts[i];
+    }
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+
+    const quint64 rank = qMax(quint64(1),quint64(std::ceil(qBound(0.0,quantile,1.0) * double(totalCount))));
+    quint64 cumulativeCount = 0;
+    for (int i = 0; i < RHttpLatencyHistogram::nBuckets; i++)
+    {
+        cumulativeCount += bucketCounts[i];
+        if (cumulativeCount >= rank)
+        {
+            return qMin(RHttpLatencyHistogram::findBucketUpperBound(i),this->getMax());
+        }
+    }
+    return this->getMax();
+}
+
+int RHttpLatencyHistogram::findBucket(qint64 valueUs)
+{
+    if (valueUs < RHttpLatencyHistogram::subBucketCount)
+    {
+        return int(qMax(qint64(0),valueUs));
+    }
+    const int exponent = 63 - qCountLeadingZeroBits(quint64(valueUs));
+    const int shift = exponent - RHttpLatencyHistogram::subBucketBits;
+    const int subBucket = int(valueUs >> shift) - RHttpLatencyHistogram::subBucketCount;
+    return RHttpLatencyHistogram::subBucketCount + shift * RHttpLatencyHistogram::subBucketCount + subBucket;
+}
+
+qint64 RHttpLatencyHistogram::findBucketUpperBound(int bucket)
+{
+    if (bucket < RHttpLatencyHistogram::subBucketCount)
+    {
+        return bucket;
+    }
+    const int shift = (bucket - RHttpLatencyHistogram::subBucketCount) / RHttpLatencyHistogram::subBucketCount;
+    const int subBucket = (bucket - RHttpLatencyHistogram::subBucketCount) % RHttpLatencyHistogram::subBucketCount;
+    return ((qint64(RHttpLatencyHistogram::subBucketCount + subBucket + 1)) << shift) - 1;
+}
@@ -0,0 +1,146 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_load_shedder.h"
+
+RHttpLoadShedder::RHttpLoadShedder(const QList<QString> &actionKeys)
+{
+    R_LOG_TRACE_IN;
+    for (const QString &actionKey : actionKeys)
+    {
+        this->actionEstimates.insert(actionKey,new Estimate);
+    }
+    for (std::atomic<quint64> &nShed : this->nShed)
+    {
+        nShed.store(0,std::memory_order_relaxed);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpLoadShedder::~RHttpLoadShedder()
+{
+    qDeleteAll(this->actionEstimates);
+}
+
+void RHttpLoadShedder::recordServiceTime(const QString &action, RHttpDispatchLane::Type laneType, qint64 serviceTime)
+{
+    if (serviceTime < 0)
+    {
+        return;
+    }
+    if (Estimate *pEstimate = this->actionEstimates.value(action,nullptr))
+    {
+        RHttpLoadShedder::addSample(*pEstimate,serviceTime);
+    }
+    if (laneType >= 0 && laneType < RHttpDispatchLane::nTypes)
+    {
+        RHttpLoadShedder::addSample(this->laneEstimates[laneType],serviceTime);
+    }
+}
+
+qint64 RHttpLoadShedder::getServiceTime(const QString &action) const
+{
+    const Estimate *pEstimate = this->actionEstimates.value(action,nullptr);
+    return pEstimate ? pEstimate->serviceTime.load(std::memory_order_relaxed) : 0;
+}
+
+qint64 RHttpLoadShedder::getLaneServiceTime(RHttpDispatchLane::Type laneType) const
+{
+    if (laneType < 0 || laneType >= RHttpDispatchLane::nTypes)
+    {
+        return 0;
+    }
+    return this->laneEstimates[laneType].serviceTime.load(std::memory_order_relaxed);
+}
+
+bool RHttpLoadShedder::admitQueued(const QString &action, RHttpDispatchLane::Type laneType, qsizetype nQueued, qsizetype concurrency, qint64 timeLeft, qint64 &retryAfterMs)
+{
+    // Slot is freed every (lane service time / concurrency) on average and all queued requests are ahead.
+    const qint64 waitTime = (qint64(nQueued) + 1) * this->getLaneServiceTime(laneType) / qMax(qsizetype(1),concurrency);
+    if (waitTime + this->getServiceTime(action) <= timeLeft)
+    {
+        return true;
+    }
+    this->nShed[RHttpLoadShedder::Admission].fetch_add(1,std::memory_order_relaxed);
+    retryAfterMs = RHttpLoadShedder::toRetryAfter(waitTime);
+    return false;
+}
+
+bool RHttpLoadShedder::admitDispatch(const QString &action, RHttpDispatchLane::Type laneType, qint64 timeLeft, qint64 &retryAfterMs)
+{
+    if (this->getServiceTime(action) <= timeLeft)
+    {
+        return true;
+    }
+    this->nShed[RHttpLoadShedder::Dispatch].fetch_add(1,std::memory_order_relaxed);
+    retryAfterMs = RHttpLoadShedder::toRetryAfter(this->getLaneServiceTime(laneType));
+    return false;
+}
+
+quint64 RHttpLoadShedder::getShedCount(Stage stage) const
+{
+    return this->nShed[stage].load(std::memory_order_relaxed);
+}
+
+QJsonObject RHttpLoadShedder::toJson() const
+{
+    QJsonObject json;
+    QJsonObject shedJson;
+    for (int i = 0; i < RHttpLoadShedder::nStages; i++)
+    {
+        shedJson[RHttpLoadShedder::stageToString(Stage(i))] = qint64(this->getShedCount(Stage(i)));
+    }
+    json["shed"] = shedJson;
+    QJsonObject lanesJson;
+    for (int i = 0; i < RHttpDispatchLane::nTypes; i++)
+    {
+        lanesJson[RHttpDispatchLane::typeToString(RHttpDispatchLane::Type(i))] = double(this->getLaneServiceTime(RHttpDispatchLane::Type(i))) / 1.0e6;
+    }
+    json["service-time"] = lanesJson;
+    return json;
+}
+
+QByteArray RHttpLoadShedder::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_load_shed_total Number of requests rejected because they could not be answered in time.\n";
+    text += "# TYPE range_cloud_load_shed_total counter\n";
+    for (int i = 0; i < RHttpLoadShedder::nStages; i++)
+    {
+        text += "range_cloud_load_shed_total{stage=\"" + RHttpLoadShedder::stageToString(Stage(i)).toUtf8() + "\"} "
+              + QByteArray::number(this->getShedCount(Stage(i))) + "\n";
+    }
+    text += "# HELP range_cloud_lane_service_time_seconds Moving average of backend service time per dispatch lane.\n";
+    text += "# TYPE range_cloud_lane_service_time_seconds gauge\n";
+    for (int i = 0; i < RHttpDispatchLane::nTypes; i++)
+    {
+        text += "range_cloud_lane_service_time_seconds{lane=\"" + RHttpDispatchLane::typeToString(RHttpDispatchLane::Type(i)).toUtf8() + "\"} "
+              + QByteArray::number(double(this->getLaneServiceTime(RHttpDispatchLane::Type(i))) / 1.0e6) + "\n";
+    }
+    return text;
+}
+
+QString RHttpLoadShedder::stageToString(Stage stage)
+{
+    switch (stage)
+    {
+        case RHttpLoadShedder::Admission: return "admission";
+        case RHttpLoadShedder::Dispatch:  return "dispatch";
+        default:                          return "unknown";
+    }
+}
+
+void RHttpLoadShedder::addSample(Estimate &estimate, qint64 sample)
+{
+    // Lock-free update, concurrent samples are folded in one after another.
+    qint64 average = estimate.serviceTime.load(std::memory_order_relaxed);
+    qint64 newAverage;
+    do
+    {
+        newAverage = (average == 0) ? qMax(qint64(1),sample) : qMax(qint64(1),qint64(double(average) + smoothingFactor * double(sample - average)));
+    } while (!estimate.serviceTime.compare_exchange_weak(average,newAverage,std::memory_order_relaxed));
+}
+
+qint64 RHttpLoadShedder::toRetryAfter(qint64 waitTime)
+{
+    return qMax(qint64(1000),(waitTime + 999) / 1000);
+}
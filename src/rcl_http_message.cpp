@@ -2,6 +2,9 @@
 #include "rcl_http_message.h"
 #include <rbl_logger.h>
 
+const QByteArray RHttpMessage::requestTimeoutHeader = "X-Request-Timeout";
+const QByteArray RHttpMessage::idempotencyKeyHeader = "Idempotency-Key";
+
 void RHttpMessage::_init(const RHttpMessage *pHttpMessage)
 {
     if (pHttpMessage)
@@ -10,6 +13,7 @@ void RHttpMessage::_init(const RHttpMessage *pHttpMessage)
         this->urlQuery = pHttpMessage->urlQuery;
         this->requestHeaders = pHttpMessage->requestHeaders;
         this->responseHeaders = pHttpMessage->responseHeaders;
+        this->bodyDevice = pHttpMessage->bodyDevice;
     }
 }
 
@@ -117,6 +121,26 @@ void RHttpMessage::setResponseHeaders(const QHttpHeaders &responseHeaders)
     this->responseHeaders = responseHeaders;
 }
 
+QByteArray RHttpMessage::getEntityTag() const
+{
+    return this->responseHeaders.value(QHttpHeaders::WellKnownHeader::ETag).trimmed().toByteArray();
+}
+
+void RHttpMessage::setEntityTag(const QByteArray &entityTag)
+{
+    this->responseHeaders.replaceOrAppend(QHttpHeaders::WellKnownHeader::ETag,entityTag);
+}
+
+const QSharedPointer<QIODevice> &RHttpMessage::getBodyDevice() const
+{
+    return this->bodyDevice;
+}
+
+void RHttpMessage::setBodyDevice(const QSharedPointer<QIODevice> &bodyDevice)
+{
+    this->bodyDevice = bodyDevice;
+}
+
 void RHttpMessage::print(bool printBody) const
 {
     RLogger::indent();
@@ -142,10 +166,45 @@ void RHttpMessage::print(bool printBody) const
     {
         RLogger::info("body: <%ld bytes>\n",this->body.size());
     }
+    if (this->bodyDevice)
+    {
+        RLogger::info("body-device: <%lld bytes>\n",this->bodyDevice->size());
+    }
     RLogger::info("error-type: \"%s\"\n",RError::getTypeMessage(this->errorType).toUtf8().constData());
     RLogger::unindent(false);
 }
 
+QByteArray RHttpMessage::buildEntityTag(const QString &checksum)
+{
+    return QByteArray("\"") + checksum.toUtf8() + QByteArray("\"");
+}
+
+bool RHttpMessage::entityTagMatches(const QByteArray &ifNoneMatch, const QByteArray &entityTag)
+{
+    auto opaqueTag = [](QByteArray tag)
+    {
+        tag = tag.trimmed();
+        return tag.startsWith("W/") ? tag.mid(2) : tag;
+    };
+
+    const QByteArray opaqueEntityTag = opaqueTag(entityTag);
+    if (opaqueEntityTag.isEmpty())
+    {
+        return false;
+    }
+    // Entity tags cannot contain commas.
+    const QList<QByteArray> tags = ifNoneMatch.split(',');
+    for (const QByteArray &tag : tags)
+    {
+        const QByteArray opaqueIfTag = opaqueTag(tag);
+        if (opaqueIfTag == "*" || opaqueIfTag == opaqueEntityTag)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 QHttpServerRequest::Method RHttpMessage::findMethodForAction(const QString &actionKey)
 {
     if (actionKey == RCloudAction::Action::FileUpload::key ||
@@ -165,7 +224,9 @@ QHttpServerRequest::Method RHttpMessage::findMethodForAction(const QString &acti
              actionKey == RCloudAction::Action::ActionUpdateAccessMode::key ||
              actionKey == RCloudAction::Action::ProcessUpdateAccessOwner::key ||
              actionKey == RCloudAction::Action::ProcessUpdateAccessMode::key ||
-             actionKey == RCloudAction::Action::SubmitReport::key)
+             actionKey == RCloudAction::Action::SubmitReport::key ||
+             actionKey == RCloudAction::Action::Batch::key ||
+             actionKey == RCloudAction::Action::FileChanges::key)
     {
         return QHttpServerRequest::Method::Post;
     }
@@ -0,0 +1,164 @@
+#include "rcl_http_range.h"
+
+void RHttpRange::_init(const RHttpRange *pHttpRange)
+{
+    if (pHttpRange)
+    {
+        this->first = pHttpRange->first;
+        this->last = pHttpRange->last;
+        this->suffixLength = pHttpRange->suffixLength;
+    }
+}
+
+RHttpRange::RHttpRange()
+    : first{-1}
+    , last{-1}
+    , suffixLength{-1}
+{
+    this->_init();
+}
+
+RHttpRange::RHttpRange(const RHttpRange &httpRange)
+{
+    this->_init(&httpRange);
+}
+
+RHttpRange::~RHttpRange()
+{
+
+}
+
+RHttpRange &RHttpRange::operator =(const RHttpRange &httpRange)
+{
+    this->_init(&httpRange);
+    return (*this);
+}
+
+bool RHttpRange::isNull() const
+{
+    return (this->first < 0 && this->suffixLength < 0);
+}
+
+qint64 RHttpRange::getFirst() const
+{
+    return this->first;
+}
+
+qint64 RHttpRange::getLast() const
+{
+    return this->last;
+}
+
+qint64 RHttpRange::getSuffixLength() const
+{
+    return this->suffixLength;
+}
+
+bool RHttpRange::resolve(qint64 size, qint64 &offset, qint64 &length) const
+{
+    if (this->isNull() || size <= 0)
+    {
+        return false;
+    }
+
+    if (this->suffixLength >= 0)
+    {
+        if (this->suffixLength == 0)
+        {
+            return false;
+        }
+        offset = qMax(qint64(0),size - this->suffixLength);
+        length = size - offset;
+        return true;
+    }
+
+    if (this->first >= size)
+    {
+        return false;
+    }
+    const qint64 lastPosition = (this->last < 0) ? size - 1 : qMin(this->last,size - 1);
+    offset = this->first;
+    length = lastPosition - this->first + 1;
+    return true;
+}
+
+QString RHttpRange::toString() const
+{
+    if (this->isNull())
+    {
+        return QString();
+    }
+    if (this->suffixLength >= 0)
+    {
+        return QString("bytes=-%1").arg(this->suffixLength);
+    }
+    if (this->last < 0)
+    {
+        return QString("bytes=%1-").arg(this->first);
+    }
+    return QString("bytes=%1-%2").arg(this->first).arg(this->last);
+}
+
+RHttpRange RHttpRange::fromString(QByteArrayView value)
+{
+    RHttpRange httpRange;
+
+    QByteArrayView spec = value.trimmed();
+    const QByteArrayView unit("bytes=");
+    if (!spec.startsWith(unit))
+    {
+        return httpRange;
+    }
+    spec = spec.sliced(unit.size()).trimmed();
+
+    // Multiple ranges are not supported, full content is sent instead.
+    if (spec.contains(',') || spec.count('-') != 1)
+    {
+        return httpRange;
+    }
+
+    const qsizetype dashPosition = spec.indexOf('-');
+    const QByteArrayView firstValue = spec.first(dashPosition).trimmed();
+    const QByteArrayView lastValue = spec.sliced(dashPosition + 1).trimmed();
+
+    bool isOk = false;
+    if (firstValue.isEmpty())
+    {
+        const qint64 suffixLength = lastValue.toLongLong(&isOk);
+        if (isOk && suffixLength >= 0)
+        {
+            httpRange.suffixLength = suffixLength;
+        }
+        return httpRange;
+    }
+
+    const qint64 first = firstValue.toLongLong(&isOk);
+    if (!isOk || first < 0)
+    {
+        return httpRange;
+    }
+
+    qint64 last = -1;
+    if (!lastValue.isEmpty())
+    {
+        last = lastValue.toLongLong(&isOk);
+        if (!isOk || last < first)
+        {
+            return httpRange;
+        }
+    }
+
+    httpRange.first = first;
+    httpRange.last = last;
+    return httpRange;
+}
+
+QByteArray RHttpRange::buildContentRange(qint64 offset, qint64 length, qint64 size)
+{
+    return QByteArray("bytes ") + QByteArray::number(offset) + '-' + QByteArray::number(offset + length - 1) + '/' + QByteArray::number(size);
+}
+
+QByteArray RHttpRange::buildUnsatisfiedContentRange(qint64 size)
+{
+    return QByteArray("bytes */") + QByteArray::number(size);
+}
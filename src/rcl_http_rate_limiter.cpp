@@ -0,0 +1,174 @@
+#include <QMutexLocker>
+
+#include <cmath>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_rate_limiter.h"
+
+//! Retry interval suggested when only the in-flight cap is exceeded.
+static constexpr qint64 inFlightRetryAfterMs = 1000;
+
+RHttpRateLimiter::RHttpRateLimiter(double requestRate, double requestBurst, double byteRate, double byteBurst, qint64 maxInFlight)
+    : requestRate{requestRate}
+    , requestBurst{qMax(requestBurst,requestRate > 0.0 ? 1.0 : 0.0)}
+    , byteRate{byteRate}
+    , byteBurst{qMax(byteBurst,byteRate)}
+    , maxInFlight{maxInFlight}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpRateLimiter::isEnabled() const
+{
+    return this->requestRate > 0.0 || this->byteRate > 0.0 || this->maxInFlight > 0;
+}
+
+bool RHttpRateLimiter::tryAcquire(const QString &principal, qint64 nBytes, qint64 currentTime, qint64 &retryAfterMs)
+{
+    retryAfterMs = 0;
+    if (!this->isEnabled())
+    {
+        return true;
+    }
+
+    QMutexLocker locker(&this->mutex);
+
+    auto iter = this->principals.find(principal);
+    if (iter == this->principals.end())
+    {
+        Principal newPrincipal;
+        newPrincipal.requestBucket.tokens = this->requestBurst;
+        newPrincipal.requestBucket.refillTime = currentTime;
+        newPrincipal.byteBucket.tokens = this->byteBurst;
+        newPrincipal.byteBucket.refillTime = currentTime;
+        iter = this->principals.insert(principal,newPrincipal);
+    }
+    Principal &state = iter.value();
+
+    const double byteCost = double(qMax(qint64(0),nBytes));
+    retryAfterMs = this->findRetryAfter(state,byteCost,currentTime);
+    if (retryAfterMs > 0)
+    {
+        return false;
+    }
+
+    if (this->requestRate > 0.0)
+    {
+        state.requestBucket.tokens -= 1.0;
+    }
+    if (this->byteRate > 0.0)
+    {
+        state.byteBucket.tokens -= byteCost;
+    }
+    state.nInFlight++;
+    return true;
+}
+
+bool RHttpRateLimiter::check(const QString &principal, qint64 nBytes, qint64 currentTime, qint64 &retryAfterMs)
+{
+    retryAfterMs = 0;
+    if (!this->isEnabled())
+    {
+        return true;
+    }
+
+    QMutexLocker locker(&this->mutex);
+
+    auto iter = this->principals.find(principal);
+    if (iter == this->principals.end())
+    {
+        // Unknown principal has full buckets and nothing in flight.
+        return true;
+    }
+
+    retryAfterMs = this->findRetryAfter(iter.value(),double(qMax(qint64(0),nBytes)),currentTime);
+    return retryAfterMs == 0;
+}
+
+void RHttpRateLimiter::release(const QString &principal)
+{
+    if (!this->isEnabled())
+    {
+        return;
+    }
+
+    QMutexLocker locker(&this->mutex);
+    auto iter = this->principals.find(principal);
+    if (iter != this->principals.end() && iter.value().nInFlight > 0)
+    {
+        iter.value().nInFlight--;
+    }
+}
+
+void RHttpRateLimiter::prune(qint64 currentTime)
+{
+    R_LOG_TRACE_IN;
+    QMutexLocker locker(&this->mutex);
+    for (auto iter = this->principals.begin(); iter != this->principals.end();)
+    {
+        Principal &state = iter.value();
+        RHttpRateLimiter::refill(state.requestBucket,this->requestRate,this->requestBurst,currentTime);
+        RHttpRateLimiter::refill(state.byteBucket,this->byteRate,this->byteBurst,currentTime);
+        if (state.nInFlight == 0 && state.requestBucket.tokens >= this->requestBurst && state.byteBucket.tokens >= this->byteBurst)
+        {
+            iter = this->principals.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+    R_LOG_TRACE_OUT;
+}
+
+qsizetype RHttpRateLimiter::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->principals.size();
+}
+
+qint64 RHttpRateLimiter::findRetryAfter(Principal &state, double byteCost, qint64 currentTime) const
+{
+    if (this->maxInFlight > 0 && state.nInFlight >= this->maxInFlight)
+    {
+        return inFlightRetryAfterMs;
+    }
+
+    qint64 retryAfterMs = 0;
+    if (this->requestRate > 0.0)
+    {
+        RHttpRateLimiter::refill(state.requestBucket,this->requestRate,this->requestBurst,currentTime);
+        if (state.requestBucket.tokens < 1.0)
+        {
+            retryAfterMs = RHttpRateLimiter::findWaitTime(state.requestBucket,this->requestRate,1.0);
+        }
+    }
+
+    // Body larger than the burst is admitted once the bucket is full and leaves it in debt.
+    if (this->byteRate > 0.0)
+    {
+        RHttpRateLimiter::refill(state.byteBucket,this->byteRate,this->byteBurst,currentTime);
+        const double requiredTokens = qMin(byteCost,this->byteBurst);
+        if (state.byteBucket.tokens < requiredTokens)
+        {
+            retryAfterMs = qMax(retryAfterMs,RHttpRateLimiter::findWaitTime(state.byteBucket,this->byteRate,requiredTokens));
+        }
+    }
+    return retryAfterMs;
+}
+
+void RHttpRateLimiter::refill(Bucket &bucket, double rate, double burst, qint64 currentTime)
+{
+    if (currentTime > bucket.refillTime)
+    {
+        bucket.tokens = qMin(burst,bucket.tokens + rate * double(currentTime - bucket.refillTime) / 1000.0);
+        bucket.refillTime = currentTime;
+    }
+}
+
+qint64 RHttpRateLimiter::findWaitTime(const Bucket &bucket, double rate, double nTokens)
+{
+    return qMax(qint64(1),qint64(std::ceil((nTokens - bucket.tokens) * 1000.0 / rate)));
+}
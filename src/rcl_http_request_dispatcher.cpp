@@ -0,0 +1,143 @@
+#include <QMutexLocker>
+#include <QPromise>
+#include <QThread>
+#include <QUuid>
+
+#include <memory>
+
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_request_dispatcher.h"
+
+//! Number of shards per worker thread.
+static constexpr int shardsPerThread = 4;
+//! Maximum number of tasks processed in one go before the shard yields its worker.
+static constexpr int maxDrainBatch = 16;
+
+RHttpRequestDispatcher::RHttpRequestDispatcher(int nThreads)
+{
+    R_LOG_TRACE_IN;
+    if (nThreads <= 0)
+    {
+        nThreads = QThread::idealThreadCount();
+    }
+    this->threadPool.setMaxThreadCount(nThreads);
+    this->threadPool.setObjectName("RHttpRequestDispatcher");
+    for (int i = 0; i < nThreads * shardsPerThread; i++)
+    {
+        this->shards.append(new Shard);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpRequestDispatcher::~RHttpRequestDispatcher()
+{
+    this->threadPool.waitForDone();
+    qDeleteAll(this->shards);
+}
+
+int RHttpRequestDispatcher::getThreadCount() const
+{
+    return this->threadPool.maxThreadCount();
+}
+
+void RHttpRequestDispatcher::setHandler(const QString &actionKey, RHttpActionHandler *pHandler)
+{
+    QMutexLocker locker(&this->handlersMutex);
+    if (pHandler)
+    {
+        this->handlers.insert(actionKey,pHandler);
+    }
+    else
+    {
+        this->handlers.remove(actionKey);
+    }
+}
+
+RHttpActionHandler *RHttpRequestDispatcher::findHandler(const QString &actionKey) const
+{
+    QMutexLocker locker(&this->handlersMutex);
+    return this->handlers.value(actionKey,nullptr);
+}
+
+QFuture<RHttpMessage> RHttpRequestDispatcher::dispatch(RHttpActionHandler *pHandler, const RHttpMessage &requestMessage)
+{
+    std::shared_ptr<QPromise<RHttpMessage>> pPromise = std::make_shared<QPromise<RHttpMessage>>();
+    pPromise->start();
+    QFuture<RHttpMessage> replyFuture = pPromise->future();
+
+    auto task = [pHandler,requestMessage,pPromise]()
+    {
+        RHttpMessage replyMessage;
+        try
+        {
+            replyMessage = pHandler->processRequest(requestMessage);
+        }
+        catch (const RError &rError)
+        {
+            replyMessage.setErrorType(rError.getType());
+            replyMessage.setBody(rError.getMessage().toUtf8());
+        }
+        catch (const std::exception &exception)
+        {
+            replyMessage.setErrorType(RError::Application);
+            replyMessage.setBody(QByteArray(exception.what()));
+        }
+        replyMessage.setHandlerId(requestMessage.getHandlerId());
+        pPromise->addResult(replyMessage);
+        pPromise->finish();
+    };
+
+    const QString shardKey = RHttpRequestDispatcher::findShardKey(requestMessage);
+    Shard *pShard = this->shards.at(qsizetype(qHash(shardKey) % size_t(this->shards.size())));
+
+    bool startWorker = false;
+    {
+        QMutexLocker locker(&pShard->mutex);
+        pShard->tasks.enqueue(task);
+        if (!pShard->running)
+        {
+            pShard->running = true;
+            startWorker = true;
+        }
+    }
+    if (startWorker)
+    {
+        this->threadPool.start([this,pShard]() { this->drainShard(pShard); });
+    }
+
+    return replyFuture;
+}
+
+QString RHttpRequestDispatcher::findShardKey(const RHttpMessage &requestMessage)
+{
+    const QUuid resourceId(requestMessage.getProperties().value(RCloudAction::Resource::Id::key));
+    if (!resourceId.isNull())
+    {
+        return resourceId.toString(QUuid::WithoutBraces);
+    }
+    return requestMessage.getOwner();
+}
+
+void RHttpRequestDispatcher::drainShard(Shard *pShard)
+{
+    // Only one worker drains a shard at a time, which keeps requests of the shard in order.
+    for (int i = 0; i < maxDrainBatch; i++)
+    {
+        std::function<void()> task;
+        {
+            QMutexLocker locker(&pShard->mutex);
+            if (pShard->tasks.isEmpty())
+            {
+                pShard->running = false;
+                return;
+            }
+            task = pShard->tasks.dequeue();
+        }
+        task();
+    }
+    // Yield worker so that busy shard does not starve the others.
+    this->threadPool.start([this,pShard]() { this->drainShard(pShard); });
+}
@@ -0,0 +1,156 @@
+#include <QMutexLocker>
+
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_response_cache.h"
+
+RHttpResponseCache::RHttpResponseCache(qint64 maxBytes, qint64 ttlMs)
+    : ttlMs{ttlMs}
+    , cache{qsizetype(qMax(qint64(0),maxBytes))}
+    , generation{0}
+    , nHits{0}
+    , nMisses{0}
+    , nInvalidations{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpResponseCache::find(const QString &key, qint64 currentTime, RHttpMessage &response)
+{
+    QMutexLocker locker(&this->mutex);
+    Entry *pEntry = this->cache.object(key);
+    if (pEntry && pEntry->expiryTime <= currentTime)
+    {
+        this->cache.remove(key);
+        pEntry = nullptr;
+    }
+    if (!pEntry)
+    {
+        this->nMisses.fetch_add(1,std::memory_order_relaxed);
+        return false;
+    }
+    response = pEntry->response;
+    this->nHits.fetch_add(1,std::memory_order_relaxed);
+    return true;
+}
+
+void RHttpResponseCache::insert(const QString &key, const RHttpMessage &response, quint64 generation, qint64 currentTime)
+{
+    if (response.getErrorType() != RError::None || response.getBodyDevice())
+    {
+        return;
+    }
+    const qint64 cost = RHttpResponseCache::findCost(key,response);
+
+    QMutexLocker locker(&this->mutex);
+    // Checked under the lock, invalidate() removes entries under the same lock.
+    if (generation != this->generation.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    // Response larger than the whole cache is deleted by insert().
+    this->cache.insert(key,new Entry{response,currentTime + this->ttlMs},qsizetype(cost));
+}
+
+void RHttpResponseCache::invalidate(const QString &mutatingActionKey)
+{
+    const QList<QString> affectedActions = RCloudAction::findAffectedActions(mutatingActionKey);
+    if (affectedActions.isEmpty())
+    {
+        return;
+    }
+
+    QMutexLocker locker(&this->mutex);
+    this->generation.fetch_add(1,std::memory_order_relaxed);
+    this->nInvalidations.fetch_add(1,std::memory_order_relaxed);
+    const QList<QString> keys = this->cache.keys();
+    for (const QString &key : keys)
+    {
+        // Key starts with the action (see buildKey()).
+        if (affectedActions.contains(key.section(QChar('\n'),0,0)))
+        {
+            this->cache.remove(key);
+        }
+    }
+}
+
+quint64 RHttpResponseCache::getGeneration() const
+{
+    return this->generation.load(std::memory_order_relaxed);
+}
+
+qsizetype RHttpResponseCache::size() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->cache.size();
+}
+
+qint64 RHttpResponseCache::getTotalBytes() const
+{
+    QMutexLocker locker(&this->mutex);
+    return qint64(this->cache.totalCost());
+}
+
+quint64 RHttpResponseCache::getHitCount() const
+{
+    return this->nHits.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpResponseCache::getMissCount() const
+{
+    return this->nMisses.load(std::memory_order_relaxed);
+}
+
+quint64 RHttpResponseCache::getInvalidationCount() const
+{
+    return this->nInvalidations.load(std::memory_order_relaxed);
+}
+
+QJsonObject RHttpResponseCache::toJson() const
+{
+    QJsonObject json;
+    json["hits"] = qint64(this->getHitCount());
+    json["misses"] = qint64(this->getMissCount());
+    json["invalidations"] = qint64(this->getInvalidationCount());
+    json["size"] = qint64(this->size());
+    json["bytes"] = this->getTotalBytes();
+    return json;
+}
+
+QByteArray RHttpResponseCache::toPrometheusText() const
+{
+    QByteArray text;
+    text += "# HELP range_cloud_response_cache_requests_total Number of cacheable requests by cache outcome.\n";
+    text += "# TYPE range_cloud_response_cache_requests_total counter\n";
+    text += "range_cloud_response_cache_requests_total{result=\"hit\"} " + QByteArray::number(this->getHitCount()) + "\n";
+    text += "range_cloud_response_cache_requests_total{result=\"miss\"} " + QByteArray::number(this->getMissCount()) + "\n";
+    text += "# HELP range_cloud_response_cache_invalidations_total Number of response cache invalidations.\n";
+    text += "# TYPE range_cloud_response_cache_invalidations_total counter\n";
+    text += "range_cloud_response_cache_invalidations_total " + QByteArray::number(this->getInvalidationCount()) + "\n";
+    text += "# HELP range_cloud_response_cache_entries Number of cached responses.\n";
+    text += "# TYPE range_cloud_response_cache_entries gauge\n";
+    text += "range_cloud_response_cache_entries " + QByteArray::number(this->size()) + "\n";
+    text += "# HELP range_cloud_response_cache_bytes Size of cached responses in bytes.\n";
+    text += "# TYPE range_cloud_response_cache_bytes gauge\n";
+    text += "range_cloud_response_cache_bytes " + QByteArray::number(this->getTotalBytes()) + "\n";
+    return text;
+}
+
+QString RHttpResponseCache::buildKey(const QString &actionKey, const QString &user, const QString &resourceName, const QUuid &resourceId, const QByteArray &contentEncoding)
+{
+    // User names and action keys cannot contain new line.
+    return actionKey + QChar('\n') + user + QChar('\n') + QString::fromLatin1(contentEncoding) + QChar('\n')
+         + resourceId.toString(QUuid::WithoutBraces) + QChar('\n') + resourceName;
+}
+
+qint64 RHttpResponseCache::findCost(const QString &key, const RHttpMessage &response)
+{
+    qint64 cost = qint64(sizeof(Entry)) + key.size() * qint64(sizeof(QChar)) + response.getBody().size();
+    for (qsizetype i = 0; i < response.getResponseHeaders().size(); i++)
+    {
+        cost += response.getResponseHeaders().nameAt(i).size() + response.getResponseHeaders().valueAt(i).size();
+    }
+    return cost;
+}
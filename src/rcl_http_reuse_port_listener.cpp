@@ -0,0 +1,100 @@
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "rcl_http_reuse_port_listener.h"
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+bool RHttpReusePortListener::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+qintptr RHttpReusePortListener::open(quint16 port, int backlog)
+{
+    R_LOG_TRACE_IN;
+#ifdef Q_OS_LINUX
+    // Dual stack socket like QHostAddress::Any, IPv4 only if IPv6 is not available.
+    bool ipv6 = true;
+    int socketDescriptor = ::socket(AF_INET6,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+    if (socketDescriptor < 0)
+    {
+        ipv6 = false;
+        socketDescriptor = ::socket(AF_INET,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+    }
+    if (socketDescriptor < 0)
+    {
+        R_LOG_TRACE_OUT;
+        throw RError(RError::Application,R_ERROR_REF,"Failed to create socket. %s",std::strerror(errno));
+    }
+
+    const int enable = 1;
+    const int disable = 0;
+    if (::setsockopt(socketDescriptor,SOL_SOCKET,SO_REUSEADDR,&enable,sizeof(enable)) != 0 ||
+        ::setsockopt(socketDescriptor,SOL_SOCKET,SO_REUSEPORT,&enable,sizeof(enable)) != 0 ||
+        (ipv6 && ::setsockopt(socketDescriptor,IPPROTO_IPV6,IPV6_V6ONLY,&disable,sizeof(disable)) != 0))
+    {
+        const int error = errno;
+        ::close(socketDescriptor);
+        R_LOG_TRACE_OUT;
+        throw RError(RError::Application,R_ERROR_REF,"Failed to set socket options. %s",std::strerror(error));
+    }
+
+    int result = 0;
+    if (ipv6)
+    {
+        sockaddr_in6 address;
+        std::memset(&address,0,sizeof(address));
+        address.sin6_family = AF_INET6;
+        address.sin6_addr = in6addr_any;
+        address.sin6_port = htons(port);
+        result = ::bind(socketDescriptor,reinterpret_cast<sockaddr*>(&address),sizeof(address));
+    }
+    else
+    {
+        sockaddr_in address;
+        std::memset(&address,0,sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        result = ::bind(socketDescriptor,reinterpret_cast<sockaddr*>(&address),sizeof(address));
+    }
+    if (result != 0 || ::listen(socketDescriptor,backlog) != 0)
+    {
+        const int error = errno;
+        ::close(socketDescriptor);
+        R_LOG_TRACE_OUT;
+        throw RError(RError::Application,R_ERROR_REF,"Failed to listen on port \"%u\". %s",port,std::strerror(error));
+    }
+
+    R_LOG_TRACE_RETURN(qintptr(socketDescriptor));
+#else
+    Q_UNUSED(port);
+    Q_UNUSED(backlog);
+    R_LOG_TRACE_OUT;
+    throw RError(RError::Application,R_ERROR_REF,"Sharing of listening port is not supported on this platform.");
+#endif
+}
+
+void RHttpReusePortListener::close(qintptr socketDescriptor)
+{
+#ifdef Q_OS_LINUX
+    if (socketDescriptor >= 0)
+    {
+        ::close(int(socketDescriptor));
+    }
+#else
+    Q_UNUSED(socketDescriptor);
+#endif
+}
@@ -1,5 +1,6 @@
 #include <QMap>
 #include <QUuid>
+#include <QCryptographicHash>
 #include <QHttpServer>
 #include <QHttpServerResponse>
 #include <QFile>
@@ -8,104 +9,80 @@
 #include <QSslKey>
 #include <QSslServer>
 #include <QLoggingCategory>
-#include <QtConcurrentRun>
-#include <QMutexLocker>
-#include <QWaitCondition>
 #include <QDateTime>
-#include <QDeadlineTimer>
+#include <QFuture>
+#include <QJsonDocument>
+#include <QUrlQuery>
+#include <QtConcurrentRun>
+
 #include <memory>
 
+#ifdef RCL_HAVE_OPENSSL
+#include <openssl/ssl.h>
+#endif
+
 #include "rcl_cloud_action.h"
+#include "rcl_http_batch_action_handler.h"
+#include "rcl_http_body_device.h"
+#include "rcl_http_content_encoder.h"
+#include "rcl_http_reuse_port_listener.h"
 #include "rcl_http_server.h"
+#include "rcl_http_tls_server.h"
 #include <rbl_logger.h>
 #include <rbl_error.h>
 #include <rbl_utils.h>
 
-class RHttpServerHandler
-{
-    private:
-
-        //! Handler ID.
-        QUuid id;
-        //! Service name.
-        QString serviceName;
-        //! Mutex to protect response data.
-        QMutex syncMutex;
-        //! Condition variable for response availability.
-        QWaitCondition responseCondition;
-        //! Response ready flag.
-        bool responseReady;
-        //! Response message.
-        RHttpMessage responseMessage;
-
-    public:
-
-        RHttpServerHandler()
-            : id(QUuid::createUuid())
-            , serviceName("HttpServerHandler_" + id.toString(QUuid::WithoutBraces))
-            , responseReady(false)
-        {
-            R_LOG_TRACE_IN;
-            R_LOG_TRACE_OUT;
-        }
-
-        const QUuid &getId() const
-        {
-            return this->id;
-        }
-
-        void sendReply(const RHttpMessage &httpMessage)
-        {
-            R_LOG_TRACE_IN;
-            QMutexLocker locker(&this->syncMutex);
-            this->responseMessage = httpMessage;
-            this->responseReady = true;
-            this->responseCondition.wakeOne();
-            R_LOG_TRACE_OUT;
-        }
-
-        bool fetchResponseMessage(int timeout, RHttpMessage &responseMessage)
-        {
-            R_LOG_TRACE_IN;
-            QMutexLocker locker(&this->syncMutex);
-            RLogger::debug("[%s] Waiting for response (timeout: %d ms)\n",
-                          this->serviceName.toUtf8().constData(), timeout);
-
-            // The reply may arrive before this thread starts waiting, so the
-            // ready flag must be checked before and after each wait.
-            QDeadlineTimer deadline(timeout);
-            while (!this->responseReady)
-            {
-                if (!this->responseCondition.wait(&this->syncMutex, deadline))
-                {
-                    break;
-                }
-            }
+const QByteArray RHttpServer::serverName = "Range Cloud HTTPs Server";
+const QString RHttpServer::metricsRoute = "metrics";
+const QByteArray RHttpServer::metricsContentType = "text/plain; version=0.0.4; charset=utf-8";
 
-            if (this->responseReady)
-            {
-                responseMessage = this->responseMessage;
-                RLogger::debug("[%s] Response received\n",this->serviceName.toUtf8().constData());
-            }
-            else
-            {
-                RLogger::warning("[%s] Response timeout after %d ms\n",
-                               this->serviceName.toUtf8().constData(), timeout);
-            }
-            R_LOG_TRACE_OUT;
-            return this->responseReady;
-        }
+//! Find whether handshake of given encrypted socket resumed an earlier session.
+static RHttpTlsMetrics::Result findHandshakeResult(QSslSocket *socket)
+{
+#ifdef RCL_HAVE_OPENSSL
+    if (QSslSocket::activeBackend() == QStringLiteral("openssl") && socket->sslHandle())
+    {
+        return SSL_session_reused(static_cast<SSL*>(socket->sslHandle())) ? RHttpTlsMetrics::Resumed : RHttpTlsMetrics::Full;
+    }
+#endif
+    Q_UNUSED(socket);
+    return RHttpTlsMetrics::Unknown;
+}
 
-};
+//! Let TLS backend free buffers of given encrypted socket whenever they are empty.
+static void releaseIdleBuffers(QSslSocket *socket)
+{
+#ifdef RCL_HAVE_OPENSSL
+    if (QSslSocket::activeBackend() == QStringLiteral("openssl") && socket->sslHandle())
+    {
+        // Idle keep-alive connection then costs no record buffers.
+        SSL_set_mode(static_cast<SSL*>(socket->sslHandle()),SSL_MODE_RELEASE_BUFFERS);
+    }
+#endif
+    Q_UNUSED(socket);
+}
 
 RHttpServer::RHttpServer(Type type, const RHttpServerSettings &httpServerSettings, QObject *parent)
+    : RHttpServer{type,httpServerSettings,std::make_shared<RHttpServerContext>(httpServerSettings),parent}
+{
+}
+
+RHttpServer::RHttpServer(Type type, const RHttpServerSettings &httpServerSettings, const std::shared_ptr<RHttpServerContext> &pContext, QObject *parent)
     : QObject{parent}
     , type{type}
     , httpServerSettings{httpServerSettings}
     , pSslServer{nullptr}
     , pHttpServer{nullptr}
+    , handlerTimingWheel{httpServerSettings.getHandlerExpiryResolutionMs(),RHttpServerHandlerRegistry::currentTime()}
+    , pExpiryTimer{nullptr}
+    , pConnectionManager{nullptr}
     , pCleanupTimer{nullptr}
+    , pTlsFileWatcher{nullptr}
+    , pTlsReloadTimer{nullptr}
+    , tlsReloadGeneration{0}
     , pAuthTokenValidator{nullptr}
+    , pFileQuotaProvider{nullptr}
+    , pContext{pContext}
 {
     R_LOG_TRACE_IN;
 
@@ -119,13 +96,13 @@ RHttpServer::RHttpServer(Type type, const RHttpServerSettings &httpServerSetting
                      validationError.toUtf8().constData());
     }
 
-    this->pSslServer = new QSslServer(this);
+    this->pSslServer = new RHttpTlsServer(this->pContext->getTicketKeyStore(),&this->pContext->getTlsMetrics(),this);
     this->pHttpServer = new QHttpServer(this);
 
 #if QT_VERSION > QT_VERSION_CHECK(6, 9, 0)
     QHttpServerConfiguration httpServerConfiguration = this->pHttpServer->configuration();
     httpServerConfiguration.setRateLimitPerSecond(this->httpServerSettings.getRateLimitPerSecond());
-    httpServerConfiguration.setMaximumBodySize(httpServerSettings.getMaxBodySize());
+    httpServerConfiguration.setMaximumBodySize(this->httpServerSettings.getMaxBodySize());
     this->pHttpServer->setConfiguration(httpServerConfiguration);
 #else
     RLogger::warning("[%s] Rate limiting is not available in Qt %s (requires Qt 6.10+). "
@@ -137,11 +114,47 @@ RHttpServer::RHttpServer(Type type, const RHttpServerSettings &httpServerSetting
     this->buildApiRoutes();
 
     this->pSslServer->setSslConfiguration(this->buildSslConfiguration());
+    QObject::connect(this->pSslServer, &QSslServer::startedEncryptionHandshake, this, &RHttpServer::onStartedEncryptionHandshake);
+    QObject::connect(this->pSslServer, &QSslServer::errorOccurred, this, &RHttpServer::onHandshakeErrorOccurred);
+
+    this->pConnectionManager = new RHttpConnectionManager(this->httpServerSettings.getConnectionIdleTimeoutMs(),
+                                                          this->httpServerSettings.getKeepAliveTimeoutMs(),
+                                                          this->httpServerSettings.getHeaderReadTimeoutMs(),
+                                                          this->httpServerSettings.getBodyReadTimeoutMs(),
+                                                          qsizetype(this->httpServerSettings.getMaxConnections()),
+                                                          RHttpServer::serverName,
+                                                          &this->pContext->getConnectionMetrics(),
+                                                          this);
+    QObject::connect(this->pConnectionManager, &RHttpConnectionManager::acceptPaused, this->pSslServer, &QSslServer::pauseAccepting);
+    QObject::connect(this->pConnectionManager, &RHttpConnectionManager::acceptResumed, this->pSslServer, &QSslServer::resumeAccepting);
+    if (this->httpServerSettings.getHeaderReadTimeoutMs() > 0)
+    {
+        // Handshake is the first part of reading request head.
+        this->pSslServer->setHandshakeTimeout(int(qMin(qint64(this->pSslServer->handshakeTimeout()),this->httpServerSettings.getHeaderReadTimeoutMs())));
+    }
+
+    if (this->httpServerSettings.getTlsFileWatchEnabled())
+    {
+        // Files are usually replaced in several steps, changes are collected into one reload.
+        this->pTlsReloadTimer = new QTimer(this);
+        this->pTlsReloadTimer->setSingleShot(true);
+        this->pTlsReloadTimer->setInterval(1000);
+        QObject::connect(this->pTlsReloadTimer, &QTimer::timeout, this, &RHttpServer::reloadTlsConfiguration);
+
+        this->pTlsFileWatcher = new QFileSystemWatcher(this->findTlsFiles(),this);
+        QObject::connect(this->pTlsFileWatcher, &QFileSystemWatcher::fileChanged, this, &RHttpServer::onTlsFileChanged);
+    }
+
+    // Setup expiry timer (runs only while there are scheduled deadlines)
+    this->pExpiryTimer = new QTimer(this);
+    this->pExpiryTimer->setTimerType(Qt::CoarseTimer);
+    this->pExpiryTimer->setInterval(this->httpServerSettings.getHandlerExpiryResolutionMs());
+    QObject::connect(this->pExpiryTimer, &QTimer::timeout, this, &RHttpServer::expireHandlers);
 
     // Setup cleanup timer
     this->pCleanupTimer = new QTimer(this);
     this->pCleanupTimer->setInterval(this->httpServerSettings.getHandlerCleanupIntervalMs());
-    QObject::connect(this->pCleanupTimer, &QTimer::timeout, this, &RHttpServer::cleanupStaleHandlers);
+    QObject::connect(this->pCleanupTimer, &QTimer::timeout, this, &RHttpServer::checkPendingHandlers);
 
     QLoggingCategory::setFilterRules("qt.httpserver=true\n"
                                      "appname.access=true");
@@ -149,9 +162,110 @@ RHttpServer::RHttpServer(Type type, const RHttpServerSettings &httpServerSetting
     R_LOG_TRACE_OUT;
 }
 
+RHttpServer::~RHttpServer()
+{
+    R_LOG_TRACE_IN;
+    // Pending promises are cancelled together with their handlers.
+    qDeleteAll(this->handlerRegistry.takeAll());
+    // Worker building SSL configuration uses server settings.
+    this->tlsBuildFuture.waitForFinished();
+    R_LOG_TRACE_OUT;
+}
+
 void RHttpServer::setAuthTokenValidator(RAuthTokenValidator *pAuthTokenValidator)
 {
-    this->pAuthTokenValidator = pAuthTokenValidator;
+    RAuthTokenValidatorCache *pAuthTokenCache = this->pContext->getAuthTokenCache();
+    if (pAuthTokenCache)
+    {
+        pAuthTokenCache->setValidator(pAuthTokenValidator);
+        this->pAuthTokenValidator = pAuthTokenValidator ? pAuthTokenCache : nullptr;
+    }
+    else
+    {
+        this->pAuthTokenValidator = pAuthTokenValidator;
+    }
+}
+
+void RHttpServer::setFileQuotaProvider(RFileQuotaProvider *pFileQuotaProvider)
+{
+    this->pFileQuotaProvider = pFileQuotaProvider;
+}
+
+void RHttpServer::invalidateAuthToken(const QString &resourceName, const QString &token)
+{
+    if (this->pContext->getAuthTokenCache())
+    {
+        this->pContext->getAuthTokenCache()->invalidate(resourceName,token);
+    }
+}
+
+void RHttpServer::invalidateAuthTokens(const QString &resourceName)
+{
+    if (this->pContext->getAuthTokenCache())
+    {
+        this->pContext->getAuthTokenCache()->invalidateResource(resourceName);
+    }
+}
+
+void RHttpServer::invalidateEntityTags()
+{
+    if (this->pContext->getEntityTagCache())
+    {
+        this->pContext->getEntityTagCache()->invalidate();
+    }
+}
+
+QFuture<bool> RHttpServer::reloadTlsConfiguration()
+{
+    R_LOG_TRACE_IN;
+    RLogger::info("[%s] Reloading TLS configuration.\n",this->getServiceName().toUtf8().constData());
+
+    // Reloads may overlap, only the latest one is applied.
+    const quint64 generation = ++this->tlsReloadGeneration;
+    this->tlsBuildFuture = QtConcurrent::run([this]()
+    {
+        return this->buildSslConfiguration();
+    });
+    QFuture<bool> reloadFuture = this->tlsBuildFuture.then(this,[this,generation](const QSslConfiguration &sslConfiguration)
+    {
+        if (this->pTlsFileWatcher)
+        {
+            // Files replaced by rename are no longer watched.
+            const QStringList tlsFiles = this->findTlsFiles();
+            for (const QString &tlsFile : tlsFiles)
+            {
+                if (!this->pTlsFileWatcher->files().contains(tlsFile) && QFile::exists(tlsFile))
+                {
+                    this->pTlsFileWatcher->addPath(tlsFile);
+                }
+            }
+        }
+        if (generation != this->tlsReloadGeneration)
+        {
+            return false;
+        }
+        // Sockets copy the configuration when accepted, existing connections are not affected.
+        this->pSslServer->setSslConfiguration(sslConfiguration);
+        RLogger::info("[%s] TLS configuration has been reloaded.\n",this->getServiceName().toUtf8().constData());
+        return true;
+    }).onFailed(this,[this](const RError &rError)
+    {
+        RLogger::error("[%s] Failed to reload TLS configuration, keeping current configuration. %s\n",
+                       this->getServiceName().toUtf8().constData(),
+                       rError.getMessage().toUtf8().constData());
+        return false;
+    }).onFailed(this,[this]()
+    {
+        RLogger::error("[%s] Failed to reload TLS configuration, keeping current configuration. Unexpected error.\n",
+                       this->getServiceName().toUtf8().constData());
+        return false;
+    });
+    R_LOG_TRACE_RETURN(reloadFuture);
+}
+
+void RHttpServer::setActionHandler(const QString &actionKey, RHttpActionHandler *pActionHandler)
+{
+    this->pContext->getDispatcher().setHandler(actionKey,pActionHandler);
 }
 
 void RHttpServer::start()
@@ -161,7 +275,22 @@ void RHttpServer::start()
     try {
         RLogger::info("[%s] Establishing HTTP server on port: \"%u\"\n",this->getServiceName().toUtf8().constData(),this->httpServerSettings.getPort());
 
-        if (!this->pSslServer->listen(QHostAddress::Any,this->httpServerSettings.getPort()) || !this->pHttpServer->bind(this->pSslServer))
+        bool listening = false;
+        if (this->httpServerSettings.getListenerInstanceCount() > 1)
+        {
+            // Several instances share the port, kernel balances connections across them.
+            const qintptr socketDescriptor = RHttpReusePortListener::open(quint16(this->httpServerSettings.getPort()));
+            listening = this->pSslServer->setSocketDescriptor(socketDescriptor);
+            if (!listening)
+            {
+                RHttpReusePortListener::close(socketDescriptor);
+            }
+        }
+        else
+        {
+            listening = this->pSslServer->listen(QHostAddress::Any,this->httpServerSettings.getPort());
+        }
+        if (!listening || !this->pHttpServer->bind(this->pSslServer))
         {
             R_LOG_TRACE_OUT;
             throw RError(RError::Application,R_ERROR_REF,"HTTP Server failed to listen on a port \"%u\".",this->pSslServer->serverPort());
@@ -170,10 +299,11 @@ void RHttpServer::start()
 
         // Start cleanup timer
         this->pCleanupTimer->start();
-        RLogger::info("[%s] Handler cleanup timer started (interval: %u ms, max age: %u ms)\n",
+        RLogger::info("[%s] Handler cleanup timer started (interval: %u ms, max age: %u ms, expiry resolution: %u ms)\n",
                      this->getServiceName().toUtf8().constData(),
                      this->httpServerSettings.getHandlerCleanupIntervalMs(),
-                     this->httpServerSettings.getMaxStaleHandlerAgeMs());
+                     this->httpServerSettings.getMaxStaleHandlerAgeMs(),
+                     this->httpServerSettings.getHandlerExpiryResolutionMs());
 
         emit this->started();
         emit this->ready();
@@ -214,9 +344,8 @@ void RHttpServer::stop()
 void RHttpServer::sendMessageReply(const RHttpMessage &httpMessage)
 {
     R_LOG_TRACE_IN;
-    QMutexLocker locker(&this->syncMutex);
-    QMap<QUuid,RHttpServerHandler*>::iterator iter = this->serverHandlers.find(httpMessage.getHandlerId());
-    if (iter == this->serverHandlers.end())
+    RHttpServerHandler *serverHandler = this->handlerRegistry.take(httpMessage.getHandlerId());
+    if (!serverHandler)
     {
         RLogger::warning("[%s] HTTP message cannot be sent. Handler (id: \"%s\") does not exist.\n",
                          this->getServiceName().toUtf8().constData(),
@@ -224,16 +353,27 @@ void RHttpServer::sendMessageReply(const RHttpMessage &httpMessage)
         R_LOG_TRACE_OUT;
         return;
     }
-    iter.value()->sendReply(httpMessage);
+    serverHandler->sendReply(httpMessage);
+    this->handlerRegistry.release(serverHandler);
     R_LOG_TRACE_OUT;
 }
 
+QJsonObject RHttpServer::getMetrics() const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject json = this->pContext->toJson(this->handlerRegistry.size());
+    R_LOG_TRACE_RETURN(json);
+}
+
 bool RHttpServer::containsServerHandlerId(const QUuid &serverHandlerId)
 {
     R_LOG_TRACE_IN;
-    QMutexLocker locker(&this->syncMutex);
-    bool contains = this->serverHandlers.contains(serverHandlerId);
-    R_LOG_TRACE_RETURN(contains);
+    R_LOG_TRACE_RETURN(this->handlerRegistry.contains(serverHandlerId));
+}
+
+qint64 RHttpServer::getPendingHandlerCount() const
+{
+    return this->handlerRegistry.size();
 }
 
 QSslConfiguration RHttpServer::buildSslConfiguration() const
@@ -277,6 +417,8 @@ QSslConfiguration RHttpServer::buildSslConfiguration() const
     sslConfig.setLocalCertificateChain(clientCertificates);
     sslConfig.setPrivateKey(privateKey);
     sslConfig.setProtocol(QSsl::TlsV1_2OrLater);
+    // Ticket keys are shared by all connections (see RHttpTlsServer).
+    sslConfig.setSslOption(QSsl::SslOptionDisableSessionTickets,!this->httpServerSettings.getTlsSessionResumptionEnabled());
     switch (this->type)
     {
         case RHttpServer::Public:
@@ -410,6 +552,13 @@ void RHttpServer::checkCertificateExpiry(const QList<QSslCertificate> &certifica
     }
 }
 
+QStringList RHttpServer::findTlsFiles() const
+{
+    return {this->httpServerSettings.getTlsTrustStore().getCertificateFile(),
+            this->httpServerSettings.getTlsKeyStore().getCertificateFile(),
+            this->httpServerSettings.getTlsKeyStore().getKeyFile()};
+}
+
 QString RHttpServer::getKeyAlgorithmName(QSsl::KeyAlgorithm algorithm)
 {
     switch (algorithm)
@@ -427,6 +576,15 @@ void RHttpServer::buildApiRoutes()
 {
     this->pHttpServer->route("/", []() { return RVendor::name(); });
 
+    if (this->type == RHttpServer::Private)
+    {
+        // Metrics are only exposed to clients authenticated by certificate.
+        this->pHttpServer->route(QString("/%1").arg(RHttpServer::metricsRoute),QHttpServerRequest::Method::Get,[this]()
+        {
+            return QHttpServerResponse(RHttpServer::metricsContentType,this->pContext->toPrometheusText(this->handlerRegistry.size()));
+        });
+    }
+
     QMap<QString,QString> actionMap = RCloudAction::getActionMap();
     for (auto iter = actionMap.cbegin(); iter != actionMap.cend(); ++iter)
     {
@@ -435,6 +593,7 @@ void RHttpServer::buildApiRoutes()
 
     this->pHttpServer->setMissingHandler(this->pHttpServer,[this](const QHttpServerRequest &request, QHttpServerResponder &responder)
     {
+        this->pConnectionManager->startRequest(request.remoteAddress(),request.remotePort());
         QString commonName = RTlsTrustStore::findCN(request.sslConfiguration().peerCertificate());
         RLogger::info("[%s] Request: user = \"%s\" url = \"%s\"\n",
                       this->getServiceName().toUtf8().constData(),
@@ -443,18 +602,29 @@ void RHttpServer::buildApiRoutes()
         responder.sendResponse(QHttpServerResponse("Not found"));
     });
 
-    this->pHttpServer->addAfterRequestHandler(this->pHttpServer, [](const QHttpServerRequest &, QHttpServerResponse &resp)
+    this->pHttpServer->addAfterRequestHandler(this->pHttpServer, [this](const QHttpServerRequest &request, QHttpServerResponse &resp)
     {
+        // Routes answered with a response object, API routes report themselves.
+        this->pConnectionManager->startRequest(request.remoteAddress(),request.remotePort());
         QHttpHeaders h = resp.headers();
-        h.append(QHttpHeaders::WellKnownHeader::Server, "Range Cloud HTTPs Server");
+        h.append(QHttpHeaders::WellKnownHeader::Server, RHttpServer::serverName);
         resp.setHeaders(std::move(h));
     });
 }
 
 void RHttpServer::buildApiRoute(const QString &actionKey)
 {
-    this->pHttpServer->route(QString("/%1/").arg(actionKey),RHttpMessage::findMethodForAction(actionKey),[=, this](const QHttpServerRequest &request)
+    this->pHttpServer->route(QString("/%1/").arg(actionKey),RHttpMessage::findMethodForAction(actionKey),[=, this](const QHttpServerRequest &request, QHttpServerResponder &responder)
     {
+        const QHostAddress remoteAddress = request.remoteAddress();
+        const quint16 remotePort = request.remotePort();
+        this->pConnectionManager->startRequest(remoteAddress,remotePort);
+
+        // Time points and access log record share one block, continuations keep it alive through either pointer.
+        std::shared_ptr<RequestState> pState = std::make_shared<RequestState>();
+        std::shared_ptr<RHttpServerMetrics::Timing> pTiming(pState,&pState->timing);
+        pTiming->receivedTime = RHttpServerMetrics::currentTime();
+
         QString resourceName(request.query().queryItemValue(RCloudAction::Resource::Name::key));
         QUuid id(request.query().queryItemValue(RCloudAction::Resource::Id::key));
 
@@ -481,18 +651,558 @@ void RHttpServer::buildApiRoute(const QString &actionKey)
             userName = RTlsTrustStore::findCN(request.sslConfiguration().peerCertificate());
         }
 
-        QString fromAddress = QString("%1:%2").arg(request.remoteAddress().toString(),QString::number(request.remotePort()));
+        // Access log record is completed and queued once the response is sent, a background thread formats it.
+        std::shared_ptr<RHttpAccessLog::Record> pAccessRecord;
+        if (this->pContext->getAccessLog())
+        {
+            pAccessRecord = std::shared_ptr<RHttpAccessLog::Record>(pState,&pState->accessRecord);
+            RHttpAccessLog::setText(pAccessRecord->service,sizeof(pAccessRecord->service),this->getServiceName());
+            RHttpAccessLog::setText(pAccessRecord->action,sizeof(pAccessRecord->action),actionKey);
+            RHttpAccessLog::setText(pAccessRecord->user,sizeof(pAccessRecord->user),userName);
+            RHttpAccessLog::setText(pAccessRecord->resourceName,sizeof(pAccessRecord->resourceName),resourceName);
+            RHttpAccessLog::setRemoteAddress(*pAccessRecord,remoteAddress,remotePort);
+            pAccessRecord->resourceId = id;
+        }
+        else
+        {
+            RLogger::info("[%s] Request: user = \"%s\" (%s), url = \"%s\"\n",
+                          this->getServiceName().toUtf8().constData(),
+                          userName.toUtf8().constData(),
+                          RHttpConnectionManager::buildPeerKey(remoteAddress,remotePort).toUtf8().constData(),
+                          request.url().toDisplayString().toUtf8().constData());
+        }
+
+        const quint32 timeoutMs = this->findRequestTimeout(request);
+        const QByteArray body = request.body();
+        const qint64 bytesIn = body.size();
+
+        // Principal is limited before anything is answered from a cache or dispatched to the backend.
+        const QString principal = userName.isEmpty() ? request.remoteAddress().toString() : userName;
+        qint64 retryAfterMs = 0;
+        if (!this->pContext->getRateLimiter().tryAcquire(principal,bytesIn,RHttpServerHandlerRegistry::currentTime(),retryAfterMs))
+        {
+            RLogger::info("[%s] Rate limit exceeded: principal = \"%s\", action = \"%s\", retry after %lld ms\n",
+                          this->getServiceName().toUtf8().constData(),
+                          principal.toUtf8().constData(),
+                          actionKey.toUtf8().constData(),
+                          retryAfterMs);
+            this->pContext->getMetrics().recordRejection(actionKey);
+            QHttpHeaders headers;
+            headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,QByteArray::number((retryAfterMs + 999) / 1000));
+            this->writeResponse(responder,QHttpServerResponse::StatusCode::TooManyRequests,headers,QByteArray(),nullptr);
+            return;
+        }
+
+        QMap<QString,QString> requestProperties;
+        RHttpRange range;
+        QByteArray ifRange;
+        if (actionKey == RCloudAction::Action::FileDownload::key)
+        {
+            range = RHttpRange::fromString(request.headers().value(QHttpHeaders::WellKnownHeader::Range));
+            if (!range.isNull())
+            {
+                ifRange = request.headers().value(QHttpHeaders::WellKnownHeader::IfRange).trimmed().toByteArray();
+                requestProperties.insert(RCloudAction::Resource::Range::key,range.toString());
+                if (!ifRange.isEmpty())
+                {
+                    requestProperties.insert(RCloudAction::Resource::IfRange::key,QString::fromUtf8(ifRange));
+                }
+            }
+        }
+
+        // File downloads are streamed as stored (usually already compressed) and support byte ranges.
+        RHttpContentEncoder::Encoding encoding = RHttpContentEncoder::Identity;
+        if (this->httpServerSettings.getCompressionEnabled() && actionKey != RCloudAction::Action::FileDownload::key)
+        {
+            encoding = RHttpContentEncoder::negotiate(request.headers().value(QHttpHeaders::WellKnownHeader::AcceptEncoding));
+        }
 
-        RLogger::info("[%s] Request: user = \"%s\" (%s), url = \"%s\"\n",
+        // Conditional request whose validator matches a recent response is answered without the backend.
+        RHttpEntityTagCache *pEntityTagCache = this->pContext->getEntityTagCache();
+        const bool isConditional = RCloudAction::isConditionalAction(actionKey);
+        QByteArray ifNoneMatch;
+        QString entityTagKey;
+        quint64 entityTagGeneration = 0;
+        if (isConditional)
+        {
+            ifNoneMatch = request.headers().combinedValue(QHttpHeaders::WellKnownHeader::IfNoneMatch).trimmed();
+            if (!ifNoneMatch.isEmpty())
+            {
+                // Backend may omit the body if one of the validators is current.
+                requestProperties.insert(RCloudAction::Resource::IfNoneMatch::key,QString::fromLatin1(ifNoneMatch));
+            }
+            if (pEntityTagCache && !userName.isEmpty())
+            {
+                entityTagKey = RHttpEntityTagCache::buildKey(userName,actionKey,resourceName,id);
+                entityTagGeneration = pEntityTagCache->getGeneration();
+                const QByteArray entityTag = ifNoneMatch.isEmpty() ? QByteArray() : pEntityTagCache->find(entityTagKey,RHttpServerHandlerRegistry::currentTime());
+                if (!entityTag.isEmpty() && RHttpMessage::entityTagMatches(ifNoneMatch,entityTag))
+                {
+                    pEntityTagCache->recordHit();
+                    this->pContext->getRateLimiter().release(principal);
+                    const qint64 bytesOut = this->sendNotModified(responder,entityTag);
+                    this->recordRequest(actionKey,RError::None,bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+                    return;
+                }
+            }
+        }
+
+        // Read-mostly listing is answered from the cache until a matching mutation invalidates it.
+        RHttpResponseCache *pResponseCache = this->pContext->getResponseCache();
+        QString responseCacheKey;
+        quint64 responseCacheGeneration = 0;
+        if (pResponseCache && !userName.isEmpty() && RCloudAction::isCacheableAction(actionKey))
+        {
+            responseCacheKey = RHttpResponseCache::buildKey(actionKey,userName,resourceName,id,RHttpContentEncoder::toName(encoding));
+            responseCacheGeneration = pResponseCache->getGeneration();
+            RHttpMessage cachedResponse;
+            if (pResponseCache->find(responseCacheKey,RHttpServerHandlerRegistry::currentTime(),cachedResponse))
+            {
+                const QByteArray entityTag = cachedResponse.getEntityTag();
+                const qint64 bytesOut = (!ifNoneMatch.isEmpty() && RHttpMessage::entityTagMatches(ifNoneMatch,entityTag))
+                                      ? this->sendNotModified(responder,entityTag)
+                                      : this->sendResponse(responder,cachedResponse,remoteAddress,remotePort);
+                this->pContext->getRateLimiter().release(principal);
+                this->recordRequest(actionKey,RError::None,bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+                return;
+            }
+        }
+
+        const qint64 maxBodySize = this->httpServerSettings.getMaxBodySize();
+        if (body.size() > maxBodySize)
+        {
+            RLogger::warning("[%s] Request body size %lld exceeds limit %lld bytes for action \"%s\"\n",
+                             this->getServiceName().toUtf8().constData(),
+                             qint64(body.size()),
+                             maxBodySize,
+                             actionKey.toUtf8().constData());
+            this->pContext->getRateLimiter().release(principal);
+            this->pContext->getMetrics().recordRejection(actionKey);
+            this->writeResponse(responder,QHttpServerResponse::StatusCode::PayloadTooLarge,QHttpHeaders(),QByteArray(),nullptr);
+            return;
+        }
+
+        if (actionKey == RCloudAction::Action::Batch::key)
+        {
+            QString errorMessage;
+            if (!RHttpBatchActionHandler::validate(body,qsizetype(this->httpServerSettings.getMaxBatchSize()),errorMessage))
+            {
+                RLogger::warning("[%s] Invalid batch request: %s\n",
+                                 this->getServiceName().toUtf8().constData(),
+                                 errorMessage.toUtf8().constData());
+                this->pContext->getRateLimiter().release(principal);
+                this->pContext->getMetrics().recordRejection(actionKey);
+                this->writeResponse(responder,QHttpServerResponse::StatusCode::BadRequest,QHttpHeaders(),errorMessage.toUtf8(),nullptr);
+                return;
+            }
+        }
+
+        // Retried mutating request is answered with the response of the original one, it costs no slot.
+        RHttpIdempotencyStore *pIdempotencyStore = this->pContext->getIdempotencyStore();
+        QString idempotencyKey;
+        if (pIdempotencyStore && !userName.isEmpty() && RCloudAction::isMutatingAction(actionKey))
+        {
+            idempotencyKey = QString::fromLatin1(request.headers().value(RHttpMessage::idempotencyKeyHeader).trimmed());
+            if (!idempotencyKey.isEmpty() && !RHttpIdempotencyStore::isValidKey(idempotencyKey))
+            {
+                RLogger::warning("[%s] Ignoring invalid idempotency key \"%s\"\n",
+                                 this->getServiceName().toUtf8().constData(),
+                                 idempotencyKey.toUtf8().constData());
+                idempotencyKey.clear();
+            }
+        }
+        if (!idempotencyKey.isEmpty())
+        {
+            // Same key with a different body (even of the same size) is a conflict, not a retry.
+            const QString fingerprint = actionKey + QChar('\n') + resourceName + QChar('\n') + id.toString() + QChar('\n')
+                                      + QString::fromLatin1(QCryptographicHash::hash(body,QCryptographicHash::Sha256).toHex());
+            QFuture<RHttpMessage> originalFuture;
+            const RHttpIdempotencyStore::Result result = pIdempotencyStore->begin(userName,idempotencyKey,fingerprint,RHttpServerHandlerRegistry::currentTime(),originalFuture);
+            if (result == RHttpIdempotencyStore::Conflict)
+            {
+                RLogger::warning("[%s] Idempotency key \"%s\" of user \"%s\" was used for a different request: action = \"%s\"\n",
+                                 this->getServiceName().toUtf8().constData(),
+                                 idempotencyKey.toUtf8().constData(),
+                                 userName.toUtf8().constData(),
+                                 actionKey.toUtf8().constData());
+                this->pContext->getRateLimiter().release(principal);
+                this->pContext->getMetrics().recordRejection(actionKey);
+                this->writeResponse(responder,QHttpServerResponse::StatusCode::UnprocessableEntity,QHttpHeaders(),QByteArray(),nullptr);
+                return;
+            }
+            if (result != RHttpIdempotencyStore::Started)
+            {
+                RLogger::info("[%s] Retried request: user = \"%s\", action = \"%s\", idempotency key = \"%s\" (%s)\n",
+                              this->getServiceName().toUtf8().constData(),
+                              userName.toUtf8().constData(),
+                              actionKey.toUtf8().constData(),
+                              idempotencyKey.toUtf8().constData(),
+                              result == RHttpIdempotencyStore::Attached ? "in progress" : "replayed");
+                this->pContext->getRateLimiter().release(principal);
+                std::shared_ptr<QHttpServerResponder> pResponder = std::make_shared<QHttpServerResponder>(std::move(responder));
+                originalFuture.then(this,[=, this](const RHttpMessage &responseMessage)
+                {
+                    const qint64 bytesOut = this->sendResponse(*pResponder,responseMessage,remoteAddress,remotePort);
+                    this->recordRequest(actionKey,responseMessage.getErrorType(),bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+                }).onCanceled(this,[=, this]()
+                {
+                    // Original request was abandoned (shed, rejected or expired), so is the retry, client may try again.
+                    const RHttpMessage overloadMessage = RHttpServer::buildOverloadMessage(1000);
+                    const qint64 bytesOut = this->sendResponse(*pResponder,overloadMessage,remoteAddress,remotePort);
+                    this->recordRequest(actionKey,overloadMessage.getErrorType(),bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+                });
+                return;
+            }
+        }
+
+        // Sync client waiting for file changes is answered from the feed, it costs no slot of a lane.
+        RHttpChangeFeed *pChangeFeed = this->pContext->getChangeFeed();
+        if (pChangeFeed && actionKey == RCloudAction::Action::FileChanges::key)
+        {
+            // Waiting client does not hold in-flight slot of its principal.
+            this->pContext->getRateLimiter().release(principal);
+            if (userName.isEmpty())
+            {
+                this->pContext->getMetrics().recordRejection(actionKey);
+                this->writeResponse(responder,QHttpServerResponse::StatusCode::Unauthorized,QHttpHeaders(),QByteArray(),nullptr);
+                return;
+            }
+            pTiming->dispatchedTime = RHttpServerMetrics::currentTime();
+            QFuture<RFileChangeSet> changeFuture;
+            const quint64 waiterId = pChangeFeed->wait(userName,body.trimmed().toULongLong(),changeFuture);
+            if (waiterId != 0)
+            {
+                // Client is answered without changes well before it gives up the request.
+                const qint64 waitMs = qMin(this->httpServerSettings.getChangeFeedMaxWaitMs(),qint64(timeoutMs) * 3 / 4);
+                QTimer::singleShot(waitMs,this,[pChangeFeed,userName,waiterId]()
+                {
+                    pChangeFeed->stopWaiting(userName,waiterId);
+                });
+            }
+            std::shared_ptr<QHttpServerResponder> pResponder = std::make_shared<QHttpServerResponder>(std::move(responder));
+            changeFuture.then(this,[=, this](const RFileChangeSet &changeSet)
+            {
+                pTiming->repliedTime = RHttpServerMetrics::currentTime();
+                const qint64 bytesOut = this->writeResponse(*pResponder,
+                                                            QHttpServerResponse::StatusCode::Ok,
+                                                            QHttpHeaders(),
+                                                            QJsonDocument(changeSet.toJson()).toJson(QJsonDocument::Compact),
+                                                            nullptr);
+                this->recordRequest(actionKey,RError::None,bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+            });
+            return;
+        }
+
+        // Each lane has its own slots, so bulk transfers cannot hold back metadata requests.
+        RHttpDispatchLane *pLane = this->pContext->findLane(actionKey);
+
+        // Request which would wait for a slot longer than it can afford is rejected before it queues.
+        RHttpLoadShedder *pLoadShedder = this->pContext->getLoadShedder();
+        if (pLoadShedder && pLane->getActiveCount() >= pLane->getMaxConcurrency())
+        {
+            const qint64 timeLeft = qint64(timeoutMs) * 1000 - (RHttpServerMetrics::currentTime() - pTiming->receivedTime);
+            if (!pLoadShedder->admitQueued(actionKey,pLane->getType(),pLane->getQueuedCount(),pLane->getMaxConcurrency(),timeLeft,retryAfterMs))
+            {
+                this->pContext->getRateLimiter().release(principal);
+                if (!idempotencyKey.isEmpty())
+                {
+                    pIdempotencyStore->abandon(userName,idempotencyKey);
+                }
+                RLogger::info("[%s] Shedding load: action = \"%s\" cannot be answered within %u ms, retry after %lld ms\n",
+                              this->getServiceName().toUtf8().constData(),
+                              actionKey.toUtf8().constData(),
+                              timeoutMs,
+                              retryAfterMs);
+                this->pContext->getMetrics().recordRejection(actionKey);
+                QHttpHeaders headers;
+                headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,QByteArray::number((retryAfterMs + 999) / 1000));
+                this->writeResponse(responder,QHttpServerResponse::StatusCode::ServiceUnavailable,headers,QByteArray(),nullptr);
+                return;
+            }
+        }
+
+        QFuture<void> slotFuture;
+        const RHttpDispatchLane::Admission admission = pLane->acquire(slotFuture);
+        if (admission == RHttpDispatchLane::Rejected)
+        {
+            this->pContext->getRateLimiter().release(principal);
+            if (!idempotencyKey.isEmpty())
+            {
+                pIdempotencyStore->abandon(userName,idempotencyKey);
+            }
+            RLogger::warning("[%s] Dispatch lane \"%s\" is full: action = \"%s\"\n",
+                             this->getServiceName().toUtf8().constData(),
+                             RHttpDispatchLane::typeToString(pLane->getType()).toUtf8().constData(),
+                             actionKey.toUtf8().constData());
+            this->pContext->getMetrics().recordRejection(actionKey);
+            QHttpHeaders headers;
+            headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,"1");
+            this->writeResponse(responder,QHttpServerResponse::StatusCode::ServiceUnavailable,headers,QByteArray(),nullptr);
+            return;
+        }
+
+        auto dispatchRequest = [=, this]() -> QFuture<RHttpMessage>
+        {
+            // Only requests reaching the backend need the address as text.
+            const QString fromAddress = RHttpConnectionManager::buildPeerKey(remoteAddress,remotePort);
+            pTiming->dispatchedTime = RHttpServerMetrics::currentTime();
+            return this->processRequest(actionKey,userName,fromAddress,resourceName,id,requestProperties,body,timeoutMs);
+        };
+
+        QFuture<RHttpMessage> responseFuture;
+        if (admission == RHttpDispatchLane::Granted)
+        {
+            responseFuture = dispatchRequest();
+        }
+        else
+        {
+            responseFuture = slotFuture.then(this,[=, this]() -> QFuture<RHttpMessage>
+            {
+                // Backend is not bothered with request whose client would give up before the reply.
+                qint64 dispatchRetryAfterMs = 0;
+                const qint64 timeLeft = qint64(timeoutMs) * 1000 - (RHttpServerMetrics::currentTime() - pTiming->receivedTime);
+                if (pLoadShedder && !pLoadShedder->admitDispatch(actionKey,pLane->getType(),timeLeft,dispatchRetryAfterMs))
+                {
+                    RLogger::info("[%s] Shedding load: action = \"%s\" waited too long for a slot, retry after %lld ms\n",
+                                  this->getServiceName().toUtf8().constData(),
+                                  actionKey.toUtf8().constData(),
+                                  dispatchRetryAfterMs);
+                    return QtFuture::makeReadyValueFuture(RHttpServer::buildOverloadMessage(dispatchRetryAfterMs));
+                }
+                return dispatchRequest();
+            }).unwrap();
+        }
+        if (!idempotencyKey.isEmpty())
+        {
+            // Response is handed to waiting retries as soon as it is available.
+            responseFuture = responseFuture.then(QtFuture::Launch::Sync,[pIdempotencyStore,userName,idempotencyKey](const RHttpMessage &responseMessage)
+            {
+                pIdempotencyStore->finish(userName,idempotencyKey,responseMessage);
+                return responseMessage;
+            });
+        }
+        if (pChangeFeed && RCloudAction::isFileChangingAction(actionKey))
+        {
+            // Waiting sync clients learn about the change as soon as it is made.
+            responseFuture = responseFuture.then(QtFuture::Launch::Sync,[pChangeFeed,actionKey,userName](const RHttpMessage &responseMessage)
+            {
+                if (responseMessage.getErrorType() == RError::None)
+                {
+                    pChangeFeed->publishResponse(actionKey,userName,responseMessage.getBody());
+                }
+                return responseMessage;
+            });
+        }
+
+        // Responder is kept until the backend replies. No thread is waiting for the reply,
+        // the continuation runs in the server thread once the promise is fulfilled.
+        std::shared_ptr<QHttpServerResponder> pResponder = std::make_shared<QHttpServerResponder>(std::move(responder));
+        auto sendReply = [=, this](const RHttpMessage &responseMessage) -> qint64
+        {
+            const QByteArray entityTag = responseMessage.getEntityTag();
+            if (isConditional && responseMessage.getErrorType() == RError::None && !entityTag.isEmpty())
+            {
+                if (!entityTagKey.isEmpty())
+                {
+                    pEntityTagCache->insert(entityTagKey,entityTag,entityTagGeneration,RHttpServerHandlerRegistry::currentTime());
+                }
+                if (!ifNoneMatch.isEmpty() && RHttpMessage::entityTagMatches(ifNoneMatch,entityTag))
+                {
+                    if (pEntityTagCache)
+                    {
+                        pEntityTagCache->recordRevalidation();
+                    }
+                    return this->sendNotModified(*pResponder,entityTag);
+                }
+            }
+            if (actionKey == RCloudAction::Action::FileDownload::key)
+            {
+                return this->sendRangeResponse(*pResponder,responseMessage,range,ifRange,remoteAddress,remotePort);
+            }
+            return this->sendResponse(*pResponder,responseMessage,remoteAddress,remotePort);
+        };
+        if (encoding != RHttpContentEncoder::Identity)
+        {
+            // Compress response body on a worker thread, the server thread only sends it.
+            const qint64 compressionMinSize = this->httpServerSettings.getCompressionMinSize();
+            responseFuture.then(pLane->getThreadPool(),[pTiming,encoding,compressionMinSize,ifNoneMatch](RHttpMessage responseMessage)
+            {
+                pTiming->repliedTime = RHttpServerMetrics::currentTime();
+                // Body which is not going to be sent is not compressed.
+                if (ifNoneMatch.isEmpty() || !RHttpMessage::entityTagMatches(ifNoneMatch,responseMessage.getEntityTag()))
+                {
+                    RHttpContentEncoder::encodeMessage(responseMessage,encoding,compressionMinSize);
+                }
+                return responseMessage;
+            }).then(this,[=, this](const RHttpMessage &responseMessage)
+            {
+                if (!responseCacheKey.isEmpty())
+                {
+                    pResponseCache->insert(responseCacheKey,responseMessage,responseCacheGeneration,RHttpServerHandlerRegistry::currentTime());
+                }
+                const qint64 bytesOut = sendReply(responseMessage);
+                this->finishRequest(actionKey,principal,responseMessage.getErrorType(),bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+            });
+        }
+        else
+        {
+            responseFuture.then(this,[=, this](const RHttpMessage &responseMessage)
+            {
+                pTiming->repliedTime = RHttpServerMetrics::currentTime();
+                if (!responseCacheKey.isEmpty())
+                {
+                    pResponseCache->insert(responseCacheKey,responseMessage,responseCacheGeneration,RHttpServerHandlerRegistry::currentTime());
+                }
+                const qint64 bytesOut = sendReply(responseMessage);
+                this->finishRequest(actionKey,principal,responseMessage.getErrorType(),bytesIn,bytesOut,*pTiming,pAccessRecord.get());
+            });
+        }
+    });
+}
+
+void RHttpServer::finishRequest(const QString &action, const QString &principal, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const RHttpServerMetrics::Timing &timing, RHttpAccessLog::Record *pAccessRecord)
+{
+    this->pContext->getRateLimiter().release(principal);
+    RHttpDispatchLane *pLane = this->pContext->findLane(action);
+    pLane->release();
+    if (this->pContext->getLoadShedder() && timing.dispatchedTime > 0 && timing.repliedTime >= timing.dispatchedTime)
+    {
+        this->pContext->getLoadShedder()->recordServiceTime(action,pLane->getType(),timing.repliedTime - timing.dispatchedTime);
+    }
+    if (errorType == RError::None && this->pContext->getEntityTagCache() && RCloudAction::isMutatingAction(action))
+    {
+        // Any listing or file may have changed.
+        this->pContext->getEntityTagCache()->invalidate();
+    }
+    if (errorType == RError::None && this->pContext->getResponseCache())
+    {
+        this->pContext->getResponseCache()->invalidate(action);
+    }
+    this->recordRequest(action,errorType,bytesIn,bytesOut,timing,pAccessRecord);
+}
+
+void RHttpServer::recordRequest(const QString &action, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const RHttpServerMetrics::Timing &timing, RHttpAccessLog::Record *pAccessRecord)
+{
+    this->pContext->getMetrics().recordRequest(action,errorType,bytesIn,bytesOut,timing);
+    if (pAccessRecord && this->pContext->getAccessLog())
+    {
+        pAccessRecord->timestamp = QDateTime::currentMSecsSinceEpoch();
+        pAccessRecord->duration = RHttpServerMetrics::currentTime() - timing.receivedTime;
+        pAccessRecord->bytesIn = bytesIn;
+        pAccessRecord->bytesOut = bytesOut;
+        pAccessRecord->errorType = errorType;
+        this->pContext->getAccessLog()->append(*pAccessRecord);
+    }
+}
+
+RHttpAdmissionGate::Verdict RHttpServer::admitRequestHead(const RHttpAdmissionGate::RequestHead &requestHead, QSslSocket *socket)
+{
+    // Only requests carrying a body are worth rejecting before it is received,
+    // the rest is checked in the route as usual.
+    if (requestHead.contentLength <= 0 && !requestHead.chunked)
+    {
+        return RHttpAdmissionGate::Verdict();
+    }
+    const QString actionKey = requestHead.url.path().section('/',1,1);
+    if (!RCloudAction::getActionMap().contains(actionKey))
+    {
+        return RHttpAdmissionGate::Verdict();
+    }
+    // Only uploads (PUT actions) are gated, bodies of other actions are small and the route
+    // answers them, authenticated or not, as it always did.
+    if (requestHead.method != "PUT" || RHttpMessage::findMethodForAction(actionKey) != QHttpServerRequest::Method::Put)
+    {
+        return RHttpAdmissionGate::Verdict();
+    }
+
+    const QUrlQuery query(requestHead.url);
+    QString userName;
+    if (this->type == RHttpServer::Public)
+    {
+        const QString authUser = query.queryItemValue(RCloudAction::Auth::User::key);
+        if (this->authenticateToken(authUser,query.queryItemValue(RCloudAction::Auth::Token::key)))
+        {
+            userName = authUser;
+        }
+    }
+    else if (this->type == RHttpServer::Private)
+    {
+        userName = RTlsTrustStore::findCN(socket->peerCertificate());
+    }
+    if (userName.isEmpty())
+    {
+        RLogger::warning("[%s] Rejected unauthenticated upload from \"%s\": action = \"%s\"\n",
+                         this->getServiceName().toUtf8().constData(),
+                         socket->peerAddress().toString().toUtf8().constData(),
+                         actionKey.toUtf8().constData());
+        this->pContext->getMetrics().recordRejection(actionKey);
+        return RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::Unauthorized);
+    }
+
+    if (requestHead.contentLength > 0)
+    {
+        const qint64 maxBodySize = this->httpServerSettings.getMaxBodySize();
+        if (requestHead.contentLength > maxBodySize)
+        {
+            RLogger::warning("[%s] Rejected upload of %lld bytes exceeding limit %lld bytes: user = \"%s\", action = \"%s\"\n",
+                             this->getServiceName().toUtf8().constData(),
+                             requestHead.contentLength,
+                             maxBodySize,
+                             userName.toUtf8().constData(),
+                             actionKey.toUtf8().constData());
+            this->pContext->getMetrics().recordRejection(actionKey);
+            return RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::PayloadTooLarge);
+        }
+
+        const bool newFile = (actionKey == RCloudAction::Action::FileUpload::key);
+        RFileQuota fileQuota;
+        RFileQuota fileUsage;
+        if (this->pFileQuotaProvider
+            && (newFile || actionKey == RCloudAction::Action::FileReplace::key)
+            && this->pFileQuotaProvider->findFileQuota(userName,fileQuota,fileUsage))
+        {
+            qint64 replacedSize = 0;
+            if (!newFile)
+            {
+                replacedSize = this->pFileQuotaProvider->findFileSize(QUuid(query.queryItemValue(RCloudAction::Resource::Id::key)));
+                if (replacedSize < 0)
+                {
+                    // Store usage cannot be told, only the file size limit is checked.
+                    replacedSize = requestHead.contentLength;
+                }
+            }
+            const RFileQuota requiredQuota(fileUsage.getStoreSize() + requestHead.contentLength - replacedSize,
+                                           requestHead.contentLength,
+                                           fileUsage.getFileCount() + (newFile ? 1 : 0));
+            if (fileQuota.quotaExceeded(requiredQuota))
+            {
+                RLogger::warning("[%s] Rejected upload of %lld bytes exceeding file quota: user = \"%s\", action = \"%s\"\n",
+                                 this->getServiceName().toUtf8().constData(),
+                                 requestHead.contentLength,
+                                 userName.toUtf8().constData(),
+                                 actionKey.toUtf8().constData());
+                this->pContext->getMetrics().recordRejection(actionKey);
+                return RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::PayloadTooLarge);
+            }
+        }
+    }
+
+    // Limits are only checked here, the route acquires them once the body is received.
+    qint64 retryAfterMs = 0;
+    if (!this->pContext->getRateLimiter().check(userName,requestHead.contentLength,RHttpServerHandlerRegistry::currentTime(),retryAfterMs))
+    {
+        RLogger::info("[%s] Rate limit exceeded before upload: principal = \"%s\", action = \"%s\", retry after %lld ms\n",
                       this->getServiceName().toUtf8().constData(),
                       userName.toUtf8().constData(),
-                      fromAddress.toUtf8().constData(),
-                      request.url().toDisplayString().toUtf8().constData());
+                      actionKey.toUtf8().constData(),
+                      retryAfterMs);
+        this->pContext->getMetrics().recordRejection(actionKey);
+        QHttpHeaders headers;
+        headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,QByteArray::number((retryAfterMs + 999) / 1000));
+        return RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::TooManyRequests,headers);
+    }
 
-        return QtConcurrent::run([=, this](const QByteArray body) {
-            return this->processRequest(actionKey,userName,fromAddress,resourceName,id,body);
-        },request.body());
-    });
+    return RHttpAdmissionGate::Verdict();
 }
 
 bool RHttpServer::authenticateToken(const QString &user, const QString &token) const
@@ -504,57 +1214,263 @@ bool RHttpServer::authenticateToken(const QString &user, const QString &token) c
     return false;
 }
 
-QHttpServerResponse RHttpServer::processRequest(
+QFuture<RHttpMessage> RHttpServer::processRequest(
     const QString &action,
     const QString &owner,
     const QString &fromAddress,
     const QString &resourceName,
     const QUuid &id,
-    const QByteArray &data)
+    const QMap<QString,QString> &requestProperties,
+    const QByteArray &data,
+    quint32 timeoutMs)
 {
     RHttpMessage message;
     message.setOwner(owner);
 
-    QMap<QString, QString> properties;
+    QMap<QString, QString> properties(requestProperties);
 
     properties.insert(RCloudAction::Action::key,action);
     properties.insert(RCloudAction::Resource::Name::key,resourceName);
     properties.insert(RCloudAction::Resource::Id::key,id.toString(QUuid::WithBraces));
+    if (action == RCloudAction::Action::Statistics::key)
+    {
+        properties.insert(RCloudAction::Server::Metrics::key,QString::fromUtf8(QJsonDocument(this->getMetrics()).toJson(QJsonDocument::Compact)));
+    }
 
     message.setProperties(properties);
     message.setBody(data);
     message.setFrom(fromAddress);
 
-    std::unique_ptr<RHttpServerHandler> serverHandler(new RHttpServerHandler);
-    this->serverHandlerAdd(serverHandler.get());
-    message.setHandlerId(serverHandler->getId());
+    // Handler is owned by the registry until somebody takes it out of it
+    // (reply or expiry) and fulfils its promise.
+    RHttpServerHandler *serverHandler = this->handlerRegistry.acquire();
+    const QUuid handlerId = serverHandler->getId();
+    QFuture<RHttpMessage> responseFuture = serverHandler->getFuture();
+    message.setHandlerId(handlerId);
     RLogger::debug("[%s] Received message with payload size = \"%ld\"\n",this->getServiceName().toUtf8().constData(),message.getBody().size());
 
-    emit this->requestAvailable(message);
+    // Expired entries of handlers which were already replied are ignored by expireHandlers().
+    this->handlerTimingWheel.schedule(handlerId,serverHandler->getCreationTime() + timeoutMs);
+    if (!this->pExpiryTimer->isActive())
+    {
+        this->pExpiryTimer->start();
+    }
+
+    RHttpActionHandler *pActionHandler = this->pContext->getDispatcher().findHandler(action);
+    if (!pActionHandler && action == RCloudAction::Action::Batch::key && RHttpBatchActionHandler::isHandledInProcess(this->pContext->getDispatcher(),data))
+    {
+        // Otherwise the whole batch goes to requestAvailable() receivers in one message.
+        pActionHandler = &this->pContext->getBatchHandler();
+    }
+    if (pActionHandler)
+    {
+        // Reply goes through the same path as replies of requestAvailable() receivers.
+        this->pContext->getDispatcher().dispatch(pActionHandler,message).then(this,[this](const RHttpMessage &replyMessage)
+        {
+            this->sendMessageReply(replyMessage);
+        });
+    }
+    else
+    {
+        emit this->requestAvailable(message);
+    }
 
-    RHttpMessage responseMessage;
-    const quint32 timeout = this->httpServerSettings.getResponseTimeoutMs();
-    bool success = serverHandler->fetchResponseMessage(timeout, responseMessage);
+    return responseFuture;
+}
 
-    if (!success)
+quint32 RHttpServer::findRequestTimeout(const QHttpServerRequest &request) const
+{
+    const quint32 defaultTimeoutMs = this->httpServerSettings.getResponseTimeoutMs();
+
+    const QByteArrayView timeoutValue = request.headers().value(RHttpMessage::requestTimeoutHeader);
+    if (timeoutValue.isEmpty())
     {
-        RLogger::error("[%s] Request timeout after %u ms for action '%s' from %s\n",
-                      this->getServiceName().toUtf8().constData(),
-                      timeout,
-                      action.toUtf8().constData(),
-                      fromAddress.toUtf8().constData());
+        return defaultTimeoutMs;
+    }
 
-        responseMessage.setErrorType(RError::Timeout);
-        responseMessage.setBody(QString("Request timeout after %1 ms").arg(timeout).toUtf8());
+    bool isOk = false;
+    const qint64 timeoutMs = timeoutValue.toLongLong(&isOk);
+    if (!isOk || timeoutMs <= 0)
+    {
+        RLogger::warning("[%s] Ignoring invalid request timeout \"%s\"\n",
+                         this->getServiceName().toUtf8().constData(),
+                         timeoutValue.toByteArray().constData());
+        return defaultTimeoutMs;
     }
 
-    this->serverHandlerRemove(serverHandler->getId());
+    return quint32(qBound(qint64(this->httpServerSettings.getHandlerExpiryResolutionMs()),
+                          timeoutMs,
+                          qint64(this->httpServerSettings.getMaxStaleHandlerAgeMs())));
+}
 
+qint64 RHttpServer::sendResponse(QHttpServerResponder &responder,
+                                 const RHttpMessage &responseMessage,
+                                 const QHostAddress &remoteAddress,
+                                 quint16 remotePort) const
+{
     RLogger::debug("[%s] Create server response\n",this->getServiceName().toUtf8().constData());
-    QHttpServerResponse response(responseMessage.getBody(),RHttpMessage::errorTypeToStatusCode(responseMessage.getErrorType()));
-    response.setHeaders(responseMessage.getResponseHeaders());
-    RLogger::debug("[%s] Response is ready\n",this->getServiceName().toUtf8().constData());
-    return response;
+    const QSharedPointer<QIODevice> &bodyDevice = responseMessage.getBodyDevice();
+    QHttpServerResponse::StatusCode statusCode = RHttpMessage::errorTypeToStatusCode(responseMessage.getErrorType());
+    if (statusCode != QHttpServerResponse::StatusCode::Ok && responseMessage.getResponseHeaders().contains(QHttpHeaders::WellKnownHeader::RetryAfter))
+    {
+        // Request was not processed and may be sent again later.
+        statusCode = QHttpServerResponse::StatusCode::ServiceUnavailable;
+    }
+    return this->writeResponse(responder,
+                               statusCode,
+                               responseMessage.getResponseHeaders(),
+                               responseMessage.getBody(),
+                               bodyDevice ? new RHttpBodyDevice(bodyDevice) : nullptr,
+                               remoteAddress,
+                               remotePort);
+}
+
+qint64 RHttpServer::sendRangeResponse(QHttpServerResponder &responder,
+                                      const RHttpMessage &responseMessage,
+                                      const RHttpRange &range,
+                                      const QByteArray &ifRange,
+                                      const QHostAddress &remoteAddress,
+                                      quint16 remotePort) const
+{
+    RLogger::debug("[%s] Create server range response\n",this->getServiceName().toUtf8().constData());
+    const QHttpServerResponse::StatusCode statusCode = RHttpMessage::errorTypeToStatusCode(responseMessage.getErrorType());
+    if (statusCode != QHttpServerResponse::StatusCode::Ok)
+    {
+        return this->sendResponse(responder,responseMessage,remoteAddress,remotePort);
+    }
+
+    QHttpHeaders headers(responseMessage.getResponseHeaders());
+    headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::AcceptRanges,"bytes");
+
+    const QSharedPointer<QIODevice> &bodyDevice = responseMessage.getBodyDevice();
+
+    bool sendFullContent = range.isNull() || !RHttpServer::ifRangeMatches(ifRange,headers);
+    if (headers.contains(QHttpHeaders::WellKnownHeader::ContentRange))
+    {
+        // Backend has already selected the range.
+        return this->writeResponse(responder,
+                                   QHttpServerResponse::StatusCode::PartialContent,
+                                   headers,
+                                   responseMessage.getBody(),
+                                   bodyDevice ? new RHttpBodyDevice(bodyDevice) : nullptr,
+                                   remoteAddress,
+                                   remotePort);
+    }
+    if (bodyDevice && bodyDevice->isSequential())
+    {
+        // Size of sequential body is not known in advance.
+        sendFullContent = true;
+    }
+    if (sendFullContent)
+    {
+        return this->writeResponse(responder,
+                                   statusCode,
+                                   headers,
+                                   responseMessage.getBody(),
+                                   bodyDevice ? new RHttpBodyDevice(bodyDevice) : nullptr,
+                                   remoteAddress,
+                                   remotePort);
+    }
+
+    const qint64 size = bodyDevice ? bodyDevice->size() : responseMessage.getBody().size();
+    qint64 offset = 0;
+    qint64 length = 0;
+    if (!range.resolve(size,offset,length))
+    {
+        RLogger::info("[%s] Requested range \"%s\" is not satisfiable (size: %lld)\n",
+                      this->getServiceName().toUtf8().constData(),
+                      range.toString().toUtf8().constData(),
+                      size);
+        headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentRange,RHttpRange::buildUnsatisfiedContentRange(size));
+        return this->writeResponse(responder,QHttpServerResponse::StatusCode::RequestRangeNotSatisfiable,headers,QByteArray(),nullptr);
+    }
+
+    headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentRange,RHttpRange::buildContentRange(offset,length,size));
+    if (bodyDevice)
+    {
+        return this->writeResponse(responder,
+                                   QHttpServerResponse::StatusCode::PartialContent,
+                                   headers,
+                                   QByteArray(),
+                                   new RHttpBodyDevice(bodyDevice,offset,length),
+                                   remoteAddress,
+                                   remotePort);
+    }
+    else
+    {
+        return this->writeResponse(responder,
+                                   QHttpServerResponse::StatusCode::PartialContent,
+                                   headers,
+                                   responseMessage.getBody().mid(offset,length),
+                                   nullptr);
+    }
+}
+
+qint64 RHttpServer::sendNotModified(QHttpServerResponder &responder, const QByteArray &entityTag) const
+{
+    RLogger::debug("[%s] Create not modified response\n",this->getServiceName().toUtf8().constData());
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::ETag,entityTag);
+    return this->writeResponse(responder,QHttpServerResponse::StatusCode::NotModified,headers,QByteArray(),nullptr);
+}
+
+qint64 RHttpServer::writeResponse(QHttpServerResponder &responder,
+                                  QHttpServerResponse::StatusCode statusCode,
+                                  const QHttpHeaders &responseHeaders,
+                                  const QByteArray &body,
+                                  QIODevice *pBodyDevice,
+                                  const QHostAddress &remoteAddress,
+                                  quint16 remotePort) const
+{
+    QHttpHeaders headers(responseHeaders);
+    headers.append(QHttpHeaders::WellKnownHeader::Server,RHttpServer::serverName);
+
+    qint64 bodySize = body.size();
+    if (pBodyDevice)
+    {
+        bodySize = pBodyDevice->size();
+        if (!headers.contains(QHttpHeaders::WellKnownHeader::ContentType))
+        {
+            headers.append(QHttpHeaders::WellKnownHeader::ContentType,"application/octet-stream");
+        }
+        // Responder takes ownership of the device and reads from it only as the socket drains.
+        this->pConnectionManager->streamResponse(remoteAddress,remotePort,pBodyDevice);
+        responder.write(pBodyDevice,headers,statusCode);
+    }
+    else
+    {
+        QHttpServerResponse response(body,statusCode);
+        response.setHeaders(std::move(headers));
+        responder.sendResponse(response);
+    }
+    RLogger::debug("[%s] Response was sent\n",this->getServiceName().toUtf8().constData());
+    return bodySize;
+}
+
+bool RHttpServer::ifRangeMatches(const QByteArray &ifRange, const QHttpHeaders &responseHeaders)
+{
+    if (ifRange.isEmpty())
+    {
+        return true;
+    }
+    // Only strong entity tags are accepted (dates cannot be validated, no Last-Modified is sent).
+    const QByteArrayView entityTag = responseHeaders.value(QHttpHeaders::WellKnownHeader::ETag);
+    if (entityTag.isEmpty() || entityTag.startsWith("W/") || ifRange.startsWith("W/"))
+    {
+        return false;
+    }
+    return entityTag == ifRange;
+}
+
+RHttpMessage RHttpServer::buildOverloadMessage(qint64 retryAfterMs)
+{
+    RHttpMessage message;
+    message.setErrorType(RError::Timeout);
+    message.setBody("Server is overloaded");
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,QByteArray::number((retryAfterMs + 999) / 1000));
+    message.setResponseHeaders(headers);
+    return message;
 }
 
 QString RHttpServer::getServiceName() const
@@ -576,97 +1492,87 @@ QString RHttpServer::getServiceName() const
     }
 }
 
-void RHttpServer::serverHandlerAdd(RHttpServerHandler *serverHandler)
-{
-    R_LOG_TRACE_IN;
-    QMutexLocker locker(&this->syncMutex);
-    this->serverHandlers.insert(serverHandler->getId(),serverHandler);
-    this->handlerCreationTimes.insert(serverHandler->getId(), QDateTime::currentDateTime());
-    RLogger::debug("[%s] Added handler %s (total handlers: %d)\n",
-                  this->getServiceName().toUtf8().constData(),
-                  serverHandler->getId().toString(QUuid::WithoutBraces).toUtf8().constData(),
-                  this->serverHandlers.size());
-    R_LOG_TRACE_OUT;
-}
-
-void RHttpServer::serverHandlerRemove(const QUuid &serverHandlerId)
-{
-    R_LOG_TRACE_IN;
-    QMutexLocker locker(&this->syncMutex);
-    this->serverHandlers.remove(serverHandlerId);
-    this->handlerCreationTimes.remove(serverHandlerId);
-    RLogger::debug("[%s] Removed handler %s (remaining handlers: %d)\n",
-                  this->getServiceName().toUtf8().constData(),
-                  serverHandlerId.toString(QUuid::WithoutBraces).toUtf8().constData(),
-                  this->serverHandlers.size());
-    R_LOG_TRACE_OUT;
-}
-
-void RHttpServer::cleanupStaleHandlers()
+void RHttpServer::expireHandlers()
 {
     R_LOG_TRACE_IN;
-    QMutexLocker locker(&this->syncMutex);
-
-    QDateTime currentTime = QDateTime::currentDateTime();
-    qint64 maxAgeMs = this->httpServerSettings.getMaxStaleHandlerAgeMs();
-
-    QList<QUuid> staleHandlerIds;
+    const qint64 currentTime = RHttpServerHandlerRegistry::currentTime();
 
-    // Find stale handlers
-    for (auto iter = this->handlerCreationTimes.constBegin(); iter != this->handlerCreationTimes.constEnd(); ++iter)
+    const QList<QUuid> expiredIds = this->handlerTimingWheel.advance(currentTime);
+    for (const QUuid &handlerId : expiredIds)
     {
-        qint64 ageMs = iter.value().msecsTo(currentTime);
-        if (ageMs > maxAgeMs)
+        // Handlers which were already replied are no longer registered.
+        RHttpServerHandler *expiredHandler = this->handlerRegistry.take(handlerId);
+        if (!expiredHandler)
         {
-            staleHandlerIds.append(iter.key());
-            RLogger::warning("[%s] Found stale handler %s (age: %lld ms, max: %lld ms)\n",
-                           this->getServiceName().toUtf8().constData(),
-                           iter.key().toString(QUuid::WithoutBraces).toUtf8().constData(),
-                           ageMs,
-                           maxAgeMs);
+            continue;
         }
-    }
 
-    // Remove stale handlers. Handlers are owned by the request thread inside
-    // processRequest(), so they must never be deleted here — only woken up.
-    for (const QUuid &handlerId : staleHandlerIds)
-    {
-        RHttpServerHandler *handler = this->serverHandlers.value(handlerId, nullptr);
-        if (handler)
-        {
-            // Send timeout response to wake up waiting thread
-            RHttpMessage timeoutResponse;
-            timeoutResponse.setErrorType(RError::Timeout);
-            timeoutResponse.setBody("Handler cleanup: request exceeded maximum age");
-            handler->sendReply(timeoutResponse);
-        }
-        this->serverHandlers.remove(handlerId);
-        this->handlerCreationTimes.remove(handlerId);
+        const qint64 ageMs = currentTime - expiredHandler->getCreationTime();
+        RLogger::error("[%s] Request timeout after %lld ms (handler: %s)\n",
+                       this->getServiceName().toUtf8().constData(),
+                       ageMs,
+                       handlerId.toString(QUuid::WithoutBraces).toUtf8().constData());
+
+        RHttpMessage timeoutResponse;
+        timeoutResponse.setErrorType(RError::Timeout);
+        timeoutResponse.setBody(QString("Request timeout after %1 ms").arg(ageMs).toUtf8());
+        expiredHandler->sendReply(timeoutResponse);
+        this->handlerRegistry.release(expiredHandler);
     }
 
-    if (!staleHandlerIds.isEmpty())
+    if (this->handlerTimingWheel.isEmpty())
     {
-        RLogger::warning("[%s] Cleaned up %d stale handler(s). Remaining handlers: %d\n",
-                       this->getServiceName().toUtf8().constData(),
-                       staleHandlerIds.size(),
-                       this->serverHandlers.size());
+        this->pExpiryTimer->stop();
     }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpServer::checkPendingHandlers()
+{
+    R_LOG_TRACE_IN;
+    const int nHandlers = this->handlerRegistry.size();
+
+    this->pContext->getRateLimiter().prune(RHttpServerHandlerRegistry::currentTime());
 
     // Log warning if handler count is high
-    if (this->serverHandlers.size() > 100)
+    if (nHandlers > 100)
     {
         RLogger::warning("[%s] High number of active handlers: %d. This may indicate a resource leak.\n",
-                       this->getServiceName().toUtf8().constData(),
-                       this->serverHandlers.size());
+                         this->getServiceName().toUtf8().constData(),
+                         nHandlers);
     }
 
     R_LOG_TRACE_OUT;
 }
 
+void RHttpServer::onTlsFileChanged(const QString &path)
+{
+    RLogger::info("[%s] TLS file \"%s\" has changed.\n",
+                  this->getServiceName().toUtf8().constData(),
+                  path.toUtf8().constData());
+    this->pTlsReloadTimer->start();
+}
+
 void RHttpServer::onStartedEncryptionHandshake(QSslSocket *socket)
 {
-    if (socket->waitForEncrypted())
+    this->pConnectionManager->addConnection(socket,RHttpServerHandlerRegistry::currentTime());
+
+    if (this->httpServerSettings.getEarlyAdmissionEnabled())
+    {
+        RHttpAdmissionGate *pAdmissionGate = new RHttpAdmissionGate([this, socket](const RHttpAdmissionGate::RequestHead &requestHead)
+        {
+            return this->admitRequestHead(requestHead,socket);
+        },RHttpServer::serverName);
+        pAdmissionGate->attach(socket,this->pSslServer);
+    }
+
+    const qint64 startTime = RHttpServerMetrics::currentTime();
+    QObject::connect(socket, &QSslSocket::encrypted, this, [this, socket, startTime]()
     {
+        const RHttpTlsMetrics::Result result = findHandshakeResult(socket);
+        this->pContext->getTlsMetrics().recordHandshake(result,RHttpServerMetrics::currentTime() - startTime);
+        releaseIdleBuffers(socket);
+
         QSslCertificate certificate = socket->peerCertificate();
 
         QString commonName = RTlsTrustStore::findCN(certificate);
@@ -691,5 +1597,18 @@ void RHttpServer::onStartedEncryptionHandshake(QSslSocket *socket)
         RLogger::debug("[%s] SSL Certificate serial no.: %s\n",
                        this->getServiceName().toUtf8().constData(),
                        certificate.serialNumber().constData());
-    }
+        RLogger::debug("[%s] SSL Session: %s\n",
+                       this->getServiceName().toUtf8().constData(),
+                       RHttpTlsMetrics::resultToString(result).toUtf8().constData());
+    }, Qt::SingleShotConnection);
+}
+
+void RHttpServer::onHandshakeErrorOccurred(QSslSocket *socket, QAbstractSocket::SocketError socketError)
+{
+    Q_UNUSED(socketError);
+    this->pContext->getTlsMetrics().recordHandshake(RHttpTlsMetrics::Failed,0);
+    RLogger::debug("[%s] SSL handshake with \"%s\" has failed. %s\n",
+                   this->getServiceName().toUtf8().constData(),
+                   socket->peerAddress().toString().toUtf8().constData(),
+                   socket->errorString().toUtf8().constData());
 }
@@ -0,0 +1,198 @@
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "rcl_http_reuse_port_listener.h"
+#include "rcl_http_server_cluster.h"
+
+RHttpServerCluster::RHttpServerCluster(RHttpServer::Type type, const RHttpServerSettings &httpServerSettings, QObject *parent)
+    : QObject{parent}
+    , pContext{std::make_shared<RHttpServerContext>(httpServerSettings)}
+    , nStarted{0}
+    , nFinished{0}
+    , hasFailed{false}
+{
+    R_LOG_TRACE_IN;
+    const int nInstances = int(qMax(quint32(1),httpServerSettings.getListenerInstanceCount()));
+    if (nInstances > 1 && !RHttpReusePortListener::isSupported())
+    {
+        R_LOG_TRACE_OUT;
+        throw RError(RError::Application,R_ERROR_REF,"Multiple server instances are not supported on this platform.");
+    }
+
+    for (int i = 0; i < nInstances; i++)
+    {
+        RHttpServer *pServer = new RHttpServer(type,httpServerSettings,this->pContext);
+        QThread *pThread = new QThread;
+        pThread->setObjectName(QString("RHttpServer-%1").arg(i));
+        pServer->moveToThread(pThread);
+        // Instance has to be destroyed in its own thread.
+        QObject::connect(pThread, &QThread::finished, pServer, &QObject::deleteLater);
+
+        QObject::connect(pServer, &RHttpServer::started, this, &RHttpServerCluster::onInstanceStarted);
+        QObject::connect(pServer, &RHttpServer::finished, this, &RHttpServerCluster::onInstanceFinished);
+        QObject::connect(pServer, &RHttpServer::failed, this, &RHttpServerCluster::onInstanceFailed);
+        QObject::connect(pServer, &RHttpServer::requestAvailable, this, &RHttpServerCluster::requestAvailable);
+
+        this->servers.append(pServer);
+        this->threads.append(pThread);
+        pThread->start();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpServerCluster::~RHttpServerCluster()
+{
+    R_LOG_TRACE_IN;
+    for (QThread *pThread : std::as_const(this->threads))
+    {
+        pThread->quit();
+    }
+    for (QThread *pThread : std::as_const(this->threads))
+    {
+        pThread->wait();
+    }
+    qDeleteAll(this->threads);
+    R_LOG_TRACE_OUT;
+}
+
+int RHttpServerCluster::getInstanceCount() const
+{
+    return int(this->servers.size());
+}
+
+void RHttpServerCluster::setAuthTokenValidator(RAuthTokenValidator *pAuthTokenValidator)
+{
+    this->runOnInstances([pAuthTokenValidator](RHttpServer *pServer)
+    {
+        pServer->setAuthTokenValidator(pAuthTokenValidator);
+    });
+}
+
+void RHttpServerCluster::setFileQuotaProvider(RFileQuotaProvider *pFileQuotaProvider)
+{
+    this->runOnInstances([pFileQuotaProvider](RHttpServer *pServer)
+    {
+        pServer->setFileQuotaProvider(pFileQuotaProvider);
+    });
+}
+
+void RHttpServerCluster::invalidateAuthToken(const QString &resourceName, const QString &token)
+{
+    // Token cache is shared by all instances.
+    if (this->pContext->getAuthTokenCache())
+    {
+        this->pContext->getAuthTokenCache()->invalidate(resourceName,token);
+    }
+}
+
+void RHttpServerCluster::invalidateAuthTokens(const QString &resourceName)
+{
+    if (this->pContext->getAuthTokenCache())
+    {
+        this->pContext->getAuthTokenCache()->invalidateResource(resourceName);
+    }
+}
+
+void RHttpServerCluster::setActionHandler(const QString &actionKey, RHttpActionHandler *pActionHandler)
+{
+    // Dispatcher is shared by all instances.
+    this->pContext->getDispatcher().setHandler(actionKey,pActionHandler);
+}
+
+void RHttpServerCluster::reloadTlsConfiguration()
+{
+    for (RHttpServer *pServer : std::as_const(this->servers))
+    {
+        QMetaObject::invokeMethod(pServer,[pServer]() { pServer->reloadTlsConfiguration(); },Qt::QueuedConnection);
+    }
+}
+
+void RHttpServerCluster::start()
+{
+    R_LOG_TRACE_IN;
+    RLogger::info("Starting %d HTTP server instances.\n",int(this->servers.size()));
+    this->nStarted = 0;
+    this->hasFailed = false;
+    for (RHttpServer *pServer : std::as_const(this->servers))
+    {
+        QMetaObject::invokeMethod(pServer,&RHttpServer::start,Qt::QueuedConnection);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpServerCluster::stop()
+{
+    R_LOG_TRACE_IN;
+    this->nFinished = 0;
+    for (RHttpServer *pServer : std::as_const(this->servers))
+    {
+        QMetaObject::invokeMethod(pServer,&RHttpServer::stop,Qt::QueuedConnection);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpServerCluster::sendMessageReply(const RHttpMessage &httpMessage)
+{
+    R_LOG_TRACE_IN;
+    // Handler ID identifies the registry of the instance which received the request.
+    for (RHttpServer *pServer : std::as_const(this->servers))
+    {
+        if (pServer->containsServerHandlerId(httpMessage.getHandlerId()))
+        {
+            pServer->sendMessageReply(httpMessage);
+            R_LOG_TRACE_OUT;
+            return;
+        }
+    }
+    RLogger::warning("HTTP message cannot be sent. Handler (id: \"%s\") does not exist.\n",
+                     httpMessage.getHandlerId().toString(QUuid::WithoutBraces).toUtf8().constData());
+    R_LOG_TRACE_OUT;
+}
+
+QJsonObject RHttpServerCluster::getMetrics() const
+{
+    R_LOG_TRACE_IN;
+    qint64 nPendingHandlers = 0;
+    for (const RHttpServer *pServer : std::as_const(this->servers))
+    {
+        nPendingHandlers += pServer->getPendingHandlerCount();
+    }
+    QJsonObject json = this->pContext->toJson(nPendingHandlers);
+    json["instances"] = this->getInstanceCount();
+    R_LOG_TRACE_RETURN(json);
+}
+
+void RHttpServerCluster::runOnInstances(const std::function<void(RHttpServer *)> &function)
+{
+    for (RHttpServer *pServer : std::as_const(this->servers))
+    {
+        QMetaObject::invokeMethod(pServer,[pServer,function]() { function(pServer); },Qt::BlockingQueuedConnection);
+    }
+}
+
+void RHttpServerCluster::onInstanceStarted()
+{
+    if (++this->nStarted == this->servers.size())
+    {
+        RLogger::info("All %d HTTP server instances have started.\n",int(this->servers.size()));
+        emit this->started();
+        emit this->ready();
+    }
+}
+
+void RHttpServerCluster::onInstanceFinished()
+{
+    if (++this->nFinished == this->servers.size())
+    {
+        emit this->finished();
+    }
+}
+
+void RHttpServerCluster::onInstanceFailed()
+{
+    if (!this->hasFailed)
+    {
+        this->hasFailed = true;
+        emit this->failed();
+    }
+}
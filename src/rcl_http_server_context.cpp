@@ -0,0 +1,259 @@
+#include <rbl_logger.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_server_context.h"
+#include "rcl_http_server_handler_registry.h"
+
+RHttpServerContext::RHttpServerContext(const RHttpServerSettings &httpServerSettings)
+    : metrics{RCloudAction::getActionMap().keys()}
+    , rateLimiter{double(httpServerSettings.getPrincipalRequestRate()),
+                  double(httpServerSettings.getPrincipalRequestBurst()),
+                  double(httpServerSettings.getPrincipalByteRate()),
+                  double(httpServerSettings.getPrincipalByteBurst()),
+                  qint64(httpServerSettings.getPrincipalMaxInFlight())}
+    , dispatcher{int(httpServerSettings.getDispatcherThreadCount())}
+    , batchHandler{&this->dispatcher}
+    , pAuthTokenCache{nullptr}
+    , pAccessLog{nullptr}
+    , pIdempotencyStore{nullptr}
+    , pEntityTagCache{nullptr}
+    , pLoadShedder{nullptr}
+    , pResponseCache{nullptr}
+    , pChangeFeed{nullptr}
+    , pTicketKeyStore{nullptr}
+{
+    R_LOG_TRACE_IN;
+    this->lanes.append(new RHttpDispatchLane(RHttpDispatchLane::Interactive,
+                                             httpServerSettings.getInteractiveLaneConcurrency(),
+                                             httpServerSettings.getInteractiveLaneQueueSize()));
+    this->lanes.append(new RHttpDispatchLane(RHttpDispatchLane::Bulk,
+                                             httpServerSettings.getBulkLaneConcurrency(),
+                                             httpServerSettings.getBulkLaneQueueSize()));
+    this->lanes.append(new RHttpDispatchLane(RHttpDispatchLane::Admin,
+                                             httpServerSettings.getAdminLaneConcurrency(),
+                                             httpServerSettings.getAdminLaneQueueSize()));
+
+    if (httpServerSettings.getAuthTokenCacheSize() > 0)
+    {
+        this->pAuthTokenCache = new RAuthTokenValidatorCache(nullptr,
+                                                             httpServerSettings.getAuthTokenCacheSize(),
+                                                             httpServerSettings.getAuthTokenCacheTtlMs(),
+                                                             httpServerSettings.getAuthTokenNegativeCacheTtlMs());
+    }
+
+    if (httpServerSettings.getAccessLogEnabled())
+    {
+        this->pAccessLog = new RHttpAccessLog(httpServerSettings.getAccessLogCapacity(),
+                                              httpServerSettings.getAccessLogSampleRate(),
+                                              httpServerSettings.getAccessLogCompactFormat() ? RHttpAccessLog::Compact : RHttpAccessLog::Text,
+                                              httpServerSettings.getAccessLogFile());
+        this->pAccessLog->start();
+    }
+
+    if (httpServerSettings.getIdempotencyCacheSize() > 0)
+    {
+        this->pIdempotencyStore = new RHttpIdempotencyStore(httpServerSettings.getIdempotencyCacheSize(),
+                                                            httpServerSettings.getIdempotencyTtlMs());
+    }
+
+    if (httpServerSettings.getEntityTagCacheSize() > 0)
+    {
+        this->pEntityTagCache = new RHttpEntityTagCache(httpServerSettings.getEntityTagCacheSize(),
+                                                        httpServerSettings.getEntityTagCacheTtlMs());
+    }
+
+    if (httpServerSettings.getLoadSheddingEnabled())
+    {
+        this->pLoadShedder = new RHttpLoadShedder(RCloudAction::getActionMap().keys());
+    }
+
+    if (httpServerSettings.getResponseCacheMaxBytes() > 0)
+    {
+        this->pResponseCache = new RHttpResponseCache(httpServerSettings.getResponseCacheMaxBytes(),
+                                                      httpServerSettings.getResponseCacheTtlMs());
+    }
+
+    if (httpServerSettings.getChangeFeedEnabled())
+    {
+        this->pChangeFeed = new RHttpChangeFeed();
+    }
+
+    if (httpServerSettings.getTlsSessionResumptionEnabled())
+    {
+        this->pTicketKeyStore = new RHttpTlsTicketKeyStore(httpServerSettings.getTlsSessionTicketKeyRotationMs(),
+                                                           RHttpServerHandlerRegistry::currentTime());
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpServerContext::~RHttpServerContext()
+{
+    qDeleteAll(this->lanes);
+    delete this->pAuthTokenCache;
+    delete this->pAccessLog;
+    delete this->pIdempotencyStore;
+    delete this->pEntityTagCache;
+    delete this->pLoadShedder;
+    delete this->pResponseCache;
+    delete this->pChangeFeed;
+    delete this->pTicketKeyStore;
+}
+
+RHttpServerMetrics &RHttpServerContext::getMetrics()
+{
+    return this->metrics;
+}
+
+RHttpTlsMetrics &RHttpServerContext::getTlsMetrics()
+{
+    return this->tlsMetrics;
+}
+
+RHttpConnectionMetrics &RHttpServerContext::getConnectionMetrics()
+{
+    return this->connectionMetrics;
+}
+
+RHttpRateLimiter &RHttpServerContext::getRateLimiter()
+{
+    return this->rateLimiter;
+}
+
+RHttpDispatchLane *RHttpServerContext::findLane(const QString &actionKey) const
+{
+    return this->lanes.at(RHttpDispatchLane::findTypeForAction(actionKey));
+}
+
+RHttpRequestDispatcher &RHttpServerContext::getDispatcher()
+{
+    return this->dispatcher;
+}
+
+RHttpBatchActionHandler &RHttpServerContext::getBatchHandler()
+{
+    return this->batchHandler;
+}
+
+RAuthTokenValidatorCache *RHttpServerContext::getAuthTokenCache() const
+{
+    return this->pAuthTokenCache;
+}
+
+RHttpAccessLog *RHttpServerContext::getAccessLog() const
+{
+    return this->pAccessLog;
+}
+
+RHttpIdempotencyStore *RHttpServerContext::getIdempotencyStore() const
+{
+    return this->pIdempotencyStore;
+}
+
+RHttpEntityTagCache *RHttpServerContext::getEntityTagCache() const
+{
+    return this->pEntityTagCache;
+}
+
+RHttpLoadShedder *RHttpServerContext::getLoadShedder() const
+{
+    return this->pLoadShedder;
+}
+
+RHttpResponseCache *RHttpServerContext::getResponseCache() const
+{
+    return this->pResponseCache;
+}
+
+RHttpChangeFeed *RHttpServerContext::getChangeFeed() const
+{
+    return this->pChangeFeed;
+}
+
+RHttpTlsTicketKeyStore *RHttpServerContext::getTicketKeyStore() const
+{
+    return this->pTicketKeyStore;
+}
+
+QByteArray RHttpServerContext::toPrometheusText(qint64 nInFlightHandlers) const
+{
+    R_LOG_TRACE_IN;
+    QByteArray text = this->metrics.toPrometheusText(nInFlightHandlers);
+    text += RHttpDispatchLane::toPrometheusText(this->lanes);
+    text += this->tlsMetrics.toPrometheusText();
+    text += this->connectionMetrics.toPrometheusText();
+    if (this->pAuthTokenCache)
+    {
+        text += this->pAuthTokenCache->toPrometheusText();
+    }
+    if (this->pAccessLog)
+    {
+        text += this->pAccessLog->toPrometheusText();
+    }
+    if (this->pIdempotencyStore)
+    {
+        text += this->pIdempotencyStore->toPrometheusText();
+    }
+    if (this->pEntityTagCache)
+    {
+        text += this->pEntityTagCache->toPrometheusText();
+    }
+    if (this->pLoadShedder)
+    {
+        text += this->pLoadShedder->toPrometheusText();
+    }
+    if (this->pResponseCache)
+    {
+        text += this->pResponseCache->toPrometheusText();
+    }
+    if (this->pChangeFeed)
+    {
+        text += this->pChangeFeed->toPrometheusText();
+    }
+    R_LOG_TRACE_RETURN(text);
+}
+
+QJsonObject RHttpServerContext::toJson(qint64 nInFlightHandlers) const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject json = this->metrics.toJson(nInFlightHandlers);
+    QJsonObject lanesJson;
+    for (const RHttpDispatchLane *pLane : this->lanes)
+    {
+        QJsonObject laneJson;
+        laneJson["active"] = pLane->getActiveCount();
+        laneJson["queued"] = pLane->getQueuedCount();
+        lanesJson[RHttpDispatchLane::typeToString(pLane->getType())] = laneJson;
+    }
+    json["lanes"] = lanesJson;
+    json["tls"] = this->tlsMetrics.toJson();
+    json["connections"] = this->connectionMetrics.toJson();
+    if (this->pAuthTokenCache)
+    {
+        json["auth-cache"] = this->pAuthTokenCache->toJson();
+    }
+    if (this->pAccessLog)
+    {
+        json["access-log"] = this->pAccessLog->toJson();
+    }
+    if (this->pIdempotencyStore)
+    {
+        json["idempotency"] = this->pIdempotencyStore->toJson();
+    }
+    if (this->pEntityTagCache)
+    {
+        json["entity-tags"] = this->pEntityTagCache->toJson();
+    }
+    if (this->pLoadShedder)
+    {
+        json["load-shedding"] = this->pLoadShedder->toJson();
+    }
+    if (this->pResponseCache)
+    {
+        json["response-cache"] = this->pResponseCache->toJson();
+    }
+    if (this->pChangeFeed)
+    {
+        json["change-feed"] = this->pChangeFeed->toJson();
+    }
+    R_LOG_TRACE_RETURN(json);
+}
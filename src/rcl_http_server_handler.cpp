@@ -0,0 +1,50 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_server_handler.h"
+
+RHttpServerHandler::RHttpServerHandler()
+    : handle{0}
+    , creationTime{0}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+const QUuid &RHttpServerHandler::getId() const
+{
+    return this->id;
+}
+
+quint64 RHttpServerHandler::getHandle() const
+{
+    return this->handle;
+}
+
+qint64 RHttpServerHandler::getCreationTime() const
+{
+    return this->creationTime;
+}
+
+QFuture<RHttpMessage> RHttpServerHandler::getFuture()
+{
+    return this->responsePromise.future();
+}
+
+void RHttpServerHandler::sendReply(const RHttpMessage &httpMessage)
+{
+    R_LOG_TRACE_IN;
+    this->responsePromise.addResult(httpMessage);
+    this->responsePromise.finish();
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpServerHandler::reset(const QUuid &id, quint64 handle, qint64 creationTime)
+{
+    this->id = id;
+    this->handle = handle;
+    this->creationTime = creationTime;
+    // Futures handed out for the previous request keep their own shared state,
+    // so the promise state is still allocated per request, only the handler is reused.
+    this->responsePromise = QPromise<RHttpMessage>();
+    this->responsePromise.start();
+}
@@ -0,0 +1,227 @@
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+#include <rbl_error.h>
+#include <rbl_logger.h>
+
+#include "rcl_http_server_handler_registry.h"
+
+static constexpr quint32 slotIndexMask = 0x00ffffff;
+
+RHttpServerHandlerRegistry::RHttpServerHandlerRegistry()
+    : nextStripe{0}
+    , nHandlers{0}
+{
+    R_LOG_TRACE_IN;
+    QRandomGenerator *generator = QRandomGenerator::global();
+    this->tag1 = generator->generate();
+    this->tag2 = generator->generate();
+    R_LOG_TRACE_OUT;
+}
+
+RHttpServerHandlerRegistry::~RHttpServerHandlerRegistry()
+{
+    R_LOG_TRACE_IN;
+    for (Stripe &stripe : this->stripes)
+    {
+        QMutexLocker locker(&stripe.mutex);
+        for (Slot &slot : stripe.slots)
+        {
+            delete slot.pHandler;
+            slot.pHandler = nullptr;
+        }
+        qDeleteAll(stripe.pool);
+        stripe.pool.clear();
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpServerHandler *RHttpServerHandlerRegistry::acquire()
+{
+    R_LOG_TRACE_IN;
+    const quint32 stripeIndex = this->nextStripe.fetchAndAddRelaxed(1) % nStripes;
+    const qint64 creationTime = RHttpServerHandlerRegistry::currentTime();
+
+    Stripe &stripe = this->stripes[stripeIndex];
+    QMutexLocker locker(&stripe.mutex);
+
+    quint32 slotIndex = 0;
+    if (!stripe.freeSlots.isEmpty())
+    {
+        slotIndex = stripe.freeSlots.takeLast();
+    }
+    else
+    {
+        if (quint32(stripe.slots.size()) > slotIndexMask)
+        {
+            throw RError(RError::Application,R_ERROR_REF,"Too many pending server handlers.");
+        }
+        slotIndex = quint32(stripe.slots.size());
+        stripe.slots.append(Slot{nullptr,0});
+    }
+
+    RHttpServerHandler *pHandler = stripe.pool.isEmpty() ? new RHttpServerHandler : stripe.pool.takeLast();
+
+    Slot &slot = stripe.slots[slotIndex];
+    const quint64 handle = (quint64(slot.generation) << 32) | (quint64(stripeIndex) << 24) | quint64(slotIndex);
+    pHandler->reset(this->encodeId(handle),handle,creationTime);
+    slot.pHandler = pHandler;
+
+    this->nHandlers.fetchAndAddRelaxed(1);
+
+    R_LOG_TRACE_RETURN(pHandler);
+}
+
+RHttpServerHandler *RHttpServerHandlerRegistry::take(const QUuid &id)
+{
+    R_LOG_TRACE_IN;
+    quint64 handle = 0;
+    if (!this->decodeId(id,handle))
+    {
+        R_LOG_TRACE_RETURN(nullptr);
+    }
+
+    const quint32 generation = quint32(handle >> 32);
+    const quint32 stripeIndex = quint32(handle >> 24) & 0xff;
+    const quint32 slotIndex = quint32(handle) & slotIndexMask;
+    if (stripeIndex >= nStripes)
+    {
+        R_LOG_TRACE_RETURN(nullptr);
+    }
+
+    Stripe &stripe = this->stripes[stripeIndex];
+    QMutexLocker locker(&stripe.mutex);
+
+    if (slotIndex >= quint32(stripe.slots.size()))
+    {
+        R_LOG_TRACE_RETURN(nullptr);
+    }
+    const Slot &slot = stripe.slots.at(slotIndex);
+    if (slot.generation != generation || !slot.pHandler)
+    {
+        R_LOG_TRACE_RETURN(nullptr);
+    }
+
+    R_LOG_TRACE_RETURN(this->takeSlot(stripe,slotIndex));
+}
+
+QList<RHttpServerHandler *> RHttpServerHandlerRegistry::takeAll()
+{
+    R_LOG_TRACE_IN;
+    QList<RHttpServerHandler*> handlers;
+    for (Stripe &stripe : this->stripes)
+    {
+        QMutexLocker locker(&stripe.mutex);
+        for (quint32 slotIndex = 0; slotIndex < quint32(stripe.slots.size()); slotIndex++)
+        {
+            if (stripe.slots.at(slotIndex).pHandler)
+            {
+                handlers.append(this->takeSlot(stripe,slotIndex));
+            }
+        }
+    }
+    R_LOG_TRACE_RETURN(handlers);
+}
+
+void RHttpServerHandlerRegistry::release(RHttpServerHandler *pHandler)
+{
+    R_LOG_TRACE_IN;
+    if (!pHandler)
+    {
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    const quint32 stripeIndex = quint32(pHandler->getHandle() >> 24) & 0xff;
+    if (stripeIndex < nStripes)
+    {
+        Stripe &stripe = this->stripes[stripeIndex];
+        QMutexLocker locker(&stripe.mutex);
+        if (stripe.pool.size() < maxPoolSize)
+        {
+            stripe.pool.append(pHandler);
+            R_LOG_TRACE_OUT;
+            return;
+        }
+    }
+    delete pHandler;
+    R_LOG_TRACE_OUT;
+}
+
+bool RHttpServerHandlerRegistry::contains(const QUuid &id)
+{
+    R_LOG_TRACE_IN;
+    quint64 handle = 0;
+    if (!this->decodeId(id,handle))
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    const quint32 generation = quint32(handle >> 32);
+    const quint32 stripeIndex = quint32(handle >> 24) & 0xff;
+    const quint32 slotIndex = quint32(handle) & slotIndexMask;
+    if (stripeIndex >= nStripes)
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+
+    Stripe &stripe = this->stripes[stripeIndex];
+    QMutexLocker locker(&stripe.mutex);
+    if (slotIndex >= quint32(stripe.slots.size()))
+    {
+        R_LOG_TRACE_RETURN(false);
+    }
+    const Slot &slot = stripe.slots.at(slotIndex);
+    R_LOG_TRACE_RETURN(slot.pHandler && slot.generation == generation);
+}
+
+int RHttpServerHandlerRegistry::size() const
+{
+    return this->nHandlers.loadRelaxed();
+}
+
+qint64 RHttpServerHandlerRegistry::currentTime()
+{
+    return QDeadlineTimer::current(Qt::CoarseTimer).deadline();
+}
+
+QUuid RHttpServerHandlerRegistry::encodeId(quint64 handle) const
+{
+    return QUuid(this->tag1,
+                 ushort(this->tag2 >> 16),
+                 ushort(this->tag2 & 0xffff),
+                 uchar(handle >> 56),
+                 uchar(handle >> 48),
+                 uchar(handle >> 40),
+                 uchar(handle >> 32),
+                 uchar(handle >> 24),
+                 uchar(handle >> 16),
+                 uchar(handle >> 8),
+                 uchar(handle));
+}
+
+bool RHttpServerHandlerRegistry::decodeId(const QUuid &id, quint64 &handle) const
+{
+    if (id.data1 != this->tag1 || id.data2 != ushort(this->tag2 >> 16) || id.data3 != ushort(this->tag2 & 0xffff))
+    {
+        return false;
+    }
+    handle = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        handle = (handle << 8) | quint64(id.data4[i]);
+    }
+    return true;
+}
+
+RHttpServerHandler *RHttpServerHandlerRegistry::takeSlot(Stripe &stripe, quint32 slotIndex)
+{
+    Slot &slot = stripe.slots[slotIndex];
+    RHttpServerHandler *pHandler = slot.pHandler;
+    slot.pHandler = nullptr;
+    slot.generation++;
+    stripe.freeSlots.append(slotIndex);
+    this->nHandlers.fetchAndSubRelaxed(1);
+    return pHandler;
+}
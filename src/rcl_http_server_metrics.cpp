@@ -0,0 +1,292 @@
+#include <QDeadlineTimer>
+#include <QJsonArray>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_server_metrics.h"
+
+//! Error types in order of their counters.
+static const QList<RError::Type> errorTypes = {
+    RError::None,
+    RError::InvalidInput,
+    RError::Unauthorized,
+    RError::NotFound,
+    RError::Timeout,
+    RError::OpenFile,
+    RError::ReadFile,
+    RError::WriteFile,
+    RError::RemoveFile,
+    RError::RenameFile,
+    RError::InvalidFileName,
+    RError::InvalidFileFormat,
+    RError::OpenDir,
+    RError::ReadDir,
+    RError::Application,
+    RError::ChildProcess,
+    RError::Connection,
+    RError::Unknown
+};
+
+//! Quantiles exported for each latency histogram.
+static const QList<double> exportedQuantiles = {0.5, 0.9, 0.99, 0.999};
+
+static int findErrorTypeIndex(RError::Type errorType)
+{
+    const qsizetype index = errorTypes.indexOf(errorType);
+    return int((index < 0) ? errorTypes.indexOf(RError::Unknown) : index);
+}
+
+RHttpServerMetrics::RHttpServerMetrics(const QList<QString> &actionKeys)
+    : actionKeys{actionKeys}
+{
+    R_LOG_TRACE_IN;
+    for (const QString &actionKey : actionKeys)
+    {
+        ActionMetrics *pActionMetrics = new ActionMetrics;
+        for (std::atomic<quint64> &nErrors : pActionMetrics->nErrors)
+        {
+            nErrors.store(0,std::memory_order_relaxed);
+        }
+        this->actionMetrics.insert(actionKey,pActionMetrics);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+RHttpServerMetrics::~RHttpServerMetrics()
+{
+    qDeleteAll(this->actionMetrics);
+}
+
+void RHttpServerMetrics::recordRequest(const QString &action, RError::Type errorType, qint64 bytesIn, qint64 bytesOut, const Timing &timing)
+{
+    ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    if (!pActionMetrics)
+    {
+        return;
+    }
+
+    const qint64 finishedTime = RHttpServerMetrics::currentTime();
+    const qint64 dispatchedTime = timing.dispatchedTime ? timing.dispatchedTime : timing.receivedTime;
+    const qint64 repliedTime = timing.repliedTime ? timing.repliedTime : finishedTime;
+
+    pActionMetrics->nRequests.fetch_add(1,std::memory_order_relaxed);
+    pActionMetrics->bytesIn.fetch_add(quint64(qMax(qint64(0),bytesIn)),std::memory_order_relaxed);
+    pActionMetrics->bytesOut.fetch_add(quint64(qMax(qint64(0),bytesOut)),std::memory_order_relaxed);
+    if (errorType != RError::None)
+    {
+        pActionMetrics->nErrors[findErrorTypeIndex(errorType)].fetch_add(1,std::memory_order_relaxed);
+    }
+    pActionMetrics->latency[RHttpServerMetrics::Queue].record(dispatchedTime - timing.receivedTime);
+    pActionMetrics->latency[RHttpServerMetrics::Backend].record(repliedTime - dispatchedTime);
+    pActionMetrics->latency[RHttpServerMetrics::Send].record(finishedTime - repliedTime);
+}
+
+void RHttpServerMetrics::recordRejection(const QString &action)
+{
+    ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    if (pActionMetrics)
+    {
+        pActionMetrics->nRejected.fetch_add(1,std::memory_order_relaxed);
+    }
+}
+
+quint64 RHttpServerMetrics::getRejectionCount(const QString &action) const
+{
+    const ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    return pActionMetrics ? pActionMetrics->nRejected.load(std::memory_order_relaxed) : 0;
+}
+
+quint64 RHttpServerMetrics::getRequestCount(const QString &action) const
+{
+    const ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    return pActionMetrics ? pActionMetrics->nRequests.load(std::memory_order_relaxed) : 0;
+}
+
+quint64 RHttpServerMetrics::getErrorCount(const QString &action, RError::Type errorType) const
+{
+    const ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    return pActionMetrics ? pActionMetrics->nErrors[findErrorTypeIndex(errorType)].load(std::memory_order_relaxed) : 0;
+}
+
+const RHttpLatencyHistogram *RHttpServerMetrics::findLatency(const QString &action, Phase phase) const
+{
+    const ActionMetrics *pActionMetrics = this->actionMetrics.value(action,nullptr);
+    return pActionMetrics ? &pActionMetrics->latency[phase] : nullptr;
+}
+
+QByteArray RHttpServerMetrics::toPrometheusText(qint64 nInFlightHandlers) const
+{
+    R_LOG_TRACE_IN;
+    QByteArray requestsText;
+    QByteArray errorsText;
+    QByteArray rejectedText;
+    QByteArray bytesInText;
+    QByteArray bytesOutText;
+    QByteArray latencyText;
+
+    for (const QString &actionKey : std::as_const(this->actionKeys))
+    {
+        const ActionMetrics *pActionMetrics = this->actionMetrics.value(actionKey);
+        const QByteArray actionLabel = "action=\"" + actionKey.toUtf8() + "\"";
+
+        requestsText += "range_cloud_http_requests_total{" + actionLabel + "} "
+                      + QByteArray::number(pActionMetrics->nRequests.load(std::memory_order_relaxed)) + "\n";
+        rejectedText += "range_cloud_http_rejected_total{" + actionLabel + "} "
+                      + QByteArray::number(pActionMetrics->nRejected.load(std::memory_order_relaxed)) + "\n";
+        bytesInText += "range_cloud_http_request_bytes_total{" + actionLabel + "} "
+                     + QByteArray::number(pActionMetrics->bytesIn.load(std::memory_order_relaxed)) + "\n";
+        bytesOutText += "range_cloud_http_response_bytes_total{" + actionLabel + "} "
+                      + QByteArray::number(pActionMetrics->bytesOut.load(std::memory_order_relaxed)) + "\n";
+
+        for (qsizetype i = 0; i < errorTypes.size(); i++)
+        {
+            const quint64 nErrors = pActionMetrics->nErrors[i].load(std::memory_order_relaxed);
+            if (nErrors > 0)
+            {
+                errorsText += "range_cloud_http_errors_total{" + actionLabel + ",error=\""
+                            + RHttpServerMetrics::errorTypeToString(errorTypes.at(i)).toUtf8() + "\"} "
+                            + QByteArray::number(nErrors) + "\n";
+            }
+        }
+
+        for (int phase = 0; phase < RHttpServerMetrics::nPhases; phase++)
+        {
+            const RHttpLatencyHistogram &histogram = pActionMetrics->latency[phase];
+            const QByteArray labels = actionLabel + ",phase=\"" + RHttpServerMetrics::phaseToString(Phase(phase)).toUtf8() + "\"";
+            for (double quantile : exportedQuantiles)
+            {
+                latencyText += "range_cloud_http_latency_seconds{" + labels + ",quantile=\"" + QByteArray::number(quantile) + "\"} "
+                             + QByteArray::number(double(histogram.findQuantile(quantile)) / 1.0e6,'g',6) + "\n";
+            }
+            latencyText += "range_cloud_http_latency_seconds_sum{" + labels + "} "
+                         + QByteArray::number(double(histogram.getSum()) / 1.0e6,'g',12) + "\n";
+            latencyText += "range_cloud_http_latency_seconds_count{" + labels + "} "
+                         + QByteArray::number(histogram.getCount()) + "\n";
+        }
+    }
+
+    QByteArray text;
+    text += "# HELP range_cloud_http_requests_total Number of finished requests.\n";
+    text += "# TYPE range_cloud_http_requests_total counter\n";
+    text += requestsText;
+    text += "# HELP range_cloud_http_errors_total Number of failed requests by error type.\n";
+    text += "# TYPE range_cloud_http_errors_total counter\n";
+    text += errorsText;
+    text += "# HELP range_cloud_http_rejected_total Number of requests rejected before dispatch (rate limited).\n";
+    text += "# TYPE range_cloud_http_rejected_total counter\n";
+    text += rejectedText;
+    text += "# HELP range_cloud_http_request_bytes_total Size of request bodies in bytes.\n";
+    text += "# TYPE range_cloud_http_request_bytes_total counter\n";
+    text += bytesInText;
+    text += "# HELP range_cloud_http_response_bytes_total Size of response bodies in bytes.\n";
+    text += "# TYPE range_cloud_http_response_bytes_total counter\n";
+    text += bytesOutText;
+    text += "# HELP range_cloud_http_latency_seconds Request latency by phase (queue, backend, send).\n";
+    text += "# TYPE range_cloud_http_latency_seconds summary\n";
+    text += latencyText;
+    text += "# HELP range_cloud_http_inflight_handlers Number of requests waiting for the backend.\n";
+    text += "# TYPE range_cloud_http_inflight_handlers gauge\n";
+    text += "range_cloud_http_inflight_handlers " + QByteArray::number(nInFlightHandlers) + "\n";
+
+    R_LOG_TRACE_RETURN(text);
+}
+
+QJsonObject RHttpServerMetrics::toJson(qint64 nInFlightHandlers) const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject actionsObject;
+    for (const QString &actionKey : std::as_const(this->actionKeys))
+    {
+        const ActionMetrics *pActionMetrics = this->actionMetrics.value(actionKey);
+
+        QJsonObject errorsObject;
+        for (qsizetype i = 0; i < errorTypes.size(); i++)
+        {
+            const quint64 nErrors = pActionMetrics->nErrors[i].load(std::memory_order_relaxed);
+            if (nErrors > 0)
+            {
+                errorsObject[RHttpServerMetrics::errorTypeToString(errorTypes.at(i))] = qint64(nErrors);
+            }
+        }
+
+        QJsonObject latencyObject;
+        for (int phase = 0; phase < RHttpServerMetrics::nPhases; phase++)
+        {
+            const RHttpLatencyHistogram &histogram = pActionMetrics->latency[phase];
+            QJsonObject phaseObject;
+            phaseObject["count"] = qint64(histogram.getCount());
+            phaseObject["p50"] = histogram.findQuantile(0.5);
+            phaseObject["p99"] = histogram.findQuantile(0.99);
+            phaseObject["max"] = histogram.getMax();
+            latencyObject[RHttpServerMetrics::phaseToString(Phase(phase))] = phaseObject;
+        }
+
+        QJsonObject actionObject;
+        actionObject["requests"] = qint64(pActionMetrics->nRequests.load(std::memory_order_relaxed));
+        actionObject["rejected"] = qint64(pActionMetrics->nRejected.load(std::memory_order_relaxed));
+        actionObject["bytes-in"] = qint64(pActionMetrics->bytesIn.load(std::memory_order_relaxed));
+        actionObject["bytes-out"] = qint64(pActionMetrics->bytesOut.load(std::memory_order_relaxed));
+        actionObject["errors"] = errorsObject;
+        actionObject["latency-us"] = latencyObject;
+        actionsObject[actionKey] = actionObject;
+    }
+
+    QJsonObject json;
+    json["in-flight-handlers"] = nInFlightHandlers;
+    json["actions"] = actionsObject;
+    R_LOG_TRACE_RETURN(json);
+}
+
+qint64 RHttpServerMetrics::currentTime()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() / 1000;
+}
+
+QString RHttpServerMetrics::phaseToString(Phase phase)
+{
+    switch (phase)
+    {
+        case RHttpServerMetrics::Queue:
+        {
+            return "queue";
+        }
+        case RHttpServerMetrics::Backend:
+        {
+            return "backend";
+        }
+        case RHttpServerMetrics::Send:
+        {
+            return "send";
+        }
+        default:
+        {
+            return QString();
+        }
+    }
+}
+
+QString RHttpServerMetrics::errorTypeToString(RError::Type errorType)
+{
+    switch (errorType)
+    {
+        case RError::None:              return "None";
+        case RError::InvalidInput:      return "InvalidInput";
+        case RError::Unauthorized:      return "Unauthorized";
+        case RError::NotFound:          return "NotFound";
+        case RError::Timeout:           return "Timeout";
+        case RError::OpenFile:          return "OpenFile";
+        case RError::ReadFile:          return "ReadFile";
+        case RError::WriteFile:         return "WriteFile";
+        case RError::RemoveFile:        return "RemoveFile";
+        case RError::RenameFile:        return "RenameFile";
+        case RError::InvalidFileName:   return "InvalidFileName";
+        case RError::InvalidFileFormat: return "InvalidFileFormat";
+        case RError::OpenDir:           return "OpenDir";
+        case RError::ReadDir:           return "ReadDir";
+        case RError::Application:       return "Application";
+        case RError::ChildProcess:      return "ChildProcess";
+        case RError::Connection:        return "Connection";
+        case RError::Unknown:
+        default:                        return "Unknown";
+    }
+}
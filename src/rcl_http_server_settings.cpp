@@ -10,7 +10,50 @@ void RHttpServerSettings::_init(const RHttpServerSettings *pHttpServerSettings)
         this->responseTimeoutMs = pHttpServerSettings->responseTimeoutMs;
         this->handlerCleanupIntervalMs = pHttpServerSettings->handlerCleanupIntervalMs;
         this->maxStaleHandlerAgeMs = pHttpServerSettings->maxStaleHandlerAgeMs;
+        this->handlerExpiryResolutionMs = pHttpServerSettings->handlerExpiryResolutionMs;
         this->maxBodySize = pHttpServerSettings->maxBodySize;
+        this->compressionEnabled = pHttpServerSettings->compressionEnabled;
+        this->compressionMinSize = pHttpServerSettings->compressionMinSize;
+        this->authTokenCacheSize = pHttpServerSettings->authTokenCacheSize;
+        this->authTokenCacheTtlMs = pHttpServerSettings->authTokenCacheTtlMs;
+        this->authTokenNegativeCacheTtlMs = pHttpServerSettings->authTokenNegativeCacheTtlMs;
+        this->principalRequestRate = pHttpServerSettings->principalRequestRate;
+        this->principalRequestBurst = pHttpServerSettings->principalRequestBurst;
+        this->principalByteRate = pHttpServerSettings->principalByteRate;
+        this->principalByteBurst = pHttpServerSettings->principalByteBurst;
+        this->principalMaxInFlight = pHttpServerSettings->principalMaxInFlight;
+        this->interactiveLaneConcurrency = pHttpServerSettings->interactiveLaneConcurrency;
+        this->interactiveLaneQueueSize = pHttpServerSettings->interactiveLaneQueueSize;
+        this->bulkLaneConcurrency = pHttpServerSettings->bulkLaneConcurrency;
+        this->bulkLaneQueueSize = pHttpServerSettings->bulkLaneQueueSize;
+        this->adminLaneConcurrency = pHttpServerSettings->adminLaneConcurrency;
+        this->adminLaneQueueSize = pHttpServerSettings->adminLaneQueueSize;
+        this->dispatcherThreadCount = pHttpServerSettings->dispatcherThreadCount;
+        this->tlsSessionResumptionEnabled = pHttpServerSettings->tlsSessionResumptionEnabled;
+        this->tlsSessionTicketKeyRotationMs = pHttpServerSettings->tlsSessionTicketKeyRotationMs;
+        this->tlsFileWatchEnabled = pHttpServerSettings->tlsFileWatchEnabled;
+        this->listenerInstanceCount = pHttpServerSettings->listenerInstanceCount;
+        this->accessLogEnabled = pHttpServerSettings->accessLogEnabled;
+        this->accessLogCapacity = pHttpServerSettings->accessLogCapacity;
+        this->accessLogSampleRate = pHttpServerSettings->accessLogSampleRate;
+        this->accessLogCompactFormat = pHttpServerSettings->accessLogCompactFormat;
+        this->accessLogFile = pHttpServerSettings->accessLogFile;
+        this->earlyAdmissionEnabled = pHttpServerSettings->earlyAdmissionEnabled;
+        this->idempotencyCacheSize = pHttpServerSettings->idempotencyCacheSize;
+        this->idempotencyTtlMs = pHttpServerSettings->idempotencyTtlMs;
+        this->entityTagCacheSize = pHttpServerSettings->entityTagCacheSize;
+        this->entityTagCacheTtlMs = pHttpServerSettings->entityTagCacheTtlMs;
+        this->maxBatchSize = pHttpServerSettings->maxBatchSize;
+        this->loadSheddingEnabled = pHttpServerSettings->loadSheddingEnabled;
+        this->responseCacheMaxBytes = pHttpServerSettings->responseCacheMaxBytes;
+        this->responseCacheTtlMs = pHttpServerSettings->responseCacheTtlMs;
+        this->changeFeedEnabled = pHttpServerSettings->changeFeedEnabled;
+        this->changeFeedMaxWaitMs = pHttpServerSettings->changeFeedMaxWaitMs;
+        this->connectionIdleTimeoutMs = pHttpServerSettings->connectionIdleTimeoutMs;
+        this->keepAliveTimeoutMs = pHttpServerSettings->keepAliveTimeoutMs;
+        this->headerReadTimeoutMs = pHttpServerSettings->headerReadTimeoutMs;
+        this->bodyReadTimeoutMs = pHttpServerSettings->bodyReadTimeoutMs;
+        this->maxConnections = pHttpServerSettings->maxConnections;
     }
     else
     {
@@ -18,7 +61,50 @@ void RHttpServerSettings::_init(const RHttpServerSettings *pHttpServerSettings)
         this->responseTimeoutMs = defaultResponseTimeoutMs;
         this->handlerCleanupIntervalMs = defaultHandlerCleanupIntervalMs;
         this->maxStaleHandlerAgeMs = defaultMaxStaleHandlerAgeMs;
+        this->handlerExpiryResolutionMs = defaultHandlerExpiryResolutionMs;
         this->maxBodySize = defaultMaxBodySize;
+        this->compressionEnabled = defaultCompressionEnabled;
+        this->compressionMinSize = defaultCompressionMinSize;
+        this->authTokenCacheSize = defaultAuthTokenCacheSize;
+        this->authTokenCacheTtlMs = defaultAuthTokenCacheTtlMs;
+        this->authTokenNegativeCacheTtlMs = defaultAuthTokenNegativeCacheTtlMs;
+        this->principalRequestRate = defaultPrincipalRequestRate;
+        this->principalRequestBurst = defaultPrincipalRequestBurst;
+        this->principalByteRate = defaultPrincipalByteRate;
+        this->principalByteBurst = defaultPrincipalByteBurst;
+        this->principalMaxInFlight = defaultPrincipalMaxInFlight;
+        this->interactiveLaneConcurrency = defaultInteractiveLaneConcurrency;
+        this->interactiveLaneQueueSize = defaultInteractiveLaneQueueSize;
+        this->bulkLaneConcurrency = defaultBulkLaneConcurrency;
+        this->bulkLaneQueueSize = defaultBulkLaneQueueSize;
+        this->adminLaneConcurrency = defaultAdminLaneConcurrency;
+        this->adminLaneQueueSize = defaultAdminLaneQueueSize;
+        this->dispatcherThreadCount = defaultDispatcherThreadCount;
+        this->tlsSessionResumptionEnabled = defaultTlsSessionResumptionEnabled;
+        this->tlsSessionTicketKeyRotationMs = defaultTlsSessionTicketKeyRotationMs;
+        this->tlsFileWatchEnabled = defaultTlsFileWatchEnabled;
+        this->listenerInstanceCount = defaultListenerInstanceCount;
+        this->accessLogEnabled = defaultAccessLogEnabled;
+        this->accessLogCapacity = defaultAccessLogCapacity;
+        this->accessLogSampleRate = defaultAccessLogSampleRate;
+        this->accessLogCompactFormat = defaultAccessLogCompactFormat;
+        this->accessLogFile.clear();
+        this->earlyAdmissionEnabled = defaultEarlyAdmissionEnabled;
+        this->idempotencyCacheSize = defaultIdempotencyCacheSize;
+        this->idempotencyTtlMs = defaultIdempotencyTtlMs;
+        this->entityTagCacheSize = defaultEntityTagCacheSize;
+        this->entityTagCacheTtlMs = defaultEntityTagCacheTtlMs;
+        this->maxBatchSize = defaultMaxBatchSize;
+        this->loadSheddingEnabled = defaultLoadSheddingEnabled;
+        this->responseCacheMaxBytes = defaultResponseCacheMaxBytes;
+        this->responseCacheTtlMs = defaultResponseCacheTtlMs;
+        this->changeFeedEnabled = defaultChangeFeedEnabled;
+        this->changeFeedMaxWaitMs = defaultChangeFeedMaxWaitMs;
+        this->connectionIdleTimeoutMs = defaultConnectionIdleTimeoutMs;
+        this->keepAliveTimeoutMs = defaultKeepAliveTimeoutMs;
+        this->headerReadTimeoutMs = defaultHeaderReadTimeoutMs;
+        this->bodyReadTimeoutMs = defaultBodyReadTimeoutMs;
+        this->maxConnections = defaultMaxConnections;
     }
 }
 
@@ -85,6 +171,16 @@ void RHttpServerSettings::setMaxStaleHandlerAgeMs(quint32 ageMs)
     this->maxStaleHandlerAgeMs = ageMs;
 }
 
+quint32 RHttpServerSettings::getHandlerExpiryResolutionMs() const
+{
+    return this->handlerExpiryResolutionMs;
+}
+
+void RHttpServerSettings::setHandlerExpiryResolutionMs(quint32 resolutionMs)
+{
+    this->handlerExpiryResolutionMs = resolutionMs;
+}
+
 qint64 RHttpServerSettings::getMaxBodySize() const
 {
     return this->maxBodySize;
@@ -95,6 +191,426 @@ void RHttpServerSettings::setMaxBodySize(qint64 maxBodySize)
     this->maxBodySize = maxBodySize;
 }
 
+bool RHttpServerSettings::getCompressionEnabled() const
+{
+    return this->compressionEnabled;
+}
+
+void RHttpServerSettings::setCompressionEnabled(bool compressionEnabled)
+{
+    this->compressionEnabled = compressionEnabled;
+}
+
+qint64 RHttpServerSettings::getCompressionMinSize() const
+{
+    return this->compressionMinSize;
+}
+
+void RHttpServerSettings::setCompressionMinSize(qint64 compressionMinSize)
+{
+    this->compressionMinSize = compressionMinSize;
+}
+
+qint64 RHttpServerSettings::getAuthTokenCacheSize() const
+{
+    return this->authTokenCacheSize;
+}
+
+void RHttpServerSettings::setAuthTokenCacheSize(qint64 authTokenCacheSize)
+{
+    this->authTokenCacheSize = authTokenCacheSize;
+}
+
+qint64 RHttpServerSettings::getAuthTokenCacheTtlMs() const
+{
+    return this->authTokenCacheTtlMs;
+}
+
+void RHttpServerSettings::setAuthTokenCacheTtlMs(qint64 authTokenCacheTtlMs)
+{
+    this->authTokenCacheTtlMs = authTokenCacheTtlMs;
+}
+
+qint64 RHttpServerSettings::getAuthTokenNegativeCacheTtlMs() const
+{
+    return this->authTokenNegativeCacheTtlMs;
+}
+
+void RHttpServerSettings::setAuthTokenNegativeCacheTtlMs(qint64 authTokenNegativeCacheTtlMs)
+{
+    this->authTokenNegativeCacheTtlMs = authTokenNegativeCacheTtlMs;
+}
+
+quint32 RHttpServerSettings::getPrincipalRequestRate() const
+{
+    return this->principalRequestRate;
+}
+
+void RHttpServerSettings::setPrincipalRequestRate(quint32 principalRequestRate)
+{
+    this->principalRequestRate = principalRequestRate;
+}
+
+quint32 RHttpServerSettings::getPrincipalRequestBurst() const
+{
+    return this->principalRequestBurst;
+}
+
+void RHttpServerSettings::setPrincipalRequestBurst(quint32 principalRequestBurst)
+{
+    this->principalRequestBurst = principalRequestBurst;
+}
+
+qint64 RHttpServerSettings::getPrincipalByteRate() const
+{
+    return this->principalByteRate;
+}
+
+void RHttpServerSettings::setPrincipalByteRate(qint64 principalByteRate)
+{
+    this->principalByteRate = principalByteRate;
+}
+
+qint64 RHttpServerSettings::getPrincipalByteBurst() const
+{
+    return this->principalByteBurst;
+}
+
+void RHttpServerSettings::setPrincipalByteBurst(qint64 principalByteBurst)
+{
+    this->principalByteBurst = principalByteBurst;
+}
+
+quint32 RHttpServerSettings::getPrincipalMaxInFlight() const
+{
+    return this->principalMaxInFlight;
+}
+
+void RHttpServerSettings::setPrincipalMaxInFlight(quint32 principalMaxInFlight)
+{
+    this->principalMaxInFlight = principalMaxInFlight;
+}
+
+quint32 RHttpServerSettings::getInteractiveLaneConcurrency() const
+{
+    return this->interactiveLaneConcurrency;
+}
+
+void RHttpServerSettings::setInteractiveLaneConcurrency(quint32 interactiveLaneConcurrency)
+{
+    this->interactiveLaneConcurrency = interactiveLaneConcurrency;
+}
+
+quint32 RHttpServerSettings::getInteractiveLaneQueueSize() const
+{
+    return this->interactiveLaneQueueSize;
+}
+
+void RHttpServerSettings::setInteractiveLaneQueueSize(quint32 interactiveLaneQueueSize)
+{
+    this->interactiveLaneQueueSize = interactiveLaneQueueSize;
+}
+
+quint32 RHttpServerSettings::getBulkLaneConcurrency() const
+{
+    return this->bulkLaneConcurrency;
+}
+
+void RHttpServerSettings::setBulkLaneConcurrency(quint32 bulkLaneConcurrency)
+{
+    this->bulkLaneConcurrency = bulkLaneConcurrency;
+}
+
+quint32 RHttpServerSettings::getBulkLaneQueueSize() const
+{
+    return this->bulkLaneQueueSize;
+}
+
+void RHttpServerSettings::setBulkLaneQueueSize(quint32 bulkLaneQueueSize)
+{
+    this->bulkLaneQueueSize = bulkLaneQueueSize;
+}
+
+quint32 RHttpServerSettings::getAdminLaneConcurrency() const
+{
+    return this->adminLaneConcurrency;
+}
+
+void RHttpServerSettings::setAdminLaneConcurrency(quint32 adminLaneConcurrency)
+{
+    this->adminLaneConcurrency = adminLaneConcurrency;
+}
+
+quint32 RHttpServerSettings::getAdminLaneQueueSize() const
+{
+    return this->adminLaneQueueSize;
+}
+
+void RHttpServerSettings::setAdminLaneQueueSize(quint32 adminLaneQueueSize)
+{
+    this->adminLaneQueueSize = adminLaneQueueSize;
+}
+
+quint32 RHttpServerSettings::getDispatcherThreadCount() const
+{
+    return this->dispatcherThreadCount;
+}
+
+void RHttpServerSettings::setDispatcherThreadCount(quint32 dispatcherThreadCount)
+{
+    this->dispatcherThreadCount = dispatcherThreadCount;
+}
+
+bool RHttpServerSettings::getTlsSessionResumptionEnabled() const
+{
+    return this->tlsSessionResumptionEnabled;
+}
+
+void RHttpServerSettings::setTlsSessionResumptionEnabled(bool tlsSessionResumptionEnabled)
+{
+    this->tlsSessionResumptionEnabled = tlsSessionResumptionEnabled;
+}
+
+quint32 RHttpServerSettings::getTlsSessionTicketKeyRotationMs() const
+{
+    return this->tlsSessionTicketKeyRotationMs;
+}
+
+void RHttpServerSettings::setTlsSessionTicketKeyRotationMs(quint32 tlsSessionTicketKeyRotationMs)
+{
+    this->tlsSessionTicketKeyRotationMs = tlsSessionTicketKeyRotationMs;
+}
+
+bool RHttpServerSettings::getTlsFileWatchEnabled() const
+{
+    return this->tlsFileWatchEnabled;
+}
+
+void RHttpServerSettings::setTlsFileWatchEnabled(bool tlsFileWatchEnabled)
+{
+    this->tlsFileWatchEnabled = tlsFileWatchEnabled;
+}
+
+quint32 RHttpServerSettings::getListenerInstanceCount() const
+{
+    return this->listenerInstanceCount;
+}
+
+void RHttpServerSettings::setListenerInstanceCount(quint32 listenerInstanceCount)
+{
+    this->listenerInstanceCount = listenerInstanceCount;
+}
+
+bool RHttpServerSettings::getAccessLogEnabled() const
+{
+    return this->accessLogEnabled;
+}
+
+void RHttpServerSettings::setAccessLogEnabled(bool accessLogEnabled)
+{
+    this->accessLogEnabled = accessLogEnabled;
+}
+
+quint32 RHttpServerSettings::getAccessLogCapacity() const
+{
+    return this->accessLogCapacity;
+}
+
+void RHttpServerSettings::setAccessLogCapacity(quint32 accessLogCapacity)
+{
+    this->accessLogCapacity = accessLogCapacity;
+}
+
+quint32 RHttpServerSettings::getAccessLogSampleRate() const
+{
+    return this->accessLogSampleRate;
+}
+
+void RHttpServerSettings::setAccessLogSampleRate(quint32 accessLogSampleRate)
+{
+    this->accessLogSampleRate = accessLogSampleRate;
+}
+
+bool RHttpServerSettings::getAccessLogCompactFormat() const
+{
+    return this->accessLogCompactFormat;
+}
+
+void RHttpServerSettings::setAccessLogCompactFormat(bool accessLogCompactFormat)
+{
+    this->accessLogCompactFormat = accessLogCompactFormat;
+}
+
+const QString &RHttpServerSettings::getAccessLogFile() const
+{
+    return this->accessLogFile;
+}
+
+void RHttpServerSettings::setAccessLogFile(const QString &accessLogFile)
+{
+    this->accessLogFile = accessLogFile;
+}
+
+bool RHttpServerSettings::getEarlyAdmissionEnabled() const
+{
+    return this->earlyAdmissionEnabled;
+}
+
+void RHttpServerSettings::setEarlyAdmissionEnabled(bool earlyAdmissionEnabled)
+{
+    this->earlyAdmissionEnabled = earlyAdmissionEnabled;
+}
+
+qint64 RHttpServerSettings::getIdempotencyCacheSize() const
+{
+    return this->idempotencyCacheSize;
+}
+
+void RHttpServerSettings::setIdempotencyCacheSize(qint64 idempotencyCacheSize)
+{
+    this->idempotencyCacheSize = idempotencyCacheSize;
+}
+
+qint64 RHttpServerSettings::getIdempotencyTtlMs() const
+{
+    return this->idempotencyTtlMs;
+}
+
+void RHttpServerSettings::setIdempotencyTtlMs(qint64 idempotencyTtlMs)
+{
+    this->idempotencyTtlMs = idempotencyTtlMs;
+}
+
+qint64 RHttpServerSettings::getEntityTagCacheSize() const
+{
+    return this->entityTagCacheSize;
+}
+
+void RHttpServerSettings::setEntityTagCacheSize(qint64 entityTagCacheSize)
+{
+    this->entityTagCacheSize = entityTagCacheSize;
+}
+
+qint64 RHttpServerSettings::getEntityTagCacheTtlMs() const
+{
+    return this->entityTagCacheTtlMs;
+}
+
+void RHttpServerSettings::setEntityTagCacheTtlMs(qint64 entityTagCacheTtlMs)
+{
+    this->entityTagCacheTtlMs = entityTagCacheTtlMs;
+}
+
+quint32 RHttpServerSettings::getMaxBatchSize() const
+{
+    return this->maxBatchSize;
+}
+
+void RHttpServerSettings::setMaxBatchSize(quint32 maxBatchSize)
+{
+    this->maxBatchSize = maxBatchSize;
+}
+
+bool RHttpServerSettings::getLoadSheddingEnabled() const
+{
+    return this->loadSheddingEnabled;
+}
+
+void RHttpServerSettings::setLoadSheddingEnabled(bool loadSheddingEnabled)
+{
+    this->loadSheddingEnabled = loadSheddingEnabled;
+}
+
+qint64 RHttpServerSettings::getResponseCacheMaxBytes() const
+{
+    return this->responseCacheMaxBytes;
+}
+
+void RHttpServerSettings::setResponseCacheMaxBytes(qint64 responseCacheMaxBytes)
+{
+    this->responseCacheMaxBytes = responseCacheMaxBytes;
+}
+
+qint64 RHttpServerSettings::getResponseCacheTtlMs() const
+{
+    return this->responseCacheTtlMs;
+}
+
+void RHttpServerSettings::setResponseCacheTtlMs(qint64 responseCacheTtlMs)
+{
+    this->responseCacheTtlMs = responseCacheTtlMs;
+}
+
+bool RHttpServerSettings::getChangeFeedEnabled() const
+{
+    return this->changeFeedEnabled;
+}
+
+void RHttpServerSettings::setChangeFeedEnabled(bool changeFeedEnabled)
+{
+    this->changeFeedEnabled = changeFeedEnabled;
+}
+
+qint64 RHttpServerSettings::getChangeFeedMaxWaitMs() const
+{
+    return this->changeFeedMaxWaitMs;
+}
+
+void RHttpServerSettings::setChangeFeedMaxWaitMs(qint64 changeFeedMaxWaitMs)
+{
+    this->changeFeedMaxWaitMs = changeFeedMaxWaitMs;
+}
+
+qint64 RHttpServerSettings::getConnectionIdleTimeoutMs() const
+{
+    return this->connectionIdleTimeoutMs;
+}
+
+void RHttpServerSettings::setConnectionIdleTimeoutMs(qint64 connectionIdleTimeoutMs)
+{
+    this->connectionIdleTimeoutMs = connectionIdleTimeoutMs;
+}
+
+qint64 RHttpServerSettings::getKeepAliveTimeoutMs() const
+{
+    return this->keepAliveTimeoutMs;
+}
+
+void RHttpServerSettings::setKeepAliveTimeoutMs(qint64 keepAliveTimeoutMs)
+{
+    this->keepAliveTimeoutMs = keepAliveTimeoutMs;
+}
+
+qint64 RHttpServerSettings::getHeaderReadTimeoutMs() const
+{
+    return this->headerReadTimeoutMs;
+}
+
+void RHttpServerSettings::setHeaderReadTimeoutMs(qint64 headerReadTimeoutMs)
+{
+    this->headerReadTimeoutMs = headerReadTimeoutMs;
+}
+
+qint64 RHttpServerSettings::getBodyReadTimeoutMs() const
+{
+    return this->bodyReadTimeoutMs;
+}
+
+void RHttpServerSettings::setBodyReadTimeoutMs(qint64 bodyReadTimeoutMs)
+{
+    this->bodyReadTimeoutMs = bodyReadTimeoutMs;
+}
+
+uint RHttpServerSettings::getMaxConnections() const
+{
+    return this->maxConnections;
+}
+
+void RHttpServerSettings::setMaxConnections(uint maxConnections)
+{
+    this->maxConnections = maxConnections;
+}
+
 bool RHttpServerSettings::validate(QString *errorMessage) const
 {
     // Validate port
@@ -173,6 +689,15 @@ bool RHttpServerSettings::validate(QString *errorMessage) const
         return false;
     }
 
+    if (this->handlerExpiryResolutionMs == 0 || this->handlerExpiryResolutionMs > this->responseTimeoutMs)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid handler expiry resolution: must be greater than 0 and <= responseTimeoutMs";
+        }
+        return false;
+    }
+
     if (this->maxStaleHandlerAgeMs < this->responseTimeoutMs)
     {
         if (errorMessage)
@@ -182,6 +707,116 @@ bool RHttpServerSettings::validate(QString *errorMessage) const
         return false;
     }
 
+    // Validate compression
+    if (this->compressionEnabled && this->compressionMinSize < 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid compression minimum size: must be >= 0";
+        }
+        return false;
+    }
+
+    // Validate authentication token cache
+    if (this->authTokenCacheSize < 0 || this->authTokenCacheTtlMs < 0 || this->authTokenNegativeCacheTtlMs < 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid authentication token cache: size and TTLs must be >= 0";
+        }
+        return false;
+    }
+
+    // Validate per-principal limits
+    if (this->principalByteRate < 0 || this->principalByteBurst < 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid principal byte rate: rate and burst must be >= 0";
+        }
+        return false;
+    }
+
+    // Validate dispatch lanes
+    if (this->interactiveLaneConcurrency == 0 || this->bulkLaneConcurrency == 0 || this->adminLaneConcurrency == 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid dispatch lane concurrency: must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate access log
+    if (this->accessLogEnabled && (this->accessLogCapacity == 0 || this->accessLogSampleRate == 0))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid access log: capacity and sample rate must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate idempotency cache
+    if (this->idempotencyCacheSize < 0 || this->idempotencyTtlMs <= 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid idempotency cache: size must be >= 0 and TTL must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate entity tag cache
+    if (this->entityTagCacheSize < 0 || this->entityTagCacheTtlMs <= 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid entity tag cache: size must be >= 0 and TTL must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate batch size
+    if (this->maxBatchSize == 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid maximum batch size: must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate response cache
+    if (this->responseCacheMaxBytes < 0 || this->responseCacheTtlMs <= 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid response cache: size must be >= 0 and TTL must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate change feed wait time
+    if (this->changeFeedMaxWaitMs <= 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid change feed wait time: must be greater than 0";
+        }
+        return false;
+    }
+
+    // Validate connection timeouts
+    if (this->connectionIdleTimeoutMs < 0 || this->keepAliveTimeoutMs < 0 || this->headerReadTimeoutMs < 0 || this->bodyReadTimeoutMs < 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid connection timeouts: must be >= 0";
+        }
+        return false;
+    }
+
     return true;
 }
 
@@ -0,0 +1,127 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_timing_wheel.h"
+
+RHttpTimingWheel::RHttpTimingWheel(qint64 resolutionMs, qint64 startTime)
+    : resolutionMs{qMax(resolutionMs,qint64(1))}
+    , startTime{startTime}
+    , currentTick{0}
+    , nEntries{0}
+    , slots(nLevels * levelSize)
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+qint64 RHttpTimingWheel::getResolutionMs() const
+{
+    return this->resolutionMs;
+}
+
+void RHttpTimingWheel::schedule(const QUuid &id, qint64 deadline)
+{
+    // Round up so that an entry never expires before its deadline.
+    const qint64 expiryTick = (deadline - this->startTime + this->resolutionMs - 1) / this->resolutionMs;
+    this->insert(Entry{id,expiryTick});
+    this->nEntries++;
+}
+
+QList<QUuid> RHttpTimingWheel::advance(qint64 now)
+{
+    QList<QUuid> expiredIds;
+    expiredIds.swap(this->dueIds);
+    this->nEntries -= int(expiredIds.size());
+
+    const qint64 targetTick = (now - this->startTime) / this->resolutionMs;
+
+    if (this->nEntries == 0)
+    {
+        this->currentTick = qMax(this->currentTick,targetTick);
+        return expiredIds;
+    }
+
+    while (this->currentTick < targetTick)
+    {
+        this->currentTick++;
+
+        // Refill lower levels once their range wraps around.
+        uint level = 1;
+        while (level < nLevels && (this->currentTick & ((qint64(1) << (levelBits * level)) - 1)) == 0)
+        {
+            level++;
+        }
+        for (uint l = level - 1; l >= 1; l--)
+        {
+            this->cascade(l);
+        }
+
+        QList<Entry> &dueSlot = this->slot(0,this->currentTick);
+        for (const Entry &entry : std::as_const(dueSlot))
+        {
+            expiredIds.append(entry.id);
+        }
+        this->nEntries -= int(dueSlot.size());
+        dueSlot.clear();
+
+        // Entries moved by the cascade may be due right now.
+        this->nEntries -= int(this->dueIds.size());
+        expiredIds.append(this->dueIds);
+        this->dueIds.clear();
+
+        if (this->nEntries == 0)
+        {
+            this->currentTick = targetTick;
+        }
+    }
+
+    return expiredIds;
+}
+
+int RHttpTimingWheel::size() const
+{
+    return this->nEntries;
+}
+
+bool RHttpTimingWheel::isEmpty() const
+{
+    return this->nEntries == 0;
+}
+
+void RHttpTimingWheel::insert(const Entry &entry)
+{
+    const qint64 delta = entry.expiryTick - this->currentTick;
+    if (delta <= 0)
+    {
+        this->dueIds.append(entry.id);
+        return;
+    }
+
+    for (uint level = 0; level < nLevels; level++)
+    {
+        if (delta < (qint64(1) << (levelBits * (level + 1))))
+        {
+            this->slot(level,entry.expiryTick).append(entry);
+            return;
+        }
+    }
+
+    // Beyond wheel range: park in the top level and re-evaluate on cascade.
+    const qint64 maxTick = this->currentTick + (qint64(1) << (levelBits * nLevels)) - 1;
+    this->slot(nLevels - 1,maxTick).append(entry);
+}
+
+void RHttpTimingWheel::cascade(uint level)
+{
+    QList<Entry> entries;
+    entries.swap(this->slot(level,this->currentTick));
+    for (const Entry &entry : std::as_const(entries))
+    {
+        this->insert(entry);
+    }
+}
+
+QList<RHttpTimingWheel::Entry> &RHttpTimingWheel::slot(uint level, qint64 tick)
+{
+    const uint index = uint(tick >> (levelBits * level)) & (levelSize - 1);
+    return this->slots[level * levelSize + index];
+}
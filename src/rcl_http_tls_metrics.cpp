@@ -0,0 +1,131 @@
+#include <rbl_logger.h>
+
+#include "rcl_http_tls_metrics.h"
+
+RHttpTlsMetrics::RHttpTlsMetrics()
+    : nKeyRotations{0}
+{
+    R_LOG_TRACE_IN;
+    for (std::atomic<quint64> &nResultHandshakes : this->nHandshakes)
+    {
+        nResultHandshakes.store(0,std::memory_order_relaxed);
+    }
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpTlsMetrics::recordHandshake(Result result, qint64 duration)
+{
+    this->nHandshakes[result].fetch_add(1,std::memory_order_relaxed);
+    if (result != RHttpTlsMetrics::Failed)
+    {
+        this->latency.record(duration);
+    }
+}
+
+void RHttpTlsMetrics::recordKeyRotation()
+{
+    this->nKeyRotations.fetch_add(1,std::memory_order_relaxed);
+}
+
+quint64 RHttpTlsMetrics::getHandshakeCount(Result result) const
+{
+    return this->nHandshakes[result].load(std::memory_order_relaxed);
+}
+
+quint64 RHttpTlsMetrics::getKeyRotationCount() const
+{
+    return this->nKeyRotations.load(std::memory_order_relaxed);
+}
+
+double RHttpTlsMetrics::getResumptionRatio() const
+{
+    const quint64 nResumed = this->getHandshakeCount(RHttpTlsMetrics::Resumed);
+    const quint64 nCompleted = nResumed
+                             + this->getHandshakeCount(RHttpTlsMetrics::Full)
+                             + this->getHandshakeCount(RHttpTlsMetrics::Unknown);
+    return nCompleted ? double(nResumed) / double(nCompleted) : 0.0;
+}
+
+const RHttpLatencyHistogram &RHttpTlsMetrics::getLatency() const
+{
+    return this->latency;
+}
+
+QByteArray RHttpTlsMetrics::toPrometheusText() const
+{
+    R_LOG_TRACE_IN;
+    QByteArray text;
+    text += "# HELP range_cloud_tls_handshakes_total Number of TLS handshakes by result.\n";
+    text += "# TYPE range_cloud_tls_handshakes_total counter\n";
+    for (int result = 0; result < RHttpTlsMetrics::nResults; result++)
+    {
+        text += "range_cloud_tls_handshakes_total{result=\"" + RHttpTlsMetrics::resultToString(Result(result)).toUtf8() + "\"} "
+              + QByteArray::number(this->getHandshakeCount(Result(result))) + "\n";
+    }
+    text += "# HELP range_cloud_tls_resumption_ratio Fraction of completed TLS handshakes which resumed a session.\n";
+    text += "# TYPE range_cloud_tls_resumption_ratio gauge\n";
+    text += "range_cloud_tls_resumption_ratio " + QByteArray::number(this->getResumptionRatio(),'g',6) + "\n";
+    text += "# HELP range_cloud_tls_handshake_seconds Duration of completed TLS handshakes.\n";
+    text += "# TYPE range_cloud_tls_handshake_seconds summary\n";
+    for (double quantile : {0.5, 0.9, 0.99})
+    {
+        text += "range_cloud_tls_handshake_seconds{quantile=\"" + QByteArray::number(quantile) + "\"} "
+              + QByteArray::number(double(this->latency.findQuantile(quantile)) / 1.0e6,'g',6) + "\n";
+    }
+    text += "range_cloud_tls_handshake_seconds_sum " + QByteArray::number(double(this->latency.getSum()) / 1.0e6,'g',12) + "\n";
+    text += "range_cloud_tls_handshake_seconds_count " + QByteArray::number(this->latency.getCount()) + "\n";
+    text += "# HELP range_cloud_tls_ticket_key_rotations_total Number of TLS session ticket key rotations.\n";
+    text += "# TYPE range_cloud_tls_ticket_key_rotations_total counter\n";
+    text += "range_cloud_tls_ticket_key_rotations_total " + QByteArray::number(this->getKeyRotationCount()) + "\n";
+    R_LOG_TRACE_RETURN(text);
+}
+
+QJsonObject RHttpTlsMetrics::toJson() const
+{
+    R_LOG_TRACE_IN;
+    QJsonObject handshakesObject;
+    for (int result = 0; result < RHttpTlsMetrics::nResults; result++)
+    {
+        handshakesObject[RHttpTlsMetrics::resultToString(Result(result))] = qint64(this->getHandshakeCount(Result(result)));
+    }
+
+    QJsonObject latencyObject;
+    latencyObject["count"] = qint64(this->latency.getCount());
+    latencyObject["p50"] = this->latency.findQuantile(0.5);
+    latencyObject["p99"] = this->latency.findQuantile(0.99);
+    latencyObject["max"] = this->latency.getMax();
+
+    QJsonObject json;
+    json["handshakes"] = handshakesObject;
+    json["resumption-ratio"] = this->getResumptionRatio();
+    json["handshake-us"] = latencyObject;
+    json["ticket-key-rotations"] = qint64(this->getKeyRotationCount());
+    R_LOG_TRACE_RETURN(json);
+}
+
+QString RHttpTlsMetrics::resultToString(Result result)
+{
+    switch (result)
+    {
+        case RHttpTlsMetrics::Full:
+        {
+            return "full";
+        }
+        case RHttpTlsMetrics::Resumed:
+        {
+            return "resumed";
+        }
+        case RHttpTlsMetrics::Unknown:
+        {
+            return "unknown";
+        }
+        case RHttpTlsMetrics::Failed:
+        {
+            return "failed";
+        }
+        default:
+        {
+            return QString();
+        }
+    }
+}
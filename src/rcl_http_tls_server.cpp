@@ -0,0 +1,178 @@
+#include <QTimer>
+
+#include <cstring>
+
+#ifdef RCL_HAVE_OPENSSL
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+#include <openssl/params.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#endif
+
+#include <rbl_logger.h>
+
+#include "rcl_http_server_handler_registry.h"
+#include "rcl_http_tls_server.h"
+
+const QByteArray RHttpTlsServer::sessionIdContext = "range-cloud";
+
+#if defined(RCL_HAVE_OPENSSL) && OPENSSL_VERSION_MAJOR >= 3
+
+//! Return index of SSL extra data holding the server which accepted the connection.
+static int findServerDataIndex()
+{
+    static const int index = SSL_get_ex_new_index(0,nullptr,nullptr,nullptr,nullptr);
+    return index;
+}
+
+//! Set HMAC-SHA256 secret of given MAC context.
+static bool setMacSecret(EVP_MAC_CTX *macContext, const QByteArray &secret)
+{
+    OSSL_PARAM parameters[3];
+    parameters[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,const_cast<char*>(secret.constData()),size_t(secret.size()));
+    parameters[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,const_cast<char*>("SHA256"),0);
+    parameters[2] = OSSL_PARAM_construct_end();
+    return EVP_MAC_CTX_set_params(macContext,parameters) == 1;
+}
+
+//! Session ticket key callback (see SSL_CTX_set_tlsext_ticket_key_evp_cb).
+static int processTicketKey(SSL *ssl, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipherContext, EVP_MAC_CTX *macContext, int encrypt)
+{
+    const RHttpTlsServer *pServer = static_cast<const RHttpTlsServer*>(SSL_get_ex_data(ssl,findServerDataIndex()));
+    if (!pServer || !pServer->getTicketKeyStore())
+    {
+        // No ticket is issued, or given one is ignored.
+        return 0;
+    }
+    RHttpTlsTicketKeyStore *pTicketKeyStore = pServer->getTicketKeyStore();
+    if (pTicketKeyStore->rotateIfDue(RHttpServerHandlerRegistry::currentTime()))
+    {
+        pServer->getTlsMetrics()->recordKeyRotation();
+    }
+
+    const EVP_CIPHER *cipher = EVP_aes_256_cbc();
+    if (encrypt)
+    {
+        const RHttpTlsTicketKeyStore::Key key = pTicketKeyStore->getCurrentKey();
+        if (RAND_bytes(iv,EVP_CIPHER_get_iv_length(cipher)) != 1)
+        {
+            return -1;
+        }
+        std::memcpy(keyName,key.name.constData(),size_t(key.name.size()));
+        if (EVP_EncryptInit_ex(cipherContext,cipher,nullptr,reinterpret_cast<const unsigned char*>(key.encryptionSecret.constData()),iv) != 1
+            || !setMacSecret(macContext,key.macSecret))
+        {
+            return -1;
+        }
+        return 1;
+    }
+
+    RHttpTlsTicketKeyStore::Key key;
+    bool isCurrent = false;
+    if (!pTicketKeyStore->findKey(QByteArray(reinterpret_cast<const char*>(keyName),RHttpTlsTicketKeyStore::nameSize),key,&isCurrent))
+    {
+        // Unknown or expired key, full handshake follows.
+        return 0;
+    }
+    if (!setMacSecret(macContext,key.macSecret)
+        || EVP_DecryptInit_ex(cipherContext,cipher,nullptr,reinterpret_cast<const unsigned char*>(key.encryptionSecret.constData()),iv) != 1)
+    {
+        return -1;
+    }
+    // Ticket protected by previous key is renewed.
+    return isCurrent ? 1 : 2;
+}
+
+#endif
+
+RHttpTlsServer::RHttpTlsServer(RHttpTlsTicketKeyStore *pTicketKeyStore, RHttpTlsMetrics *pTlsMetrics, QObject *parent)
+    : QSslServer{parent}
+    , pTicketKeyStore{pTicketKeyStore}
+    , pTlsMetrics{pTlsMetrics}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RHttpTlsTicketKeyStore *RHttpTlsServer::getTicketKeyStore() const
+{
+    return this->pTicketKeyStore;
+}
+
+RHttpTlsMetrics *RHttpTlsServer::getTlsMetrics() const
+{
+    return this->pTlsMetrics;
+}
+
+void RHttpTlsServer::incomingConnection(qintptr socketDescriptor)
+{
+    R_LOG_TRACE_IN;
+    QSslSocket *pSocket = new QSslSocket(this);
+    pSocket->setSslConfiguration(this->sslConfiguration());
+    if (!pSocket->setSocketDescriptor(socketDescriptor))
+    {
+        delete pSocket;
+        R_LOG_TRACE_OUT;
+        return;
+    }
+
+    QTimer *pHandshakeTimer = new QTimer(pSocket);
+    pHandshakeTimer->setSingleShot(true);
+    pHandshakeTimer->setInterval(this->handshakeTimeout());
+
+    QObject::connect(pSocket, &QSslSocket::peerVerifyError, this, [this, pSocket](const QSslError &error)
+    {
+        emit this->peerVerifyError(pSocket,error);
+    });
+    QObject::connect(pSocket, &QSslSocket::sslErrors, this, [this, pSocket](const QList<QSslError> &errors)
+    {
+        emit this->sslErrors(pSocket,errors);
+    });
+    QObject::connect(pSocket, &QAbstractSocket::errorOccurred, this, [this, pSocket](QAbstractSocket::SocketError socketError)
+    {
+        emit this->errorOccurred(pSocket,socketError);
+        if (!pSocket->isEncrypted())
+        {
+            pSocket->deleteLater();
+        }
+    });
+    QObject::connect(pHandshakeTimer, &QTimer::timeout, this, [this, pSocket]()
+    {
+        pSocket->disconnect(this);
+        pSocket->abort();
+        emit this->errorOccurred(pSocket,QAbstractSocket::SocketTimeoutError);
+        pSocket->deleteLater();
+    });
+    QObject::connect(pSocket, &QSslSocket::encrypted, this, [this, pSocket, pHandshakeTimer]()
+    {
+        delete pHandshakeTimer;
+        pSocket->disconnect(this);
+        this->addPendingConnection(pSocket);
+    });
+
+    // Client hello is not read yet, it is processed once the ticket keys are in place.
+    pSocket->startServerEncryption();
+    this->installTicketKeys(pSocket);
+    emit this->startedEncryptionHandshake(pSocket);
+    pHandshakeTimer->start();
+    R_LOG_TRACE_OUT;
+}
+
+void RHttpTlsServer::installTicketKeys(QSslSocket *pSocket)
+{
+#if defined(RCL_HAVE_OPENSSL) && OPENSSL_VERSION_MAJOR >= 3
+    if (!this->pTicketKeyStore || QSslSocket::activeBackend() != QStringLiteral("openssl") || !pSocket->sslHandle())
+    {
+        return;
+    }
+    SSL *ssl = static_cast<SSL*>(pSocket->sslHandle());
+    SSL_set_ex_data(ssl,findServerDataIndex(),this);
+    // Sessions of peers verified by certificate are resumed only within the same context.
+    SSL_set_session_id_context(ssl,reinterpret_cast<const unsigned char*>(RHttpTlsServer::sessionIdContext.constData()),uint(RHttpTlsServer::sessionIdContext.size()));
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(SSL_get_SSL_CTX(ssl),processTicketKey);
+#else
+    Q_UNUSED(pSocket);
+#endif
+}
@@ -0,0 +1,82 @@
+#include <QList>
+#include <QRandomGenerator>
+
+#include <rbl_logger.h>
+
+#include "rcl_http_tls_ticket_key_store.h"
+
+RHttpTlsTicketKeyStore::RHttpTlsTicketKeyStore(qint64 rotationMs, qint64 currentTime)
+    : rotationMs{rotationMs}
+    , currentKey{RHttpTlsTicketKeyStore::generateKey(currentTime)}
+    , previousKey{QByteArray(),QByteArray(),QByteArray(),currentTime}
+{
+    R_LOG_TRACE_IN;
+    R_LOG_TRACE_OUT;
+}
+
+RHttpTlsTicketKeyStore::Key RHttpTlsTicketKeyStore::generateKey(qint64 currentTime)
+{
+    const qsizetype size = RHttpTlsTicketKeyStore::nameSize + 2 * RHttpTlsTicketKeyStore::secretSize;
+    QList<quint32> words((size + 3) / 4);
+    QRandomGenerator::system()->fillRange(words.data(),words.size());
+    const QByteArray bytes(reinterpret_cast<const char*>(words.constData()),size);
+
+    Key key;
+    key.name = bytes.left(RHttpTlsTicketKeyStore::nameSize);
+    key.encryptionSecret = bytes.mid(RHttpTlsTicketKeyStore::nameSize,RHttpTlsTicketKeyStore::secretSize);
+    key.macSecret = bytes.right(RHttpTlsTicketKeyStore::secretSize);
+    key.createTime = currentTime;
+    return key;
+}
+
+bool RHttpTlsTicketKeyStore::rotateIfDue(qint64 currentTime)
+{
+    QMutexLocker locker(&this->mutex);
+    if (this->rotationMs <= 0 || currentTime - this->currentKey.createTime < this->rotationMs)
+    {
+        return false;
+    }
+    // Previous key is dropped if it has not been in use for a whole period either.
+    this->previousKey = (currentTime - this->currentKey.createTime < 2 * this->rotationMs)
+                      ? this->currentKey
+                      : Key{QByteArray(),QByteArray(),QByteArray(),currentTime};
+    this->currentKey = RHttpTlsTicketKeyStore::generateKey(currentTime);
+    return true;
+}
+
+void RHttpTlsTicketKeyStore::rotate(qint64 currentTime)
+{
+    QMutexLocker locker(&this->mutex);
+    this->previousKey = this->currentKey;
+    this->currentKey = RHttpTlsTicketKeyStore::generateKey(currentTime);
+}
+
+RHttpTlsTicketKeyStore::Key RHttpTlsTicketKeyStore::getCurrentKey() const
+{
+    QMutexLocker locker(&this->mutex);
+    return this->currentKey;
+}
+
+bool RHttpTlsTicketKeyStore::findKey(const QByteArray &name, Key &key, bool *isCurrent) const
+{
+    QMutexLocker locker(&this->mutex);
+    if (name == this->currentKey.name)
+    {
+        key = this->currentKey;
+        if (isCurrent)
+        {
+            *isCurrent = true;
+        }
+        return true;
+    }
+    if (!this->previousKey.name.isEmpty() && name == this->previousKey.name)
+    {
+        key = this->previousKey;
+        if (isCurrent)
+        {
+            *isCurrent = false;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#ifndef HTTP_TEST_SUPPORT_H
+#define HTTP_TEST_SUPPORT_H
+
+#include <QProcess>
+#include <QString>
+#include <QTcpServer>
+
+//! Helpers shared by tests which stand up a server.
+class HttpTestSupport
+{
+
+    public:
+
+        //! Environment variable which enables benchmarks.
+        static constexpr const char *benchmarkVariable = "RANGE_BENCHMARKS";
+
+        //! Find free TCP port.
+        static quint16 findFreePort()
+        {
+            QTcpServer server;
+            server.listen(QHostAddress::LocalHost, 0);
+            return server.serverPort();
+        }
+
+        //! Generate self-signed certificate for localhost with the OpenSSL command line tool.
+        //! Return false if the tool is not available.
+        static bool generateCertificate(const QString &certificateFile, const QString &keyFile)
+        {
+            QProcess openssl;
+            openssl.start("openssl", {"req", "-x509", "-newkey", "ec", "-pkeyopt", "ec_paramgen_curve:prime256v1",
+                                      "-nodes", "-days", "1", "-subj", "/CN=localhost",
+                                      "-keyout", keyFile, "-out", certificateFile});
+            return openssl.waitForFinished(30000) && openssl.exitStatus() == QProcess::NormalExit && openssl.exitCode() == 0;
+        }
+
+        //! Return true if benchmarks are enabled.
+        //! Benchmarks are slow and need large resources, they are not run by default.
+        static bool isBenchmarkEnabled()
+        {
+            return !qEnvironmentVariableIsEmpty(HttpTestSupport::benchmarkVariable);
+        }
+
+};
+
+#endif // HTTP_TEST_SUPPORT_H
@@ -0,0 +1,200 @@
+#include <QtTest>
+
+#include "rcl_auth_token_validator_cache.h"
+
+class CountingValidator : public RAuthTokenValidator
+{
+    public:
+
+        QString validToken = "valid";
+        qint64 validityDate = 0;
+        int nCalls = 0;
+
+        bool validate(const QString &resourceName, const QString &token) override
+        {
+            qint64 tokenValidityDate = 0;
+            return this->validateWithValidityDate(resourceName, token, tokenValidityDate);
+        }
+
+        bool validateWithValidityDate(const QString &resourceName, const QString &token, qint64 &validityDate) override
+        {
+            Q_UNUSED(resourceName);
+            this->nCalls++;
+            validityDate = this->validityDate;
+            return token == this->validToken;
+        }
+};
+
+class RevokingValidator : public RAuthTokenValidator
+{
+    public:
+
+        RAuthTokenValidatorCache *pCache = nullptr;
+
+        bool validate(const QString &resourceName, const QString &token) override
+        {
+            // Token is revoked while its (still positive) validation is in flight.
+            this->pCache->invalidate(resourceName, token);
+            return true;
+        }
+};
+
+class ManualClockCache : public RAuthTokenValidatorCache
+{
+    public:
+
+        qint64 now = 1000000;
+
+        using RAuthTokenValidatorCache::RAuthTokenValidatorCache;
+
+    protected:
+
+        qint64 currentTime() const override
+        {
+            return this->now;
+        }
+};
+
+class TestAuthTokenValidatorCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void positiveResultIsCached();
+    void negativeResultExpiresQuickly();
+    void validityDateCapsTtl();
+    void leastRecentlyUsedIsEvicted();
+    void invalidate();
+    void setValidatorClearsCache();
+    void invalidationDuringValidationIsNotCached();
+};
+
+void TestAuthTokenValidatorCache::positiveResultIsCached()
+{
+    CountingValidator validator;
+    ManualClockCache cache(&validator, 100, 1000, 100);
+
+    QVERIFY(cache.validate("alice", "valid"));
+    QVERIFY(cache.validate("alice", "valid"));
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(validator.nCalls, 1);
+    QCOMPARE(cache.getHitCount(), quint64(2));
+    QCOMPARE(cache.getMissCount(), quint64(1));
+
+    // Same token of another resource is a different entry.
+    QVERIFY(cache.validate("bob", "valid"));
+    QCOMPARE(validator.nCalls, 2);
+
+    cache.now += 1000;
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(validator.nCalls, 3);
+}
+
+void TestAuthTokenValidatorCache::negativeResultExpiresQuickly()
+{
+    CountingValidator validator;
+    ManualClockCache cache(&validator, 100, 1000, 100);
+
+    QVERIFY(!cache.validate("alice", "invalid"));
+    QVERIFY(!cache.validate("alice", "invalid"));
+    QCOMPARE(validator.nCalls, 1);
+
+    // Token becomes valid (e.g. has just been created).
+    validator.validToken = "invalid";
+    cache.now += 100;
+    QVERIFY(cache.validate("alice", "invalid"));
+    QCOMPARE(validator.nCalls, 2);
+}
+
+void TestAuthTokenValidatorCache::validityDateCapsTtl()
+{
+    CountingValidator validator;
+    ManualClockCache cache(&validator, 100, 60000, 100);
+
+    // Token expires in 5 seconds, well before cache TTL.
+    validator.validityDate = cache.now / 1000 + 5;
+    QVERIFY(cache.validate("alice", "valid"));
+    cache.now += 4000;
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(validator.nCalls, 1);
+    cache.now += 1000;
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(validator.nCalls, 2);
+
+    // Already expired tokens are not cached.
+    validator.validityDate = cache.now / 1000 - 1;
+    QVERIFY(cache.validate("bob", "valid"));
+    QVERIFY(cache.validate("bob", "valid"));
+    QCOMPARE(validator.nCalls, 4);
+}
+
+void TestAuthTokenValidatorCache::leastRecentlyUsedIsEvicted()
+{
+    CountingValidator validator;
+    ManualClockCache cache(&validator, 2, 60000, 100);
+
+    QVERIFY(cache.validate("a", "valid"));
+    QVERIFY(cache.validate("b", "valid"));
+    QVERIFY(cache.validate("a", "valid"));
+    QVERIFY(cache.validate("c", "valid"));
+    QCOMPARE(validator.nCalls, 3);
+
+    // "b" was least recently used.
+    QVERIFY(cache.validate("a", "valid"));
+    QCOMPARE(validator.nCalls, 3);
+    QVERIFY(cache.validate("b", "valid"));
+    QCOMPARE(validator.nCalls, 4);
+}
+
+void TestAuthTokenValidatorCache::invalidate()
+{
+    CountingValidator validator;
+    ManualClockCache cache(&validator, 100, 60000, 60000);
+
+    QVERIFY(cache.validate("alice", "valid"));
+    QVERIFY(cache.validate("bob", "valid"));
+    QVERIFY(!cache.validate("alice", "other"));
+    QCOMPARE(cache.size(), qsizetype(3));
+
+    // Token was removed.
+    validator.validToken = "new";
+    cache.invalidate("alice", "valid");
+    QVERIFY(!cache.validate("alice", "valid"));
+    QVERIFY(cache.validate("bob", "valid"));
+
+    cache.invalidateResource("bob");
+    QVERIFY(!cache.validate("bob", "valid"));
+
+    cache.clear();
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestAuthTokenValidatorCache::setValidatorClearsCache()
+{
+    CountingValidator validator;
+    ManualClockCache cache(nullptr, 100, 60000, 60000);
+
+    QVERIFY(!cache.validate("alice", "valid"));
+    QCOMPARE(cache.size(), qsizetype(0));
+
+    cache.setValidator(&validator);
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(validator.nCalls, 1);
+    QVERIFY(cache.getValidator() == &validator);
+}
+
+void TestAuthTokenValidatorCache::invalidationDuringValidationIsNotCached()
+{
+    RevokingValidator validator;
+    ManualClockCache cache(&validator, 100, 60000, 60000);
+    validator.pCache = &cache;
+
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(cache.size(), qsizetype(0));
+    QVERIFY(cache.validate("alice", "valid"));
+    QCOMPARE(cache.getMissCount(), quint64(2));
+}
+
+QTEST_APPLESS_MAIN(TestAuthTokenValidatorCache)
+#include "tst_auth_token_validator_cache.moc"
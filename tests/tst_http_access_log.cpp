@@ -0,0 +1,231 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "rcl_http_access_log.h"
+
+#include "http_test_support.h"
+
+class TestHttpAccessLog : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    static RHttpAccessLog::Record buildRecord(const QString &user, RError::Type errorType);
+
+    //! Read lines written to given file.
+    static QList<QByteArray> readLines(const QString &fileName);
+
+private slots:
+
+    void setText();
+    void textFormat();
+    void compactFormat();
+    void sampling();
+    void dropWhenFull();
+    void concurrentAppend();
+    void backgroundWriter();
+    void prometheusText();
+    void benchmarkAppend();
+};
+
+RHttpAccessLog::Record TestHttpAccessLog::buildRecord(const QString &user, RError::Type errorType)
+{
+    RHttpAccessLog::Record record;
+    RHttpAccessLog::setText(record.service,sizeof(record.service),QString("PublicHttpService"));
+    RHttpAccessLog::setText(record.action,sizeof(record.action),QString("file-info"));
+    RHttpAccessLog::setText(record.user,sizeof(record.user),user);
+    RHttpAccessLog::setText(record.resourceName,sizeof(record.resourceName),QString("report.pdf"));
+    RHttpAccessLog::setRemoteAddress(record,QHostAddress("192.168.1.10"),40000);
+    record.resourceId = QUuid("{2f9c3c0e-4a7b-4f5e-9d1a-2b3c4d5e6f70}");
+    record.timestamp = 1700000000000;
+    record.duration = 1234;
+    record.bytesIn = 10;
+    record.bytesOut = 200;
+    record.errorType = errorType;
+    return record;
+}
+
+QList<QByteArray> TestHttpAccessLog::readLines(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QList<QByteArray>();
+    }
+    QList<QByteArray> lines = file.readAll().split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty())
+    {
+        lines.removeLast();
+    }
+    return lines;
+}
+
+void TestHttpAccessLog::setText()
+{
+    char text[8];
+    RHttpAccessLog::setText(text,sizeof(text),QString("alice"));
+    QCOMPARE(QByteArray(text), QByteArray("alice"));
+    RHttpAccessLog::setText(text,sizeof(text),QString("administrator"));
+    QCOMPARE(QByteArray(text), QByteArray("adminis"));
+    // Multi-byte character is never cut in half.
+    RHttpAccessLog::setText(text,sizeof(text),QString::fromUtf8("žžžž"));
+    QCOMPARE(QString::fromUtf8(text), QString::fromUtf8("žžž"));
+}
+
+void TestHttpAccessLog::textFormat()
+{
+    const QByteArray line = RHttpAccessLog::formatRecord(buildRecord("alice",RError::None),RHttpAccessLog::Text);
+    QVERIFY(line.startsWith("[PublicHttpService] Request: user = \"alice\" (192.168.1.10:40000), "
+                            "url = \"/file-info/?resource-name=report.pdf&resource-id={2f9c3c0e-4a7b-4f5e-9d1a-2b3c4d5e6f70}\""));
+    QVERIFY(line.contains("status = 200"));
+    QVERIFY(line.endsWith("duration = 1234 us\n"));
+}
+
+void TestHttpAccessLog::compactFormat()
+{
+    const QByteArray line = RHttpAccessLog::formatRecord(buildRecord("alice",RError::None),RHttpAccessLog::Compact);
+    QCOMPARE(line, QByteArray("time=2023-11-14T22:13:20.000Z service=PublicHttpService action=file-info user=\"alice\" from=192.168.1.10:40000 "
+                              "resource=\"report.pdf\" id=2f9c3c0e-4a7b-4f5e-9d1a-2b3c4d5e6f70 status=200 in=10 out=200 us=1234\n"));
+
+    bool ok = false;
+    QCOMPARE(RHttpAccessLog::formatFromString("compact",&ok), RHttpAccessLog::Compact);
+    QVERIFY(ok);
+    RHttpAccessLog::formatFromString("xml",&ok);
+    QVERIFY(!ok);
+}
+
+void TestHttpAccessLog::sampling()
+{
+    QTemporaryDir directory;
+    const QString fileName = directory.filePath("access.log");
+    {
+        RHttpAccessLog accessLog(64,4,RHttpAccessLog::Compact,fileName);
+        for (int i = 0; i < 8; i++)
+        {
+            accessLog.append(buildRecord("alice",RError::None));
+        }
+        // Failed requests are never sampled out.
+        accessLog.append(buildRecord("bob",RError::NotFound));
+        QCOMPARE(accessLog.flush(), qsizetype(3));
+        QCOMPARE(accessLog.getSampledOutCount(), quint64(6));
+    }
+    const QList<QByteArray> lines = readLines(fileName);
+    QCOMPARE(lines.size(), 3);
+    QVERIFY(lines.last().contains("user=\"bob\""));
+}
+
+void TestHttpAccessLog::dropWhenFull()
+{
+    RHttpAccessLog accessLog(4,1,RHttpAccessLog::Text,QString());
+    QCOMPARE(accessLog.getCapacity(), qsizetype(4));
+    for (int i = 0; i < 4; i++)
+    {
+        QVERIFY(accessLog.append(buildRecord("alice",RError::None)));
+    }
+    QVERIFY(!accessLog.append(buildRecord("alice",RError::None)));
+    QCOMPARE(accessLog.getDroppedCount(), quint64(1));
+
+    // Ring buffer is reusable once the writer caught up.
+    QTemporaryDir directory;
+    RHttpAccessLog fileLog(4,1,RHttpAccessLog::Text,directory.filePath("access.log"));
+    for (int lap = 0; lap < 3; lap++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            QVERIFY(fileLog.append(buildRecord("alice",RError::None)));
+        }
+        QCOMPARE(fileLog.flush(), qsizetype(4));
+    }
+    QCOMPARE(fileLog.getWrittenCount(), quint64(12));
+}
+
+void TestHttpAccessLog::concurrentAppend()
+{
+    QTemporaryDir directory;
+    const QString fileName = directory.filePath("access.log");
+    const int nThreads = 4;
+    const int nRecordsPerThread = 5000;
+    {
+        RHttpAccessLog accessLog(nThreads * nRecordsPerThread,1,RHttpAccessLog::Compact,fileName);
+        QList<QThread*> threads;
+        for (int i = 0; i < nThreads; i++)
+        {
+            threads.append(QThread::create([&accessLog, i]()
+            {
+                for (int j = 0; j < nRecordsPerThread; j++)
+                {
+                    accessLog.append(buildRecord(QString("user-%1-%2").arg(i).arg(j),RError::None));
+                }
+            }));
+            threads.last()->start();
+        }
+        for (QThread *pThread : std::as_const(threads))
+        {
+            pThread->wait();
+        }
+        qDeleteAll(threads);
+        QCOMPARE(accessLog.getDroppedCount(), quint64(0));
+    }
+
+    // Every record is written exactly once and complete.
+    const QList<QByteArray> lines = readLines(fileName);
+    QCOMPARE(lines.size(), nThreads * nRecordsPerThread);
+    QSet<QByteArray> users;
+    for (const QByteArray &line : lines)
+    {
+        QVERIFY(line.endsWith("us=1234"));
+        users.insert(line.mid(line.indexOf("user=")).split(' ').first());
+    }
+    QCOMPARE(users.size(), nThreads * nRecordsPerThread);
+}
+
+void TestHttpAccessLog::backgroundWriter()
+{
+    QTemporaryDir directory;
+    const QString fileName = directory.filePath("access.log");
+    RHttpAccessLog accessLog(64,1,RHttpAccessLog::Text,fileName,10);
+    accessLog.start();
+    for (int i = 0; i < 10; i++)
+    {
+        accessLog.append(buildRecord("alice",RError::None));
+    }
+    QTRY_COMPARE(accessLog.getWrittenCount(), quint64(10));
+    accessLog.stop();
+    QCOMPARE(readLines(fileName).size(), 10);
+}
+
+void TestHttpAccessLog::prometheusText()
+{
+    RHttpAccessLog accessLog(2,1,RHttpAccessLog::Text,QString());
+    accessLog.append(buildRecord("alice",RError::None));
+    accessLog.append(buildRecord("alice",RError::None));
+    accessLog.append(buildRecord("alice",RError::None));
+
+    const QByteArray text = accessLog.toPrometheusText();
+    QVERIFY(text.contains("# TYPE range_cloud_access_log_records_total counter\n"));
+    QVERIFY(text.contains("range_cloud_access_log_records_total{outcome=\"dropped\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_access_log_queued 2\n"));
+}
+
+void TestHttpAccessLog::benchmarkAppend()
+{
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    // Cost paid by the server thread per request, formatting happens on the writer thread.
+    QTemporaryDir directory;
+    RHttpAccessLog accessLog(1 << 16,1,RHttpAccessLog::Text,directory.filePath("access.log"));
+    const RHttpAccessLog::Record record = buildRecord("alice",RError::None);
+    QBENCHMARK
+    {
+        if (!accessLog.append(record))
+        {
+            accessLog.flush();
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestHttpAccessLog)
+#include "tst_http_access_log.moc"
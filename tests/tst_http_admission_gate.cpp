@@ -0,0 +1,163 @@
+#include <QtTest>
+#include <QUrlQuery>
+
+#include <memory>
+
+#include "rcl_http_admission_gate.h"
+
+class TestHttpAdmissionGate : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Return gate rejecting requests whose Content-Length exceeds given size and recording inspected heads.
+    static RHttpAdmissionGate *createGate(qint64 maxContentLength, QList<RHttpAdmissionGate::RequestHead> *pHeads);
+
+private slots:
+
+    void parseHead();
+    void parseInvalidHead();
+    void splitHead();
+    void keepAliveRequests();
+    void rejectBeforeBody();
+    void chunkedBodyPassesThrough();
+    void oversizedHeadPassesThrough();
+    void response();
+};
+
+RHttpAdmissionGate *TestHttpAdmissionGate::createGate(qint64 maxContentLength, QList<RHttpAdmissionGate::RequestHead> *pHeads)
+{
+    return new RHttpAdmissionGate([maxContentLength, pHeads](const RHttpAdmissionGate::RequestHead &requestHead)
+    {
+        pHeads->append(requestHead);
+        if (requestHead.contentLength > maxContentLength)
+        {
+            return RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::PayloadTooLarge);
+        }
+        return RHttpAdmissionGate::Verdict();
+    },"range-cloud");
+}
+
+void TestHttpAdmissionGate::parseHead()
+{
+    RHttpAdmissionGate::RequestHead requestHead;
+    QVERIFY(RHttpAdmissionGate::parseHead("\r\nPUT /file-upload/?resource-name=a.txt&auth-user=alice HTTP/1.1\r\n"
+                                          "Host: localhost\r\n"
+                                          "Content-Length: 1048576\r\n"
+                                          "Expect: 100-continue\r\n\r\n",requestHead));
+    QCOMPARE(requestHead.method, QByteArray("PUT"));
+    QCOMPARE(requestHead.url.path(), QString("/file-upload/"));
+    QCOMPARE(QUrlQuery(requestHead.url).queryItemValue("resource-name"), QString("a.txt"));
+    QCOMPARE(requestHead.contentLength, qint64(1048576));
+    QVERIFY(requestHead.expectContinue);
+    QVERIFY(!requestHead.chunked);
+    QCOMPARE(requestHead.headers.value(QHttpHeaders::WellKnownHeader::Host), QByteArrayView("localhost"));
+
+    RHttpAdmissionGate::RequestHead chunkedHead;
+    QVERIFY(RHttpAdmissionGate::parseHead("POST /file-upload/ HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",chunkedHead));
+    QVERIFY(chunkedHead.chunked);
+    QCOMPARE(chunkedHead.contentLength, qint64(-1));
+}
+
+void TestHttpAdmissionGate::parseInvalidHead()
+{
+    RHttpAdmissionGate::RequestHead requestHead;
+    QVERIFY(!RHttpAdmissionGate::parseHead("PUT /file-upload/\r\n\r\n",requestHead));
+    QVERIFY(!RHttpAdmissionGate::parseHead("PRI * HTTP/2.0\r\n\r\n",requestHead));
+    QVERIFY(!RHttpAdmissionGate::parseHead("PUT /file-upload/ HTTP/1.1\r\nContent-Length: many\r\n\r\n",requestHead));
+    QVERIFY(!RHttpAdmissionGate::parseHead("PUT /file-upload/ HTTP/1.1\r\nno separator\r\n\r\n",requestHead));
+}
+
+void TestHttpAdmissionGate::splitHead()
+{
+    QList<RHttpAdmissionGate::RequestHead> heads;
+    std::unique_ptr<RHttpAdmissionGate> pGate(createGate(100,&heads));
+
+    const QByteArray request = "PUT /file-upload/ HTTP/1.1\r\nContent-Length: 10\r\n\r\n0123456789";
+    RHttpAdmissionGate::Verdict verdict;
+    // Feed byte by byte, head end may be split anywhere.
+    for (char byte : request)
+    {
+        QVERIFY(pGate->inspect(QByteArray(1,byte),verdict));
+    }
+    QCOMPARE(heads.size(), 1);
+    QCOMPARE(heads.first().contentLength, qint64(10));
+    QCOMPARE(pGate->getState(), RHttpAdmissionGate::ReadingHead);
+}
+
+void TestHttpAdmissionGate::keepAliveRequests()
+{
+    QList<RHttpAdmissionGate::RequestHead> heads;
+    std::unique_ptr<RHttpAdmissionGate> pGate(createGate(100,&heads));
+
+    // Body which looks like a request head is skipped, not inspected.
+    const QByteArray body = "GET /fake/ HTTP/1.1\r\n\r\n";
+    const QByteArray data = "PUT /file-upload/ HTTP/1.1\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body
+                          + "GET /file-info/ HTTP/1.1\r\n\r\n"
+                          + "PUT /file-replace/ HTTP/1.1\r\nContent-Length: 4\r\n\r\nabcd";
+    RHttpAdmissionGate::Verdict verdict;
+    QVERIFY(pGate->inspect(data.left(40),verdict));
+    QVERIFY(pGate->inspect(data.mid(40),verdict));
+
+    QCOMPARE(heads.size(), 3);
+    QCOMPARE(heads.at(0).url.path(), QString("/file-upload/"));
+    QCOMPARE(heads.at(1).url.path(), QString("/file-info/"));
+    QCOMPARE(heads.at(2).url.path(), QString("/file-replace/"));
+    QCOMPARE(pGate->getState(), RHttpAdmissionGate::ReadingHead);
+}
+
+void TestHttpAdmissionGate::rejectBeforeBody()
+{
+    QList<RHttpAdmissionGate::RequestHead> heads;
+    std::unique_ptr<RHttpAdmissionGate> pGate(createGate(100,&heads));
+
+    RHttpAdmissionGate::Verdict verdict;
+    QVERIFY(!pGate->inspect("PUT /file-upload/ HTTP/1.1\r\nContent-Length: 1000000\r\nExpect: 100-continue\r\n\r\n",verdict));
+    QVERIFY(!verdict.admitted);
+    QCOMPARE(verdict.statusCode, QHttpServerResponse::StatusCode::PayloadTooLarge);
+    QCOMPARE(pGate->getState(), RHttpAdmissionGate::Rejected);
+
+    // Anything sent afterwards is not inspected.
+    QVERIFY(!pGate->inspect("GET /file-info/ HTTP/1.1\r\n\r\n",verdict));
+    QCOMPARE(heads.size(), 1);
+}
+
+void TestHttpAdmissionGate::chunkedBodyPassesThrough()
+{
+    QList<RHttpAdmissionGate::RequestHead> heads;
+    std::unique_ptr<RHttpAdmissionGate> pGate(createGate(100,&heads));
+
+    RHttpAdmissionGate::Verdict verdict;
+    QVERIFY(pGate->inspect("PUT /file-upload/ HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n",verdict));
+    QCOMPARE(heads.size(), 1);
+    QCOMPARE(pGate->getState(), RHttpAdmissionGate::PassThrough);
+    QVERIFY(pGate->inspect("PUT /file-upload/ HTTP/1.1\r\nContent-Length: 1000000\r\n\r\n",verdict));
+    QCOMPARE(heads.size(), 1);
+}
+
+void TestHttpAdmissionGate::oversizedHeadPassesThrough()
+{
+    QList<RHttpAdmissionGate::RequestHead> heads;
+    std::unique_ptr<RHttpAdmissionGate> pGate(createGate(100,&heads));
+
+    RHttpAdmissionGate::Verdict verdict;
+    QVERIFY(pGate->inspect("PUT /file-upload/ HTTP/1.1\r\nX-Padding: " + QByteArray(RHttpAdmissionGate::maxHeadSize,'x'),verdict));
+    QCOMPARE(pGate->getState(), RHttpAdmissionGate::PassThrough);
+    QVERIFY(heads.isEmpty());
+}
+
+void TestHttpAdmissionGate::response()
+{
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::RetryAfter,"2");
+    const QByteArray response = RHttpAdmissionGate::buildResponse(RHttpAdmissionGate::Verdict::reject(QHttpServerResponse::StatusCode::TooManyRequests,headers),"range-cloud");
+    QVERIFY(response.startsWith("HTTP/1.1 429 Too Many Requests\r\n"));
+    QVERIFY(response.contains("\r\nretry-after: 2\r\n"));
+    QVERIFY(response.contains("\r\nServer: range-cloud\r\n"));
+    QVERIFY(response.contains("\r\nConnection: close\r\n"));
+    QVERIFY(response.endsWith("Content-Length: 0\r\nConnection: close\r\n\r\n"));
+}
+
+QTEST_APPLESS_MAIN(TestHttpAdmissionGate)
+#include "tst_http_admission_gate.moc"
@@ -0,0 +1,141 @@
+#include <QtTest>
+
+#include <rbl_error.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_batch_action_handler.h"
+#include "rcl_http_request_dispatcher.h"
+
+class EchoActionHandler : public RHttpActionHandler
+{
+
+    public:
+
+        RHttpMessage processRequest(const RHttpMessage &requestMessage) override
+        {
+            if (requestMessage.getBody() == "fail")
+            {
+                throw RError(RError::InvalidInput,R_ERROR_REF,"Request failed");
+            }
+            RHttpMessage replyMessage;
+            replyMessage.setBody(requestMessage.getOwner().toUtf8() + ":" +
+                                 requestMessage.getProperties().value(RCloudAction::Action::key).toUtf8() + ":" +
+                                 requestMessage.getBody());
+            return replyMessage;
+        }
+
+};
+
+class TestHttpBatchActionHandler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void jsonRoundTrip();
+    void invalidJson();
+    void validate();
+    void handledInProcess();
+    void processRequest();
+};
+
+void TestHttpBatchActionHandler::jsonRoundTrip()
+{
+    RCloudAction action(QUuid::createUuid(),"alice","token",RCloudAction::Action::FileUpdateTags::key,QString(),QUuid::createUuid(),QByteArray("a,b\n\0c",6));
+    action.setErrorType(RError::NotFound);
+
+    bool ok = false;
+    const QList<RCloudAction> actions = RCloudAction::batchFromJson(RCloudAction::batchToJson({action}),&ok);
+    QVERIFY(ok);
+    QCOMPARE(actions.size(), qsizetype(1));
+    QCOMPARE(actions.at(0).getId(), action.getId());
+    QCOMPARE(actions.at(0).getAction(), action.getAction());
+    QCOMPARE(actions.at(0).getResourceId(), action.getResourceId());
+    QCOMPARE(actions.at(0).getData(), action.getData());
+    QCOMPARE(actions.at(0).getErrorType(), RError::NotFound);
+    // Credentials belong to the batch request, not to its items.
+    QVERIFY(actions.at(0).getExecutor().isEmpty());
+    QVERIFY(actions.at(0).getAuthToken().isEmpty());
+}
+
+void TestHttpBatchActionHandler::invalidJson()
+{
+    bool ok = true;
+    QVERIFY(RCloudAction::batchFromJson("{}",&ok).isEmpty());
+    QVERIFY(!ok);
+    QVERIFY(RCloudAction::batchFromJson("[1,2]",&ok).isEmpty());
+    QVERIFY(!ok);
+    QVERIFY(RCloudAction::batchFromJson("[",&ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void TestHttpBatchActionHandler::validate()
+{
+    const RCloudAction info(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileInfo::key,QString(),QUuid::createUuid(),QByteArray());
+    const RCloudAction upload(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpload::key,"a.txt",QUuid(),"data");
+    const RCloudAction nested(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::Batch::key,QString(),QUuid(),QByteArray());
+
+    QString errorMessage;
+    QVERIFY(RHttpBatchActionHandler::validate(RCloudAction::batchToJson({info,info}),2,errorMessage));
+    QVERIFY(!RHttpBatchActionHandler::validate(RCloudAction::batchToJson({info,info,info}),2,errorMessage));
+    QVERIFY(!RHttpBatchActionHandler::validate(RCloudAction::batchToJson({}),2,errorMessage));
+    QVERIFY(!RHttpBatchActionHandler::validate(RCloudAction::batchToJson({info,upload}),2,errorMessage));
+    QVERIFY(!RHttpBatchActionHandler::validate(RCloudAction::batchToJson({nested}),2,errorMessage));
+    QVERIFY(!RHttpBatchActionHandler::validate("not json",2,errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestHttpBatchActionHandler::handledInProcess()
+{
+    RHttpRequestDispatcher dispatcher(1);
+    EchoActionHandler handler;
+    dispatcher.setHandler(RCloudAction::Action::FileInfo::key,&handler);
+
+    const RCloudAction info(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileInfo::key,QString(),QUuid::createUuid(),QByteArray());
+    const RCloudAction tags(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateTags::key,QString(),QUuid::createUuid(),"a");
+
+    QVERIFY(RHttpBatchActionHandler::isHandledInProcess(dispatcher,RCloudAction::batchToJson({info})));
+    QVERIFY(!RHttpBatchActionHandler::isHandledInProcess(dispatcher,RCloudAction::batchToJson({info,tags})));
+}
+
+void TestHttpBatchActionHandler::processRequest()
+{
+    RHttpRequestDispatcher dispatcher(1);
+    EchoActionHandler handler;
+    dispatcher.setHandler(RCloudAction::Action::FileUpdateVersion::key,&handler);
+    dispatcher.setHandler(RCloudAction::Action::FileUpdateTags::key,&handler);
+    RHttpBatchActionHandler batchHandler(&dispatcher);
+
+    const QUuid fileId = QUuid::createUuid();
+    const QList<RCloudAction> items = {
+        RCloudAction(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateVersion::key,QString(),fileId,"1.0.1"),
+        RCloudAction(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateTags::key,QString(),fileId,"fail"),
+        RCloudAction(QUuid::createUuid(),QString(),QString(),RCloudAction::Action::FileUpdateTags::key,QString(),fileId,"a,b")
+    };
+
+    RHttpMessage requestMessage;
+    requestMessage.setOwner("alice");
+    requestMessage.setBody(RCloudAction::batchToJson(items));
+
+    const RHttpMessage replyMessage = batchHandler.processRequest(requestMessage);
+    QCOMPARE(replyMessage.getErrorType(), RError::None);
+
+    bool ok = false;
+    const QList<RCloudAction> results = RCloudAction::batchFromJson(replyMessage.getBody(),&ok);
+    QVERIFY(ok);
+    QCOMPARE(results.size(), items.size());
+    for (qsizetype i = 0; i < items.size(); i++)
+    {
+        QCOMPARE(results.at(i).getId(), items.at(i).getId());
+        QCOMPARE(results.at(i).getResourceId(), fileId);
+    }
+    QCOMPARE(results.at(0).getErrorType(), RError::None);
+    QCOMPARE(results.at(0).getData(), QByteArray("alice:file-update-version:1.0.1"));
+    // Failed item does not fail the others.
+    QCOMPARE(results.at(1).getErrorType(), RError::InvalidInput);
+    QCOMPARE(results.at(2).getErrorType(), RError::None);
+    QCOMPARE(results.at(2).getData(), QByteArray("alice:file-update-tags:a,b"));
+}
+
+QTEST_APPLESS_MAIN(TestHttpBatchActionHandler)
+#include "tst_http_batch_action_handler.moc"
@@ -0,0 +1,68 @@
+#include <QtTest>
+#include <QBuffer>
+
+#include "rcl_http_body_device.h"
+
+class TestHttpBodyDevice : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void nullSource();
+    void readWholeBody();
+    void independentViews();
+    void writeIsRejected();
+};
+
+static QSharedPointer<QIODevice> createSource(const QByteArray &content)
+{
+    QSharedPointer<QBuffer> buffer(new QBuffer);
+    buffer->setData(content);
+    buffer->open(QIODevice::ReadOnly);
+    return buffer;
+}
+
+void TestHttpBodyDevice::nullSource()
+{
+    RHttpBodyDevice device(QSharedPointer<QIODevice>{});
+    QVERIFY(!device.isOpen());
+    QCOMPARE(device.size(), qint64(0));
+}
+
+void TestHttpBodyDevice::readWholeBody()
+{
+    const QByteArray content("0123456789abcdef");
+    RHttpBodyDevice device(createSource(content));
+    QVERIFY(device.isOpen());
+    QVERIFY(!device.isSequential());
+    QCOMPARE(device.size(), qint64(content.size()));
+
+    QCOMPARE(device.read(4), QByteArray("0123"));
+    QCOMPARE(device.readAll(), QByteArray("456789abcdef"));
+    QVERIFY(device.atEnd());
+
+    QVERIFY(device.seek(10));
+    QCOMPARE(device.read(2), QByteArray("ab"));
+}
+
+void TestHttpBodyDevice::independentViews()
+{
+    QSharedPointer<QIODevice> source = createSource("abcdefgh");
+    RHttpBodyDevice device1(source);
+    RHttpBodyDevice device2(source);
+
+    QCOMPARE(device1.read(3), QByteArray("abc"));
+    QCOMPARE(device2.read(2), QByteArray("ab"));
+    QCOMPARE(device1.read(3), QByteArray("def"));
+    QCOMPARE(device2.readAll(), QByteArray("cdefgh"));
+}
+
+void TestHttpBodyDevice::writeIsRejected()
+{
+    RHttpBodyDevice device(createSource("abc"));
+    QCOMPARE(device.write("x"), qint64(-1));
+}
+
+QTEST_APPLESS_MAIN(TestHttpBodyDevice)
+#include "tst_http_body_device.moc"
@@ -0,0 +1,232 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtTest>
+
+#include "rcl_cloud_action.h"
+#include "rcl_file_info.h"
+#include "rcl_http_change_feed.h"
+
+class TestHttpChangeFeed : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void resetOnUnknownCursor();
+    void changesAfterCursor();
+    void waiterIsWokenUp();
+    void stopWaiting();
+    void forgottenChanges();
+    void feedsDifferPerUser();
+    void sharedFileResetsAllClients();
+    void findChanges();
+    void changeSetJson();
+};
+
+static QJsonObject buildFileInfoJson(const QUuid &id, const QString &path, const QString &owner, RAccessMode::ModeMask groupModeMask = RAccessMode::None)
+{
+    RAccessOwner accessOwner;
+    accessOwner.setUser(owner);
+    RAccessMode accessMode;
+    accessMode.setUserModeMask(RAccessMode::RW);
+    accessMode.setGroupModeMask(groupModeMask);
+    RAccessRights accessRights;
+    accessRights.setOwner(accessOwner);
+    accessRights.setMode(accessMode);
+    RFileInfo fileInfo;
+    fileInfo.setId(id);
+    fileInfo.setPath(path);
+    fileInfo.setAccessRights(accessRights);
+    fileInfo.setMd5Checksum("d41d8cd98f00b204e9800998ecf8427e");
+    return fileInfo.toJson();
+}
+
+static RFileChange buildChange(const QString &path)
+{
+    return RFileChange(QUuid::createUuid(),path,QByteArray(),RFileChange::Updated);
+}
+
+void TestHttpChangeFeed::resetOnUnknownCursor()
+{
+    RHttpChangeFeed feed;
+    QFuture<RFileChangeSet> future;
+
+    // First request of a client.
+    QCOMPARE(feed.wait("alice",0,future), quint64(0));
+    QVERIFY(future.isFinished());
+    QVERIFY(future.result().getReset());
+    QCOMPARE(future.result().getCursor(), feed.getCursor());
+
+    // Cursor of a previous server run.
+    QCOMPARE(feed.wait("alice",feed.getCursor() - 1,future), quint64(0));
+    QVERIFY(future.result().getReset());
+
+    // Cursor from the future.
+    QCOMPARE(feed.wait("alice",feed.getCursor() + 1,future), quint64(0));
+    QVERIFY(future.result().getReset());
+}
+
+void TestHttpChangeFeed::changesAfterCursor()
+{
+    RHttpChangeFeed feed;
+    const quint64 cursor = feed.getCursor();
+    feed.publish("alice",buildChange("a.txt"));
+    feed.publish("alice",buildChange("b.txt"));
+
+    QFuture<RFileChangeSet> future;
+    QCOMPARE(feed.wait("alice",cursor,future), quint64(0));
+    QVERIFY(!future.result().getReset());
+    QCOMPARE(future.result().getChanges().size(), 2);
+    QCOMPARE(future.result().getChanges().at(1).getPath(), QString("b.txt"));
+    QCOMPARE(future.result().getCursor(), feed.getCursor());
+
+    // Nothing new after the returned cursor.
+    QVERIFY(feed.wait("alice",future.result().getCursor(),future) != 0);
+    QVERIFY(!future.isFinished());
+}
+
+void TestHttpChangeFeed::waiterIsWokenUp()
+{
+    RHttpChangeFeed feed;
+    QFuture<RFileChangeSet> future;
+    QVERIFY(feed.wait("alice",feed.getCursor(),future) != 0);
+    QCOMPARE(feed.getWaitingCount(), qsizetype(1));
+
+    feed.publish("alice",buildChange("a.txt"));
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.result().getChanges().size(), 1);
+    QCOMPARE(future.result().getCursor(), feed.getCursor());
+    QCOMPARE(feed.getWaitingCount(), qsizetype(0));
+}
+
+void TestHttpChangeFeed::stopWaiting()
+{
+    RHttpChangeFeed feed;
+    QFuture<RFileChangeSet> future;
+    const quint64 waiterId = feed.wait("alice",feed.getCursor(),future);
+    QVERIFY(waiterId != 0);
+
+    feed.stopWaiting("alice",waiterId);
+    QVERIFY(future.isFinished());
+    QVERIFY(!future.result().getReset());
+    QVERIFY(future.result().getChanges().isEmpty());
+    QCOMPARE(feed.getWaitingCount(), qsizetype(0));
+
+    // Waiter which was already answered is ignored.
+    feed.stopWaiting("alice",waiterId);
+    feed.stopWaiting("bob",waiterId);
+}
+
+void TestHttpChangeFeed::forgottenChanges()
+{
+    RHttpChangeFeed feed(2);
+    const quint64 cursor = feed.getCursor();
+    feed.publish("alice",buildChange("a.txt"));
+    feed.publish("alice",buildChange("b.txt"));
+    feed.publish("alice",buildChange("c.txt"));
+
+    QFuture<RFileChangeSet> future;
+    QCOMPARE(feed.wait("alice",cursor,future), quint64(0));
+    QVERIFY(future.result().getReset());
+
+    // Client which has seen the first change still gets the rest.
+    QCOMPARE(feed.wait("alice",cursor + 1,future), quint64(0));
+    QVERIFY(!future.result().getReset());
+    QCOMPARE(future.result().getChanges().size(), 2);
+}
+
+void TestHttpChangeFeed::feedsDifferPerUser()
+{
+    RHttpChangeFeed feed;
+    QFuture<RFileChangeSet> bobFuture;
+    QVERIFY(feed.wait("bob",feed.getCursor(),bobFuture) != 0);
+
+    feed.publish("alice",buildChange("a.txt"));
+    QVERIFY(!bobFuture.isFinished());
+
+    feed.publish("bob",buildChange("b.txt"));
+    QVERIFY(bobFuture.isFinished());
+    QCOMPARE(bobFuture.result().getChanges().at(0).getPath(), QString("b.txt"));
+}
+
+void TestHttpChangeFeed::sharedFileResetsAllClients()
+{
+    RHttpChangeFeed feed;
+    const quint64 cursor = feed.getCursor();
+    QFuture<RFileChangeSet> bobFuture;
+    QVERIFY(feed.wait("bob",cursor,bobFuture) != 0);
+
+    // Private file is reported to its owner only.
+    const QUuid id = QUuid::createUuid();
+    feed.publishResponse(RCloudAction::Action::FileUpload::key,"alice",QJsonDocument(buildFileInfoJson(id,"a.txt","alice")).toJson());
+    QVERIFY(!bobFuture.isFinished());
+
+    // Group members who can read the file are not known, every client lists files.
+    feed.publishResponse(RCloudAction::Action::FileUpdateTags::key,"alice",QJsonDocument(buildFileInfoJson(id,"a.txt","alice",RAccessMode::R)).toJson());
+    QVERIFY(bobFuture.isFinished());
+    QVERIFY(bobFuture.result().getReset());
+    QCOMPARE(bobFuture.result().getCursor(), feed.getCursor());
+
+    // Client which has not waited yet is reset too, client with the new cursor is not.
+    QFuture<RFileChangeSet> carolFuture;
+    QCOMPARE(feed.wait("carol",cursor,carolFuture), quint64(0));
+    QVERIFY(carolFuture.result().getReset());
+    QVERIFY(feed.wait("bob",bobFuture.result().getCursor(),bobFuture) != 0);
+
+    // Access rights change may hide the file from former readers.
+    bool isShared = false;
+    RHttpChangeFeed::findChanges(RCloudAction::Action::FileUpdateAccessMode::key,QJsonDocument(buildFileInfoJson(id,"a.txt","alice")).toJson(),&isShared);
+    QVERIFY(isShared);
+}
+
+void TestHttpChangeFeed::findChanges()
+{
+    const QUuid id = QUuid::createUuid();
+    const QByteArray uploadBody = QJsonDocument(buildFileInfoJson(id,"a.txt","alice")).toJson();
+
+    QList<std::pair<QString,RFileChange>> changes = RHttpChangeFeed::findChanges(RCloudAction::Action::FileUpload::key,uploadBody);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).first, QString("alice"));
+    QCOMPARE(changes.at(0).second.getId(), id);
+    QCOMPARE(changes.at(0).second.getOperation(), RFileChange::Created);
+
+    changes = RHttpChangeFeed::findChanges(RCloudAction::Action::FileRemove::key,uploadBody);
+    QCOMPARE(changes.at(0).second.getOperation(), RFileChange::Removed);
+
+    QJsonObject replaceJson;
+    replaceJson["upload"] = buildFileInfoJson(QUuid::createUuid(),"a.txt","alice");
+    replaceJson["remove"] = QJsonArray({buildFileInfoJson(id,"a.txt","alice")});
+    changes = RHttpChangeFeed::findChanges(RCloudAction::Action::FileReplace::key,QJsonDocument(replaceJson).toJson());
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes.at(0).second.getOperation(), RFileChange::Created);
+    QCOMPARE(changes.at(1).second.getOperation(), RFileChange::Removed);
+    QCOMPARE(changes.at(1).second.getId(), id);
+
+    RCloudAction succeeded(QUuid::createUuid(),"alice",QString(),RCloudAction::Action::FileUpdateTags::key,QString(),id,uploadBody);
+    RCloudAction failed(QUuid::createUuid(),"alice",QString(),RCloudAction::Action::FileUpdateVersion::key,QString(),id,uploadBody);
+    failed.setErrorType(RError::InvalidInput);
+    changes = RHttpChangeFeed::findChanges(RCloudAction::Action::Batch::key,RCloudAction::batchToJson({succeeded,failed}));
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).second.getOperation(), RFileChange::Updated);
+
+    QVERIFY(RHttpChangeFeed::findChanges(RCloudAction::Action::ListFiles::key,uploadBody).isEmpty());
+    QVERIFY(RHttpChangeFeed::findChanges(RCloudAction::Action::FileUpdate::key,"not json").isEmpty());
+}
+
+void TestHttpChangeFeed::changeSetJson()
+{
+    const RFileChange change(QUuid::createUuid(),"a.txt","d41d8cd98f00b204e9800998ecf8427e",RFileChange::Removed);
+    const RFileChangeSet changeSet(Q_UINT64_C(1760000000000000123),false,{change});
+
+    const RFileChangeSet parsed = RFileChangeSet::fromJson(changeSet.toJson());
+    QCOMPARE(parsed.getCursor(), changeSet.getCursor());
+    QCOMPARE(parsed.getReset(), false);
+    QCOMPARE(parsed.getChanges().size(), 1);
+    QCOMPARE(parsed.getChanges().at(0).getId(), change.getId());
+    QCOMPARE(parsed.getChanges().at(0).getPath(), change.getPath());
+    QCOMPARE(parsed.getChanges().at(0).getMd5Checksum(), change.getMd5Checksum());
+    QCOMPARE(parsed.getChanges().at(0).getOperation(), RFileChange::Removed);
+}
+
+QTEST_APPLESS_MAIN(TestHttpChangeFeed)
+#include "tst_http_change_feed.moc"
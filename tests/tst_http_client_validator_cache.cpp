@@ -0,0 +1,173 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QSslKey>
+#include <QSslServer>
+#include <QSslSocket>
+#include <QTemporaryDir>
+
+#include "rcl_cloud_client.h"
+#include "rcl_http_client_validator_cache.h"
+
+#include "http_test_support.h"
+
+//! Server answering every listing with the same entity tag and recording the validators it received.
+class ListingServer : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        static constexpr const char *entityTag = "\"listing-1\"";
+
+        QSslServer server;
+        //! If-None-Match header of each request (empty if not sent).
+        QList<QByteArray> receivedValidators;
+
+        bool listen(const QString &certificateFile, const QString &keyFile)
+        {
+            QFile keyDevice(keyFile);
+            if (!keyDevice.open(QIODevice::ReadOnly))
+            {
+                return false;
+            }
+            QSslConfiguration sslConfiguration = QSslConfiguration::defaultConfiguration();
+            sslConfiguration.setLocalCertificateChain(QSslCertificate::fromPath(certificateFile));
+            sslConfiguration.setPrivateKey(QSslKey(&keyDevice, QSsl::Ec));
+            sslConfiguration.setPeerVerifyMode(QSslSocket::VerifyNone);
+            this->server.setSslConfiguration(sslConfiguration);
+
+            QObject::connect(&this->server, &QSslServer::pendingConnectionAvailable, this, [this]()
+            {
+                while (QTcpSocket *pSocket = this->server.nextPendingConnection())
+                {
+                    QObject::connect(pSocket, &QTcpSocket::disconnected, pSocket, &QObject::deleteLater);
+                    QObject::connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]()
+                    {
+                        pSocket->setProperty("head", pSocket->property("head").toByteArray() + pSocket->readAll());
+                        const QByteArray head = pSocket->property("head").toByteArray();
+                        if (!head.contains("\r\n\r\n"))
+                        {
+                            return;
+                        }
+                        this->answer(pSocket, head);
+                    });
+                }
+            });
+            return this->server.listen(QHostAddress::LocalHost, 0);
+        }
+
+    private:
+
+        void answer(QTcpSocket *pSocket, const QByteArray &head)
+        {
+            QByteArray validator;
+            for (const QByteArray &line : head.split('\n'))
+            {
+                if (line.toLower().startsWith("if-none-match:"))
+                {
+                    validator = line.mid(14).trimmed();
+                }
+            }
+            this->receivedValidators.append(validator);
+
+            if (validator == ListingServer::entityTag)
+            {
+                pSocket->write(QByteArray("HTTP/1.1 304 Not Modified\r\nETag: ") + ListingServer::entityTag + "\r\nConnection: close\r\n\r\n");
+            }
+            else
+            {
+                const QByteArray body("[]");
+                pSocket->write(QByteArray("HTTP/1.1 200 OK\r\nETag: ") + ListingServer::entityTag
+                               + "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size())
+                               + "\r\nConnection: close\r\n\r\n" + body);
+            }
+            pSocket->disconnectFromHost();
+        }
+
+};
+
+class TestHttpClientValidatorCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void findInsertedListing();
+    void removeListing();
+    void cacheIsBounded();
+    void secondListingIsConditional();
+};
+
+void TestHttpClientValidatorCache::findInsertedListing()
+{
+    RHttpClientValidatorCache cache;
+    QVERIFY(cache.findEntityTag("https://localhost/list-files").isEmpty());
+
+    cache.insert("https://localhost/list-files", "\"a\"", "[1]");
+    QCOMPARE(cache.findEntityTag("https://localhost/list-files"), QByteArray("\"a\""));
+    QByteArray body;
+    QVERIFY(cache.findBody("https://localhost/list-files", body));
+    QCOMPARE(body, QByteArray("[1]"));
+    QVERIFY(cache.findEntityTag("https://localhost/list-users").isEmpty());
+
+    cache.insert("https://localhost/list-files", "\"b\"", "[2]");
+    QCOMPARE(cache.size(), qsizetype(1));
+    QCOMPARE(cache.findEntityTag("https://localhost/list-files"), QByteArray("\"b\""));
+}
+
+void TestHttpClientValidatorCache::removeListing()
+{
+    RHttpClientValidatorCache cache;
+    cache.insert("https://localhost/list-files", "\"a\"", "[1]");
+    cache.remove("https://localhost/list-files");
+
+    QByteArray body;
+    QVERIFY(!cache.findBody("https://localhost/list-files", body));
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestHttpClientValidatorCache::cacheIsBounded()
+{
+    RHttpClientValidatorCache cache(4);
+    for (int i = 0; i < 10; i++)
+    {
+        cache.insert(QString("https://localhost/list-files?page=%1").arg(i), "\"a\"", "[]");
+        QVERIFY(cache.size() <= 4);
+    }
+}
+
+void TestHttpClientValidatorCache::secondListingIsConditional()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString certificateFile = directory.filePath("server.crt");
+    const QString keyFile = directory.filePath("server.key");
+    if (!HttpTestSupport::generateCertificate(certificateFile, keyFile))
+    {
+        QSKIP("OpenSSL command line tool is not available to generate a certificate");
+    }
+
+    ListingServer listingServer;
+    QVERIFY(listingServer.listen(certificateFile, keyFile));
+
+    RHttpClientSettings httpClientSettings;
+    httpClientSettings.setUrl(RHttpClient::buildUrl("localhost", listingServer.server.serverPort()));
+    httpClientSettings.setTlsTrustStore(RTlsTrustStore(certificateFile));
+
+    // Each request is sent by its own HTTP client.
+    RCloudClient cloudClient(RHttpClient::Public, httpClientSettings);
+    cloudClient.setBlocking(false);
+    QSignalSpy finishedSpy(&cloudClient, &RCloudClient::finished);
+
+    cloudClient.requestListFiles("user", "token");
+    QVERIFY(finishedSpy.wait(10000));
+    cloudClient.requestListFiles("user", "token");
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(listingServer.receivedValidators.size(), 2);
+    QVERIFY(listingServer.receivedValidators.at(0).isEmpty());
+    QCOMPARE(listingServer.receivedValidators.at(1), QByteArray(ListingServer::entityTag));
+}
+
+QTEST_GUILESS_MAIN(TestHttpClientValidatorCache)
+#include "tst_http_client_validator_cache.moc"
@@ -0,0 +1,453 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QScopeGuard>
+#include <QSignalSpy>
+#include <QSslSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
+#include "rcl_http_connection_manager.h"
+#include "rcl_http_connection_metrics.h"
+#include "rcl_http_server.h"
+#include "rcl_http_server_handler_registry.h"
+
+#include "http_test_support.h"
+
+class TestHttpConnectionManager : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Loopback listener accepting connections of unit tests.
+    QTcpServer listener;
+    //! Client ends of connections.
+    QList<QTcpSocket*> clientSockets;
+
+    //! Open loopback connection and return its server end.
+    QTcpSocket *openConnection();
+
+    //! Return resident set size of this process in kilobytes (-1 if unknown).
+    static qint64 findResidentSetSize();
+
+    //! Return number of connections which this process can hold (both ends are in the process).
+    //! If raiseLimit is true, the soft limit of open files is raised to the hard one first.
+    static int findConnectionLimit(bool raiseLimit);
+
+    //! Send request over given connection and wait for complete response.
+    static bool sendRequest(QSslSocket *pSocket);
+
+private slots:
+
+    void initTestCase();
+    void cleanup();
+    void idleTimeout();
+    void keepAliveTimeout();
+    void streamedResponseKeepsConnectionBusy();
+    void headerTimeout();
+    void bodyProgressExtendsDeadline();
+    void evictLeastRecentlyUsed();
+    void benchmarkIdleConnections_data();
+    void benchmarkIdleConnections();
+};
+
+QTcpSocket *TestHttpConnectionManager::openConnection()
+{
+    QTcpSocket *pClientSocket = new QTcpSocket(this);
+    pClientSocket->connectToHost(QHostAddress::LocalHost, this->listener.serverPort());
+    if (!pClientSocket->waitForConnected(5000) || !this->listener.waitForNewConnection(5000))
+    {
+        delete pClientSocket;
+        return nullptr;
+    }
+    this->clientSockets.append(pClientSocket);
+    return this->listener.nextPendingConnection();
+}
+
+qint64 TestHttpConnectionManager::findResidentSetSize()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return -1;
+    }
+    while (!file.atEnd())
+    {
+        const QByteArray line = file.readLine();
+        if (line.startsWith("VmRSS:"))
+        {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+int TestHttpConnectionManager::findConnectionLimit(bool raiseLimit)
+{
+#ifdef Q_OS_LINUX
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+    {
+        return 0;
+    }
+    if (raiseLimit && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    // Each connection takes two descriptors, some are left for the rest of the process.
+    return int(qMax(qint64(0), (qint64(qMin(limit.rlim_cur, rlim_t(1 << 20))) - 256) / 2));
+#else
+    return 0;
+#endif
+}
+
+bool TestHttpConnectionManager::sendRequest(QSslSocket *pSocket)
+{
+    pSocket->write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QByteArray response;
+    while (true)
+    {
+        const qsizetype headEnd = response.indexOf("\r\n\r\n");
+        if (headEnd >= 0)
+        {
+            qint64 contentLength = 0;
+            const QList<QByteArray> lines = response.left(headEnd).split('\n');
+            for (const QByteArray &line : lines)
+            {
+                if (line.toLower().startsWith("content-length:"))
+                {
+                    contentLength = line.mid(15).trimmed().toLongLong();
+                }
+            }
+            if (response.size() >= headEnd + 4 + contentLength)
+            {
+                return response.startsWith("HTTP/1.1 200");
+            }
+        }
+        if (!pSocket->waitForReadyRead(5000))
+        {
+            return false;
+        }
+        response += pSocket->readAll();
+    }
+}
+
+void TestHttpConnectionManager::initTestCase()
+{
+    QVERIFY(this->listener.listen(QHostAddress::LocalHost, 0));
+}
+
+void TestHttpConnectionManager::cleanup()
+{
+    qDeleteAll(this->clientSockets);
+    this->clientSockets.clear();
+}
+
+void TestHttpConnectionManager::idleTimeout()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,0,QByteArray(),&metrics);
+    QTcpSocket *pSocket = this->openConnection();
+    QVERIFY(pSocket);
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pSocket,now);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::Idle);
+    QCOMPARE(manager.getDeadline(pSocket), now + 1000);
+    QCOMPARE(manager.getIdleCount(), qsizetype(1));
+    QCOMPARE(metrics.getOpenCount(), qint64(1));
+
+    QVERIFY(manager.expire(now + 999).isEmpty());
+    QCOMPARE(manager.expire(now + 1000 + RHttpConnectionManager::resolutionMs), QList<QAbstractSocket*>{pSocket});
+    QVERIFY(!manager.contains(pSocket));
+    QCOMPARE(manager.size(), qsizetype(0));
+    QCOMPARE(metrics.getOpenCount(), qint64(0));
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::IdleTimeout), quint64(1));
+    QVERIFY(metrics.toPrometheusText().contains("range_cloud_connections_closed_total{reason=\"idle-timeout\"} 1\n"));
+}
+
+void TestHttpConnectionManager::keepAliveTimeout()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,0,QByteArray(),&metrics);
+    QTcpSocket *pSocket = this->openConnection();
+    QVERIFY(pSocket);
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pSocket,now);
+    manager.receiveData(pSocket,"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n",now + 10);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::ReadingBody);
+
+    // Request being processed has no deadline, however long it takes.
+    manager.startRequest(pSocket->peerAddress(),pSocket->peerPort());
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::Processing);
+    QCOMPARE(manager.getDeadline(pSocket), qint64(0));
+    QVERIFY(manager.expire(now + 4000).isEmpty());
+
+    manager.sendData(pSocket,now + 4000);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::Idle);
+    QCOMPARE(manager.getDeadline(pSocket), now + 9000);
+    QVERIFY(manager.expire(now + 8999).isEmpty());
+    QCOMPARE(manager.expire(now + 9000 + RHttpConnectionManager::resolutionMs).size(), 1);
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::KeepAliveTimeout), quint64(1));
+}
+
+void TestHttpConnectionManager::streamedResponseKeepsConnectionBusy()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,1,QByteArray(),&metrics);
+    QTcpSocket *pSocket = this->openConnection();
+    QVERIFY(pSocket);
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pSocket,now);
+    manager.receiveData(pSocket,"GET /file-download/ HTTP/1.1\r\nHost: localhost\r\n\r\n",now);
+    manager.startRequest(pSocket->peerAddress(),pSocket->peerPort());
+
+    QBuffer *pBodyDevice = new QBuffer;
+    pBodyDevice->setData("body");
+    pBodyDevice->open(QIODevice::ReadOnly);
+    manager.streamResponse(pSocket->peerAddress(),pSocket->peerPort(),pBodyDevice);
+
+    // Write buffer drained between chunks, the connection is neither idle nor evictable.
+    manager.sendData(pSocket,now + 100);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::Processing);
+    QCOMPARE(manager.getDeadline(pSocket), qint64(0));
+    QCOMPARE(manager.getIdleCount(), qsizetype(0));
+    QTcpSocket *pOtherSocket = this->openConnection();
+    QVERIFY(pOtherSocket);
+    manager.addConnection(pOtherSocket,now + 100);
+    QVERIFY(manager.contains(pSocket));
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::Evicted), quint64(0));
+    manager.removeConnection(pOtherSocket);
+
+    // Responder deletes the device once the body is sent.
+    delete pBodyDevice;
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::Idle);
+    QVERIFY(manager.getDeadline(pSocket) > now);
+    QCOMPARE(manager.getIdleCount(), qsizetype(1));
+}
+
+void TestHttpConnectionManager::headerTimeout()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,0,RHttpServer::serverName,&metrics);
+    QTcpSocket *pSocket = this->openConnection();
+    QVERIFY(pSocket);
+    QTcpSocket *pClientSocket = this->clientSockets.last();
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pSocket,now);
+    manager.receiveData(pSocket,"GET / HTTP/1.1\r\nHost: localhost\r",now);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::ReadingHead);
+    QCOMPARE(manager.getDeadline(pSocket), now + 500);
+
+    // Trickling head does not extend the deadline.
+    manager.receiveData(pSocket,"\nAccept: */*\r\n",now + 400);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::ReadingHead);
+    QCOMPARE(manager.getDeadline(pSocket), now + 500);
+
+    QCOMPARE(manager.expire(now + 500 + RHttpConnectionManager::resolutionMs).size(), 1);
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::HeaderTimeout), quint64(1));
+
+    pSocket->waitForBytesWritten(5000);
+    QVERIFY(pClientSocket->waitForReadyRead(5000));
+    QVERIFY(pClientSocket->readAll().startsWith("HTTP/1.1 408 Request Timeout\r\n"));
+}
+
+void TestHttpConnectionManager::bodyProgressExtendsDeadline()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,0,QByteArray(),&metrics);
+    QTcpSocket *pSocket = this->openConnection();
+    QVERIFY(pSocket);
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pSocket,now);
+    // Empty line ending the head is split between reads.
+    manager.receiveData(pSocket,"PUT /file-upload/ HTTP/1.1\r\nContent-Length: 4096\r\n\r",now);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::ReadingHead);
+    manager.receiveData(pSocket,"\n0123",now);
+    QCOMPARE(manager.getPhase(pSocket), RHttpConnectionManager::ReadingBody);
+    QCOMPARE(manager.getDeadline(pSocket), now + 500);
+
+    manager.receiveData(pSocket,QByteArray(),now + 400);
+    QCOMPARE(manager.getDeadline(pSocket), now + 900);
+    QVERIFY(manager.expire(now + 500 + RHttpConnectionManager::resolutionMs).isEmpty());
+    QVERIFY(manager.contains(pSocket));
+
+    QCOMPARE(manager.expire(now + 900 + RHttpConnectionManager::resolutionMs).size(), 1);
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::BodyTimeout), quint64(1));
+}
+
+void TestHttpConnectionManager::evictLeastRecentlyUsed()
+{
+    RHttpConnectionMetrics metrics;
+    RHttpConnectionManager manager(1000,5000,500,500,2,QByteArray(),&metrics);
+    QSignalSpy pausedSpy(&manager, &RHttpConnectionManager::acceptPaused);
+    QSignalSpy resumedSpy(&manager, &RHttpConnectionManager::acceptResumed);
+    QTcpSocket *pFirstSocket = this->openConnection();
+    QTcpSocket *pSecondSocket = this->openConnection();
+    QTcpSocket *pThirdSocket = this->openConnection();
+    QVERIFY(pFirstSocket && pSecondSocket && pThirdSocket);
+
+    const qint64 now = RHttpServerHandlerRegistry::currentTime();
+    manager.addConnection(pFirstSocket,now);
+    manager.addConnection(pSecondSocket,now + 1);
+    manager.addConnection(pThirdSocket,now + 2);
+    QVERIFY(!manager.contains(pFirstSocket));
+    QCOMPARE(manager.size(), qsizetype(2));
+    QCOMPARE(metrics.getClosedCount(RHttpConnectionMetrics::Evicted), quint64(1));
+
+    // Busy connections are never evicted, accepting stops instead.
+    manager.receiveData(pSecondSocket,"GET",now + 3);
+    QVERIFY(!manager.isPaused());
+    manager.receiveData(pThirdSocket,"GET",now + 3);
+    QVERIFY(manager.isPaused());
+    QCOMPARE(pausedSpy.count(), 1);
+    QCOMPARE(metrics.getAcceptPauseCount(), quint64(1));
+
+    manager.removeConnection(pSecondSocket);
+    QVERIFY(!manager.isPaused());
+    QCOMPARE(resumedSpy.count(), 1);
+}
+
+void TestHttpConnectionManager::benchmarkIdleConnections_data()
+{
+    QTest::addColumn<int>("nIdleConnections");
+
+    // Soak run raises the limit of open files and holds many connections, it needs its own knob.
+    QTest::addRow("0 idle") << 0;
+    const int nSoakConnections = qEnvironmentVariableIntValue("RANGE_SOAK_CONNECTIONS");
+    if (nSoakConnections > 0)
+    {
+        QTest::addRow("%d idle", nSoakConnections) << nSoakConnections;
+    }
+}
+
+void TestHttpConnectionManager::benchmarkIdleConnections()
+{
+    QFETCH(int, nIdleConnections);
+
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+#ifndef Q_OS_LINUX
+    QSKIP("Resident set size is read from /proc");
+#endif
+    const int nActiveConnections = 16;
+    const int connectionLimit = findConnectionLimit(nIdleConnections > 0) - nActiveConnections;
+    if (nIdleConnections > connectionLimit)
+    {
+        qInfo("Limit of open files allows only %d idle connections.", qMax(connectionLimit, 0));
+        nIdleConnections = qMax(connectionLimit, 0);
+    }
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString certificateFile = directory.filePath("server.crt");
+    const QString keyFile = directory.filePath("server.key");
+    if (!HttpTestSupport::generateCertificate(certificateFile, keyFile))
+    {
+        QSKIP("OpenSSL command line tool is not available to generate a certificate");
+    }
+
+    RHttpServerSettings settings;
+    settings.setPort(HttpTestSupport::findFreePort());
+    settings.setTlsKeyStore(RTlsKeyStore(certificateFile, keyFile, QString()));
+    settings.setTlsTrustStore(RTlsTrustStore(certificateFile));
+    settings.setConnectionIdleTimeoutMs(600000);
+    settings.setKeepAliveTimeoutMs(600000);
+    settings.setMaxConnections(uint(nIdleConnections + nActiveConnections + 64));
+
+    QList<QSslSocket*> sockets;
+    QThread serverThread;
+    RHttpServer *pServer = new RHttpServer(RHttpServer::Public, settings);
+    pServer->moveToThread(&serverThread);
+    QObject::connect(&serverThread, &QThread::finished, pServer, &QObject::deleteLater);
+    const auto stopServer = qScopeGuard([&sockets, &serverThread]()
+    {
+        qDeleteAll(sockets);
+        serverThread.quit();
+        serverThread.wait();
+    });
+    QSignalSpy readySpy(pServer, &RHttpServer::ready);
+    serverThread.start();
+    QMetaObject::invokeMethod(pServer, &RHttpServer::start, Qt::BlockingQueuedConnection);
+    QCOMPARE(readySpy.count(), 1);
+
+    int nEncrypted = 0;
+    auto openConnections = [&](int nConnections)
+    {
+        for (int i = 0; i < nConnections; i++)
+        {
+            QSslSocket *pSocket = new QSslSocket;
+            pSocket->setPeerVerifyMode(QSslSocket::VerifyNone);
+            QObject::connect(pSocket, &QSslSocket::encrypted, [&nEncrypted]() { nEncrypted++; });
+            pSocket->connectToHostEncrypted("localhost", settings.getPort());
+            sockets.append(pSocket);
+            // Keep the listen backlog short.
+            if (i % 256 == 255)
+            {
+                QTRY_VERIFY_WITH_TIMEOUT(nEncrypted == sockets.size(), 60000);
+            }
+        }
+        QTRY_VERIFY_WITH_TIMEOUT(nEncrypted == sockets.size(), 60000);
+    };
+
+    openConnections(nActiveConnections);
+    if (QTest::currentTestFailed())
+    {
+        return;
+    }
+    const QList<QSslSocket*> activeSockets = sockets;
+    const qint64 residentSetSize = findResidentSetSize();
+    openConnections(nIdleConnections);
+    if (QTest::currentTestFailed())
+    {
+        return;
+    }
+    if (nIdleConnections > 0)
+    {
+        // Both ends of the connections live in this process.
+        qInfo("Resident set size grew by %.2f kB per idle connection (client and server end).",
+              double(findResidentSetSize() - residentSetSize) / double(nIdleConnections));
+    }
+
+    QList<qint64> latencies;
+    QBENCHMARK
+    {
+        for (QSslSocket *pSocket : activeSockets)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            QVERIFY(sendRequest(pSocket));
+            latencies.append(timer.nsecsElapsed() / 1000);
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    qInfo("Request latency with %d idle connections: p50 = %lld us, p99 = %lld us.",
+          nIdleConnections,
+          latencies.at(latencies.size() / 2),
+          latencies.at(qMin(latencies.size() - 1, latencies.size() * 99 / 100)));
+
+    // Idle connections were neither dropped nor evicted.
+    for (QSslSocket *pSocket : std::as_const(sockets))
+    {
+        QCOMPARE(pSocket->state(), QAbstractSocket::ConnectedState);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestHttpConnectionManager)
+#include "tst_http_connection_manager.moc"
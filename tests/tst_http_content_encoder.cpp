@@ -0,0 +1,195 @@
+#include <QtTest>
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "rcl_file_info.h"
+#include "rcl_http_content_encoder.h"
+#include "rcl_user_info.h"
+
+#include "http_test_support.h"
+
+class TestHttpContentEncoder : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    static QByteArray buildFileListPayload(int nFiles);
+    static QByteArray buildUserListPayload(int nUsers);
+    static void addPayloadRows();
+
+private slots:
+
+    void negotiate_data();
+    void negotiate();
+    void roundTrip_data();
+    void roundTrip();
+    void encodeMessage();
+    void benchmarkEncode_data();
+    void benchmarkEncode();
+};
+
+QByteArray TestHttpContentEncoder::buildFileListPayload(int nFiles)
+{
+    QJsonArray filesArray;
+    for (int i = 0; i < nFiles; i++)
+    {
+        RFileInfo fileInfo;
+        fileInfo.setId(QUuid::createUuid());
+        fileInfo.setSize(qint64(1024) * (i + 1));
+        fileInfo.setCreationDateTime(QDateTime::currentSecsSinceEpoch());
+        fileInfo.setUpdateDateTime(QDateTime::currentSecsSinceEpoch());
+        fileInfo.setPath(QString("projects/model-%1/result-%2.rbin").arg(i / 10).arg(i));
+        fileInfo.setTags({"result", "mesh"});
+        fileInfo.setMd5Checksum(QCryptographicHash::hash(QByteArray::number(i),QCryptographicHash::Md5).toHex());
+        filesArray.append(fileInfo.toJson());
+    }
+    QJsonObject jsonObject;
+    jsonObject["files"] = filesArray;
+    return QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
+}
+
+QByteArray TestHttpContentEncoder::buildUserListPayload(int nUsers)
+{
+    QJsonArray usersArray;
+    for (int i = 0; i < nUsers; i++)
+    {
+        RUserInfo userInfo;
+        userInfo.setName(QString("user-%1").arg(i));
+        userInfo.setGroupNames({"users", QString("group-%1").arg(i % 5)});
+        usersArray.append(userInfo.toJson());
+    }
+    QJsonObject jsonObject;
+    jsonObject["users"] = usersArray;
+    return QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
+}
+
+void TestHttpContentEncoder::addPayloadRows()
+{
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<int>("encoding");
+
+    const QList<RHttpContentEncoder::Encoding> encodings = {RHttpContentEncoder::Gzip, RHttpContentEncoder::Zstd};
+    const QList<QPair<QByteArray,QByteArray>> payloads = {
+        {"list-files/10", buildFileListPayload(10)},
+        {"list-files/1000", buildFileListPayload(1000)},
+        {"list-users/100", buildUserListPayload(100)}
+    };
+
+    for (const QPair<QByteArray,QByteArray> &payload : payloads)
+    {
+        for (RHttpContentEncoder::Encoding encoding : encodings)
+        {
+            if (!RHttpContentEncoder::isAvailable(encoding))
+            {
+                continue;
+            }
+            QByteArray rowName = payload.first + "/" + RHttpContentEncoder::toName(encoding);
+            QTest::newRow(rowName.constData()) << payload.second << int(encoding);
+        }
+    }
+}
+
+void TestHttpContentEncoder::negotiate_data()
+{
+    QTest::addColumn<QByteArray>("acceptEncoding");
+    QTest::addColumn<int>("expected");
+
+    const int best = RHttpContentEncoder::isAvailable(RHttpContentEncoder::Zstd) ? RHttpContentEncoder::Zstd : RHttpContentEncoder::Gzip;
+
+    QTest::newRow("empty") << QByteArray() << int(RHttpContentEncoder::Identity);
+    QTest::newRow("gzip") << QByteArray("gzip") << int(RHttpContentEncoder::Gzip);
+    QTest::newRow("gzip, deflate") << QByteArray("gzip, deflate") << int(RHttpContentEncoder::Gzip);
+    QTest::newRow("case") << QByteArray("GZIP") << int(RHttpContentEncoder::Gzip);
+    QTest::newRow("both") << QByteArray("gzip, zstd") << best;
+    QTest::newRow("wildcard") << QByteArray("*") << best;
+    QTest::newRow("gzip refused") << QByteArray("gzip;q=0") << int(RHttpContentEncoder::Identity);
+    QTest::newRow("wildcard refused") << QByteArray("*;q=0, gzip;q=0") << int(RHttpContentEncoder::Identity);
+    QTest::newRow("gzip preferred") << QByteArray("zstd;q=0.5, gzip;q=1.0") << int(RHttpContentEncoder::Gzip);
+    QTest::newRow("unsupported") << QByteArray("br, deflate") << int(RHttpContentEncoder::Identity);
+}
+
+void TestHttpContentEncoder::negotiate()
+{
+    QFETCH(QByteArray, acceptEncoding);
+    QFETCH(int, expected);
+
+    QCOMPARE(int(RHttpContentEncoder::negotiate(acceptEncoding)), expected);
+}
+
+void TestHttpContentEncoder::roundTrip_data()
+{
+    addPayloadRows();
+}
+
+void TestHttpContentEncoder::roundTrip()
+{
+    QFETCH(QByteArray, payload);
+    QFETCH(int, encoding);
+
+    QByteArray encoded = RHttpContentEncoder::encode(payload, RHttpContentEncoder::Encoding(encoding));
+    QVERIFY(!encoded.isEmpty());
+    QVERIFY(encoded.size() < payload.size());
+    QCOMPARE(RHttpContentEncoder::decode(encoded, RHttpContentEncoder::Encoding(encoding)), payload);
+}
+
+void TestHttpContentEncoder::encodeMessage()
+{
+    const QByteArray payload = buildFileListPayload(50);
+
+    RHttpMessage message;
+    message.setBody(payload);
+    message.setEntityTag("\"v7\"");
+    QVERIFY(RHttpContentEncoder::encodeMessage(message, RHttpContentEncoder::Gzip, 1024));
+    QCOMPARE(message.getResponseHeaders().value(QHttpHeaders::WellKnownHeader::ContentEncoding), QByteArrayView("gzip"));
+    QCOMPARE(message.getResponseHeaders().value(QHttpHeaders::WellKnownHeader::Vary), QByteArrayView("Accept-Encoding"));
+    QCOMPARE(message.getEntityTag(), QByteArray("W/\"v7\""));
+    QCOMPARE(RHttpContentEncoder::decode(message.getBody(), RHttpContentEncoder::Gzip), payload);
+
+    // Already encoded.
+    QVERIFY(!RHttpContentEncoder::encodeMessage(message, RHttpContentEncoder::Gzip, 1024));
+
+    // Below threshold.
+    RHttpMessage smallMessage;
+    smallMessage.setBody("{\"files\":[]}");
+    QVERIFY(!RHttpContentEncoder::encodeMessage(smallMessage, RHttpContentEncoder::Gzip, 1024));
+    QCOMPARE(smallMessage.getBody(), QByteArray("{\"files\":[]}"));
+
+    // Identity.
+    RHttpMessage identityMessage;
+    identityMessage.setBody(payload);
+    QVERIFY(!RHttpContentEncoder::encodeMessage(identityMessage, RHttpContentEncoder::Identity, 0));
+    QCOMPARE(identityMessage.getBody(), payload);
+}
+
+void TestHttpContentEncoder::benchmarkEncode_data()
+{
+    addPayloadRows();
+}
+
+void TestHttpContentEncoder::benchmarkEncode()
+{
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    QFETCH(QByteArray, payload);
+    QFETCH(int, encoding);
+
+    QByteArray encoded;
+    QBENCHMARK
+    {
+        encoded = RHttpContentEncoder::encode(payload, RHttpContentEncoder::Encoding(encoding));
+    }
+
+    qInfo("%s: %lld -> %lld bytes on wire (%.1f %%)",
+          QTest::currentDataTag(),
+          qint64(payload.size()),
+          qint64(encoded.size()),
+          100.0 * double(encoded.size()) / double(payload.size()));
+}
+
+QTEST_APPLESS_MAIN(TestHttpContentEncoder)
+#include "tst_http_content_encoder.moc"
@@ -0,0 +1,204 @@
+#include <QtTest>
+
+#include <algorithm>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_dispatch_lane.h"
+
+class TestHttpDispatchLane : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Run bulk and metadata requests with simulated backend durations and return metadata p99 latency in ms.
+    qint64 simulateMixedLoad(RHttpDispatchLane *pMetadataLane, RHttpDispatchLane *pBulkLane);
+
+    //! Dispatch simulated request which takes given time once it has a slot.
+    void dispatch(RHttpDispatchLane *pLane, int durationMs, const QElapsedTimer &clock, QList<qint64> *pLatencies);
+
+private slots:
+
+    void laneTable();
+    void admission();
+    void fifoHandover();
+    void destroyCancelsWaiting();
+    void prometheusText();
+    void metadataLatencyUnderMixedLoad();
+};
+
+void TestHttpDispatchLane::laneTable()
+{
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::FileUpload::key), RHttpDispatchLane::Bulk);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::FileDownload::key), RHttpDispatchLane::Bulk);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::FileReplace::key), RHttpDispatchLane::Bulk);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::Process::key), RHttpDispatchLane::Admin);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::UserAdd::key), RHttpDispatchLane::Admin);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::ListFiles::key), RHttpDispatchLane::Interactive);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction(RCloudAction::Action::FileInfo::key), RHttpDispatchLane::Interactive);
+    QCOMPARE(RHttpDispatchLane::findTypeForAction("unknown-action"), RHttpDispatchLane::Interactive);
+}
+
+void TestHttpDispatchLane::admission()
+{
+    RHttpDispatchLane lane(RHttpDispatchLane::Interactive, 2, 1);
+
+    QFuture<void> slotFuture;
+    QCOMPARE(lane.acquire(slotFuture), RHttpDispatchLane::Granted);
+    QCOMPARE(lane.acquire(slotFuture), RHttpDispatchLane::Granted);
+    QCOMPARE(lane.acquire(slotFuture), RHttpDispatchLane::Queued);
+    QVERIFY(!slotFuture.isFinished());
+    QFuture<void> rejectedFuture;
+    QCOMPARE(lane.acquire(rejectedFuture), RHttpDispatchLane::Rejected);
+    QCOMPARE(lane.getActiveCount(), qsizetype(2));
+    QCOMPARE(lane.getQueuedCount(), qsizetype(1));
+
+    // Slot is handed over, number of active requests does not change.
+    lane.release();
+    QVERIFY(slotFuture.isFinished());
+    QCOMPARE(lane.getActiveCount(), qsizetype(2));
+    QCOMPARE(lane.getQueuedCount(), qsizetype(0));
+
+    lane.release();
+    lane.release();
+    QCOMPARE(lane.getActiveCount(), qsizetype(0));
+}
+
+void TestHttpDispatchLane::fifoHandover()
+{
+    RHttpDispatchLane lane(RHttpDispatchLane::Bulk, 1, 10);
+
+    QFuture<void> slotFuture;
+    QCOMPARE(lane.acquire(slotFuture), RHttpDispatchLane::Granted);
+
+    QList<QFuture<void>> waiting;
+    for (int i = 0; i < 3; i++)
+    {
+        QFuture<void> waitingFuture;
+        QCOMPARE(lane.acquire(waitingFuture), RHttpDispatchLane::Queued);
+        waiting.append(waitingFuture);
+    }
+
+    for (int i = 0; i < waiting.size(); i++)
+    {
+        lane.release();
+        for (int j = 0; j < waiting.size(); j++)
+        {
+            QCOMPARE(waiting.at(j).isFinished(), j <= i);
+        }
+    }
+}
+
+void TestHttpDispatchLane::destroyCancelsWaiting()
+{
+    QFuture<void> waitingFuture;
+    {
+        RHttpDispatchLane lane(RHttpDispatchLane::Admin, 1, 1);
+        QFuture<void> slotFuture;
+        QCOMPARE(lane.acquire(slotFuture), RHttpDispatchLane::Granted);
+        QCOMPARE(lane.acquire(waitingFuture), RHttpDispatchLane::Queued);
+    }
+    QVERIFY(waitingFuture.isCanceled());
+}
+
+void TestHttpDispatchLane::prometheusText()
+{
+    RHttpDispatchLane interactiveLane(RHttpDispatchLane::Interactive, 1, 1);
+    RHttpDispatchLane bulkLane(RHttpDispatchLane::Bulk, 1, 1);
+
+    QFuture<void> slotFuture;
+    interactiveLane.acquire(slotFuture);
+    interactiveLane.acquire(slotFuture);
+
+    const QByteArray text = RHttpDispatchLane::toPrometheusText({&interactiveLane,&bulkLane});
+    QVERIFY(text.contains("# TYPE range_cloud_http_lane_active gauge\n"));
+    QVERIFY(text.contains("range_cloud_http_lane_active{lane=\"interactive\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_http_lane_queued{lane=\"interactive\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_http_lane_active{lane=\"bulk\"} 0\n"));
+}
+
+void TestHttpDispatchLane::dispatch(RHttpDispatchLane *pLane, int durationMs, const QElapsedTimer &clock, QList<qint64> *pLatencies)
+{
+    const qint64 startTime = clock.elapsed();
+    auto process = [=, &clock]()
+    {
+        QTimer::singleShot(durationMs,this,[=, &clock]()
+        {
+            if (pLatencies)
+            {
+                pLatencies->append(clock.elapsed() - startTime);
+            }
+            pLane->release();
+        });
+    };
+
+    QFuture<void> slotFuture;
+    switch (pLane->acquire(slotFuture))
+    {
+        case RHttpDispatchLane::Granted:
+        {
+            process();
+            break;
+        }
+        case RHttpDispatchLane::Queued:
+        {
+            slotFuture.then(this,process);
+            break;
+        }
+        default:
+        {
+            QFAIL("Request was rejected");
+        }
+    }
+}
+
+qint64 TestHttpDispatchLane::simulateMixedLoad(RHttpDispatchLane *pMetadataLane, RHttpDispatchLane *pBulkLane)
+{
+    const int nBulk = 16;
+    const int nMetadata = 50;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    QList<qint64> latencies;
+    for (int i = 0; i < nBulk; i++)
+    {
+        this->dispatch(pBulkLane,50,clock,nullptr);
+    }
+    for (int i = 0; i < nMetadata; i++)
+    {
+        this->dispatch(pMetadataLane,1,clock,&latencies);
+    }
+
+    if (!QTest::qWaitFor([&]() { return latencies.size() == nMetadata; }, 10000))
+    {
+        return -1;
+    }
+    QTest::qWaitFor([&]() { return pBulkLane->getActiveCount() == 0; }, 10000);
+
+    std::sort(latencies.begin(),latencies.end());
+    return latencies.at(qsizetype(0.99 * (latencies.size() - 1)));
+}
+
+void TestHttpDispatchLane::metadataLatencyUnderMixedLoad()
+{
+    // Single shared lane: metadata requests wait behind bulk transfers.
+    RHttpDispatchLane sharedLane(RHttpDispatchLane::Interactive, 4, 1000);
+    const qint64 sharedP99 = this->simulateMixedLoad(&sharedLane,&sharedLane);
+
+    // Separate lanes: bulk transfers occupy only their own slots.
+    RHttpDispatchLane interactiveLane(RHttpDispatchLane::Interactive, 4, 1000);
+    RHttpDispatchLane bulkLane(RHttpDispatchLane::Bulk, 4, 1000);
+    const qint64 laneP99 = this->simulateMixedLoad(&interactiveLane,&bulkLane);
+
+    qDebug() << "Metadata p99 latency: shared lane =" << sharedP99 << "ms, separate lanes =" << laneP99 << "ms";
+
+    QVERIFY(sharedP99 > 0);
+    QVERIFY(laneP99 >= 0);
+    // Four rounds of 50 ms bulk transfers are ahead of metadata in a shared lane.
+    QVERIFY(sharedP99 >= 150);
+    QVERIFY(laneP99 < sharedP99 / 2);
+}
+
+QTEST_GUILESS_MAIN(TestHttpDispatchLane)
+#include "tst_http_dispatch_lane.moc"
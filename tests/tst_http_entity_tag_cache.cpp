@@ -0,0 +1,100 @@
+#include <QtTest>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_entity_tag_cache.h"
+#include "rcl_http_message.h"
+
+class TestHttpEntityTagCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void findAndExpire();
+    void invalidate();
+    void staleInsertIsDropped();
+    void keysDifferPerUser();
+    void conditionalAction();
+    void entityTagMatches();
+    void messageEntityTag();
+};
+
+void TestHttpEntityTagCache::findAndExpire()
+{
+    RHttpEntityTagCache cache(10,1000);
+    const QString key = RHttpEntityTagCache::buildKey("alice",RCloudAction::Action::ListFiles::key,QString(),QUuid());
+    QVERIFY(cache.find(key,0).isEmpty());
+
+    cache.insert(key,"\"v1\"",cache.getGeneration(),0);
+    QCOMPARE(cache.find(key,999), QByteArray("\"v1\""));
+    QVERIFY(cache.find(key,1000).isEmpty());
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestHttpEntityTagCache::invalidate()
+{
+    RHttpEntityTagCache cache(10,1000);
+    cache.insert("a","\"v1\"",cache.getGeneration(),0);
+    cache.insert("b","\"v2\"",cache.getGeneration(),0);
+    QCOMPARE(cache.size(), qsizetype(2));
+
+    cache.invalidate();
+    QCOMPARE(cache.size(), qsizetype(0));
+    QCOMPARE(cache.getInvalidationCount(), quint64(1));
+    QVERIFY(cache.find("a",1).isEmpty());
+}
+
+void TestHttpEntityTagCache::staleInsertIsDropped()
+{
+    RHttpEntityTagCache cache(10,1000);
+    // Request started before a mutation finished after it.
+    const quint64 generation = cache.getGeneration();
+    cache.invalidate();
+    cache.insert("a","\"v1\"",generation,0);
+    QVERIFY(cache.find("a",1).isEmpty());
+
+    cache.insert("a","\"v2\"",cache.getGeneration(),0);
+    QCOMPARE(cache.find("a",1), QByteArray("\"v2\""));
+}
+
+void TestHttpEntityTagCache::keysDifferPerUser()
+{
+    const QUuid id = QUuid::createUuid();
+    QVERIFY(RHttpEntityTagCache::buildKey("alice",RCloudAction::Action::FileDownload::key,QString(),id)
+            != RHttpEntityTagCache::buildKey("bob",RCloudAction::Action::FileDownload::key,QString(),id));
+    QVERIFY(RHttpEntityTagCache::buildKey("alice",RCloudAction::Action::ListFiles::key,QString(),QUuid())
+            != RHttpEntityTagCache::buildKey("alice",RCloudAction::Action::ListUsers::key,QString(),QUuid()));
+}
+
+void TestHttpEntityTagCache::conditionalAction()
+{
+    QVERIFY(RCloudAction::isConditionalAction(RCloudAction::Action::ListFiles::key));
+    QVERIFY(RCloudAction::isConditionalAction(RCloudAction::Action::FileDownload::key));
+    QVERIFY(!RCloudAction::isConditionalAction(RCloudAction::Action::FileUpload::key));
+    QVERIFY(!RCloudAction::isConditionalAction(RCloudAction::Action::Statistics::key));
+}
+
+void TestHttpEntityTagCache::entityTagMatches()
+{
+    QVERIFY(RHttpMessage::entityTagMatches("\"v1\"","\"v1\""));
+    QVERIFY(RHttpMessage::entityTagMatches("\"v0\", \"v1\"","\"v1\""));
+    QVERIFY(RHttpMessage::entityTagMatches("W/\"v1\"","\"v1\""));
+    QVERIFY(RHttpMessage::entityTagMatches("\"v1\"","W/\"v1\""));
+    QVERIFY(RHttpMessage::entityTagMatches("*","\"v1\""));
+    QVERIFY(!RHttpMessage::entityTagMatches("\"v2\"","\"v1\""));
+    QVERIFY(!RHttpMessage::entityTagMatches("\"v1\"",QByteArray()));
+    QVERIFY(!RHttpMessage::entityTagMatches(QByteArray(),"\"v1\""));
+}
+
+void TestHttpEntityTagCache::messageEntityTag()
+{
+    RHttpMessage message;
+    QVERIFY(message.getEntityTag().isEmpty());
+    message.setEntityTag(RHttpMessage::buildEntityTag("d41d8cd98f00b204e9800998ecf8427e"));
+    QCOMPARE(message.getEntityTag(), QByteArray("\"d41d8cd98f00b204e9800998ecf8427e\""));
+    message.setEntityTag("\"v2\"");
+    QCOMPARE(message.getResponseHeaders().values(QHttpHeaders::WellKnownHeader::ETag).size(), 1);
+}
+
+QTEST_APPLESS_MAIN(TestHttpEntityTagCache)
+#include "tst_http_entity_tag_cache.moc"
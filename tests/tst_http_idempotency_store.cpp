@@ -0,0 +1,176 @@
+#include <QtTest>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_idempotency_store.h"
+
+class TestHttpIdempotencyStore : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Return response with given body and error type.
+    static RHttpMessage createResponse(const QByteArray &body, RError::Type errorType = RError::None);
+
+private slots:
+
+    void startAndReplay();
+    void attachToInProgress();
+    void failedRequestIsNotRemembered();
+    void conflict();
+    void usersAreSeparated();
+    void abandon();
+    void expiry();
+    void capacity();
+    void validKey();
+    void mutatingAction();
+};
+
+RHttpMessage TestHttpIdempotencyStore::createResponse(const QByteArray &body, RError::Type errorType)
+{
+    RHttpMessage response;
+    response.setBody(body);
+    response.setErrorType(errorType);
+    return response;
+}
+
+void TestHttpIdempotencyStore::startAndReplay()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    store.finish("alice","k1",createResponse("done"));
+
+    QCOMPARE(store.begin("alice","k1","upload",10,future), RHttpIdempotencyStore::Replayed);
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.result().getBody(), QByteArray("done"));
+    QCOMPARE(store.getStartedCount(), quint64(1));
+    QCOMPARE(store.getReplayedCount(), quint64(1));
+}
+
+void TestHttpIdempotencyStore::attachToInProgress()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+
+    QFuture<RHttpMessage> firstRetry;
+    QFuture<RHttpMessage> secondRetry;
+    QCOMPARE(store.begin("alice","k1","upload",1,firstRetry), RHttpIdempotencyStore::Attached);
+    QCOMPARE(store.begin("alice","k1","upload",2,secondRetry), RHttpIdempotencyStore::Attached);
+    QVERIFY(!firstRetry.isFinished());
+
+    store.finish("alice","k1",createResponse("done"));
+    QVERIFY(firstRetry.isFinished());
+    QVERIFY(secondRetry.isFinished());
+    QCOMPARE(firstRetry.result().getBody(), QByteArray("done"));
+    QCOMPARE(secondRetry.result().getBody(), QByteArray("done"));
+    QCOMPARE(store.getAttachedCount(), quint64(2));
+}
+
+void TestHttpIdempotencyStore::failedRequestIsNotRemembered()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QFuture<RHttpMessage> retry;
+    QCOMPARE(store.begin("alice","k1","upload",1,retry), RHttpIdempotencyStore::Attached);
+
+    store.finish("alice","k1",createResponse("failed",RError::Timeout));
+    // Waiting retry gets the failure, next one is processed again.
+    QCOMPARE(retry.result().getErrorType(), RError::Timeout);
+    QCOMPARE(store.size(), qsizetype(0));
+    QCOMPARE(store.begin("alice","k1","upload",2,future), RHttpIdempotencyStore::Started);
+}
+
+void TestHttpIdempotencyStore::conflict()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.begin("alice","k1","remove",1,future), RHttpIdempotencyStore::Conflict);
+    QCOMPARE(store.getConflictCount(), quint64(1));
+}
+
+void TestHttpIdempotencyStore::usersAreSeparated()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.begin("bob","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.size(), qsizetype(2));
+}
+
+void TestHttpIdempotencyStore::abandon()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QFuture<RHttpMessage> retry;
+    QCOMPARE(store.begin("alice","k1","upload",1,retry), RHttpIdempotencyStore::Attached);
+    // Server answers the retry from a cancellation handler, it must not be left without a response.
+    bool retryAnswered = false;
+    bool retryCanceled = false;
+    retry.then(QtFuture::Launch::Sync,[&retryAnswered](const RHttpMessage &) { retryAnswered = true; })
+         .onCanceled([&retryCanceled]() { retryCanceled = true; });
+
+    store.abandon("alice","k1");
+    QVERIFY(retry.isCanceled());
+    QVERIFY(!retryAnswered);
+    QVERIFY(retryCanceled);
+    QCOMPARE(store.begin("alice","k1","upload",2,future), RHttpIdempotencyStore::Started);
+}
+
+void TestHttpIdempotencyStore::expiry()
+{
+    RHttpIdempotencyStore store(10,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QFuture<RHttpMessage> retry;
+    QCOMPARE(store.begin("alice","k1","upload",500,retry), RHttpIdempotencyStore::Attached);
+
+    // Original request did not finish within TTL.
+    QCOMPARE(store.begin("alice","k2","upload",1000,future), RHttpIdempotencyStore::Started);
+    QVERIFY(retry.isCanceled());
+    QCOMPARE(store.size(), qsizetype(1));
+
+    // Late finish of forgotten request is ignored.
+    store.finish("alice","k1",createResponse("done"));
+    QCOMPARE(store.begin("alice","k1","upload",1001,future), RHttpIdempotencyStore::Started);
+}
+
+void TestHttpIdempotencyStore::capacity()
+{
+    RHttpIdempotencyStore store(2,1000);
+    QFuture<RHttpMessage> future;
+    QCOMPARE(store.begin("alice","k1","upload",0,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.begin("alice","k2","upload",0,future), RHttpIdempotencyStore::Started);
+    // Full store does not remember new keys.
+    QCOMPARE(store.begin("alice","k3","upload",0,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.size(), qsizetype(2));
+    QCOMPARE(store.begin("alice","k3","upload",1,future), RHttpIdempotencyStore::Started);
+
+    QCOMPARE(store.begin("alice","k3","upload",1000,future), RHttpIdempotencyStore::Started);
+    QCOMPARE(store.size(), qsizetype(1));
+}
+
+void TestHttpIdempotencyStore::validKey()
+{
+    QVERIFY(RHttpIdempotencyStore::isValidKey("5b0c3c5e-7f43-4f6a-9c7e-2d1a8f0e6b11"));
+    QVERIFY(!RHttpIdempotencyStore::isValidKey(QString()));
+    QVERIFY(!RHttpIdempotencyStore::isValidKey("with space"));
+    QVERIFY(!RHttpIdempotencyStore::isValidKey("line\nbreak"));
+    QVERIFY(!RHttpIdempotencyStore::isValidKey(QString(RHttpIdempotencyStore::maxKeyLength + 1,'k')));
+}
+
+void TestHttpIdempotencyStore::mutatingAction()
+{
+    QVERIFY(RCloudAction::isMutatingAction(RCloudAction::Action::FileUpload::key));
+    QVERIFY(RCloudAction::isMutatingAction(RCloudAction::Action::FileRemove::key));
+    QVERIFY(RCloudAction::isMutatingAction(RCloudAction::Action::UserTokenGenerate::key));
+    QVERIFY(!RCloudAction::isMutatingAction(RCloudAction::Action::FileDownload::key));
+    QVERIFY(!RCloudAction::isMutatingAction(RCloudAction::Action::ListFiles::key));
+}
+
+QTEST_APPLESS_MAIN(TestHttpIdempotencyStore)
+#include "tst_http_idempotency_store.moc"
@@ -0,0 +1,102 @@
+#include <QtTest>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_load_shedder.h"
+
+class TestHttpLoadShedder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void movingAverage();
+    void unknownServiceTimeAdmits();
+    void admitQueued();
+    void admitDispatch();
+    void prometheusText();
+};
+
+void TestHttpLoadShedder::movingAverage()
+{
+    RHttpLoadShedder shedder({RCloudAction::Action::ListFiles::key});
+    QCOMPARE(shedder.getServiceTime(RCloudAction::Action::ListFiles::key), qint64(0));
+
+    // First sample is taken as it is.
+    shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,8000);
+    QCOMPARE(shedder.getServiceTime(RCloudAction::Action::ListFiles::key), qint64(8000));
+    QCOMPARE(shedder.getLaneServiceTime(RHttpDispatchLane::Interactive), qint64(8000));
+
+    shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,16000);
+    QCOMPARE(shedder.getServiceTime(RCloudAction::Action::ListFiles::key), qint64(9000));
+
+    // Average follows sustained change.
+    for (int i = 0; i < 100; i++)
+    {
+        shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,100000);
+    }
+    QVERIFY(shedder.getServiceTime(RCloudAction::Action::ListFiles::key) > 99000);
+    QCOMPARE(shedder.getLaneServiceTime(RHttpDispatchLane::Bulk), qint64(0));
+
+    // Unknown actions only contribute to their lane.
+    shedder.recordServiceTime("unknown",RHttpDispatchLane::Bulk,5000);
+    QCOMPARE(shedder.getServiceTime("unknown"), qint64(0));
+    QCOMPARE(shedder.getLaneServiceTime(RHttpDispatchLane::Bulk), qint64(5000));
+}
+
+void TestHttpLoadShedder::unknownServiceTimeAdmits()
+{
+    RHttpLoadShedder shedder({RCloudAction::Action::ListFiles::key});
+    qint64 retryAfterMs = 0;
+    QVERIFY(shedder.admitQueued(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,1000,1,1000,retryAfterMs));
+    QVERIFY(shedder.admitDispatch(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,0,retryAfterMs));
+}
+
+void TestHttpLoadShedder::admitQueued()
+{
+    RHttpLoadShedder shedder({RCloudAction::Action::ListFiles::key});
+    // 100 ms per request, 4 slots.
+    shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,100000);
+
+    qint64 retryAfterMs = 0;
+    // 7 queued requests ahead: (7 + 1) * 100 / 4 + 100 = 300 ms.
+    QVERIFY(shedder.admitQueued(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,7,4,300000,retryAfterMs));
+    QCOMPARE(shedder.getShedCount(RHttpLoadShedder::Admission), quint64(0));
+
+    // 39 queued requests ahead: (39 + 1) * 100 / 4 + 100 = 1100 ms.
+    QVERIFY(!shedder.admitQueued(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,39,4,1000000,retryAfterMs));
+    QCOMPARE(shedder.getShedCount(RHttpLoadShedder::Admission), quint64(1));
+    QCOMPARE(retryAfterMs, qint64(1000));
+
+    // 399 queued requests ahead wait 10 s.
+    QVERIFY(!shedder.admitQueued(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,399,4,1000000,retryAfterMs));
+    QCOMPARE(retryAfterMs, qint64(10000));
+}
+
+void TestHttpLoadShedder::admitDispatch()
+{
+    RHttpLoadShedder shedder({RCloudAction::Action::ListFiles::key});
+    shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,100000);
+
+    qint64 retryAfterMs = 0;
+    QVERIFY(shedder.admitDispatch(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,100000,retryAfterMs));
+    QVERIFY(!shedder.admitDispatch(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,99999,retryAfterMs));
+    QVERIFY(!shedder.admitDispatch(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,-1,retryAfterMs));
+    QCOMPARE(shedder.getShedCount(RHttpLoadShedder::Dispatch), quint64(2));
+    QVERIFY(retryAfterMs >= 1000);
+}
+
+void TestHttpLoadShedder::prometheusText()
+{
+    RHttpLoadShedder shedder({RCloudAction::Action::ListFiles::key});
+    qint64 retryAfterMs = 0;
+    shedder.recordServiceTime(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,2000000);
+    shedder.admitDispatch(RCloudAction::Action::ListFiles::key,RHttpDispatchLane::Interactive,0,retryAfterMs);
+
+    const QByteArray text = shedder.toPrometheusText();
+    QVERIFY(text.contains("range_cloud_load_shed_total{stage=\"admission\"} 0\n"));
+    QVERIFY(text.contains("range_cloud_load_shed_total{stage=\"dispatch\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_lane_service_time_seconds{lane=\"" + RHttpDispatchLane::typeToString(RHttpDispatchLane::Interactive).toUtf8() + "\"} 2\n"));
+}
+
+QTEST_APPLESS_MAIN(TestHttpLoadShedder)
+#include "tst_http_load_shedder.moc"
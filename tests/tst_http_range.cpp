@@ -0,0 +1,110 @@
+#include <QtTest>
+#include <QBuffer>
+
+#include "rcl_http_body_device.h"
+#include "rcl_http_range.h"
+
+class TestHttpRange : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void parse_data();
+    void parse();
+    void resolve_data();
+    void resolve();
+    void contentRange();
+    void bodyDeviceRange();
+};
+
+void TestHttpRange::parse_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<bool>("isNull");
+    QTest::addColumn<QString>("normalized");
+
+    QTest::newRow("closed") << QByteArray("bytes=0-499") << false << QString("bytes=0-499");
+    QTest::newRow("open") << QByteArray("bytes=500-") << false << QString("bytes=500-");
+    QTest::newRow("suffix") << QByteArray("bytes=-200") << false << QString("bytes=-200");
+    QTest::newRow("spaces") << QByteArray("  bytes= 10 - 20 ") << false << QString("bytes=10-20");
+    QTest::newRow("empty") << QByteArray() << true << QString();
+    QTest::newRow("unit") << QByteArray("items=0-1") << true << QString();
+    QTest::newRow("multi") << QByteArray("bytes=0-1,5-6") << true << QString();
+    QTest::newRow("reversed") << QByteArray("bytes=10-5") << true << QString();
+    QTest::newRow("garbage") << QByteArray("bytes=a-b") << true << QString();
+    QTest::newRow("dash") << QByteArray("bytes=-") << true << QString();
+}
+
+void TestHttpRange::parse()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(bool, isNull);
+    QFETCH(QString, normalized);
+
+    RHttpRange range = RHttpRange::fromString(value);
+    QCOMPARE(range.isNull(), isNull);
+    QCOMPARE(range.toString(), normalized);
+}
+
+void TestHttpRange::resolve_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<qint64>("size");
+    QTest::addColumn<bool>("satisfiable");
+    QTest::addColumn<qint64>("offset");
+    QTest::addColumn<qint64>("length");
+
+    QTest::newRow("closed") << QByteArray("bytes=0-499") << qint64(1000) << true << qint64(0) << qint64(500);
+    QTest::newRow("clamped") << QByteArray("bytes=900-2000") << qint64(1000) << true << qint64(900) << qint64(100);
+    QTest::newRow("open") << QByteArray("bytes=990-") << qint64(1000) << true << qint64(990) << qint64(10);
+    QTest::newRow("suffix") << QByteArray("bytes=-100") << qint64(1000) << true << qint64(900) << qint64(100);
+    QTest::newRow("long suffix") << QByteArray("bytes=-5000") << qint64(1000) << true << qint64(0) << qint64(1000);
+    QTest::newRow("past end") << QByteArray("bytes=1000-") << qint64(1000) << false << qint64(0) << qint64(0);
+    QTest::newRow("zero suffix") << QByteArray("bytes=-0") << qint64(1000) << false << qint64(0) << qint64(0);
+    QTest::newRow("empty resource") << QByteArray("bytes=0-") << qint64(0) << false << qint64(0) << qint64(0);
+}
+
+void TestHttpRange::resolve()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(qint64, size);
+    QFETCH(bool, satisfiable);
+    QFETCH(qint64, offset);
+    QFETCH(qint64, length);
+
+    qint64 resolvedOffset = 0;
+    qint64 resolvedLength = 0;
+    QCOMPARE(RHttpRange::fromString(value).resolve(size, resolvedOffset, resolvedLength), satisfiable);
+    if (satisfiable)
+    {
+        QCOMPARE(resolvedOffset, offset);
+        QCOMPARE(resolvedLength, length);
+    }
+}
+
+void TestHttpRange::contentRange()
+{
+    QCOMPARE(RHttpRange::buildContentRange(0, 500, 1000), QByteArray("bytes 0-499/1000"));
+    QCOMPARE(RHttpRange::buildContentRange(999, 1, 1000), QByteArray("bytes 999-999/1000"));
+    QCOMPARE(RHttpRange::buildUnsatisfiedContentRange(1000), QByteArray("bytes */1000"));
+}
+
+void TestHttpRange::bodyDeviceRange()
+{
+    QSharedPointer<QBuffer> buffer(new QBuffer);
+    buffer->setData("0123456789");
+    buffer->open(QIODevice::ReadOnly);
+
+    RHttpBodyDevice device(buffer, 3, 4);
+    QCOMPARE(device.size(), qint64(4));
+    QCOMPARE(device.readAll(), QByteArray("3456"));
+    QVERIFY(device.atEnd());
+
+    RHttpBodyDevice tail(buffer, 8, 100);
+    QCOMPARE(tail.size(), qint64(2));
+    QCOMPARE(tail.readAll(), QByteArray("89"));
+}
+
+QTEST_APPLESS_MAIN(TestHttpRange)
+#include "tst_http_range.moc"
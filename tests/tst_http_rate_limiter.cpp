@@ -0,0 +1,158 @@
+#include <QtTest>
+
+#include "rcl_http_rate_limiter.h"
+
+class TestHttpRateLimiter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void disabled();
+    void requestBucket();
+    void byteBucket();
+    void largeBodyIsAdmittedWithDebt();
+    void inFlightCap();
+    void principalsAreIndependent();
+    void checkDoesNotAcquire();
+    void prune();
+};
+
+void TestHttpRateLimiter::disabled()
+{
+    RHttpRateLimiter limiter(0.0, 0.0, 0.0, 0.0, 0);
+    QVERIFY(!limiter.isEnabled());
+
+    qint64 retryAfterMs = -1;
+    for (int i = 0; i < 1000; i++)
+    {
+        QVERIFY(limiter.tryAcquire("alice", 1000000, 0, retryAfterMs));
+    }
+    QCOMPARE(retryAfterMs, qint64(0));
+    QCOMPARE(limiter.size(), qsizetype(0));
+}
+
+void TestHttpRateLimiter::requestBucket()
+{
+    // 10 requests per second, burst of 5.
+    RHttpRateLimiter limiter(10.0, 5.0, 0.0, 0.0, 0);
+
+    qint64 retryAfterMs = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        QVERIFY(limiter.tryAcquire("alice", 0, 1000, retryAfterMs));
+    }
+    QVERIFY(!limiter.tryAcquire("alice", 0, 1000, retryAfterMs));
+    QCOMPARE(retryAfterMs, qint64(100));
+
+    // One token is refilled after 100 ms.
+    QVERIFY(!limiter.tryAcquire("alice", 0, 1050, retryAfterMs));
+    QCOMPARE(retryAfterMs, qint64(50));
+    QVERIFY(limiter.tryAcquire("alice", 0, 1100, retryAfterMs));
+    QVERIFY(!limiter.tryAcquire("alice", 0, 1100, retryAfterMs));
+
+    // Bucket does not grow beyond burst.
+    for (int i = 0; i < 5; i++)
+    {
+        QVERIFY(limiter.tryAcquire("alice", 0, 100000, retryAfterMs));
+    }
+    QVERIFY(!limiter.tryAcquire("alice", 0, 100000, retryAfterMs));
+}
+
+void TestHttpRateLimiter::byteBucket()
+{
+    // 1000 bytes per second, burst of 2000 bytes.
+    RHttpRateLimiter limiter(0.0, 0.0, 1000.0, 2000.0, 0);
+
+    qint64 retryAfterMs = 0;
+    QVERIFY(limiter.tryAcquire("alice", 1500, 0, retryAfterMs));
+    QVERIFY(!limiter.tryAcquire("alice", 1000, 0, retryAfterMs));
+    QCOMPARE(retryAfterMs, qint64(500));
+    QVERIFY(limiter.tryAcquire("alice", 1000, 500, retryAfterMs));
+}
+
+void TestHttpRateLimiter::largeBodyIsAdmittedWithDebt()
+{
+    RHttpRateLimiter limiter(0.0, 0.0, 1000.0, 1000.0, 0);
+
+    qint64 retryAfterMs = 0;
+    // Body larger than the burst is admitted once the bucket is full.
+    QVERIFY(limiter.tryAcquire("alice", 5000, 0, retryAfterMs));
+    // Debt of 4000 bytes has to be paid back first.
+    QVERIFY(!limiter.tryAcquire("alice", 1, 0, retryAfterMs));
+    QCOMPARE(retryAfterMs, qint64(4001));
+    QVERIFY(limiter.tryAcquire("alice", 1, 4001, retryAfterMs));
+}
+
+void TestHttpRateLimiter::inFlightCap()
+{
+    RHttpRateLimiter limiter(0.0, 0.0, 0.0, 0.0, 2);
+
+    qint64 retryAfterMs = 0;
+    QVERIFY(limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(!limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(retryAfterMs > 0);
+
+    limiter.release("alice");
+    QVERIFY(limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+
+    // Unknown principal is ignored.
+    limiter.release("bob");
+}
+
+void TestHttpRateLimiter::principalsAreIndependent()
+{
+    RHttpRateLimiter limiter(1.0, 1.0, 0.0, 0.0, 0);
+
+    qint64 retryAfterMs = 0;
+    QVERIFY(limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(!limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(limiter.tryAcquire("bob", 0, 0, retryAfterMs));
+    QVERIFY(limiter.tryAcquire("10.0.0.1", 0, 0, retryAfterMs));
+    QCOMPARE(limiter.size(), qsizetype(3));
+}
+
+void TestHttpRateLimiter::checkDoesNotAcquire()
+{
+    RHttpRateLimiter limiter(1.0, 1.0, 1000.0, 1000.0, 1);
+
+    qint64 retryAfterMs = 0;
+    // Unknown principal is not tracked by a check.
+    QVERIFY(limiter.check("alice", 500, 0, retryAfterMs));
+    QCOMPARE(limiter.size(), qsizetype(0));
+
+    QVERIFY(limiter.tryAcquire("alice", 500, 0, retryAfterMs));
+    QVERIFY(!limiter.check("alice", 500, 0, retryAfterMs));
+    QVERIFY(retryAfterMs > 0);
+
+    limiter.release("alice");
+    QVERIFY(limiter.check("alice", 500, 1000, retryAfterMs));
+    QVERIFY(limiter.check("alice", 500, 1000, retryAfterMs));
+    QVERIFY(limiter.tryAcquire("alice", 500, 1000, retryAfterMs));
+}
+
+void TestHttpRateLimiter::prune()
+{
+    RHttpRateLimiter limiter(1.0, 1.0, 0.0, 0.0, 10);
+
+    qint64 retryAfterMs = 0;
+    QVERIFY(limiter.tryAcquire("alice", 0, 0, retryAfterMs));
+    QVERIFY(limiter.tryAcquire("bob", 0, 0, retryAfterMs));
+    limiter.release("bob");
+
+    // Buckets are not full yet.
+    limiter.prune(500);
+    QCOMPARE(limiter.size(), qsizetype(2));
+
+    // "alice" still has a request in flight.
+    limiter.prune(1000);
+    QCOMPARE(limiter.size(), qsizetype(1));
+
+    limiter.release("alice");
+    limiter.prune(1000);
+    QCOMPARE(limiter.size(), qsizetype(0));
+}
+
+QTEST_APPLESS_MAIN(TestHttpRateLimiter)
+#include "tst_http_rate_limiter.moc"
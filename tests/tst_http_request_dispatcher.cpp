@@ -0,0 +1,239 @@
+#include <QtTest>
+
+#include <atomic>
+
+#include <rbl_error.h>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_request_dispatcher.h"
+
+#include "http_test_support.h"
+
+class TestActionHandler : public RHttpActionHandler
+{
+
+    public:
+
+        //! Time each request takes in milliseconds.
+        int sleepMs = 0;
+        //! Amount of work (bytes checksummed) each request takes.
+        qsizetype workSize = 0;
+        //! Processed sequence numbers per shard key.
+        QHash<QString,QList<int>> sequences;
+        QMutex mutex;
+        std::atomic<int> nRunning{0};
+        std::atomic<int> maxRunning{0};
+
+        RHttpMessage processRequest(const RHttpMessage &requestMessage) override
+        {
+            const int nNowRunning = ++this->nRunning;
+            int maxNowRunning = this->maxRunning.load();
+            while (nNowRunning > maxNowRunning && !this->maxRunning.compare_exchange_weak(maxNowRunning,nNowRunning)) { }
+
+            if (this->sleepMs > 0)
+            {
+                QThread::msleep(this->sleepMs);
+            }
+            quint16 checksum = 0;
+            if (this->workSize > 0)
+            {
+                const QByteArray data(this->workSize,char(requestMessage.getBody().size()));
+                checksum = qChecksum(data);
+            }
+            {
+                QMutexLocker locker(&this->mutex);
+                this->sequences[RHttpRequestDispatcher::findShardKey(requestMessage)].append(requestMessage.getBody().toInt());
+            }
+
+            this->nRunning--;
+
+            if (requestMessage.getBody() == "fail")
+            {
+                throw RError(RError::Application,R_ERROR_REF,"Request failed");
+            }
+
+            RHttpMessage replyMessage;
+            replyMessage.setBody(requestMessage.getBody() + "-" + QByteArray::number(checksum));
+            return replyMessage;
+        }
+
+};
+
+class TestHttpRequestDispatcher : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    static RHttpMessage buildRequest(const QUuid &resourceId, const QString &owner, const QByteArray &body);
+
+    //! Dispatch given number of requests over given number of resources and wait for all replies.
+    static void dispatchAll(RHttpRequestDispatcher &dispatcher, RHttpActionHandler *pHandler, int nRequests, const QList<QUuid> &resourceIds);
+
+private slots:
+
+    void shardKey();
+    void handlers();
+    void reply();
+    void errorReply();
+    void perResourceOrdering();
+    void parallelResources();
+    void benchmarkThroughput_data();
+    void benchmarkThroughput();
+};
+
+RHttpMessage TestHttpRequestDispatcher::buildRequest(const QUuid &resourceId, const QString &owner, const QByteArray &body)
+{
+    RHttpMessage requestMessage;
+    QMap<QString,QString> properties;
+    properties.insert(RCloudAction::Resource::Id::key,resourceId.toString(QUuid::WithBraces));
+    requestMessage.setProperties(properties);
+    requestMessage.setOwner(owner);
+    requestMessage.setHandlerId(QUuid::createUuid());
+    requestMessage.setBody(body);
+    return requestMessage;
+}
+
+void TestHttpRequestDispatcher::dispatchAll(RHttpRequestDispatcher &dispatcher, RHttpActionHandler *pHandler, int nRequests, const QList<QUuid> &resourceIds)
+{
+    QList<QFuture<RHttpMessage>> replyFutures;
+    replyFutures.reserve(nRequests);
+    for (int i = 0; i < nRequests; i++)
+    {
+        replyFutures.append(dispatcher.dispatch(pHandler,buildRequest(resourceIds.at(i % resourceIds.size()),"alice",QByteArray::number(i))));
+    }
+    for (QFuture<RHttpMessage> &replyFuture : replyFutures)
+    {
+        replyFuture.waitForFinished();
+    }
+}
+
+void TestHttpRequestDispatcher::shardKey()
+{
+    const QUuid resourceId = QUuid::createUuid();
+    QCOMPARE(RHttpRequestDispatcher::findShardKey(buildRequest(resourceId,"alice",QByteArray())), resourceId.toString(QUuid::WithoutBraces));
+    // Requests without resource are sharded by user.
+    QCOMPARE(RHttpRequestDispatcher::findShardKey(buildRequest(QUuid(),"alice",QByteArray())), QString("alice"));
+}
+
+void TestHttpRequestDispatcher::handlers()
+{
+    RHttpRequestDispatcher dispatcher(2);
+    QCOMPARE(dispatcher.getThreadCount(), 2);
+
+    TestActionHandler handler;
+    QVERIFY(dispatcher.findHandler(RCloudAction::Action::FileInfo::key) == nullptr);
+    dispatcher.setHandler(RCloudAction::Action::FileInfo::key,&handler);
+    QVERIFY(dispatcher.findHandler(RCloudAction::Action::FileInfo::key) == &handler);
+    QVERIFY(dispatcher.findHandler(RCloudAction::Action::FileUpload::key) == nullptr);
+    dispatcher.setHandler(RCloudAction::Action::FileInfo::key,nullptr);
+    QVERIFY(dispatcher.findHandler(RCloudAction::Action::FileInfo::key) == nullptr);
+}
+
+void TestHttpRequestDispatcher::reply()
+{
+    RHttpRequestDispatcher dispatcher(2);
+    TestActionHandler handler;
+
+    const RHttpMessage requestMessage = buildRequest(QUuid::createUuid(),"alice","7");
+    const RHttpMessage replyMessage = dispatcher.dispatch(&handler,requestMessage).result();
+    QCOMPARE(replyMessage.getHandlerId(), requestMessage.getHandlerId());
+    QCOMPARE(replyMessage.getBody(), QByteArray("7-0"));
+    QCOMPARE(replyMessage.getErrorType(), RError::None);
+}
+
+void TestHttpRequestDispatcher::errorReply()
+{
+    RHttpRequestDispatcher dispatcher(2);
+    TestActionHandler handler;
+
+    const RHttpMessage requestMessage = buildRequest(QUuid::createUuid(),"alice","fail");
+    const RHttpMessage replyMessage = dispatcher.dispatch(&handler,requestMessage).result();
+    QCOMPARE(replyMessage.getHandlerId(), requestMessage.getHandlerId());
+    QCOMPARE(replyMessage.getErrorType(), RError::Application);
+}
+
+void TestHttpRequestDispatcher::perResourceOrdering()
+{
+    RHttpRequestDispatcher dispatcher(4);
+    TestActionHandler handler;
+
+    QList<QUuid> resourceIds;
+    for (int i = 0; i < 10; i++)
+    {
+        resourceIds.append(QUuid::createUuid());
+    }
+    dispatchAll(dispatcher,&handler,2000,resourceIds);
+
+    QCOMPARE(handler.sequences.size(), resourceIds.size());
+    for (const QList<int> &sequence : std::as_const(handler.sequences))
+    {
+        QCOMPARE(sequence.size(), 200);
+        for (qsizetype i = 1; i < sequence.size(); i++)
+        {
+            QVERIFY(sequence.at(i - 1) < sequence.at(i));
+        }
+    }
+}
+
+void TestHttpRequestDispatcher::parallelResources()
+{
+    RHttpRequestDispatcher dispatcher(4);
+    TestActionHandler handler;
+    handler.sleepMs = 20;
+
+    QList<QUuid> resourceIds;
+    for (int i = 0; i < 16; i++)
+    {
+        resourceIds.append(QUuid::createUuid());
+    }
+    dispatchAll(dispatcher,&handler,32,resourceIds);
+    QVERIFY(handler.maxRunning.load() > 1);
+
+    // Requests of one resource are never processed concurrently.
+    TestActionHandler serialHandler;
+    serialHandler.sleepMs = 5;
+    dispatchAll(dispatcher,&serialHandler,16,{QUuid::createUuid()});
+    QCOMPARE(serialHandler.maxRunning.load(), 1);
+}
+
+void TestHttpRequestDispatcher::benchmarkThroughput_data()
+{
+    QTest::addColumn<int>("nThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("ideal thread count") << QThread::idealThreadCount();
+}
+
+void TestHttpRequestDispatcher::benchmarkThroughput()
+{
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    QFETCH(int, nThreads);
+
+    if (nThreads >= 8 && QThread::idealThreadCount() < 8)
+    {
+        qInfo() << "Only" << QThread::idealThreadCount() << "cores available, results do not show scaling";
+    }
+
+    RHttpRequestDispatcher dispatcher(nThreads);
+    TestActionHandler handler;
+    handler.workSize = 64 * 1024;
+
+    QList<QUuid> resourceIds;
+    for (int i = 0; i < 256; i++)
+    {
+        resourceIds.append(QUuid::createUuid());
+    }
+
+    QBENCHMARK
+    {
+        dispatchAll(dispatcher,&handler,4096,resourceIds);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestHttpRequestDispatcher)
+#include "tst_http_request_dispatcher.moc"
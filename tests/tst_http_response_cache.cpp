@@ -0,0 +1,141 @@
+#include <QBuffer>
+#include <QtTest>
+
+#include "rcl_cloud_action.h"
+#include "rcl_http_message.h"
+#include "rcl_http_response_cache.h"
+
+class TestHttpResponseCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void findAndExpire();
+    void onlySuccessfulResponses();
+    void invalidateAffectedActions();
+    void staleInsertIsDropped();
+    void memoryCap();
+    void keysDiffer();
+    void counters();
+};
+
+static RHttpMessage buildResponse(const QByteArray &body)
+{
+    RHttpMessage response;
+    response.setBody(body);
+    return response;
+}
+
+static QString listUsersKey(const QString &user = "alice")
+{
+    return RHttpResponseCache::buildKey(RCloudAction::Action::ListUsers::key,user,QString(),QUuid(),"identity");
+}
+
+void TestHttpResponseCache::findAndExpire()
+{
+    RHttpResponseCache cache(1024 * 1024,1000);
+    RHttpMessage response;
+    QVERIFY(!cache.find(listUsersKey(),0,response));
+
+    cache.insert(listUsersKey(),buildResponse("[]"),cache.getGeneration(),0);
+    QVERIFY(cache.find(listUsersKey(),999,response));
+    QCOMPARE(response.getBody(), QByteArray("[]"));
+    QVERIFY(!cache.find(listUsersKey(),1000,response));
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestHttpResponseCache::onlySuccessfulResponses()
+{
+    RHttpResponseCache cache(1024 * 1024,1000);
+    RHttpMessage errorResponse = buildResponse("failed");
+    errorResponse.setErrorType(RError::Application);
+    cache.insert(listUsersKey(),errorResponse,cache.getGeneration(),0);
+
+    RHttpMessage streamedResponse;
+    streamedResponse.setBodyDevice(QSharedPointer<QIODevice>(new QBuffer));
+    cache.insert(listUsersKey("bob"),streamedResponse,cache.getGeneration(),0);
+
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestHttpResponseCache::invalidateAffectedActions()
+{
+    RHttpResponseCache cache(1024 * 1024,1000);
+    const QString actionsKey = RHttpResponseCache::buildKey(RCloudAction::Action::ListActions::key,"alice",QString(),QUuid(),"identity");
+    cache.insert(listUsersKey(),buildResponse("users"),cache.getGeneration(),0);
+    cache.insert(actionsKey,buildResponse("actions"),cache.getGeneration(),0);
+
+    // Not a mutation of anything cached.
+    cache.invalidate(RCloudAction::Action::FileUpload::key);
+    QCOMPARE(cache.size(), qsizetype(2));
+    QCOMPARE(cache.getInvalidationCount(), quint64(0));
+
+    cache.invalidate(RCloudAction::Action::UserUpdate::key);
+    RHttpMessage response;
+    QVERIFY(!cache.find(listUsersKey(),1,response));
+    QVERIFY(cache.find(actionsKey,1,response));
+
+    cache.invalidate(RCloudAction::Action::ActionUpdateAccessMode::key);
+    QVERIFY(!cache.find(actionsKey,1,response));
+    QCOMPARE(cache.getInvalidationCount(), quint64(2));
+}
+
+void TestHttpResponseCache::staleInsertIsDropped()
+{
+    RHttpResponseCache cache(1024 * 1024,1000);
+    // Listing started before a mutation finished after it.
+    const quint64 generation = cache.getGeneration();
+    cache.invalidate(RCloudAction::Action::GroupAdd::key);
+    cache.insert(listUsersKey(),buildResponse("old"),generation,0);
+    QCOMPARE(cache.size(), qsizetype(0));
+}
+
+void TestHttpResponseCache::memoryCap()
+{
+    RHttpResponseCache cache(4096,1000);
+    for (int i = 0; i < 16; i++)
+    {
+        cache.insert(listUsersKey(QString("user%1").arg(i)),buildResponse(QByteArray(1000,'x')),cache.getGeneration(),0);
+        QVERIFY(cache.getTotalBytes() <= 4096);
+    }
+    QVERIFY(cache.size() < 16);
+
+    // Response larger than the whole cache is not kept.
+    cache.insert(listUsersKey("large"),buildResponse(QByteArray(8192,'x')),cache.getGeneration(),0);
+    RHttpMessage response;
+    QVERIFY(!cache.find(listUsersKey("large"),1,response));
+}
+
+void TestHttpResponseCache::keysDiffer()
+{
+    QVERIFY(listUsersKey("alice") != listUsersKey("bob"));
+    QVERIFY(RHttpResponseCache::buildKey(RCloudAction::Action::ListUsers::key,"alice",QString(),QUuid(),"identity")
+            != RHttpResponseCache::buildKey(RCloudAction::Action::ListUsers::key,"alice",QString(),QUuid(),"gzip"));
+    QVERIFY(RHttpResponseCache::buildKey(RCloudAction::Action::UserInfo::key,"alice","bob",QUuid(),"identity")
+            != RHttpResponseCache::buildKey(RCloudAction::Action::UserInfo::key,"alice","carol",QUuid(),"identity"));
+
+    QVERIFY(RCloudAction::isCacheableAction(RCloudAction::Action::ListGroups::key));
+    QVERIFY(!RCloudAction::isCacheableAction(RCloudAction::Action::ListFiles::key));
+    QVERIFY(!RCloudAction::isCacheableAction(RCloudAction::Action::UserAdd::key));
+}
+
+void TestHttpResponseCache::counters()
+{
+    RHttpResponseCache cache(1024 * 1024,1000);
+    RHttpMessage response;
+    cache.find(listUsersKey(),0,response);
+    cache.insert(listUsersKey(),buildResponse("[]"),cache.getGeneration(),0);
+    cache.find(listUsersKey(),1,response);
+    cache.find(listUsersKey(),2,response);
+    QCOMPARE(cache.getHitCount(), quint64(2));
+    QCOMPARE(cache.getMissCount(), quint64(1));
+
+    const QByteArray text = cache.toPrometheusText();
+    QVERIFY(text.contains("range_cloud_response_cache_requests_total{result=\"hit\"} 2\n"));
+    QVERIFY(text.contains("range_cloud_response_cache_requests_total{result=\"miss\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_response_cache_entries 1\n"));
+}
+
+QTEST_APPLESS_MAIN(TestHttpResponseCache)
+#include "tst_http_response_cache.moc"
@@ -0,0 +1,231 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <atomic>
+
+#include <rbl_error.h>
+
+#include "rcl_http_reuse_port_listener.h"
+
+#include "http_test_support.h"
+
+//! Listener instance with its own thread and event loop answering every request line with "ok".
+class LoopbackInstance : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        std::atomic<int> nConnections{0};
+        std::atomic<int> nRequests{0};
+
+        void listen(qintptr socketDescriptor)
+        {
+            QTcpServer *pServer = new QTcpServer(this);
+            if (!pServer->setSocketDescriptor(socketDescriptor))
+            {
+                RHttpReusePortListener::close(socketDescriptor);
+                return;
+            }
+            QObject::connect(pServer, &QTcpServer::newConnection, this, [this, pServer]()
+            {
+                while (QTcpSocket *pSocket = pServer->nextPendingConnection())
+                {
+                    this->nConnections++;
+                    QObject::connect(pSocket, &QTcpSocket::disconnected, pSocket, &QObject::deleteLater);
+                    QObject::connect(pSocket, &QTcpSocket::readyRead, this, [this, pSocket]()
+                    {
+                        while (pSocket->canReadLine())
+                        {
+                            pSocket->readLine();
+                            // Stands for TLS record and HTTP parsing work.
+                            static const QByteArray payload(16 * 1024, 'x');
+                            const quint16 checksum = qChecksum(payload);
+                            pSocket->write("ok " + QByteArray::number(checksum) + "\n");
+                            this->nRequests++;
+                        }
+                    });
+                }
+            });
+        }
+
+};
+
+class TestHttpReusePort : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Start given number of instances listening on given port.
+    static void startInstances(int nInstances, quint16 port, QList<QThread*> &threads, QList<LoopbackInstance*> &instances);
+
+    //! Stop instances started by startInstances().
+    static void stopInstances(QList<QThread*> &threads, QList<LoopbackInstance*> &instances);
+
+    //! Run given number of clients each sending given number of requests over one connection.
+    static int runClients(quint16 port, int nClients, int nRequestsPerClient);
+
+private slots:
+
+    void initTestCase();
+    void sharedPort();
+    void connectionsAreBalanced();
+    void benchmarkLoopback_data();
+    void benchmarkLoopback();
+};
+
+void TestHttpReusePort::startInstances(int nInstances, quint16 port, QList<QThread*> &threads, QList<LoopbackInstance*> &instances)
+{
+    for (int i = 0; i < nInstances; i++)
+    {
+        const qintptr socketDescriptor = RHttpReusePortListener::open(port);
+        QThread *pThread = new QThread;
+        LoopbackInstance *pInstance = new LoopbackInstance;
+        pInstance->moveToThread(pThread);
+        QObject::connect(pThread, &QThread::finished, pInstance, &QObject::deleteLater);
+        pThread->start();
+        QMetaObject::invokeMethod(pInstance,[pInstance, socketDescriptor]() { pInstance->listen(socketDescriptor); },Qt::BlockingQueuedConnection);
+        threads.append(pThread);
+        instances.append(pInstance);
+    }
+}
+
+void TestHttpReusePort::stopInstances(QList<QThread*> &threads, QList<LoopbackInstance*> &instances)
+{
+    for (QThread *pThread : std::as_const(threads))
+    {
+        pThread->quit();
+        pThread->wait();
+    }
+    qDeleteAll(threads);
+    threads.clear();
+    instances.clear();
+}
+
+int TestHttpReusePort::runClients(quint16 port, int nClients, int nRequestsPerClient)
+{
+    std::atomic<int> nReplies{0};
+    QList<QThread*> clientThreads;
+    for (int i = 0; i < nClients; i++)
+    {
+        clientThreads.append(QThread::create([port, nRequestsPerClient, &nReplies]()
+        {
+            QTcpSocket socket;
+            socket.connectToHost(QHostAddress::LocalHost, port);
+            if (!socket.waitForConnected(5000))
+            {
+                return;
+            }
+            for (int j = 0; j < nRequestsPerClient; j++)
+            {
+                socket.write("request\n");
+                while (!socket.canReadLine())
+                {
+                    if (!socket.waitForReadyRead(5000))
+                    {
+                        return;
+                    }
+                }
+                socket.readLine();
+                nReplies++;
+            }
+            socket.disconnectFromHost();
+        }));
+        clientThreads.last()->start();
+    }
+    for (QThread *pThread : std::as_const(clientThreads))
+    {
+        pThread->wait();
+    }
+    qDeleteAll(clientThreads);
+    return nReplies.load();
+}
+
+void TestHttpReusePort::initTestCase()
+{
+    if (!RHttpReusePortListener::isSupported())
+    {
+        QSKIP("SO_REUSEPORT is not supported on this platform");
+    }
+}
+
+void TestHttpReusePort::sharedPort()
+{
+    const quint16 port = HttpTestSupport::findFreePort();
+    const qintptr firstSocket = RHttpReusePortListener::open(port);
+    const qintptr secondSocket = RHttpReusePortListener::open(port);
+    QVERIFY(firstSocket >= 0);
+    QVERIFY(secondSocket >= 0);
+    QVERIFY(firstSocket != secondSocket);
+
+    // Plain listener cannot join the port.
+    QTcpServer server;
+    QVERIFY(!server.listen(QHostAddress::Any, port));
+
+    RHttpReusePortListener::close(firstSocket);
+    RHttpReusePortListener::close(secondSocket);
+}
+
+void TestHttpReusePort::connectionsAreBalanced()
+{
+    const int nInstances = 4;
+    const quint16 port = HttpTestSupport::findFreePort();
+
+    QList<QThread*> threads;
+    QList<LoopbackInstance*> instances;
+    startInstances(nInstances, port, threads, instances);
+
+    QCOMPARE(runClients(port, 64, 4), 256);
+    int nConnections = 0;
+    for (const LoopbackInstance *pInstance : std::as_const(instances))
+    {
+        // Kernel spreads connections by hash of the client address and port.
+        QVERIFY(pInstance->nConnections.load() > 0);
+        nConnections += pInstance->nConnections.load();
+    }
+    QCOMPARE(nConnections, 64);
+
+    stopInstances(threads, instances);
+}
+
+void TestHttpReusePort::benchmarkLoopback_data()
+{
+    QTest::addColumn<int>("nInstances");
+
+    for (int nInstances = 1; nInstances < QThread::idealThreadCount(); nInstances *= 2)
+    {
+        QTest::addRow("%d instances", nInstances) << nInstances;
+    }
+    QTest::addRow("%d instances (core count)", QThread::idealThreadCount()) << QThread::idealThreadCount();
+}
+
+void TestHttpReusePort::benchmarkLoopback()
+{
+    QFETCH(int, nInstances);
+
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    const quint16 port = HttpTestSupport::findFreePort();
+    QList<QThread*> threads;
+    QList<LoopbackInstance*> instances;
+    startInstances(nInstances, port, threads, instances);
+
+    // Many connections, so that the kernel has something to balance.
+    const int nClients = 4 * QThread::idealThreadCount();
+    const int nRequestsPerClient = 500;
+    int nReplies = 0;
+    QBENCHMARK
+    {
+        nReplies = runClients(port, nClients, nRequestsPerClient);
+    }
+    QCOMPARE(nReplies, nClients * nRequestsPerClient);
+
+    stopInstances(threads, instances);
+}
+
+QTEST_GUILESS_MAIN(TestHttpReusePort)
+#include "tst_http_reuse_port.moc"
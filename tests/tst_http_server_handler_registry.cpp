@@ -0,0 +1,263 @@
+#include <QtTest>
+#include <QDateTime>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+
+#include <functional>
+
+#include "rcl_http_server_handler_registry.h"
+
+#include "http_test_support.h"
+
+//! Number of add/lookup/remove cycles per thread in benchmarks.
+static constexpr int nBenchmarkCycles = 20000;
+
+//! Replica of the former handler bookkeeping (single mutex, two maps, random UUIDs).
+class LegacyHandlerMap
+{
+    private:
+
+        QMutex mutex;
+        QMap<QUuid,void*> handlers;
+        QMap<QUuid,QDateTime> creationTimes;
+
+    public:
+
+        QUuid add()
+        {
+            QUuid id = QUuid::createUuid();
+            QMutexLocker locker(&this->mutex);
+            this->handlers.insert(id,nullptr);
+            this->creationTimes.insert(id,QDateTime::currentDateTime());
+            return id;
+        }
+
+        bool contains(const QUuid &id)
+        {
+            QMutexLocker locker(&this->mutex);
+            return this->handlers.contains(id);
+        }
+
+        void remove(const QUuid &id)
+        {
+            QMutexLocker locker(&this->mutex);
+            this->handlers.remove(id);
+            this->creationTimes.remove(id);
+        }
+};
+
+static void runConcurrently(int nThreads, const std::function<void()> &function)
+{
+    QList<QThread*> threads;
+    for (int i = 0; i < nThreads; i++)
+    {
+        threads.append(QThread::create(function));
+    }
+    for (QThread *thread : std::as_const(threads))
+    {
+        thread->start();
+    }
+    for (QThread *thread : std::as_const(threads))
+    {
+        thread->wait();
+        delete thread;
+    }
+}
+
+class TestHttpServerHandlerRegistry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void acquireAndTake();
+    void staleIdIsRejected();
+    void foreignIdIsRejected();
+    void handlersAreRecycled();
+    void concurrentAcquireAndTake();
+
+    void benchmarkRegistry_data();
+    void benchmarkRegistry();
+    void benchmarkLegacyMap_data();
+    void benchmarkLegacyMap();
+};
+
+void TestHttpServerHandlerRegistry::acquireAndTake()
+{
+    RHttpServerHandlerRegistry registry;
+    RHttpServerHandler *handler = registry.acquire();
+    QVERIFY(handler);
+    QVERIFY(!handler->getId().isNull());
+    QCOMPARE(registry.size(), 1);
+    QVERIFY(registry.contains(handler->getId()));
+
+    QFuture<RHttpMessage> future = handler->getFuture();
+    RHttpServerHandler *taken = registry.take(handler->getId());
+    QCOMPARE(taken, handler);
+    QCOMPARE(registry.size(), 0);
+    QVERIFY(!registry.contains(handler->getId()));
+    QVERIFY(!registry.take(handler->getId()));
+
+    RHttpMessage reply;
+    reply.setBody("reply");
+    taken->sendReply(reply);
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.result().getBody(), QByteArray("reply"));
+    registry.release(taken);
+}
+
+void TestHttpServerHandlerRegistry::staleIdIsRejected()
+{
+    RHttpServerHandlerRegistry registry;
+
+    QList<QUuid> ids;
+    for (uint i = 0; i < RHttpServerHandlerRegistry::nStripes; i++)
+    {
+        RHttpServerHandler *handler = registry.acquire();
+        ids.append(handler->getId());
+        registry.release(registry.take(handler->getId()));
+    }
+
+    // Every stripe slot is reused now, but with a new generation.
+    for (uint i = 0; i < RHttpServerHandlerRegistry::nStripes; i++)
+    {
+        RHttpServerHandler *handler = registry.acquire();
+        QVERIFY(!ids.contains(handler->getId()));
+    }
+    for (const QUuid &id : std::as_const(ids))
+    {
+        QVERIFY(!registry.contains(id));
+        QVERIFY(!registry.take(id));
+    }
+    QCOMPARE(registry.size(), int(RHttpServerHandlerRegistry::nStripes));
+}
+
+void TestHttpServerHandlerRegistry::foreignIdIsRejected()
+{
+    RHttpServerHandlerRegistry registry1;
+    RHttpServerHandlerRegistry registry2;
+
+    RHttpServerHandler *handler = registry1.acquire();
+    QVERIFY(!registry2.contains(handler->getId()));
+    QVERIFY(!registry2.take(handler->getId()));
+    QVERIFY(!registry1.take(QUuid::createUuid()));
+    QVERIFY(!registry1.take(QUuid()));
+    QVERIFY(registry1.contains(handler->getId()));
+}
+
+void TestHttpServerHandlerRegistry::handlersAreRecycled()
+{
+    RHttpServerHandlerRegistry registry;
+
+    QSet<RHttpServerHandler*> handlers;
+    for (uint i = 0; i < RHttpServerHandlerRegistry::nStripes; i++)
+    {
+        RHttpServerHandler *handler = registry.acquire();
+        handlers.insert(handler);
+        registry.release(registry.take(handler->getId()));
+    }
+    for (uint i = 0; i < RHttpServerHandlerRegistry::nStripes; i++)
+    {
+        RHttpServerHandler *handler = registry.acquire();
+        QVERIFY(handlers.contains(handler));
+
+        // Recycled handler must hand out a fresh, unfinished future.
+        QFuture<RHttpMessage> future = handler->getFuture();
+        QVERIFY(!future.isFinished());
+        registry.release(registry.take(handler->getId()));
+    }
+}
+
+void TestHttpServerHandlerRegistry::concurrentAcquireAndTake()
+{
+    RHttpServerHandlerRegistry registry;
+    QAtomicInt nFailures(0);
+
+    runConcurrently(8,[&registry,&nFailures]()
+    {
+        for (int i = 0; i < 5000; i++)
+        {
+            RHttpServerHandler *handler = registry.acquire();
+            const QUuid id = handler->getId();
+            RHttpServerHandler *taken = registry.take(id);
+            if (taken != handler || registry.take(id))
+            {
+                nFailures.fetchAndAddRelaxed(1);
+            }
+            registry.release(taken);
+        }
+    });
+
+    QCOMPARE(nFailures.loadRelaxed(), 0);
+    QCOMPARE(registry.size(), 0);
+}
+
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("nThreads");
+    for (int nThreads : {1, 2, 4, 8, 16, 32})
+    {
+        QTest::newRow(QByteArray::number(nThreads).append(" threads").constData()) << nThreads;
+    }
+}
+
+void TestHttpServerHandlerRegistry::benchmarkRegistry_data()
+{
+    addThreadCountRows();
+}
+
+void TestHttpServerHandlerRegistry::benchmarkRegistry()
+{
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    QFETCH(int, nThreads);
+    RHttpServerHandlerRegistry registry;
+
+    QBENCHMARK
+    {
+        runConcurrently(nThreads,[&registry]()
+        {
+            for (int i = 0; i < nBenchmarkCycles; i++)
+            {
+                RHttpServerHandler *handler = registry.acquire();
+                const QUuid id = handler->getId();
+                registry.contains(id);
+                registry.release(registry.take(id));
+            }
+        });
+    }
+}
+
+void TestHttpServerHandlerRegistry::benchmarkLegacyMap_data()
+{
+    addThreadCountRows();
+}
+
+void TestHttpServerHandlerRegistry::benchmarkLegacyMap()
+{
+    if (!HttpTestSupport::isBenchmarkEnabled())
+    {
+        QSKIP("Set RANGE_BENCHMARKS to run benchmarks");
+    }
+    QFETCH(int, nThreads);
+    LegacyHandlerMap handlerMap;
+
+    QBENCHMARK
+    {
+        runConcurrently(nThreads,[&handlerMap]()
+        {
+            for (int i = 0; i < nBenchmarkCycles; i++)
+            {
+                const QUuid id = handlerMap.add();
+                handlerMap.contains(id);
+                handlerMap.remove(id);
+            }
+        });
+    }
+}
+
+QTEST_GUILESS_MAIN(TestHttpServerHandlerRegistry)
+#include "tst_http_server_handler_registry.moc"
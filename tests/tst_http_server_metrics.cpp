@@ -0,0 +1,177 @@
+#include <QtTest>
+#include <QThread>
+
+#include "rcl_http_latency_histogram.h"
+#include "rcl_http_server_metrics.h"
+
+class TestHttpServerMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void histogramBuckets();
+    void histogramQuantiles();
+    void histogramConcurrentRecord();
+    void recordRequest();
+    void prometheusText();
+    void json();
+};
+
+void TestHttpServerMetrics::histogramBuckets()
+{
+    // Small values are exact.
+    for (qint64 value = 0; value < RHttpLatencyHistogram::subBucketCount; value++)
+    {
+        QCOMPARE(RHttpLatencyHistogram::findBucket(value), int(value));
+        QCOMPARE(RHttpLatencyHistogram::findBucketUpperBound(int(value)), value);
+    }
+
+    // Every value lies within its bucket, relative error is bounded by sub-bucket resolution.
+    int previousBucket = 0;
+    for (qint64 value = 1; value <= RHttpLatencyHistogram::maxValue; value = value * 5 / 4 + 1)
+    {
+        const int bucket = RHttpLatencyHistogram::findBucket(value);
+        QVERIFY(bucket >= previousBucket);
+        QVERIFY(bucket < RHttpLatencyHistogram::nBuckets);
+        const qint64 upperBound = RHttpLatencyHistogram::findBucketUpperBound(bucket);
+        QVERIFY(upperBound >= value);
+        QVERIFY(double(upperBound - value) <= double(value) / RHttpLatencyHistogram::subBucketCount);
+        if (bucket > 0)
+        {
+            QVERIFY(RHttpLatencyHistogram::findBucketUpperBound(bucket - 1) < value);
+        }
+        previousBucket = bucket;
+    }
+    QCOMPARE(RHttpLatencyHistogram::findBucket(RHttpLatencyHistogram::maxValue), RHttpLatencyHistogram::nBuckets - 1);
+}
+
+void TestHttpServerMetrics::histogramQuantiles()
+{
+    RHttpLatencyHistogram histogram;
+    QCOMPARE(histogram.findQuantile(0.5), qint64(0));
+
+    for (qint64 value = 1; value <= 10000; value++)
+    {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.getCount(), quint64(10000));
+    QCOMPARE(histogram.getSum(), quint64(10000) * 10001 / 2);
+    QCOMPARE(histogram.getMax(), qint64(10000));
+
+    const QList<double> quantiles = {0.5, 0.9, 0.99, 0.999};
+    for (double quantile : quantiles)
+    {
+        const double expected = quantile * 10000.0;
+        const double actual = double(histogram.findQuantile(quantile));
+        QVERIFY2(actual >= expected && actual <= expected * (1.0 + 1.0 / RHttpLatencyHistogram::subBucketCount),
+                 qPrintable(QString("q = %1, value = %2").arg(quantile).arg(actual)));
+    }
+    QCOMPARE(histogram.findQuantile(1.0), qint64(10000));
+
+    histogram.record(-5);
+    histogram.record(RHttpLatencyHistogram::maxValue * 2);
+    QCOMPARE(histogram.getMax(), RHttpLatencyHistogram::maxValue);
+}
+
+void TestHttpServerMetrics::histogramConcurrentRecord()
+{
+    RHttpLatencyHistogram histogram;
+    const int nThreads = 8;
+    const int nValues = 100000;
+
+    QList<QThread*> threads;
+    for (int i = 0; i < nThreads; i++)
+    {
+        threads.append(QThread::create([&histogram, i]()
+        {
+            for (int j = 0; j < nValues; j++)
+            {
+                histogram.record(qint64(i) * 1000 + j % 1000);
+            }
+        }));
+    }
+    for (QThread *thread : std::as_const(threads))
+    {
+        thread->start();
+    }
+    for (QThread *thread : std::as_const(threads))
+    {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    QCOMPARE(histogram.getCount(), quint64(nThreads) * nValues);
+    QCOMPARE(histogram.getMax(), qint64(nThreads - 1) * 1000 + 999);
+}
+
+void TestHttpServerMetrics::recordRequest()
+{
+    RHttpServerMetrics metrics({"list-files", "file-upload"});
+
+    RHttpServerMetrics::Timing timing;
+    timing.receivedTime = 1000;
+    timing.dispatchedTime = 1500;
+    timing.repliedTime = RHttpServerMetrics::currentTime();
+
+    metrics.recordRequest("list-files", RError::None, 100, 2000, timing);
+    metrics.recordRequest("list-files", RError::NotFound, 100, 10, timing);
+    metrics.recordRequest("list-files", RError::Timeout, 100, 10, timing);
+    metrics.recordRequest("unknown-action", RError::None, 100, 10, timing);
+
+    QCOMPARE(metrics.getRequestCount("list-files"), quint64(3));
+    QCOMPARE(metrics.getRequestCount("file-upload"), quint64(0));
+    QCOMPARE(metrics.getRequestCount("unknown-action"), quint64(0));
+    QCOMPARE(metrics.getErrorCount("list-files", RError::NotFound), quint64(1));
+    QCOMPARE(metrics.getErrorCount("list-files", RError::Timeout), quint64(1));
+    QCOMPARE(metrics.getErrorCount("list-files", RError::None), quint64(0));
+
+    const RHttpLatencyHistogram *queueLatency = metrics.findLatency("list-files", RHttpServerMetrics::Queue);
+    QVERIFY(queueLatency);
+    QCOMPARE(queueLatency->getCount(), quint64(3));
+    QCOMPARE(queueLatency->getMax(), qint64(500));
+    QVERIFY(!metrics.findLatency("unknown-action", RHttpServerMetrics::Queue));
+}
+
+void TestHttpServerMetrics::prometheusText()
+{
+    RHttpServerMetrics metrics({"list-files"});
+
+    RHttpServerMetrics::Timing timing;
+    timing.receivedTime = RHttpServerMetrics::currentTime();
+    timing.dispatchedTime = timing.receivedTime;
+    timing.repliedTime = timing.receivedTime;
+    metrics.recordRequest("list-files", RError::None, 10, 2000, timing);
+    metrics.recordRequest("list-files", RError::NotFound, 10, 20, timing);
+
+    const QByteArray text = metrics.toPrometheusText(3);
+    QVERIFY(text.contains("# TYPE range_cloud_http_requests_total counter\n"));
+    QVERIFY(text.contains("range_cloud_http_requests_total{action=\"list-files\"} 2\n"));
+    QVERIFY(text.contains("range_cloud_http_errors_total{action=\"list-files\",error=\"NotFound\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_http_request_bytes_total{action=\"list-files\"} 20\n"));
+    QVERIFY(text.contains("range_cloud_http_response_bytes_total{action=\"list-files\"} 2020\n"));
+    QVERIFY(text.contains("range_cloud_http_latency_seconds_count{action=\"list-files\",phase=\"backend\"} 2\n"));
+    QVERIFY(text.contains("range_cloud_http_latency_seconds{action=\"list-files\",phase=\"send\",quantile=\"0.99\"} "));
+    QVERIFY(text.contains("range_cloud_http_inflight_handlers 3\n"));
+}
+
+void TestHttpServerMetrics::json()
+{
+    RHttpServerMetrics metrics({"list-files"});
+
+    RHttpServerMetrics::Timing timing;
+    timing.receivedTime = RHttpServerMetrics::currentTime();
+    metrics.recordRequest("list-files", RError::Unauthorized, 10, 20, timing);
+
+    const QJsonObject json = metrics.toJson(1);
+    QCOMPARE(json["in-flight-handlers"].toInteger(), qint64(1));
+    const QJsonObject actionObject = json["actions"].toObject()["list-files"].toObject();
+    QCOMPARE(actionObject["requests"].toInteger(), qint64(1));
+    QCOMPARE(actionObject["bytes-in"].toInteger(), qint64(10));
+    QCOMPARE(actionObject["bytes-out"].toInteger(), qint64(20));
+    QCOMPARE(actionObject["errors"].toObject()["Unauthorized"].toInteger(), qint64(1));
+    QCOMPARE(actionObject["latency-us"].toObject()["queue"].toObject()["count"].toInteger(), qint64(1));
+}
+
+QTEST_GUILESS_MAIN(TestHttpServerMetrics)
+#include "tst_http_server_metrics.moc"
@@ -0,0 +1,129 @@
+#include <QtTest>
+#include <QMap>
+#include <QScopeGuard>
+#include <QSslSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+
+#include "rcl_auth_token_validator.h"
+#include "rcl_cloud_action.h"
+#include "rcl_http_server.h"
+
+#include "http_test_support.h"
+
+//! Validator accepting every token.
+class AcceptingTokenValidator : public RAuthTokenValidator
+{
+    Q_OBJECT
+
+    public:
+
+        bool validate(const QString &, const QString &) override
+        {
+            return true;
+        }
+
+};
+
+class TestHttpServerPendingRequests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void pendingRequestsExceedThreadPool();
+};
+
+void TestHttpServerPendingRequests::pendingRequestsExceedThreadPool()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString certificateFile = directory.filePath("server.crt");
+    const QString keyFile = directory.filePath("server.key");
+    if (!HttpTestSupport::generateCertificate(certificateFile, keyFile))
+    {
+        QSKIP("OpenSSL command line tool is not available to generate a certificate");
+    }
+
+    // Backend holds every request until all of them are pending, parked pool threads would run out first.
+    const int nRequests = 4 * QThreadPool::globalInstance()->maxThreadCount() + 16;
+
+    RHttpServerSettings settings;
+    settings.setPort(HttpTestSupport::findFreePort());
+    settings.setTlsKeyStore(RTlsKeyStore(certificateFile, keyFile, QString()));
+    settings.setTlsTrustStore(RTlsTrustStore(certificateFile));
+    settings.setRateLimitPerSecond(0);
+    // Dispatch lanes cap requests in flight per lane regardless of threads, Test action runs
+    // in the interactive lane whose default cap would queue requests before the backend sees them.
+    settings.setInteractiveLaneConcurrency(quint32(nRequests));
+
+    QThread serverThread;
+    RHttpServer *pServer = new RHttpServer(RHttpServer::Public, settings);
+    AcceptingTokenValidator *pValidator = new AcceptingTokenValidator(pServer);
+    pServer->setAuthTokenValidator(pValidator);
+    pServer->moveToThread(&serverThread);
+    QObject::connect(&serverThread, &QThread::finished, pServer, &QObject::deleteLater);
+    const auto stopServer = qScopeGuard([&serverThread]()
+    {
+        serverThread.quit();
+        serverThread.wait();
+    });
+    QList<RHttpMessage> requests;
+    QObject::connect(pServer, &RHttpServer::requestAvailable, this, [&requests](const RHttpMessage &httpMessage)
+    {
+        requests.append(httpMessage);
+    });
+    QSignalSpy readySpy(pServer, &RHttpServer::ready);
+    serverThread.start();
+    QMetaObject::invokeMethod(pServer, &RHttpServer::start, Qt::BlockingQueuedConnection);
+    QCOMPARE(readySpy.count(), 1);
+
+    const QByteArray request = "POST /" + RCloudAction::Action::Test::key.toUtf8() + "/?"
+                             + RCloudAction::Auth::User::key.toUtf8() + "=user&"
+                             + RCloudAction::Auth::Token::key.toUtf8() + "=token HTTP/1.1\r\n"
+                             + "Host: localhost\r\nContent-Length: 0\r\n\r\n";
+    QObject clients;
+    QMap<QSslSocket*,QByteArray> responses;
+    for (int i = 0; i < nRequests; i++)
+    {
+        QSslSocket *pSocket = new QSslSocket(&clients);
+        pSocket->setPeerVerifyMode(QSslSocket::VerifyNone);
+        QObject::connect(pSocket, &QSslSocket::encrypted, pSocket, [pSocket, request]()
+        {
+            pSocket->write(request);
+        });
+        QObject::connect(pSocket, &QSslSocket::readyRead, pSocket, [pSocket, &responses]()
+        {
+            responses[pSocket] += pSocket->readAll();
+        });
+        pSocket->connectToHostEncrypted("localhost", settings.getPort());
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(requests.size(), nRequests, 60000);
+    QCOMPARE(pServer->getPendingHandlerCount(), qint64(nRequests));
+    QVERIFY(responses.isEmpty());
+
+    for (RHttpMessage httpMessage : std::as_const(requests))
+    {
+        httpMessage.setBody("ok");
+        pServer->sendMessageReply(httpMessage);
+    }
+    const auto countAnswered = [&responses]()
+    {
+        int nAnswered = 0;
+        for (const QByteArray &response : std::as_const(responses))
+        {
+            if (response.startsWith("HTTP/1.1 200") && response.endsWith("\r\n\r\nok"))
+            {
+                nAnswered++;
+            }
+        }
+        return nAnswered;
+    };
+    QTRY_COMPARE_WITH_TIMEOUT(countAnswered(), nRequests, 60000);
+    QCOMPARE(pServer->getPendingHandlerCount(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestHttpServerPendingRequests)
+#include "tst_http_server_pending_requests.moc"
@@ -0,0 +1,129 @@
+#include <QtTest>
+#include <QRandomGenerator>
+
+#include "rcl_http_timing_wheel.h"
+
+class TestHttpTimingWheel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void emptyWheel();
+    void expiresAtDeadline();
+    void pastDeadlineExpiresImmediately();
+    void expiresAcrossLevels();
+    void beyondRangeIsKept();
+    void randomDeadlines();
+};
+
+void TestHttpTimingWheel::emptyWheel()
+{
+    RHttpTimingWheel wheel(50, 1000);
+    QVERIFY(wheel.isEmpty());
+    QVERIFY(wheel.advance(1000000).isEmpty());
+    QCOMPARE(wheel.size(), 0);
+}
+
+void TestHttpTimingWheel::expiresAtDeadline()
+{
+    RHttpTimingWheel wheel(50, 0);
+    const QUuid id = QUuid::createUuid();
+    wheel.schedule(id, 120);
+    QCOMPARE(wheel.size(), 1);
+
+    // Deadline is rounded up to the next tick (150 ms).
+    QVERIFY(wheel.advance(100).isEmpty());
+    QVERIFY(wheel.advance(149).isEmpty());
+
+    const QList<QUuid> expired = wheel.advance(150);
+    QCOMPARE(expired.size(), 1);
+    QCOMPARE(expired.first(), id);
+    QVERIFY(wheel.isEmpty());
+}
+
+void TestHttpTimingWheel::pastDeadlineExpiresImmediately()
+{
+    RHttpTimingWheel wheel(10, 0);
+    wheel.advance(500);
+
+    const QUuid id = QUuid::createUuid();
+    wheel.schedule(id, 100);
+    const QList<QUuid> expired = wheel.advance(500);
+    QCOMPARE(expired.size(), 1);
+    QCOMPARE(expired.first(), id);
+    QVERIFY(wheel.isEmpty());
+}
+
+void TestHttpTimingWheel::expiresAcrossLevels()
+{
+    RHttpTimingWheel wheel(1, 0);
+
+    // One deadline per wheel level.
+    const QList<qint64> deadlines = {10, 1000, 100000, 5000000};
+    QList<QUuid> ids;
+    for (qint64 deadline : deadlines)
+    {
+        ids.append(QUuid::createUuid());
+        wheel.schedule(ids.last(), deadline);
+    }
+
+    for (int i = 0; i < deadlines.size(); i++)
+    {
+        QVERIFY(wheel.advance(deadlines.at(i) - 1).isEmpty());
+        const QList<QUuid> expired = wheel.advance(deadlines.at(i));
+        QCOMPARE(expired.size(), 1);
+        QCOMPARE(expired.first(), ids.at(i));
+    }
+    QVERIFY(wheel.isEmpty());
+}
+
+void TestHttpTimingWheel::beyondRangeIsKept()
+{
+    RHttpTimingWheel wheel(1, 0);
+    const qint64 range = qint64(1) << (RHttpTimingWheel::levelBits * RHttpTimingWheel::nLevels);
+    const qint64 deadline = 3 * range + 7;
+
+    const QUuid id = QUuid::createUuid();
+    wheel.schedule(id, deadline);
+
+    QVERIFY(wheel.advance(range).isEmpty());
+    QVERIFY(wheel.advance(deadline - 1).isEmpty());
+    const QList<QUuid> expired = wheel.advance(deadline);
+    QCOMPARE(expired.size(), 1);
+    QCOMPARE(expired.first(), id);
+}
+
+void TestHttpTimingWheel::randomDeadlines()
+{
+    RHttpTimingWheel wheel(5, 0);
+    QRandomGenerator generator(42);
+
+    QMap<QUuid,qint64> deadlines;
+    for (int i = 0; i < 2000; i++)
+    {
+        const QUuid id = QUuid::createUuid();
+        const qint64 deadline = generator.bounded(1, 300000);
+        deadlines.insert(id, deadline);
+        wheel.schedule(id, deadline);
+    }
+
+    qint64 now = 0;
+    while (!wheel.isEmpty())
+    {
+        now += generator.bounded(1, 700);
+        const QList<QUuid> expired = wheel.advance(now);
+        for (const QUuid &id : expired)
+        {
+            QVERIFY(deadlines.contains(id));
+            const qint64 deadline = deadlines.take(id);
+            // Never early, and late by less than one resolution plus the step.
+            QVERIFY(deadline <= now);
+            QVERIFY(now - deadline < 5 + 700);
+        }
+    }
+    QVERIFY(deadlines.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(TestHttpTimingWheel)
+#include "tst_http_timing_wheel.moc"
@@ -0,0 +1,80 @@
+#include <QtTest>
+
+#include "rcl_http_tls_metrics.h"
+
+class TestHttpTlsMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void empty();
+    void handshakes();
+    void prometheusText();
+    void json();
+};
+
+void TestHttpTlsMetrics::empty()
+{
+    RHttpTlsMetrics metrics;
+    for (int result = 0; result < RHttpTlsMetrics::nResults; result++)
+    {
+        QCOMPARE(metrics.getHandshakeCount(RHttpTlsMetrics::Result(result)), quint64(0));
+    }
+    QCOMPARE(metrics.getResumptionRatio(), 0.0);
+    QCOMPARE(metrics.getLatency().getCount(), quint64(0));
+}
+
+void TestHttpTlsMetrics::handshakes()
+{
+    RHttpTlsMetrics metrics;
+    metrics.recordHandshake(RHttpTlsMetrics::Full, 4000);
+    metrics.recordHandshake(RHttpTlsMetrics::Resumed, 500);
+    metrics.recordHandshake(RHttpTlsMetrics::Resumed, 600);
+    metrics.recordHandshake(RHttpTlsMetrics::Resumed, 700);
+    metrics.recordHandshake(RHttpTlsMetrics::Failed, 0);
+    metrics.recordKeyRotation();
+
+    QCOMPARE(metrics.getHandshakeCount(RHttpTlsMetrics::Full), quint64(1));
+    QCOMPARE(metrics.getHandshakeCount(RHttpTlsMetrics::Resumed), quint64(3));
+    QCOMPARE(metrics.getHandshakeCount(RHttpTlsMetrics::Failed), quint64(1));
+    QCOMPARE(metrics.getKeyRotationCount(), quint64(1));
+    // Failed handshakes are not part of the ratio nor of the durations.
+    QCOMPARE(metrics.getResumptionRatio(), 0.75);
+    QCOMPARE(metrics.getLatency().getCount(), quint64(4));
+    QVERIFY(metrics.getLatency().getMax() >= 4000);
+
+    // Handshakes of unknown kind lower the ratio.
+    metrics.recordHandshake(RHttpTlsMetrics::Unknown, 1000);
+    QCOMPARE(metrics.getResumptionRatio(), 0.6);
+}
+
+void TestHttpTlsMetrics::prometheusText()
+{
+    RHttpTlsMetrics metrics;
+    metrics.recordHandshake(RHttpTlsMetrics::Full, 2000);
+    metrics.recordHandshake(RHttpTlsMetrics::Resumed, 200);
+
+    const QByteArray text = metrics.toPrometheusText();
+    QVERIFY(text.contains("# TYPE range_cloud_tls_handshakes_total counter\n"));
+    QVERIFY(text.contains("range_cloud_tls_handshakes_total{result=\"full\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_tls_handshakes_total{result=\"resumed\"} 1\n"));
+    QVERIFY(text.contains("range_cloud_tls_handshakes_total{result=\"failed\"} 0\n"));
+    QVERIFY(text.contains("range_cloud_tls_resumption_ratio 0.5\n"));
+    QVERIFY(text.contains("range_cloud_tls_handshake_seconds_count 2\n"));
+    QVERIFY(text.contains("range_cloud_tls_ticket_key_rotations_total 0\n"));
+}
+
+void TestHttpTlsMetrics::json()
+{
+    RHttpTlsMetrics metrics;
+    metrics.recordHandshake(RHttpTlsMetrics::Resumed, 300);
+
+    const QJsonObject json = metrics.toJson();
+    QCOMPARE(json["handshakes"].toObject()["resumed"].toInteger(), qint64(1));
+    QCOMPARE(json["resumption-ratio"].toDouble(), 1.0);
+    QCOMPARE(json["handshake-us"].toObject()["count"].toInteger(), qint64(1));
+}
+
+QTEST_APPLESS_MAIN(TestHttpTlsMetrics)
+#include "tst_http_tls_metrics.moc"
@@ -0,0 +1,187 @@
+#include <QtTest>
+#include <QScopeGuard>
+#include <QSignalSpy>
+#include <QSslConfiguration>
+#include <QSslSocket>
+#include <QTemporaryDir>
+
+#include <limits>
+
+#include "rcl_http_server.h"
+#include "rcl_http_tls_ticket_key_store.h"
+
+#include "http_test_support.h"
+
+class TestHttpTlsTicketKeyStore : public QObject
+{
+    Q_OBJECT
+
+private:
+
+    //! Return number of server handshakes with given result.
+    static qint64 findHandshakeCount(const RHttpServer *pServer, RHttpTlsMetrics::Result result);
+
+    //! Send request over given connection and wait for the response.
+    static bool sendRequest(QSslSocket *pSocket);
+
+private slots:
+
+    void keysAreRandom();
+    void previousKeyIsAccepted();
+    void rotationIsDue();
+    void unusedPreviousKeyIsDropped();
+    void reconnectResumesSession();
+};
+
+qint64 TestHttpTlsTicketKeyStore::findHandshakeCount(const RHttpServer *pServer, RHttpTlsMetrics::Result result)
+{
+    const QJsonObject tlsJson = pServer->getMetrics()["tls"].toObject();
+    return tlsJson["handshakes"].toObject()[RHttpTlsMetrics::resultToString(result)].toInteger();
+}
+
+bool TestHttpTlsTicketKeyStore::sendRequest(QSslSocket *pSocket)
+{
+    pSocket->write("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QByteArray response;
+    while (!response.contains("\r\n\r\n"))
+    {
+        if (pSocket->bytesAvailable() == 0 && !pSocket->waitForReadyRead(10000))
+        {
+            return false;
+        }
+        response += pSocket->readAll();
+    }
+    return response.startsWith("HTTP/1.1");
+}
+
+void TestHttpTlsTicketKeyStore::keysAreRandom()
+{
+    RHttpTlsTicketKeyStore store(1000,0);
+    const RHttpTlsTicketKeyStore::Key key = store.getCurrentKey();
+    QCOMPARE(key.name.size(), RHttpTlsTicketKeyStore::nameSize);
+    QCOMPARE(key.encryptionSecret.size(), RHttpTlsTicketKeyStore::secretSize);
+    QCOMPARE(key.macSecret.size(), RHttpTlsTicketKeyStore::secretSize);
+    QVERIFY(key.encryptionSecret != key.macSecret);
+
+    RHttpTlsTicketKeyStore otherStore(1000,0);
+    QVERIFY(otherStore.getCurrentKey().name != key.name);
+    RHttpTlsTicketKeyStore::Key otherKey;
+    QVERIFY(!otherStore.findKey(key.name,otherKey));
+}
+
+void TestHttpTlsTicketKeyStore::previousKeyIsAccepted()
+{
+    RHttpTlsTicketKeyStore store(1000,0);
+    const RHttpTlsTicketKeyStore::Key firstKey = store.getCurrentKey();
+    store.rotate(10);
+    const RHttpTlsTicketKeyStore::Key secondKey = store.getCurrentKey();
+    QVERIFY(secondKey.name != firstKey.name);
+
+    RHttpTlsTicketKeyStore::Key key;
+    bool isCurrent = false;
+    QVERIFY(store.findKey(secondKey.name,key,&isCurrent));
+    QVERIFY(isCurrent);
+    QVERIFY(store.findKey(firstKey.name,key,&isCurrent));
+    QVERIFY(!isCurrent);
+    QCOMPARE(key.encryptionSecret, firstKey.encryptionSecret);
+
+    store.rotate(20);
+    QVERIFY(!store.findKey(firstKey.name,key));
+    QVERIFY(store.findKey(secondKey.name,key,&isCurrent));
+    QVERIFY(!isCurrent);
+}
+
+void TestHttpTlsTicketKeyStore::rotationIsDue()
+{
+    RHttpTlsTicketKeyStore store(1000,0);
+    const QByteArray firstName = store.getCurrentKey().name;
+    QVERIFY(!store.rotateIfDue(999));
+    QCOMPARE(store.getCurrentKey().name, firstName);
+    QVERIFY(store.rotateIfDue(1000));
+    QVERIFY(store.getCurrentKey().name != firstName);
+    QVERIFY(!store.rotateIfDue(1500));
+
+    RHttpTlsTicketKeyStore neverRotatedStore(0,0);
+    QVERIFY(!neverRotatedStore.rotateIfDue(std::numeric_limits<qint32>::max()));
+}
+
+void TestHttpTlsTicketKeyStore::unusedPreviousKeyIsDropped()
+{
+    RHttpTlsTicketKeyStore store(1000,0);
+    const QByteArray firstName = store.getCurrentKey().name;
+    RHttpTlsTicketKeyStore::Key key;
+    QVERIFY(store.rotateIfDue(2500));
+    QVERIFY(!store.findKey(firstName,key));
+}
+
+void TestHttpTlsTicketKeyStore::reconnectResumesSession()
+{
+    if (QSslSocket::activeBackend() != QStringLiteral("openssl"))
+    {
+        QSKIP("Session ticket keys are installed with the OpenSSL TLS backend only");
+    }
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString certificateFile = directory.filePath("server.crt");
+    const QString keyFile = directory.filePath("server.key");
+    if (!HttpTestSupport::generateCertificate(certificateFile, keyFile))
+    {
+        QSKIP("OpenSSL command line tool is not available to generate a certificate");
+    }
+
+    RHttpServerSettings settings;
+    settings.setPort(HttpTestSupport::findFreePort());
+    settings.setTlsKeyStore(RTlsKeyStore(certificateFile, keyFile, QString()));
+    settings.setTlsTrustStore(RTlsTrustStore(certificateFile));
+
+    QThread serverThread;
+    RHttpServer *pServer = new RHttpServer(RHttpServer::Public, settings);
+    pServer->moveToThread(&serverThread);
+    QObject::connect(&serverThread, &QThread::finished, pServer, &QObject::deleteLater);
+    const auto stopServer = qScopeGuard([&serverThread]()
+    {
+        serverThread.quit();
+        serverThread.wait();
+    });
+    QSignalSpy readySpy(pServer, &RHttpServer::ready);
+    serverThread.start();
+    QMetaObject::invokeMethod(pServer, &RHttpServer::start, Qt::BlockingQueuedConnection);
+    QCOMPARE(readySpy.count(), 1);
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
+    QByteArray sessionTicket;
+    {
+        QSslSocket socket;
+        socket.setSslConfiguration(configuration);
+        QSignalSpy ticketSpy(&socket, &QSslSocket::newSessionTicketReceived);
+        socket.connectToHostEncrypted("localhost", settings.getPort());
+        QVERIFY(socket.waitForEncrypted(10000));
+        // Tickets follow the handshake, they are read with the response.
+        QVERIFY(sendRequest(&socket));
+        QVERIFY(ticketSpy.count() > 0 || ticketSpy.wait(10000));
+        sessionTicket = socket.sslConfiguration().sessionTicket();
+        socket.disconnectFromHost();
+    }
+    QVERIFY(!sessionTicket.isEmpty());
+    QTRY_COMPARE(findHandshakeCount(pServer,RHttpTlsMetrics::Full) + findHandshakeCount(pServer,RHttpTlsMetrics::Unknown), qint64(1));
+    if (findHandshakeCount(pServer,RHttpTlsMetrics::Unknown) > 0)
+    {
+        QSKIP("Library is built without OpenSSL, resumed handshakes cannot be told apart");
+    }
+
+    // New connection gets new TLS context on the server, ticket keys are shared.
+    configuration.setSessionTicket(sessionTicket);
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    socket.connectToHostEncrypted("localhost", settings.getPort());
+    QVERIFY(socket.waitForEncrypted(10000));
+    QVERIFY(sendRequest(&socket));
+    QTRY_COMPARE(findHandshakeCount(pServer,RHttpTlsMetrics::Resumed), qint64(1));
+    QCOMPARE(findHandshakeCount(pServer,RHttpTlsMetrics::Full), qint64(1));
+}
+
+QTEST_GUILESS_MAIN(TestHttpTlsTicketKeyStore)
+#include "tst_http_tls_ticket_key_store.moc"